@@ -1,6 +1,7 @@
 #ifndef ZCOROUTINE_HOOK_H_
 #define ZCOROUTINE_HOOK_H_
 
+#include <cstdint>
 #include <ctime>
 #include <sys/socket.h>
 #include <sys/types.h>
@@ -60,6 +61,10 @@ typedef int (*accept_func)(int sockfd, struct sockaddr *addr,
                            socklen_t *addrlen);
 extern accept_func accept_f;
 
+typedef int (*accept4_func)(int sockfd, struct sockaddr *addr,
+                            socklen_t *addrlen, int flags);
+extern accept4_func accept4_f;
+
 // IO系列
 typedef ssize_t (*read_func)(int fd, void *buf, size_t count);
 extern read_func read_f;
@@ -116,6 +121,13 @@ typedef int (*getsockopt_func)(int sockfd, int level, int optname, void *optval,
                                socklen_t *optlen);
 extern getsockopt_func getsockopt_f;
 
+/**
+ * @brief 带超时的connect（hook未启用时退化为原始connect）
+ * @param timeout_ms 超时时间（毫秒），超时返回-1且errno为ETIMEDOUT
+ */
+int connect_with_timeout(int fd, const struct sockaddr *addr, socklen_t addrlen,
+                         uint64_t timeout_ms);
+
 } // extern "C"
 
 #endif // ZCOROUTINE_HOOK_H_
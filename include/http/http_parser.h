@@ -0,0 +1,131 @@
+#ifndef ZCOROUTINE_HTTP_PARSER_H_
+#define ZCOROUTINE_HTTP_PARSER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace zcoroutine {
+
+/**
+ * @brief 指向外部缓冲区的只读字节片段（不拥有内存）
+ */
+struct HttpSlice {
+  const char *data = nullptr;
+  size_t size = 0;
+
+  HttpSlice() = default;
+  HttpSlice(const char *d, size_t n) : data(d), size(n) {}
+
+  bool empty() const { return size == 0; }
+  std::string to_string() const { return std::string(data, size); }
+
+  bool equals(const char *str) const {
+    return std::strlen(str) == size && std::memcmp(data, str, size) == 0;
+  }
+
+  /**
+   * @brief 忽略ASCII大小写比较（用于头部名与token值）
+   */
+  bool iequals(const char *str) const;
+};
+
+/**
+ * @brief 解析出的HTTP请求
+ *
+ * 所有HttpSlice都指向连接的读缓冲区，只在请求处理期间有效。
+ */
+struct HttpRequest {
+  HttpSlice method;
+  HttpSlice target; // 原始请求目标（路径 + 查询串）
+  HttpSlice path;
+  HttpSlice query; // 不含'?'
+  int version_minor = 1; // HTTP/1.x
+  std::vector<std::pair<HttpSlice, HttpSlice>> headers;
+  HttpSlice body;
+  bool keep_alive = true;
+
+  /**
+   * @brief 查找头部（名字忽略大小写）
+   * @return 头部值；不存在时返回空片段
+   */
+  HttpSlice header(const char *name) const;
+
+  void clear();
+};
+
+/**
+ * @brief HTTP/1.x 请求解析器（增量、零拷贝）
+ *
+ * 调用方把连接读缓冲区中的连续数据交给parse()：
+ *  - 数据不完整时返回kIncomplete，并记住已扫描到的位置，
+ *    追加数据后再次调用不会从头查找头部结束标记；
+ *  - 完整时返回kComplete，consumed()为该请求占用的字节数，
+ *    缓冲区中剩余的数据即流水线上的下一个请求；
+ *  - 出错时返回kError，error_status()为应答的HTTP状态码。
+ *
+ * 请求体只支持Content-Length；带Transfer-Encoding的请求返回501。
+ * 两次parse()之间数据可以被搬移（环形缓冲区线性化），解析器只保存偏移量。
+ */
+class HttpParser {
+public:
+  enum class Status { kComplete, kIncomplete, kError };
+
+  struct Options {
+    size_t max_header_size = 8192;  // 请求行 + 头部的最大字节数
+    size_t max_body_size = 1 << 20; // 请求体最大字节数
+    size_t max_headers = 64;        // 头部数量上限
+  };
+
+  HttpParser() = default;
+  explicit HttpParser(Options options) : options_(options) {}
+
+  /**
+   * @brief 解析data开头的一个请求
+   * @param data 缓冲区起始地址（上次未完成的请求也从这里开始）
+   * @param len 缓冲区中的字节数
+   * @param req 输出请求，kComplete时有效
+   */
+  Status parse(const char *data, size_t len, HttpRequest *req);
+
+  /**
+   * @brief 上一个完整请求占用的字节数
+   */
+  size_t consumed() const { return header_len_ + body_len_; }
+
+  /**
+   * @brief kError时应答的状态码（400/413/431/501/505）
+   */
+  int error_status() const { return error_status_; }
+
+  /**
+   * @brief 开始解析下一个请求
+   */
+  void reset();
+
+private:
+  /**
+   * @brief 解析请求行与头部（header_len_已确定）
+   * @return 成功返回true，失败设置error_status_
+   */
+  bool parse_header(const char *data, HttpRequest *req);
+
+  Status fail(int status) {
+    error_status_ = status;
+    return Status::kError;
+  }
+
+private:
+  Options options_;
+  size_t scan_pos_ = 0;   // 下次查找"\r\n\r\n"的起始位置
+  size_t header_len_ = 0; // 请求行 + 头部长度（含空行），0表示尚未找到
+  size_t body_len_ = 0;
+  int error_status_ = 0;
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_HTTP_PARSER_H_
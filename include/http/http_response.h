@@ -0,0 +1,109 @@
+#ifndef ZCOROUTINE_HTTP_RESPONSE_H_
+#define ZCOROUTINE_HTTP_RESPONSE_H_
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "net/socket_stream.h"
+#include "util/noncopyable.h"
+
+namespace zcoroutine {
+
+/**
+ * @brief HTTP响应
+ *
+ * 两种发送方式：
+ *  - 普通响应：set_body()/append_body()填充响应体，处理函数返回后由服务器
+ *    加上Content-Length一次写出；
+ *  - 分块响应：调用write_chunk()时先发送头部（Transfer-Encoding: chunked），
+ *    之后每块直接写入连接，处理函数返回后服务器补上结束块。
+ *    HTTP/1.0请求不支持分块，write_chunk()退化为append_body()。
+ *
+ * 写入都进入连接的写缓冲区（自动cork），流水线上的多个响应合并发送。
+ */
+class HttpResponse : public NonCopyable {
+public:
+  explicit HttpResponse(SocketStream *stream) : stream_(stream) {}
+
+  void set_status(int status) { status_ = status; }
+  int status() const { return status_; }
+
+  /**
+   * @brief 添加响应头（Content-Length/Transfer-Encoding/Connection/Date
+   * 由服务器生成，不应手动设置）
+   */
+  void set_header(std::string name, std::string value) {
+    headers_.emplace_back(std::move(name), std::move(value));
+  }
+
+  void set_content_type(std::string type) {
+    set_header("Content-Type", std::move(type));
+  }
+
+  void set_body(std::string body) { body_ = std::move(body); }
+  void append_body(const char *data, size_t len) { body_.append(data, len); }
+  const std::string &body() const { return body_; }
+
+  /**
+   * @brief 处理完本请求后关闭连接
+   */
+  void set_close() { keep_alive_ = false; }
+  bool keep_alive() const { return keep_alive_; }
+
+  /**
+   * @brief 发送一个分块（首次调用时先发送头部）
+   * @return 成功返回0，连接出错返回-1
+   */
+  int write_chunk(const char *data, size_t len);
+  int write_chunk(const std::string &data) {
+    return write_chunk(data.data(), data.size());
+  }
+
+  bool headers_sent() const { return headers_sent_; }
+
+  /**
+   * @brief 状态码对应的原因短语
+   */
+  static const char *reason_phrase(int status);
+
+private:
+  friend class HttpServer;
+
+  /**
+   * @brief 开始一个新响应
+   * @param version_minor 请求的HTTP次版本号
+   * @param keep_alive 请求是否允许保持连接
+   * @param head_only HEAD请求不发送响应体
+   */
+  void reset(int version_minor, bool keep_alive, bool head_only);
+
+  /**
+   * @brief 处理函数返回后完成响应
+   * @return 成功返回0，连接出错返回-1
+   */
+  int finish();
+
+  /**
+   * @brief 写出状态行与头部
+   * @param content_length 普通响应的响应体长度；分块响应传-1
+   */
+  int send_head(long long content_length);
+
+private:
+  SocketStream *stream_;
+  int status_ = 200;
+  int version_minor_ = 1;
+  bool keep_alive_ = true;
+  bool head_only_ = false;
+  bool headers_sent_ = false;
+  bool chunked_ = false;
+  std::vector<std::pair<std::string, std::string>> headers_;
+  std::string body_;
+  std::string head_; // 复用的头部序列化缓冲区
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_HTTP_RESPONSE_H_
@@ -0,0 +1,75 @@
+#ifndef ZCOROUTINE_HTTP_ROUTER_H_
+#define ZCOROUTINE_HTTP_ROUTER_H_
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "http/http_parser.h"
+#include "http/http_response.h"
+
+namespace zcoroutine {
+
+/**
+ * @brief HTTP路由表
+ *
+ * 精确路径用哈希表查找，前缀路由按前缀长度从长到短匹配。
+ * 方法为"*"的路由匹配任意方法。路径存在但方法不匹配时返回405。
+ * 路由应在服务器启动前注册，运行期只读，无需加锁。
+ */
+class HttpRouter {
+public:
+  using Handler = std::function<void(const HttpRequest &, HttpResponse &)>;
+
+  /**
+   * @brief 注册精确路径路由
+   */
+  void add(const std::string &method, const std::string &path,
+           Handler handler);
+
+  /**
+   * @brief 注册前缀路由（如"/static/"）
+   */
+  void add_prefix(const std::string &method, const std::string &prefix,
+                  Handler handler);
+
+  /**
+   * @brief 设置未匹配任何路由时的处理函数（默认返回404）
+   */
+  void set_not_found(Handler handler) { not_found_ = std::move(handler); }
+
+  /**
+   * @brief 分发请求
+   */
+  void dispatch(const HttpRequest &req, HttpResponse &resp) const;
+
+private:
+  struct MethodHandler {
+    std::string method;
+    Handler handler;
+  };
+  using HandlerList = std::vector<MethodHandler>;
+
+  struct PrefixRoute {
+    std::string prefix;
+    HandlerList handlers;
+  };
+
+  /**
+   * @brief 在同一路径的处理函数中按方法查找
+   * @return 找到返回处理函数，否则返回nullptr
+   */
+  static const Handler *match_method(const HandlerList &handlers,
+                                     const HttpSlice &method);
+
+private:
+  std::unordered_map<std::string, HandlerList> exact_;
+  std::vector<PrefixRoute> prefixes_; // 按前缀长度降序
+  Handler not_found_;
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_HTTP_ROUTER_H_
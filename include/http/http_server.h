@@ -0,0 +1,119 @@
+#ifndef ZCOROUTINE_HTTP_SERVER_H_
+#define ZCOROUTINE_HTTP_SERVER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "http/http_parser.h"
+#include "http/http_response.h"
+#include "http/http_router.h"
+#include "io/io_scheduler.h"
+#include "net/socket_stream.h"
+#include "net/tcp_acceptor.h"
+#include "util/noncopyable.h"
+
+namespace zcoroutine {
+
+/**
+ * @brief HTTP/1.1 服务器
+ *
+ * 每个连接一个协程：SocketStream读缓冲区 + 增量零拷贝解析器。
+ *  - keep-alive：HTTP/1.1默认保持连接，HTTP/1.0需显式keep-alive；
+ *    空闲超过keepalive_timeout_ms的连接被关闭。
+ *  - 流水线：缓冲区中已到达的请求依次处理，响应按顺序写入写缓冲区，
+ *    读方向即将阻塞时才一次writev发出。
+ *  - 分块响应：见HttpResponse::write_chunk()。
+ *
+ * 处理函数在连接协程中执行，可以调用hook后的阻塞IO。
+ */
+class HttpServer : public std::enable_shared_from_this<HttpServer>,
+                   public NonCopyable {
+public:
+  using ptr = std::shared_ptr<HttpServer>;
+  using Handler = HttpRouter::Handler;
+
+  struct Options {
+    HttpParser::Options parser;
+    SocketStream::Options stream;
+    TcpAcceptor::Options acceptor;
+    uint64_t keepalive_timeout_ms = 60000; // 0表示不限制
+    size_t max_keepalive_requests = 0;     // 单连接最多处理的请求数，0不限
+  };
+
+  /**
+   * @brief 构造函数
+   * @param scheduler IO调度器，需先启动且生命周期长于服务器
+   * @param options 服务器选项
+   */
+  HttpServer(IoScheduler *scheduler, Options options);
+  explicit HttpServer(IoScheduler *scheduler)
+      : HttpServer(scheduler, Options()) {}
+
+  ~HttpServer();
+
+  /**
+   * @brief 注册路由，需在start()之前调用
+   */
+  void route(const std::string &method, const std::string &path,
+             Handler handler) {
+    router_.add(method, path, std::move(handler));
+  }
+  void route_prefix(const std::string &method, const std::string &prefix,
+                    Handler handler) {
+    router_.add_prefix(method, prefix, std::move(handler));
+  }
+  void set_not_found(Handler handler) {
+    router_.set_not_found(std::move(handler));
+  }
+
+  /**
+   * @brief 开始监听
+   * @param port 0表示由内核分配，实际端口见port()
+   * @return 成功返回true
+   */
+  bool start(const std::string &ip, uint16_t port);
+
+  /**
+   * @brief 停止监听；已建立的连接处理完当前请求后关闭
+   */
+  void stop();
+
+  uint16_t port() const { return acceptor_ ? acceptor_->port() : 0; }
+
+  uint64_t request_count() const {
+    return requests_.load(std::memory_order_relaxed);
+  }
+  uint64_t connection_count() const {
+    return connections_.load(std::memory_order_relaxed);
+  }
+  uint64_t parse_error_count() const {
+    return parse_errors_.load(std::memory_order_relaxed);
+  }
+
+private:
+  /**
+   * @brief 连接协程主循环
+   */
+  void handle_connection(int fd);
+
+  /**
+   * @brief 解析失败时写出错误响应
+   */
+  void send_error(SocketStream &stream, int status);
+
+private:
+  IoScheduler *scheduler_;
+  Options options_;
+  HttpRouter router_;
+  TcpAcceptor::ptr acceptor_;
+  std::atomic<bool> running_{false};
+  std::atomic<uint64_t> requests_{0};
+  std::atomic<uint64_t> connections_{0};
+  std::atomic<uint64_t> parse_errors_{0};
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_HTTP_SERVER_H_
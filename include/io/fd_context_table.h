@@ -53,7 +53,8 @@ private:
   FdContext::ptr expand_and_create(int fd);
 
 private:
-  mutable RWMutex mutex_;                // 读写锁
+  // 读写锁
+  mutable RWMutex mutex_{ZCOROUTINE_LOCK_SITE("FdContextTable")};
   std::vector<FdContext::ptr> contexts_; // fd -> FdContext 映射
 };
 
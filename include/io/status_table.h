@@ -17,6 +17,15 @@ public:
   using ptr = std::shared_ptr<SocketStatus>;
 
   explicit SocketStatus(int fd);
+
+  /**
+   * @brief 以已知属性构造socket上下文，不发起任何系统调用
+   * @param fd 文件描述符
+   * @param user_nonblock 用户创建时是否请求了非阻塞（SOCK_NONBLOCK）
+   * @note 调用方需保证fd是以SOCK_NONBLOCK创建的socket，
+   *       由hook的socket/socketpair/accept/accept4在创建时使用
+   */
+  SocketStatus(int fd, bool user_nonblock);
   ~SocketStatus();
 
   bool init();
@@ -66,6 +75,15 @@ public:
    */
   SocketStatus::ptr get(int fd, bool auto_create = false);
 
+  /**
+   * @brief 注册一个新创建的非阻塞socket
+   * 创建者已知fd的全部属性，直接写入上下文，省去fstat和fcntl。
+   * 若该位置残留旧上下文（例如fd绕过hook被关闭后复用），直接覆盖。
+   * @param fd 文件描述符
+   * @param user_nonblock 用户是否请求了非阻塞
+   */
+  SocketStatus::ptr add_socket(int fd, bool user_nonblock);
+
   /**
    * @brief 删除文件描述符上下文
    */
@@ -80,8 +98,13 @@ public:
   ~StatusTable() = default;
 
 private:
+  /**
+   * @brief 保证容量能容纳fd，需持有写锁
+   */
+  void ensure_capacity(int fd);
+
   std::vector<SocketStatus::ptr> fd_datas_;
-  RWMutex mutex_;
+  RWMutex mutex_{ZCOROUTINE_LOCK_SITE("StatusTable")};
 };
 
 } // namespace zcoroutine
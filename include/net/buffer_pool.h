@@ -0,0 +1,48 @@
+#ifndef ZCOROUTINE_BUFFER_POOL_H_
+#define ZCOROUTINE_BUFFER_POOL_H_
+
+#include <cstddef>
+#include <memory>
+
+namespace zcoroutine {
+
+/**
+ * @brief 连接缓冲区内存池
+ *
+ * 按2的幂大小分级缓存空闲缓冲区（4KB ~ 64KB），每个线程一份缓存，
+ * 无锁。空闲连接挂起时把读写缓冲区归还到池中，被唤醒时再取回，
+ * 大量空闲连接只需要少量常驻缓冲区。
+ *
+ * 超出分级范围的缓冲区或线程缓存已满时直接释放。
+ */
+class BufferPool {
+public:
+  // 最小/最大缓存的缓冲区大小
+  static constexpr size_t kMinPooledSize = 4096;
+  static constexpr size_t kMaxPooledSize = 64 * 1024;
+
+  // 每个线程缓存的空闲字节上限
+  static constexpr size_t kMaxCachedBytes = 1 << 20;
+
+  /**
+   * @brief 获取缓冲区
+   * @param capacity 容量（2的幂）
+   */
+  static std::unique_ptr<char[]> acquire(size_t capacity);
+
+  /**
+   * @brief 归还缓冲区
+   * @param buffer 缓冲区
+   * @param capacity acquire时的容量
+   */
+  static void release(std::unique_ptr<char[]> buffer, size_t capacity);
+
+  /**
+   * @brief 当前线程缓存的空闲字节数（用于测试与观测）
+   */
+  static size_t cached_bytes();
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_BUFFER_POOL_H_
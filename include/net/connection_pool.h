@@ -0,0 +1,271 @@
+#ifndef ZCOROUTINE_CONNECTION_POOL_H_
+#define ZCOROUTINE_CONNECTION_POOL_H_
+
+#include <netinet/in.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "io/io_scheduler.h"
+#include "sync/rw_mutex.h"
+#include "sync/spinlock.h"
+#include "sync/wait_queue.h"
+#include "timer/timer.h"
+#include "util/noncopyable.h"
+
+namespace zcoroutine {
+
+/**
+ * @brief 出站TCP连接池
+ *
+ * 按端点（ip:port）缓存已建立的连接，复用连接省去每次调用的
+ * connect_with_timeout（定时器 + add_event + 一次让出）。
+ *
+ * - 空闲连接按工作线程分片缓存，借出/归还优先访问本线程分片，无跨线程竞争；
+ *   本分片为空时再从其他分片窃取。
+ * - 每个端点的连接数（空闲 + 借出 + 正在建立）不超过max_connections，
+ *   达到上限时借出方挂起协程等待归还（不阻塞线程），超时返回失败。
+ *   有协程等待时，归还的连接直接交给队头等待者，避免被新来的借出方插队。
+ * - 借出空闲连接前用 recv(MSG_PEEK|MSG_DONTWAIT) 检查对端是否已关闭。
+ * - 周期定时器清理空闲过久或已失效的连接。
+ *
+ * acquire()需要在启用hook的IoScheduler协程中调用。
+ */
+class ConnectionPool : public std::enable_shared_from_this<ConnectionPool>,
+                       public NonCopyable {
+public:
+  using ptr = std::shared_ptr<ConnectionPool>;
+
+  struct Options {
+    size_t max_connections = 64;      // 每个端点的连接上限
+    size_t max_idle_per_worker = 16;  // 每个分片缓存的空闲连接上限
+    uint64_t connect_timeout_ms = 1000; // 建立连接超时
+    uint64_t acquire_timeout_ms = 1000; // 连接耗尽时的等待超时
+    uint64_t idle_timeout_ms = 30000;   // 空闲连接存活时间
+    uint64_t sweep_interval_ms = 1000;  // 空闲连接扫描周期
+  };
+
+  /**
+   * @brief 统计信息快照
+   */
+  struct Stats {
+    uint64_t hits = 0;             // 复用空闲连接次数
+    uint64_t misses = 0;           // 新建连接次数
+    uint64_t waits = 0;            // 因连接耗尽而等待的次数
+    uint64_t wait_time_us = 0;     // 累计等待时间（微秒）
+    uint64_t wait_timeouts = 0;    // 等待超时次数
+    uint64_t connect_failures = 0; // 建立连接失败次数
+    uint64_t health_failures = 0;  // 健康检查失败关闭的空闲连接数
+    uint64_t evicted = 0;          // 空闲超时清理的连接数
+
+    double hit_rate() const {
+      uint64_t total = hits + misses;
+      return total ? static_cast<double>(hits) / static_cast<double>(total)
+                   : 0.0;
+    }
+    double avg_wait_us() const {
+      return waits ? static_cast<double>(wait_time_us) /
+                         static_cast<double>(waits)
+                   : 0.0;
+    }
+  };
+
+private:
+  struct Endpoint;
+
+public:
+  /**
+   * @brief 借出的连接，析构时归还连接池
+   */
+  class Connection : public NonCopyable {
+  public:
+    Connection() = default;
+    Connection(Connection &&other) noexcept;
+    Connection &operator=(Connection &&other) noexcept;
+    ~Connection() { release(); }
+
+    int fd() const { return fd_; }
+    bool valid() const { return fd_ >= 0; }
+    explicit operator bool() const { return valid(); }
+
+    /**
+     * @brief 是否复用的空闲连接（对端可能恰好在检查后关闭，调用方可据此重试）
+     */
+    bool reused() const { return reused_; }
+
+    /**
+     * @brief 标记连接不可复用（协议出错、读写失败），归还时直接关闭
+     */
+    void mark_broken() { reusable_ = false; }
+
+    /**
+     * @brief 提前归还连接
+     */
+    void release();
+
+  private:
+    friend class ConnectionPool;
+    Connection(ConnectionPool::ptr pool, Endpoint *endpoint, int fd,
+               bool reused)
+        : pool_(std::move(pool)), endpoint_(endpoint), fd_(fd),
+          reused_(reused) {}
+
+    ConnectionPool::ptr pool_;
+    Endpoint *endpoint_ = nullptr;
+    int fd_ = -1;
+    bool reused_ = false;
+    bool reusable_ = true;
+  };
+
+  /**
+   * @brief 构造函数
+   * @param scheduler IO调度器，用于空闲扫描定时器，生命周期需长于连接池
+   * @param options 连接池选项
+   */
+  ConnectionPool(IoScheduler *scheduler, Options options);
+  explicit ConnectionPool(IoScheduler *scheduler)
+      : ConnectionPool(scheduler, Options()) {}
+
+  ~ConnectionPool();
+
+  /**
+   * @brief 启动空闲连接扫描定时器
+   */
+  void start();
+
+  /**
+   * @brief 停止：取消扫描定时器、关闭全部空闲连接、唤醒等待者
+   * 借出中的连接归还时直接关闭。
+   */
+  void stop();
+
+  /**
+   * @brief 借出一个到ip:port的连接
+   * 优先复用空闲连接；未达上限时新建；否则挂起等待归还。
+   * @return 连接；失败时返回无效连接，errno为ETIMEDOUT（等待超时）、
+   *         EINVAL（地址非法）、ESHUTDOWN（已停止）或connect的错误码
+   */
+  Connection acquire(const std::string &ip, uint16_t port);
+
+  /**
+   * @brief 立即执行一次空闲连接扫描
+   * @return 关闭的连接数
+   */
+  size_t sweep();
+
+  /**
+   * @brief 统计快照
+   */
+  Stats stats() const;
+
+  /**
+   * @brief 端点当前的连接数（空闲 + 借出）与空闲连接数
+   */
+  size_t total_count(const std::string &ip, uint16_t port);
+  size_t idle_count(const std::string &ip, uint16_t port);
+
+private:
+  struct IdleConnection {
+    int fd;
+    uint64_t since_ms; // 进入空闲的时间
+  };
+
+  // 按缓存行对齐，避免不同工作线程的分片伪共享
+  struct alignas(64) Shard {
+    Spinlock lock{ZCOROUTINE_LOCK_SITE("ConnectionPool.shard")};
+    std::vector<IdleConnection> idle;
+
+    // C++14的new不保证超过16字节的对齐
+    static void *operator new[](size_t size);
+    static void operator delete[](void *ptr);
+  };
+
+  struct Endpoint {
+    struct sockaddr_in addr;
+    std::atomic<size_t> total{0}; // 空闲 + 借出 + 正在建立
+    std::atomic<size_t> idle{0};  // 空闲连接数
+    std::unique_ptr<Shard[]> shards;
+    // 保护等待条件检查、入队与handoff
+    Spinlock wait_lock{ZCOROUTINE_LOCK_SITE("ConnectionPool.wait")};
+    std::vector<int> handoff; // 归还时直接交给等待者的连接
+    WaitQueue waiters;
+
+    // 含按缓存行对齐的Spinlock，同样需要对齐分配
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr);
+  };
+
+  Endpoint *get_endpoint(const std::string &ip, uint16_t port);
+
+  /**
+   * @brief 当前线程对应的分片下标（非工作线程使用最后一个分片）
+   */
+  size_t shard_index() const;
+
+  /**
+   * @brief 从分片中取出一个健康的空闲连接
+   * @return fd，没有可用连接返回-1
+   */
+  int take_idle(Endpoint *endpoint);
+
+  /**
+   * @brief 新建连接
+   * @return fd，失败返回-1
+   */
+  int connect_endpoint(Endpoint *endpoint);
+
+  /**
+   * @brief 归还连接（由Connection调用）
+   */
+  void release(Endpoint *endpoint, int fd, bool reusable);
+
+  /**
+   * @brief 有等待者时把连接直接交给队头等待者
+   * @return 是否已交出
+   */
+  bool handoff(Endpoint *endpoint, int fd);
+
+  /**
+   * @brief 关闭尚未被等待者取走的handoff连接
+   */
+  void close_handoff(Endpoint *endpoint);
+
+  /**
+   * @brief 关闭连接并释放名额，唤醒一个等待者
+   */
+  void close_connection(Endpoint *endpoint, int fd);
+
+  /**
+   * @brief 名额或空闲连接变化后唤醒一个等待者
+   */
+  void notify_waiter(Endpoint *endpoint);
+
+  static bool is_healthy(int fd);
+
+private:
+  IoScheduler *scheduler_;
+  Options options_;
+  size_t shard_count_;
+  std::atomic<bool> running_{true};
+  Timer::ptr sweep_timer_;
+
+  RWMutex endpoints_mutex_{ZCOROUTINE_LOCK_SITE("ConnectionPool.endpoints")};
+  std::unordered_map<std::string, std::unique_ptr<Endpoint>> endpoints_;
+
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> waits_{0};
+  std::atomic<uint64_t> wait_time_us_{0};
+  std::atomic<uint64_t> wait_timeouts_{0};
+  std::atomic<uint64_t> connect_failures_{0};
+  std::atomic<uint64_t> health_failures_{0};
+  std::atomic<uint64_t> evicted_{0};
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_CONNECTION_POOL_H_
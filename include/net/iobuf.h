@@ -0,0 +1,191 @@
+#ifndef ZCOROUTINE_IOBUF_H_
+#define ZCOROUTINE_IOBUF_H_
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace zcoroutine {
+
+/**
+ * @brief 引用计数的非连续字节链
+ *
+ * 数据保存在引用计数的内存块中，IOBuf只持有 (块, 偏移, 长度) 引用。
+ * 切片、拼接、共享都只增减引用计数而不拷贝数据；
+ * 发送时整条链通过一次writev发出，接收时readv直接读入池化的内存块。
+ *
+ * 块内已写入的数据不可变：只有独占尾块（引用计数为1）时才会原地追加。
+ * 同一个IOBuf对象非线程安全，但不同IOBuf可以在不同线程共享同一块数据。
+ */
+class IOBuf {
+public:
+  // 默认内存块大小，池化复用
+  static constexpr size_t kBlockSize = 8192;
+
+  /**
+   * @brief 引用计数内存块
+   */
+  struct Block {
+    std::atomic<int> ref{1};
+    uint32_t size{0};     // 已写入字节数（之前的数据不可变）
+    uint32_t capacity{0}; // 容量
+    char *data{nullptr};  // 数据地址：内部块指向尾部内联区，外部块指向用户内存
+    void (*deleter)(void *){nullptr}; // 外部块的释放函数
+    void *user{nullptr};               // 传给deleter的参数
+  };
+
+  /**
+   * @brief 对内存块一段数据的引用
+   */
+  struct BlockRef {
+    Block *block;
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  IOBuf() = default;
+  ~IOBuf() { clear(); }
+
+  IOBuf(const IOBuf &other);
+  IOBuf &operator=(const IOBuf &other);
+  IOBuf(IOBuf &&other) noexcept : refs_(std::move(other.refs_)), size_(other.size_) {
+    other.size_ = 0;
+  }
+  IOBuf &operator=(IOBuf &&other) noexcept;
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  size_t block_count() const { return refs_.size(); }
+  const BlockRef &ref_at(size_t i) const { return refs_[i]; }
+
+  // ==================== 追加/前插 ====================
+
+  /**
+   * @brief 拷贝追加数据，优先写入独占的尾块剩余空间
+   */
+  void append(const void *data, size_t len);
+  void append(const std::string &s) { append(s.data(), s.size()); }
+
+  /**
+   * @brief 共享追加另一个链（只增加引用计数）
+   */
+  void append(const IOBuf &other);
+
+  /**
+   * @brief 移动追加另一个链
+   */
+  void append(IOBuf &&other);
+
+  /**
+   * @brief 零拷贝追加用户内存，最后一个引用释放时调用deleter(user)
+   * @param data 数据地址，在deleter调用前必须保持有效且不被修改
+   * @param len 数据长度
+   * @param deleter 释放函数，可为nullptr（静态数据）
+   * @param user 传给deleter的参数
+   */
+  void append_user_data(const void *data, size_t len, void (*deleter)(void *),
+                        void *user);
+
+  /**
+   * @brief 在头部插入数据（如协议头），不移动已有数据
+   */
+  void prepend(const void *data, size_t len);
+
+  // ==================== 切分/裁剪 ====================
+
+  /**
+   * @brief 从头部切下最多n字节追加到out（共享数据）
+   * @return 实际切下的字节数
+   */
+  size_t cutn(IOBuf *out, size_t n);
+
+  /**
+   * @brief 返回[offset, offset+len)的共享切片
+   */
+  IOBuf slice(size_t offset, size_t len) const;
+
+  /**
+   * @brief 丢弃头部/尾部n字节
+   * @return 实际丢弃的字节数
+   */
+  size_t pop_front(size_t n);
+  size_t pop_back(size_t n);
+
+  /**
+   * @brief 释放全部引用
+   */
+  void clear();
+
+  // ==================== 访问 ====================
+
+  /**
+   * @brief 从offset起拷贝最多n字节到buf
+   * @return 实际拷贝字节数
+   */
+  size_t copy_to(void *buf, size_t n, size_t offset = 0) const;
+
+  std::string to_string() const;
+
+  /**
+   * @brief 填充iovec数组
+   * @param iov 输出数组
+   * @param max_iov 数组容量
+   * @return 填充的iovec个数
+   */
+  int fill_iovec(struct iovec *iov, int max_iov) const;
+
+  // ==================== IO ====================
+
+  /**
+   * @brief 一次writev发送链头部（最多IOV_MAX段），并丢弃已写出的字节
+   * 经过hook：hook启用时EAGAIN会挂起当前协程。
+   * @return 写出的字节数，出错返回-1
+   */
+  ssize_t cut_into_fd(int fd);
+
+  /**
+   * @brief 循环writev直到整条链写完，正确处理部分写
+   * @return 成功返回0，出错返回-1（已写出部分已从链中移除）
+   */
+  int write_all(int fd);
+
+  /**
+   * @brief 从fd一次readv读取最多max_count字节，读入池化内存块后追加到尾部
+   * @return 同readv：读取的字节数，0表示EOF，-1表示出错
+   */
+  ssize_t append_from_fd(int fd, size_t max_count = 4 * kBlockSize);
+
+  // ==================== 块池 ====================
+
+  /**
+   * @brief 当前线程块缓存中的空闲块数（用于测试与观测）
+   */
+  static size_t cached_block_count();
+
+  /**
+   * @brief 进程内存活的内部块数量（用于测试与观测）
+   */
+  static size_t live_block_count();
+
+private:
+  static Block *acquire_block();
+  static void ref_block(Block *block) {
+    block->ref.fetch_add(1, std::memory_order_relaxed);
+  }
+  static void unref_block(Block *block);
+
+  void push_back_ref(const BlockRef &ref);
+
+private:
+  std::vector<BlockRef> refs_;
+  size_t size_{0};
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_IOBUF_H_
@@ -0,0 +1,131 @@
+#ifndef ZCOROUTINE_RING_BUFFER_H_
+#define ZCOROUTINE_RING_BUFFER_H_
+
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace zcoroutine {
+
+/**
+ * @brief 可增长的字节环形缓冲区
+ *
+ * 容量始终为2的幂，读写位置单调递增，通过掩码取下标。
+ * 可读/可写区域最多分为两段，可直接作为readv/writev的iovec使用，
+ * 读写都不需要搬移数据；只有解析器需要连续内存且数据跨越环尾时才整理。
+ * 底层内存从BufferPool获取并在释放时归还。
+ */
+class RingBuffer {
+public:
+  /**
+   * @brief 构造函数
+   * @param initial_capacity 初始容量，向上取整为2的幂；0表示延迟分配
+   */
+  explicit RingBuffer(size_t initial_capacity = 0);
+  ~RingBuffer();
+
+  RingBuffer(const RingBuffer &) = delete;
+  RingBuffer &operator=(const RingBuffer &) = delete;
+  RingBuffer(RingBuffer &&other) noexcept;
+  RingBuffer &operator=(RingBuffer &&other) noexcept;
+
+  /**
+   * @brief 可读字节数
+   */
+  size_t size() const { return static_cast<size_t>(write_pos_ - read_pos_); }
+  bool empty() const { return write_pos_ == read_pos_; }
+
+  /**
+   * @brief 当前容量
+   */
+  size_t capacity() const { return capacity_; }
+
+  /**
+   * @brief 剩余可写字节数
+   */
+  size_t writable() const { return capacity_ - size(); }
+
+  /**
+   * @brief 获取可读区域的第一段连续内存
+   * @param[out] len 连续可读字节数
+   * @return 数据起始地址，无数据时返回nullptr
+   */
+  const char *peek(size_t *len) const;
+
+  /**
+   * @brief 获取全部可读区域（最多两段）
+   * @param[out] iov 至少2个元素的iovec数组
+   * @return 段数（0、1或2）
+   */
+  int readable_segments(struct iovec *iov) const;
+
+  /**
+   * @brief 获取全部可写区域（最多两段）
+   * @param[out] iov 至少2个元素的iovec数组
+   * @return 段数（0、1或2）
+   */
+  int writable_segments(struct iovec *iov);
+
+  /**
+   * @brief 返回至少n字节的连续可读内存
+   * 数据跨越环尾时原地旋转整理，之后读位置从0开始。
+   * @return 连续内存起始地址；可读字节不足n时返回nullptr
+   */
+  const char *linearize(size_t n);
+
+  /**
+   * @brief 丢弃前n字节（n不超过size()）
+   */
+  void consume(size_t n);
+
+  /**
+   * @brief 提交通过writable_segments写入的n字节
+   */
+  void commit(size_t n);
+
+  /**
+   * @brief 追加数据，容量不足时自动扩容
+   */
+  void append(const void *data, size_t len);
+
+  /**
+   * @brief 从头部拷贝最多len字节并消费
+   * @return 实际拷贝字节数
+   */
+  size_t read(void *buf, size_t len);
+
+  /**
+   * @brief 保证至少还能写入n字节
+   */
+  void reserve(size_t n);
+
+  /**
+   * @brief 清空数据，保留内存
+   */
+  void clear() { read_pos_ = write_pos_ = 0; }
+
+  /**
+   * @brief 释放内存归还BufferPool（要求缓冲区为空）
+   */
+  void release();
+
+private:
+  /**
+   * @brief 扩容到至少new_capacity（2的幂），数据整理到起始位置
+   */
+  void grow(size_t new_capacity);
+
+  size_t mask(uint64_t pos) const { return static_cast<size_t>(pos) & (capacity_ - 1); }
+
+private:
+  std::unique_ptr<char[]> data_;
+  size_t capacity_{0};
+  uint64_t read_pos_{0};  // 读位置（单调递增）
+  uint64_t write_pos_{0}; // 写位置（单调递增）
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_RING_BUFFER_H_
@@ -0,0 +1,190 @@
+#ifndef ZCOROUTINE_SOCKET_STREAM_H_
+#define ZCOROUTINE_SOCKET_STREAM_H_
+
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "net/ring_buffer.h"
+#include "util/noncopyable.h"
+
+namespace zcoroutine {
+
+/**
+ * @brief 带缓冲的协程socket流
+ *
+ * 读方向：环形读缓冲区，一次readv填充两段可写区域；解析器通过
+ * peek/linearize/consume直接访问缓冲区，无需额外拷贝。
+ *
+ * 写方向：小块写入先聚合到写缓冲区（自动cork），只在以下时机用writev发出：
+ *  - 待发送字节达到阈值；
+ *  - 读方向即将阻塞（协程让出点）——流水线协议在处理完缓冲区内的全部
+ *    请求后才真正发送，一批响应只需一次writev；
+ *  - 显式调用flush()或close()。
+ *
+ * 空闲挂起（idle_park）：读缓冲区为空、即将等待新请求时，把读写缓冲区
+ * 归还BufferPool，共享栈模式下同时收缩协程的栈保存区，再以EPOLLIN挂起；
+ * 被唤醒后从池中重新取缓冲区。适合大量长轮询/websocket空闲连接。
+ *
+ * 阻塞语义依赖hook：fd由hook托管时读写会挂起当前协程而不是线程。
+ * 非线程安全，一个流同一时刻只应被一个协程使用。
+ */
+class SocketStream : public NonCopyable {
+public:
+  using ptr = std::shared_ptr<SocketStream>;
+
+  struct Options {
+    size_t read_buffer_size = 4096;         // 读缓冲区初始容量
+    size_t max_read_buffer_size = 4 << 20;  // 读缓冲区容量上限
+    size_t write_buffer_size = 4096;        // 写缓冲区初始容量
+    size_t cork_threshold = 16 * 1024;      // 写缓冲区累计到该值时立即发送
+    bool idle_park = false;                 // 空闲等待时归还缓冲区
+  };
+
+  /**
+   * @brief 构造函数
+   * @param fd socket文件描述符，所有权交给SocketStream
+   * @param options 缓冲区选项
+   */
+  SocketStream(int fd, Options options);
+  explicit SocketStream(int fd) : SocketStream(fd, Options()) {}
+
+  /**
+   * @brief 析构时flush并关闭fd
+   */
+  ~SocketStream();
+
+  int fd() const { return fd_; }
+  bool is_closed() const { return fd_ < 0; }
+
+  // ==================== 读方向 ====================
+
+  /**
+   * @brief 从socket读取更多数据到读缓冲区
+   * 读缓冲区已满时扩容（不超过上限）。需要阻塞等待前先flush写缓冲区。
+   * @return 读取的字节数；0表示对端关闭；-1表示出错（errno有效），
+   *         缓冲区达到上限时errno为ENOBUFS
+   */
+  ssize_t fill();
+
+  /**
+   * @brief 已缓冲的可读字节数
+   */
+  size_t readable() const { return read_buf_.size(); }
+
+  /**
+   * @brief 获取第一段连续的已缓冲数据（零拷贝）
+   */
+  const char *peek(size_t *len) const { return read_buf_.peek(len); }
+
+  /**
+   * @brief 获取全部已缓冲数据（最多两段，零拷贝）
+   */
+  int peek_segments(struct iovec *iov) const {
+    return read_buf_.readable_segments(iov);
+  }
+
+  /**
+   * @brief 获取至少n字节连续数据，必要时从socket读取
+   * @return 数据地址；连接关闭或出错时返回nullptr
+   */
+  const char *peek_exact(size_t n);
+
+  /**
+   * @brief 消费已缓冲的前n字节
+   */
+  void consume(size_t n) { read_buf_.consume(n); }
+
+  /**
+   * @brief 读取数据：优先返回缓冲区数据，缓冲区为空时读socket
+   * @return 同read(2)
+   */
+  ssize_t read(void *buf, size_t len);
+
+  /**
+   * @brief 读取恰好len字节
+   * @return 成功返回true；对端提前关闭或出错返回false
+   */
+  bool read_exact(void *buf, size_t len);
+
+  // ==================== 写方向 ====================
+
+  /**
+   * @brief 写入数据（可能只进入写缓冲区）
+   * @return 成功返回len，出错返回-1
+   */
+  ssize_t write(const void *buf, size_t len);
+
+  /**
+   * @brief 聚合写入多段数据
+   */
+  ssize_t writev(const struct iovec *iov, int iovcnt);
+
+  /**
+   * @brief 发送写缓冲区中的全部数据
+   * @return 成功返回0，出错返回-1
+   */
+  int flush();
+
+  /**
+   * @brief 写缓冲区中待发送字节数
+   */
+  size_t pending_write() const { return write_buf_.size(); }
+
+  /**
+   * @brief flush后关闭fd
+   */
+  int close();
+
+  // ==================== 统计 ====================
+
+  uint64_t read_syscalls() const { return read_syscalls_; }
+  uint64_t write_syscalls() const { return write_syscalls_; }
+  uint64_t idle_parks() const { return idle_parks_; }
+
+  /**
+   * @brief 当前读写缓冲区占用的内存字节数
+   */
+  size_t buffer_bytes() const {
+    return read_buf_.capacity() + write_buf_.capacity();
+  }
+
+private:
+  /**
+   * @brief 写缓冲区与额外数据一起writev，直到全部写出
+   */
+  int write_all(const struct iovec *extra, int extra_cnt);
+
+  /**
+   * @brief 对读缓冲区的可写区域执行一次readv
+   * @param nonblock true时直接调用原始readv试读，EAGAIN不会挂起协程
+   */
+  ssize_t read_into_buffer(bool nonblock);
+
+  /**
+   * @brief 是否可以空闲挂起：hook托管、无读超时、运行在IoScheduler协程中
+   */
+  bool can_idle_park() const;
+
+  /**
+   * @brief 归还缓冲区并挂起等待可读，唤醒后重新获取读缓冲区
+   * @return 成功返回0，注册事件失败返回-1
+   */
+  int park_idle();
+
+private:
+  int fd_;
+  Options options_;
+  bool sys_nonblock_{false}; // fd在内核层面是否非阻塞（可做无挂起的试读）
+  RingBuffer read_buf_;
+  RingBuffer write_buf_;
+  uint64_t read_syscalls_{0};
+  uint64_t write_syscalls_{0};
+  uint64_t idle_parks_{0};
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_SOCKET_STREAM_H_
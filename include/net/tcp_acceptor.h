@@ -0,0 +1,137 @@
+#ifndef ZCOROUTINE_TCP_ACCEPTOR_H_
+#define ZCOROUTINE_TCP_ACCEPTOR_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "io/io_scheduler.h"
+#include "util/noncopyable.h"
+
+namespace zcoroutine {
+
+/**
+ * @brief TCP 监听器
+ *
+ * 为每个工作线程打开一个 SO_REUSEPORT 监听socket，由内核在监听socket
+ * 之间分摊新连接。每个监听socket由一个常驻的accept协程负责：
+ * 一次可读事件到来后循环 accept4 直到 EAGAIN，一批连接只需重新注册
+ * 一次epoll事件，而不是每个连接一次。
+ *
+ * 新连接默认直接在accept协程所在的线程上运行（嵌套resume），
+ * 连接协程第一次阻塞时才让出，省去一次任务队列往返。
+ */
+class TcpAcceptor : public std::enable_shared_from_this<TcpAcceptor>,
+                    public NonCopyable {
+public:
+  using ptr = std::shared_ptr<TcpAcceptor>;
+
+  /**
+   * @brief 连接处理函数，在协程中执行
+   * @param fd 已注册到StatusTable的连接fd，用户视角为阻塞模式
+   */
+  using ConnectionHandler = std::function<void(int fd)>;
+
+  struct Options {
+    int listener_count = 0;     // 监听socket数量，0表示与工作线程数相同
+    int backlog = 4096;         // listen backlog
+    bool reuse_port = true;     // 是否使用SO_REUSEPORT分片监听
+    bool inline_dispatch = true; // 新连接是否直接在accept线程上运行
+    size_t stack_size = StackAllocator::kDefaultStackSize; // 连接协程栈大小
+  };
+
+  /**
+   * @brief 构造函数
+   * @param scheduler IO调度器，需在TcpAcceptor之前启动且生命周期更长
+   * @param ip 监听地址（点分十进制IPv4）
+   * @param port 监听端口，0表示由内核分配
+   * @param handler 连接处理函数
+   * @param options 监听选项
+   */
+  TcpAcceptor(IoScheduler *scheduler, std::string ip, uint16_t port,
+              ConnectionHandler handler, Options options);
+
+  TcpAcceptor(IoScheduler *scheduler, std::string ip, uint16_t port,
+              ConnectionHandler handler)
+      : TcpAcceptor(scheduler, std::move(ip), port, std::move(handler),
+                    Options()) {}
+
+  ~TcpAcceptor();
+
+  /**
+   * @brief 绑定监听socket并启动accept协程
+   * @return 成功返回true，失败返回false
+   */
+  bool start();
+
+  /**
+   * @brief 停止监听
+   * 关闭读端唤醒所有accept协程，协程退出时关闭监听fd。
+   */
+  void stop();
+
+  /**
+   * @brief 获取实际监听的端口
+   */
+  uint16_t port() const { return port_; }
+
+  /**
+   * @brief 获取监听socket数量
+   */
+  size_t listener_count() const { return listen_fds_.size(); }
+
+  /**
+   * @brief 获取累计接受的连接数
+   */
+  uint64_t accepted_count() const {
+    return accepted_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 获取累计的可读等待次数（每次等待对应一次epoll事件注册）
+   */
+  uint64_t wait_count() const {
+    return waits_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 是否正在运行
+   */
+  bool is_running() const { return running_.load(std::memory_order_acquire); }
+
+private:
+  /**
+   * @brief 创建并绑定一个监听socket
+   * @return 成功返回fd，失败返回-1
+   */
+  int create_listener();
+
+  /**
+   * @brief accept协程主循环
+   */
+  void accept_loop(int listen_fd);
+
+  /**
+   * @brief 把新连接交给处理协程
+   */
+  void dispatch(int fd);
+
+private:
+  IoScheduler *scheduler_;
+  std::string ip_;
+  uint16_t port_;
+  ConnectionHandler handler_;
+  Options options_;
+
+  std::vector<int> listen_fds_;
+  std::atomic<bool> running_{false};
+  std::atomic<uint64_t> accepted_{0};
+  std::atomic<uint64_t> waits_{0};
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_TCP_ACCEPTOR_H_
@@ -0,0 +1,136 @@
+#ifndef ZCOROUTINE_RPC_CHANNEL_H_
+#define ZCOROUTINE_RPC_CHANNEL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "io/io_scheduler.h"
+#include "rpc/rpc_frame.h"
+#include "sync/spinlock.h"
+#include "sync/wait_queue.h"
+#include "util/noncopyable.h"
+
+namespace zcoroutine {
+
+/**
+ * @brief 多路复用RPC客户端连接
+ *
+ * 同一连接上可以有任意多个并发调用：每个调用分配request_id后把请求帧交给
+ * 发送协程（批量writev），然后挂起等待；读协程收到响应后按request_id
+ * 找到等待的调用并唤醒它。
+ *
+ * 每个调用有独立的截止时间，超时后调用方立即返回，迟到的响应被丢弃。
+ * 连接断开时所有未完成的调用以ECONNRESET失败。
+ *
+ * connect()与call()需要在启用hook的IoScheduler协程中调用。
+ * 读协程只持有RpcChannel的弱引用，释放最后一个ptr时析构函数会关闭连接。
+ */
+class RpcChannel : public std::enable_shared_from_this<RpcChannel>,
+                   public NonCopyable {
+public:
+  using ptr = std::shared_ptr<RpcChannel>;
+
+  struct Options {
+    uint64_t connect_timeout_ms = 1000;
+    uint64_t default_timeout_ms = 1000; // call()未指定超时时使用
+    size_t max_body_size = 16 << 20;
+  };
+
+  static constexpr uint64_t kDefaultTimeout = static_cast<uint64_t>(-1);
+
+  RpcChannel(IoScheduler *scheduler, Options options);
+  explicit RpcChannel(IoScheduler *scheduler)
+      : RpcChannel(scheduler, Options()) {}
+
+  ~RpcChannel();
+
+  /**
+   * @brief 建立连接并启动读、发送协程
+   * @return 成功返回0，失败返回-1并设置errno
+   */
+  int connect(const std::string &ip, uint16_t port);
+
+  /**
+   * @brief 同步调用：挂起当前协程直到响应到达或超时
+   * @param timeout_ms 截止时间（毫秒），同时作为时间预算传给服务端
+   * @return 成功返回0；失败返回-1，errno为：
+   *         ETIMEDOUT（超时）、ECONNRESET（连接断开）、ENOSYS（方法不存在）、
+   *         EREMOTEIO（处理函数失败）、EMSGSIZE（请求过大）
+   */
+  int call(const std::string &method, const std::string &request,
+           std::string *response, uint64_t timeout_ms = kDefaultTimeout);
+
+  /**
+   * @brief 关闭连接，未完成的调用以ECONNRESET失败
+   */
+  void close();
+
+  bool is_connected() const {
+    return connected_.load(std::memory_order_acquire);
+  }
+
+  size_t pending_count() const;
+
+  uint64_t call_count() const { return calls_.load(std::memory_order_relaxed); }
+  uint64_t timeout_count() const {
+    return timeouts_.load(std::memory_order_relaxed);
+  }
+  uint64_t frames_sent() const { return writer_ ? writer_->frames_sent() : 0; }
+  uint64_t write_batches() const {
+    return writer_ ? writer_->write_batches() : 0;
+  }
+
+private:
+  struct PendingCall {
+    Spinlock lock{ZCOROUTINE_LOCK_SITE("RpcChannel.call")};
+    WaitQueue waiter;
+    bool done = false; // 受lock保护
+    int error = 0;     // 完成时的errno，0表示成功
+    std::string response;
+  };
+
+  /**
+   * @brief 读协程入口：阻塞读时不持有通道，只在处理响应时临时提升弱引用
+   */
+  static void read_loop(const std::weak_ptr<RpcChannel> &weak_self, int fd,
+                        size_t max_body_size, RpcFrameWriter::ptr writer);
+
+  /**
+   * @brief 把响应交给等待的调用
+   * @return 帧类型非法时返回false
+   */
+  bool dispatch(RpcFrame *frame);
+
+  /**
+   * @brief 完成一个调用并唤醒调用方
+   */
+  static void complete(const std::shared_ptr<PendingCall> &call, int error,
+                       std::string *response);
+
+  /**
+   * @brief 连接断开：让所有未完成的调用失败
+   */
+  void fail_all();
+
+private:
+  IoScheduler *scheduler_;
+  Options options_;
+  int fd_ = -1;
+  RpcFrameWriter::ptr writer_;
+  std::atomic<bool> connected_{false};
+  std::atomic<uint64_t> next_id_{1};
+
+  mutable Spinlock pending_lock_{ZCOROUTINE_LOCK_SITE("RpcChannel.pending")};
+  std::unordered_map<uint64_t, std::shared_ptr<PendingCall>> pending_;
+  bool closed_ = false; // 受pending_lock_保护，连接断开后不再登记新调用
+
+  std::atomic<uint64_t> calls_{0};
+  std::atomic<uint64_t> timeouts_{0};
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_RPC_CHANNEL_H_
@@ -0,0 +1,164 @@
+#ifndef ZCOROUTINE_RPC_FRAME_H_
+#define ZCOROUTINE_RPC_FRAME_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "io/io_scheduler.h"
+#include "net/iobuf.h"
+#include "sync/spinlock.h"
+#include "sync/wait_queue.h"
+#include "util/noncopyable.h"
+
+namespace zcoroutine {
+
+/**
+ * @brief RPC帧格式（所有整数为网络字节序）
+ *
+ *   0        4        6     7       8                16        20       22    24
+ *   +--------+--------+-----+-------+----------------+---------+--------+-----+
+ *   |body_len| magic  |type |status |   request_id   |timeout  |method  |rsvd |
+ *   |  u32   |  u16   | u8  |  u8   |      u64       |_ms u32  |_len u16| u16 |
+ *   +--------+--------+-----+-------+----------------+---------+--------+-----+
+ *   | method (method_len字节) | payload (body_len - method_len字节)            |
+ *
+ * request_id由客户端分配，响应原样带回，同一连接上的多个调用据此多路复用。
+ * timeout_ms为请求的剩余时间预算，服务端排队超过预算的请求不再执行。
+ */
+struct RpcFrameHeader {
+  static constexpr size_t kSize = 24;
+  static constexpr uint16_t kMagic = 0x5a52; // "ZR"
+
+  enum Type : uint8_t { kRequest = 0, kResponse = 1 };
+
+  uint32_t body_len = 0;
+  uint8_t type = kRequest;
+  uint8_t status = 0;
+  uint64_t request_id = 0;
+  uint32_t timeout_ms = 0;
+  uint16_t method_len = 0;
+
+  void encode(char *out) const;
+
+  /**
+   * @brief 解码帧头
+   * @return 魔数不符返回false
+   */
+  bool decode(const char *in);
+};
+
+/**
+ * @brief 响应状态码
+ */
+enum RpcStatus : uint8_t {
+  kRpcOk = 0,
+  kRpcNoMethod = 1,         // 方法未注册
+  kRpcHandlerError = 2,     // 处理函数返回失败
+  kRpcDeadlineExceeded = 3, // 服务端排队超过调用方的时间预算
+};
+
+/**
+ * @brief 解码后的完整帧
+ */
+struct RpcFrame {
+  RpcFrameHeader header;
+  std::string method;
+  std::string payload;
+};
+
+/**
+ * @brief 从fd读取帧
+ * 读入IOBuf的池化块，一次readv可能带回多个帧，后续帧直接从缓冲区解析。
+ */
+class RpcFrameReader : public NonCopyable {
+public:
+  RpcFrameReader(int fd, size_t max_body_size)
+      : fd_(fd), max_body_size_(max_body_size) {}
+
+  /**
+   * @brief 读取下一帧（缓冲区不足时挂起协程等待数据）
+   * @return 成功返回1；对端关闭返回0；出错返回-1（帧非法时errno为EPROTO，
+   *         超过大小上限为EMSGSIZE）
+   */
+  int read(RpcFrame *frame);
+
+private:
+  int fill();
+
+private:
+  int fd_;
+  size_t max_body_size_;
+  IOBuf buf_;
+};
+
+/**
+ * @brief 每连接一个的发送协程
+ *
+ * 任意协程调用send()把帧追加到发送队列；发送协程每次取走整个队列，
+ * 用一次（或几次，受IOV_MAX限制）writev写出，等待期间到达的帧自然合并。
+ *
+ * FrameWriter拥有fd：close()后发送协程写完队列中剩余的帧再关闭fd。
+ * 写出错时shutdown连接，使读方向也能立即感知。
+ */
+class RpcFrameWriter : public std::enable_shared_from_this<RpcFrameWriter>,
+                       public NonCopyable {
+public:
+  using ptr = std::shared_ptr<RpcFrameWriter>;
+
+  explicit RpcFrameWriter(int fd) : fd_(fd) {}
+  ~RpcFrameWriter();
+
+  /**
+   * @brief 在scheduler上启动发送协程
+   */
+  void start(IoScheduler *scheduler);
+
+  /**
+   * @brief 追加一帧到发送队列
+   * @return 成功返回true；连接已关闭或出错返回false
+   */
+  bool send(const RpcFrameHeader &header, const std::string &method,
+            const std::string &payload);
+
+  /**
+   * @brief 停止接收新帧，发送完剩余数据后关闭fd
+   */
+  void close();
+
+  /**
+   * @brief 关闭连接的读写方向，唤醒阻塞在该fd上的协程
+   * 与发送协程关闭fd互斥，fd关闭后不再操作，不会误伤被复用的fd
+   */
+  void shutdown();
+
+  bool is_broken() const { return broken_.load(std::memory_order_acquire); }
+
+  uint64_t frames_sent() const {
+    return frames_.load(std::memory_order_relaxed);
+  }
+  uint64_t write_batches() const {
+    return batches_.load(std::memory_order_relaxed);
+  }
+
+private:
+  void write_loop();
+
+private:
+  int fd_;                   // 由发送协程在lock_下置为-1
+  Spinlock lock_{ZCOROUTINE_LOCK_SITE("RpcFrameWriter")};
+  IOBuf queue_;              // 受lock_保护
+  bool closed_ = false;      // 受lock_保护
+  bool writer_waiting_ = false; // 受lock_保护
+  WaitQueue wakeup_;
+  std::atomic<bool> broken_{false};
+  std::atomic<bool> started_{false};
+  std::atomic<uint64_t> frames_{0};
+  std::atomic<uint64_t> batches_{0};
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_RPC_FRAME_H_
@@ -0,0 +1,90 @@
+#ifndef ZCOROUTINE_RPC_SERVER_H_
+#define ZCOROUTINE_RPC_SERVER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "io/io_scheduler.h"
+#include "net/tcp_acceptor.h"
+#include "rpc/rpc_frame.h"
+#include "util/noncopyable.h"
+
+namespace zcoroutine {
+
+/**
+ * @brief 多路复用RPC服务端
+ *
+ * 每个连接一个读协程与一个发送协程：读协程解析请求帧，
+ * 每个请求在独立协程中执行（慢调用不阻塞同一连接上的其他调用），
+ * 响应交给发送协程批量writev。响应顺序与请求顺序无关，客户端按request_id匹配。
+ */
+class RpcServer : public std::enable_shared_from_this<RpcServer>,
+                  public NonCopyable {
+public:
+  using ptr = std::shared_ptr<RpcServer>;
+
+  /**
+   * @brief 方法处理函数，在协程中执行，可以调用hook后的阻塞IO
+   * @return 成功返回0；非0时客户端收到kRpcHandlerError
+   */
+  using Handler =
+      std::function<int(const std::string &request, std::string *response)>;
+
+  struct Options {
+    size_t max_body_size = 16 << 20; // 单帧上限
+    bool inline_handlers = false; // 在读协程中直接执行（处理函数不阻塞时更快）
+    TcpAcceptor::Options acceptor;
+  };
+
+  RpcServer(IoScheduler *scheduler, Options options);
+  explicit RpcServer(IoScheduler *scheduler)
+      : RpcServer(scheduler, Options()) {}
+
+  ~RpcServer();
+
+  /**
+   * @brief 注册方法，需在start()之前调用
+   */
+  void register_method(const std::string &name, Handler handler) {
+    methods_[name] = std::move(handler);
+  }
+
+  bool start(const std::string &ip, uint16_t port);
+  void stop();
+
+  uint16_t port() const { return acceptor_ ? acceptor_->port() : 0; }
+
+  uint64_t request_count() const {
+    return requests_.load(std::memory_order_relaxed);
+  }
+  uint64_t deadline_dropped_count() const {
+    return deadline_dropped_.load(std::memory_order_relaxed);
+  }
+
+private:
+  void handle_connection(int fd);
+
+  /**
+   * @brief 执行一个请求并发送响应
+   * @param received_us 请求帧到达的时间，用于检查时间预算
+   */
+  void process(const RpcFrameWriter::ptr &writer,
+               const std::shared_ptr<RpcFrame> &frame, uint64_t received_us);
+
+private:
+  IoScheduler *scheduler_;
+  Options options_;
+  std::unordered_map<std::string, Handler> methods_;
+  TcpAcceptor::ptr acceptor_;
+  std::atomic<bool> running_{false};
+  std::atomic<uint64_t> requests_{0};
+  std::atomic<uint64_t> deadline_dropped_{0};
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_RPC_SERVER_H_
@@ -114,7 +114,7 @@ public:
    * @brief 获取协程名称
    * @return 协程名称（格式：name_id或fiber_id）
    */
-  std::string name() const { return name_; }
+  const std::string &name() const { return name_; }
 
   /**
    * @brief 获取协程ID
@@ -122,6 +122,33 @@ public:
    */
   uint64_t id() const { return id_; }
 
+  /**
+   * @brief 重新设置协程名称（开启统计时协程池复用时按新用途命名）
+   * @param name 名称前缀，为空时使用fiber
+   */
+  void set_name(const std::string &name) {
+    name_ = (name.empty() ? std::string("fiber") : name) + "_" +
+            std::to_string(id_);
+  }
+
+  /**
+   * @brief 尚未汇总到FiberProfiler的统计（仅在开启统计时累加）
+   */
+  uint64_t cpu_ticks() const { return cpu_ticks_; }
+  uint64_t run_count() const { return run_count_; }
+  uint64_t queue_wait_ns() const { return wait_ns_; }
+
+  /**
+   * @brief 记录一次在任务队列中的等待时间
+   */
+  void add_queue_wait(uint64_t ns) { wait_ns_ += ns; }
+
+  /**
+   * @brief 获取栈大小
+   * @return 栈大小（字节）
+   */
+  size_t stack_size() const { return stack_size_; }
+
   /**
    * @brief 获取协程状态
    * @return 当前状态
@@ -182,6 +209,8 @@ public:
 private:
   // Scheduler需要访问私有构造函数创建main_fiber
   friend class Scheduler;
+  friend class FiberProfiler;
+  friend class SamplingProfiler;
 
   /**
    * @brief 主协程构造函数（私有）
@@ -204,6 +233,9 @@ private:
 
   // 缓存优化：将热数据（频繁访问）放在前面
   State state_ = State::kReady; // 协程状态 - 最常访问
+  // 是否有线程正在运行该协程或尚未完成切出
+  // 由resume()置位，resume()返回（协程已完全切出）时清除
+  std::atomic<bool> on_cpu_{false};
   uint64_t id_ = 0;             // 协程唯一ID - 常访问
   void *stack_ptr_ = nullptr;   // 栈指针 - 常访问
   size_t stack_size_ = 0;       // 栈大小
@@ -217,6 +249,14 @@ private:
   // 共享栈上下文（封装所有共享栈相关成员）
   std::unique_ptr<SharedContext> shared_ctx_ = nullptr;
 
+  // FiberProfiler统计：自身CPU计数、切入次数、队列等待时间
+  uint64_t cpu_ticks_ = 0;
+  uint64_t run_count_ = 0;
+  uint64_t wait_ns_ = 0;
+
+  // 独立栈已按StackUsage填充图案，结束时扫描高水位
+  bool stack_painted_ = false;
+
   // 全局协程计数器（线程安全）
   static std::atomic<uint64_t> s_fiber_count_;
 };
@@ -32,6 +32,9 @@ public:
    * @param name 协程名称前缀，默认为空
    * @param use_shared_stack 是否使用共享栈，默认false
    * @return 协程智能指针
+   *
+   * @note 开启自适应栈大小后，使用默认栈大小且带名称的请求会改用
+   *       StackUsage按该名称给出的建议值；复用时只选栈不小于所需大小的协程
    */
   Fiber::ptr get_fiber(std::function<void()> func,
                        size_t stack_size = StackAllocator::kDefaultStackSize,
@@ -60,6 +63,18 @@ public:
    */
   size_t get_max_capacity() const;
 
+  /**
+   * @brief 开启或关闭自适应栈大小（开启时同时开启StackUsage栈高水位统计）
+   */
+  void set_adaptive_stack(bool enabled);
+
+  /**
+   * @brief 是否开启自适应栈大小
+   */
+  bool adaptive_stack() const {
+    return adaptive_stack_.load(std::memory_order_relaxed);
+  }
+
   /**
    * @brief 获取当前池中可用协程数量
    * @return 可用协程数量
@@ -106,6 +121,9 @@ private:
   // 最大容量，0表示不限制
   size_t max_capacity_;
 
+  // 是否按StackUsage的建议值选择栈大小
+  std::atomic<bool> adaptive_stack_{false};
+
   // 统计信息
   std::atomic<uint64_t> total_created_; // 累计创建的协程总数
   std::atomic<uint64_t> total_reused_;  // 累计复用的协程次数
@@ -267,6 +267,17 @@ public:
    */
   void *saved_stack_sp() const { return saved_stack_sp_; }
 
+  /**
+   * @brief 获取保存缓冲区容量
+   */
+  size_t save_buffer_capacity() const { return save_buffer_capacity_; }
+
+  /**
+   * @brief 请求在下一次保存栈时收缩保存缓冲区
+   * 协程进入长时间空闲前调用：曾经的深调用留下的大缓冲区按实际栈大小重新分配
+   */
+  void request_compact() { compact_requested_ = true; }
+
 private:
   // 缓存优化：热数据（频繁访问）放在一起，对齐到缓存行
   // 第一缓存行：高频访问的状态和指针
@@ -276,6 +287,7 @@ private:
   size_t save_buffer_capacity_ = 0;                  // 缓冲区容量
   SharedStackBuffer *shared_stack_buffer_ = nullptr; // 共享栈缓冲区
   bool is_shared_stack_ = false;                     // 是否使用共享栈
+  bool compact_requested_ = false; // 下一次保存时按实际大小重新分配
 };
 
 } // namespace zcoroutine
@@ -0,0 +1,116 @@
+#ifndef ZCOROUTINE_STACK_USAGE_H_
+#define ZCOROUTINE_STACK_USAGE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "util/metrics.h"
+#include "util/noncopyable.h"
+
+namespace zcoroutine {
+
+/**
+ * @brief 按名称前缀汇总的协程栈使用量
+ */
+struct StackUsageStat {
+  std::string name;        // 协程名称前缀
+  uint64_t fibers = 0;     // 采样的协程次数（每次结束计一次）
+  size_t stack_size = 0;   // 最近一次采样时的栈大小
+  size_t max_used = 0;     // 观测到的最大使用量
+  size_t p50_used = 0;     // 使用量中位数（按桶上界）
+  size_t p99_used = 0;     // 使用量p99（按桶上界）
+  size_t suggested = 0;    // 建议栈大小，样本不足时为0
+};
+
+/**
+ * @brief 协程栈高水位统计
+ *
+ * 开启后，新分配的独立栈先整体填充固定图案；协程结束时从栈底（低地址）
+ * 向上扫描第一个被改写的字，得到本次运行的最大栈深度，按名称前缀汇总，
+ * 并只重新填充被用过的部分，供协程池复用时继续测量。
+ *
+ * 填充会触碰整个栈的物理页，因此默认关闭；FiberPool开启自适应栈大小时
+ * 会自动开启。共享栈协程不参与统计。
+ */
+class StackUsage : public NonCopyable {
+public:
+  static constexpr uint64_t kPaintPattern = 0xfdfdfdfdfdfdfdfdULL;
+  // 自适应栈的下限和额外余量
+  static constexpr size_t kMinStackSize = 16 * 1024;
+  static constexpr size_t kSafetyMargin = 16 * 1024;
+  // 同名协程累计到该样本数后才给出建议值
+  static constexpr uint64_t kMinSamples = 32;
+
+  static StackUsage &instance();
+
+  static bool enabled() { return s_enabled_.load(std::memory_order_relaxed); }
+  static void set_enabled(bool enabled) {
+    s_enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 用图案填充栈内存
+   */
+  static void paint(void *stack, size_t size);
+
+  /**
+   * @brief 扫描已填充的栈，返回从栈顶起被使用过的字节数
+   * @note 返回size表示图案已被全部改写，栈可能已经溢出
+   */
+  static size_t high_water_mark(const void *stack, size_t size);
+
+  /**
+   * @brief 记录一次栈使用量
+   * @param name 协程名称前缀
+   */
+  void record(const std::string &name, size_t used, size_t stack_size);
+
+  /**
+   * @brief 按名称返回建议的栈大小
+   * @return 建议值；样本不足时返回fallback，结果不超过fallback
+   *
+   * 建议值为 max(p99 * 1.5, 最大观测值) + kSafetyMargin，按页对齐，
+   * 且不小于kMinStackSize。
+   */
+  size_t suggest_stack_size(const std::string &name, size_t fallback);
+
+  /**
+   * @brief 按最大使用量降序返回全部统计
+   */
+  std::vector<StackUsageStat> stats();
+
+  /**
+   * @brief 格式化的栈使用报告
+   */
+  std::string report();
+
+  /**
+   * @brief 清空已汇总的数据
+   */
+  void reset();
+
+private:
+  StackUsage() = default;
+
+  struct Entry {
+    HistogramSnapshot used;
+    size_t stack_size = 0;
+    size_t suggested = 0;
+  };
+
+  static size_t compute_suggestion(const HistogramSnapshot &used);
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+
+  static std::atomic<bool> s_enabled_;
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_STACK_USAGE_H_
@@ -24,6 +24,12 @@ class Scheduler {
 public:
   using ptr = std::shared_ptr<Scheduler>;
 
+  /**
+   * @brief 工作线程启动回调，参数为工作线程编号
+   * 在线程进入调度循环前执行，可用于绑定CPU、设置线程名等
+   */
+  using ThreadInitCallback = std::function<void(int worker_id)>;
+
   /**
    * @brief 构造函数
    * @param thread_count 线程数量
@@ -43,6 +49,18 @@ public:
    */
   const std::string &name() const { return name_; }
 
+  /**
+   * @brief 获取工作线程数量
+   */
+  int thread_count() const { return thread_count_; }
+
+  /**
+   * @brief 设置工作线程启动回调，需在start()之前调用
+   */
+  void set_thread_init_callback(ThreadInitCallback cb) {
+    thread_init_cb_ = std::move(cb);
+  }
+
   /**
    * @brief 启动调度器
    */
@@ -104,6 +122,13 @@ public:
    */
   static void set_this(Scheduler *scheduler);
 
+  /**
+   * @brief 获取当前工作线程编号（线程本地）
+   * @return [0, thread_count)，非工作线程返回-1
+   * 可用于按工作线程分片的数据结构
+   */
+  static int get_worker_id();
+
   /**
    * @brief 检查是否使用共享栈模式
    * @return true表示使用共享栈，false表示使用独立栈
@@ -137,6 +162,7 @@ protected:
   std::atomic<bool> stopping_;           // 停止标志
   std::atomic<int> active_thread_count_; // 活跃线程数
   std::atomic<int> idle_thread_count_;   // 空闲线程数
+  ThreadInitCallback thread_init_cb_;    // 工作线程启动回调
 
   // 共享栈相关
   bool use_shared_stack_ = false;           // 是否使用共享栈模式
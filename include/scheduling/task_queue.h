@@ -19,6 +19,7 @@ namespace zcoroutine {
 struct Task {
   Fiber::ptr fiber;               // 任务协程
   std::function<void()> callback; // 任务回调函数
+  uint64_t enqueue_ns = 0;        // 入队时间，用于统计调度延迟
 
   Task() = default;
 
@@ -28,13 +29,15 @@ struct Task {
 
   // 移动构造函数
   Task(Task &&other) noexcept
-      : fiber(std::move(other.fiber)), callback(std::move(other.callback)) {}
+      : fiber(std::move(other.fiber)), callback(std::move(other.callback)),
+        enqueue_ns(other.enqueue_ns) {}
 
   // 移动赋值运算符
   Task &operator=(Task &&other) noexcept {
     if (this != &other) {
       fiber = std::move(other.fiber);
       callback = std::move(other.callback);
+      enqueue_ns = other.enqueue_ns;
     }
     return *this;
   }
@@ -48,6 +51,7 @@ struct Task {
   void reset() {
     fiber = nullptr;
     callback = nullptr;
+    enqueue_ns = 0;
   }
 
   /**
@@ -116,8 +120,8 @@ public:
   void stop();
 
 private:
-  // 缓存行对齐，避免false sharing
-  alignas(64) mutable Spinlock spinlock_; // 自旋锁保护队列
+  // 缓存行对齐，避免false sharing；自旋锁保护队列
+  alignas(64) mutable Spinlock spinlock_{ZCOROUTINE_LOCK_SITE("TaskQueue")};
   std::condition_variable_any cv_;        // 条件变量
   std::queue<Task> tasks_;                // 任务队列
 
@@ -0,0 +1,139 @@
+#ifndef ZCOROUTINE_LOCK_PROFILER_H_
+#define ZCOROUTINE_LOCK_PROFILER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "util/noncopyable.h"
+
+namespace zcoroutine {
+
+/**
+ * @brief 一类锁的竞争统计
+ */
+struct LockStat {
+  std::string name;          // 锁名称（同名实例合并统计）
+  uint64_t acquisitions = 0; // 获取次数
+  uint64_t contended = 0;    // 首次尝试失败、进入等待的次数
+  uint64_t spins = 0;        // 自旋锁在等待中的自旋次数
+  uint64_t wait_ns = 0;      // 累计等待时间
+  uint64_t max_wait_ns = 0;  // 单次最长等待时间
+};
+
+/**
+ * @brief 按名称聚合的锁统计点
+ *
+ * 由LockProfiler分配且永不释放，锁对象只持有指针。
+ * 计数均为relaxed原子操作；等待时间以CycleClock计数累加，输出时换算。
+ */
+class LockSite : public NonCopyable {
+public:
+  explicit LockSite(std::string name) : name_(std::move(name)) {}
+
+  const std::string &name() const { return name_; }
+
+  void record_acquire() {
+    acquisitions_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void record_contended(uint64_t spins, uint64_t wait_ticks) {
+    acquisitions_.fetch_add(1, std::memory_order_relaxed);
+    contended_.fetch_add(1, std::memory_order_relaxed);
+    spins_.fetch_add(spins, std::memory_order_relaxed);
+    wait_ticks_.fetch_add(wait_ticks, std::memory_order_relaxed);
+    uint64_t max = max_wait_ticks_.load(std::memory_order_relaxed);
+    while (wait_ticks > max &&
+           !max_wait_ticks_.compare_exchange_weak(max, wait_ticks,
+                                                  std::memory_order_relaxed)) {
+    }
+  }
+
+private:
+  friend class LockProfiler;
+
+  std::string name_;
+  std::atomic<uint64_t> acquisitions_{0};
+  std::atomic<uint64_t> contended_{0};
+  std::atomic<uint64_t> spins_{0};
+  std::atomic<uint64_t> wait_ticks_{0};
+  std::atomic<uint64_t> max_wait_ticks_{0};
+};
+
+/**
+ * @brief 锁竞争分析器
+ *
+ * Spinlock、RWMutex和Mutex在构造时按名称取得LockSite，
+ * 每次获取锁时记录是否发生竞争、自旋次数和等待时间。
+ * 埋点只在定义ZCOROUTINE_ENABLE_LOCK_PROFILE（CMake选项
+ * ENABLE_LOCK_PROFILE）时编译进锁的实现，关闭时锁的大小和代码都不变，
+ * 报告为空。
+ */
+class LockProfiler : public NonCopyable {
+public:
+  static LockProfiler &instance();
+
+  /**
+   * @brief 埋点是否编译进来
+   */
+  static constexpr bool compiled_in() {
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * @brief 按名称取得（必要时创建）统计点
+   */
+  LockSite *site(const char *name);
+
+  /**
+   * @brief 按累计等待时间降序返回前n项，n为0表示全部
+   */
+  std::vector<LockStat> top(size_t n = 10);
+
+  /**
+   * @brief 格式化的热点锁报告
+   */
+  std::string report(size_t n = 10);
+
+  /**
+   * @brief 清零所有统计（统计点保留）
+   */
+  void reset();
+
+private:
+  LockProfiler() = default;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::unique_ptr<LockSite>> sites_;
+};
+
+} // namespace zcoroutine
+
+/**
+ * @brief 在命名处取得锁的统计点，每个调用点只在首次执行时查表
+ *
+ * 有些锁随对象频繁构造（如每次RPC调用一把），按名称构造会在每次构造时
+ * 获取LockProfiler的互斥锁并构造std::string。用法：
+ *   Spinlock lock_{ZCOROUTINE_LOCK_SITE("Name")};
+ * 关闭埋点时展开为名称本身，不产生任何开销。
+ */
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+#define ZCOROUTINE_LOCK_SITE(name)                                             \
+  ([]() -> ::zcoroutine::LockSite * {                                          \
+    static ::zcoroutine::LockSite *const site =                                \
+        ::zcoroutine::LockProfiler::instance().site(name);                     \
+    return site;                                                               \
+  }())
+#else
+#define ZCOROUTINE_LOCK_SITE(name) (name)
+#endif
+
+#endif // ZCOROUTINE_LOCK_PROFILER_H_
@@ -0,0 +1,71 @@
+#ifndef ZCOROUTINE_MUTEX_H_
+#define ZCOROUTINE_MUTEX_H_
+
+#include <mutex>
+
+#include "sync/lock_profiler.h"
+#include "util/noncopyable.h"
+
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+#include "util/cycle_clock.h"
+#endif
+
+namespace zcoroutine {
+
+/**
+ * @brief 带名称的互斥锁
+ * 封装std::mutex，满足Lockable要求，可配合std::lock_guard/unique_lock使用。
+ * 开启ZCOROUTINE_ENABLE_LOCK_PROFILE时先try再阻塞，记录竞争统计；
+ * 关闭时与std::mutex等价。
+ */
+class Mutex : public NonCopyable {
+public:
+  Mutex() : Mutex(ZCOROUTINE_LOCK_SITE("Mutex")) {}
+
+  /**
+   * @param name 锁名称，用于竞争分析报告；频繁构造的锁应使用
+   *             ZCOROUTINE_LOCK_SITE(name)
+   */
+  explicit Mutex(const char *name) {
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+    site_ = LockProfiler::instance().site(name);
+#else
+    (void)name;
+#endif
+  }
+
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+  /**
+   * @param site 已解析的统计点
+   */
+  explicit Mutex(LockSite *site) : site_(site) {}
+#endif
+
+  void lock() {
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+    if (mutex_.try_lock()) {
+      site_->record_acquire();
+      return;
+    }
+    const uint64_t start = CycleClock::now();
+    mutex_.lock();
+    site_->record_contended(0, CycleClock::now() - start);
+#else
+    mutex_.lock();
+#endif
+  }
+
+  bool try_lock() { return mutex_.try_lock(); }
+
+  void unlock() { mutex_.unlock(); }
+
+private:
+  std::mutex mutex_;
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+  LockSite *site_ = nullptr;
+#endif
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_MUTEX_H_
@@ -3,8 +3,13 @@
 
 #include <pthread.h>
 
+#include "sync/lock_profiler.h"
 #include "util/noncopyable.h"
 
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+#include "util/cycle_clock.h"
+#endif
+
 namespace zcoroutine {
 
 // 前向声明
@@ -74,25 +79,72 @@ private:
  * @brief 读写锁类
  * 使用pthread_rwlock_t实现
  * C++14标准库没有提供读写锁，因此保留pthread实现
+ * 开启ZCOROUTINE_ENABLE_LOCK_PROFILE时先try再阻塞，记录竞争统计
  */
 class RWMutex : public NonCopyable {
 public:
   using ReadLock = ReadLockGuard<RWMutex>;
   using WriteLock = WriteLockGuard<RWMutex>;
 
-  RWMutex() { pthread_rwlock_init(&rwlock_, nullptr); }
+  RWMutex() : RWMutex(ZCOROUTINE_LOCK_SITE("RWMutex")) {}
+
+  /**
+   * @param name 锁名称，用于竞争分析报告；频繁构造的锁应使用
+   *             ZCOROUTINE_LOCK_SITE(name)
+   */
+  explicit RWMutex(const char *name) {
+    pthread_rwlock_init(&rwlock_, nullptr);
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+    site_ = LockProfiler::instance().site(name);
+#else
+    (void)name;
+#endif
+  }
+
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+  /**
+   * @param site 已解析的统计点
+   */
+  explicit RWMutex(LockSite *site) : site_(site) {
+    pthread_rwlock_init(&rwlock_, nullptr);
+  }
+#endif
 
   ~RWMutex() { pthread_rwlock_destroy(&rwlock_); }
 
   /**
    * @brief 获取读锁
    */
-  void rdlock() { pthread_rwlock_rdlock(&rwlock_); }
+  void rdlock() {
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+    if (pthread_rwlock_tryrdlock(&rwlock_) == 0) {
+      site_->record_acquire();
+      return;
+    }
+    const uint64_t start = CycleClock::now();
+    pthread_rwlock_rdlock(&rwlock_);
+    site_->record_contended(0, CycleClock::now() - start);
+#else
+    pthread_rwlock_rdlock(&rwlock_);
+#endif
+  }
 
   /**
    * @brief 获取写锁
    */
-  void wrlock() { pthread_rwlock_wrlock(&rwlock_); }
+  void wrlock() {
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+    if (pthread_rwlock_trywrlock(&rwlock_) == 0) {
+      site_->record_acquire();
+      return;
+    }
+    const uint64_t start = CycleClock::now();
+    pthread_rwlock_wrlock(&rwlock_);
+    site_->record_contended(0, CycleClock::now() - start);
+#else
+    pthread_rwlock_wrlock(&rwlock_);
+#endif
+  }
 
   /**
    * @brief 解锁
@@ -101,6 +153,9 @@ public:
 
 private:
   pthread_rwlock_t rwlock_{}; // 底层读写锁对象
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+  LockSite *site_ = nullptr;
+#endif
 };
 
 } // namespace zcoroutine
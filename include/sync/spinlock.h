@@ -3,8 +3,13 @@
 #include <atomic>
 #include <thread>
 
+#include "sync/lock_profiler.h"
 #include "util/noncopyable.h"
 
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+#include "util/cycle_clock.h"
+#endif
+
 namespace zcoroutine {
 
 /**
@@ -15,15 +20,38 @@ namespace zcoroutine {
  * 2. exchange(acquire) 真正抢锁，建立同步
  * 3. unlock 使用 release，形成 happens-before
  * 4. 指数退避策略：缩短平均自旋时间，减少yield调用
+ * 5. 开启ZCOROUTINE_ENABLE_LOCK_PROFILE时按名称记录竞争统计
 
  */
 class alignas(64) Spinlock : public NonCopyable {
 public:
-  Spinlock() noexcept = default;
+  Spinlock() noexcept : Spinlock(ZCOROUTINE_LOCK_SITE("Spinlock")) {}
+
+  /**
+   * @param name 锁名称，用于竞争分析报告；频繁构造的锁应使用
+   *             ZCOROUTINE_LOCK_SITE(name)
+   */
+  explicit Spinlock(const char *name) noexcept {
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+    site_ = LockProfiler::instance().site(name);
+#else
+    (void)name;
+#endif
+  }
+
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+  /**
+   * @param site 已解析的统计点
+   */
+  explicit Spinlock(LockSite *site) noexcept : site_(site) {}
+#endif
 
   void lock() noexcept {
     // 快速路径：立即尝试获取锁
     if (!locked_.exchange(true, std::memory_order_acquire)) {
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+      site_->record_acquire();
+#endif
       return;
     }
 
@@ -37,8 +65,15 @@ private:
   static constexpr int kMaxSpinCount = 64; // 最大自旋次数
 
   std::atomic<bool> locked_{false};
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+  LockSite *site_ = nullptr;
+#endif
 
   void lock_slow() noexcept {
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+    const uint64_t start = CycleClock::now();
+    uint64_t spins = 0;
+#endif
     int spin_count = 1;
 
     for (;;) {
@@ -47,10 +82,16 @@ private:
         if (!locked_.load(std::memory_order_relaxed)) {
           // 尝试抢锁
           if (!locked_.exchange(true, std::memory_order_acquire)) {
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+            site_->record_contended(spins, CycleClock::now() - start);
+#endif
             return;
           }
         }
         cpu_relax();
+#ifdef ZCOROUTINE_ENABLE_LOCK_PROFILE
+        ++spins;
+#endif
       }
 
       // 指数退避：翻倍自旋次数，但不超过上限
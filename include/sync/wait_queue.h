@@ -0,0 +1,117 @@
+#ifndef ZCOROUTINE_WAIT_QUEUE_H_
+#define ZCOROUTINE_WAIT_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include "runtime/fiber.h"
+#include "sync/spinlock.h"
+#include "timer/timer.h"
+#include "util/noncopyable.h"
+#include "util/thread_context.h"
+
+namespace zcoroutine {
+
+class Scheduler;
+
+/**
+ * @brief 协程等待队列（协程版条件变量）
+ *
+ * wait()把当前协程挂到队列上并让出，只挂起协程而不阻塞线程；
+ * notify_one()/notify_all()把等待协程重新交给它所属的调度器。
+ * 支持超时：超时由IoScheduler的定时器唤醒。
+ * 协程可能在其他工作线程上恢复，wait()会恢复调用时的hook开关。
+ *
+ * 与条件变量相同，调用方用自己的锁保护等待条件：
+ * 持锁检查条件 -> wait(lock) 入队后释放锁并挂起 -> 被唤醒后重新加锁。
+ * 通知方修改条件后调用notify，不会丢失唤醒。
+ */
+class WaitQueue : public NonCopyable {
+public:
+  static constexpr uint64_t kNoTimeout = static_cast<uint64_t>(-1);
+
+  WaitQueue() = default;
+  ~WaitQueue();
+
+  /**
+   * @brief 挂起当前协程直到被通知或超时
+   * @param lock 调用方持有的锁，挂起期间释放，返回前重新获取
+   * @param timeout_ms 超时时间（毫秒），kNoTimeout表示一直等待
+   * @return 被通知返回true；超时或不在协程中返回false
+   */
+  template <class Lock>
+  bool wait(std::unique_lock<Lock> &lock, uint64_t timeout_ms = kNoTimeout) {
+    std::shared_ptr<Waiter> waiter = enqueue(timeout_ms);
+    if (!waiter) {
+      return false;
+    }
+    // hook开关是线程级状态，协程可能在另一个工作线程上恢复，需要带过去
+    const bool hook_enable = ThreadContext::is_hook_enabled();
+    lock.unlock();
+    Fiber::yield();
+    ThreadContext::set_hook_enable(hook_enable);
+    lock.lock();
+    return waiter->notified;
+  }
+
+  /**
+   * @brief 唤醒一个等待协程
+   * @return 是否唤醒了协程
+   */
+  bool notify_one();
+
+  /**
+   * @brief 唤醒全部等待协程
+   * @return 唤醒的协程数
+   */
+  size_t notify_all();
+
+  /**
+   * @brief 当前等待的协程数
+   */
+  size_t waiter_count() const;
+
+private:
+  struct Waiter {
+    Fiber::ptr fiber;
+    Scheduler *scheduler = nullptr;
+    Timer::ptr timer;
+    std::atomic<bool> done{false}; // 通知与超时只有一方生效
+    bool notified = false;
+    bool in_queue = false; // 受lock_保护
+    std::list<std::shared_ptr<Waiter>>::iterator pos;
+  };
+
+  /**
+   * @brief 当前协程入队，设置超时定时器
+   * @return 等待项；不在协程或调度器中时返回nullptr
+   */
+  std::shared_ptr<Waiter> enqueue(uint64_t timeout_ms);
+
+  /**
+   * @brief 超时回调：仍在队列中时移除并唤醒
+   */
+  void on_timeout(const std::shared_ptr<Waiter> &waiter);
+
+  /**
+   * @brief 从队头取出一个尚未超时的等待项
+   */
+  std::shared_ptr<Waiter> pop_waiter();
+
+  /**
+   * @brief 唤醒已出队的等待项
+   */
+  static void wake(const std::shared_ptr<Waiter> &waiter);
+
+private:
+  mutable Spinlock lock_{ZCOROUTINE_LOCK_SITE("WaitQueue")};
+  std::list<std::shared_ptr<Waiter>> waiters_;
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_WAIT_QUEUE_H_
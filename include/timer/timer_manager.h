@@ -8,6 +8,7 @@
 #include <set>
 #include <vector>
 
+#include "sync/mutex.h"
 #include "timer.h"
 
 namespace zcoroutine {
@@ -108,8 +109,9 @@ private:
 
   std::atomic<bool> is_ticked_{false}; // 是否已经通知协程调度器
   std::set<Timer::ptr, TimerComparator> timers_; // 定时器集合
-  mutable std::mutex mutex_;                     // 互斥锁
-  uint64_t last_time_ = 0;                       // 上次检测时间
+  // 互斥锁
+  mutable Mutex mutex_{ZCOROUTINE_LOCK_SITE("TimerManager")};
+  uint64_t last_time_ = 0; // 上次检测时间
   OnTimerInsertedCallback on_timer_inserted_callback_; // 定时器插入队首时的回调
 
   friend class Timer;
@@ -0,0 +1,46 @@
+#ifndef ZCOROUTINE_CYCLE_CLOCK_H_
+#define ZCOROUTINE_CYCLE_CLOCK_H_
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+namespace zcoroutine {
+
+/**
+ * @brief 低开销的周期计数时钟
+ *
+ * x86上读取TSC（约几纳秒），其他平台退化为CLOCK_MONOTONIC纳秒。
+ * 计数只用于求差值，换算成时间需使用ticks_per_ns()。
+ */
+class CycleClock {
+public:
+  static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL +
+           static_cast<uint64_t>(ts.tv_nsec);
+#endif
+  }
+
+  /**
+   * @brief 每纳秒的计数
+   * 以进程内首次使用时刻为基准校准；距基准不足1ms时会先睡眠10ms
+   */
+  static double ticks_per_ns();
+
+  static uint64_t to_ns(uint64_t ticks) {
+    return static_cast<uint64_t>(static_cast<double>(ticks) / ticks_per_ns());
+  }
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_CYCLE_CLOCK_H_
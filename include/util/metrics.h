@@ -0,0 +1,239 @@
+#ifndef ZCOROUTINE_METRICS_H_
+#define ZCOROUTINE_METRICS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "util/noncopyable.h"
+
+namespace zcoroutine {
+
+/**
+ * @brief 运行时计数器
+ */
+enum class Counter : uint8_t {
+  kTasksRun = 0,   // 工作线程执行的任务数
+  kFiberSwitches,  // 协程切入次数
+  kParks,          // 工作线程因队列为空而阻塞等待的次数
+  kWakeups,        // 入队时唤醒阻塞工作线程的次数
+  kEpollWaits,     // IO线程epoll_wait调用次数
+  kEpollEvents,    // epoll_wait返回的就绪事件数
+  kTimersFired,    // 到期执行的定时器数
+  kHookEagain,     // hook的IO调用遇到EAGAIN而挂起协程的次数
+  kStackCopyBytes, // 共享栈切换时保存和恢复复制的字节数
+  kCount,
+};
+
+/**
+ * @brief 运行时直方图（单位纳秒）
+ */
+enum class Histogram : uint8_t {
+  kScheduleLatency = 0, // 任务从入队到开始执行的延迟
+  kRunDuration,         // 任务单次执行（到结束或让出）的耗时
+  kCount,
+};
+
+constexpr size_t kCounterCount = static_cast<size_t>(Counter::kCount);
+constexpr size_t kHistogramCount = static_cast<size_t>(Histogram::kCount);
+
+/**
+ * @brief HDR风格的对数-线性直方图
+ *
+ * 每个2的幂区间再均分为2^kSubBits个桶，相对误差不超过1/2^kSubBits，
+ * 覆盖[0, 2^kMaxBits)纳秒，超出部分计入最后一个桶。
+ * record()只允许所属线程调用；record_shared()可被多个线程并发调用。
+ */
+class HdrHistogram {
+public:
+  static constexpr int kSubBits = 4;
+  static constexpr int kMaxBits = 40; // 约1100秒
+  static constexpr size_t kBucketCount =
+      static_cast<size_t>(kMaxBits - kSubBits + 1) << kSubBits;
+
+  static size_t bucket_index(uint64_t value) {
+    if (value < (1ULL << kSubBits)) {
+      return static_cast<size_t>(value);
+    }
+    int msb = 63 - __builtin_clzll(value);
+    if (msb >= kMaxBits) {
+      return kBucketCount - 1;
+    }
+    int shift = msb - kSubBits;
+    size_t sub = static_cast<size_t>(value >> shift) & ((1U << kSubBits) - 1);
+    return (static_cast<size_t>(shift + 1) << kSubBits) + sub;
+  }
+
+  /**
+   * @brief 桶的上界（包含）
+   */
+  static uint64_t bucket_upper(size_t index);
+
+  void record(uint64_t value) {
+    bump(buckets_[bucket_index(value)], 1);
+    bump(count_, 1);
+    bump(sum_, value);
+    if (value > max_.load(std::memory_order_relaxed)) {
+      max_.store(value, std::memory_order_relaxed);
+    }
+  }
+
+  void record_shared(uint64_t value);
+
+  const std::atomic<uint64_t> &bucket(size_t index) const {
+    return buckets_[index];
+  }
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+  uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+  uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+private:
+  // 单写者：读-改-写无需lock前缀
+  static void bump(std::atomic<uint64_t> &v, uint64_t n) {
+    v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> buckets_[kBucketCount] = {};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_{0};
+  std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * @brief 直方图快照
+ */
+struct HistogramSnapshot {
+  std::vector<uint64_t> buckets =
+      std::vector<uint64_t>(HdrHistogram::kBucketCount, 0);
+  uint64_t count = 0;
+  uint64_t sum = 0;
+  uint64_t max = 0;
+
+  void merge(const HdrHistogram &histogram);
+
+  /**
+   * @brief 百分位数（返回所在桶的上界）
+   * @param q 取值[0, 100]
+   */
+  uint64_t percentile(double q) const;
+
+  /**
+   * @brief 小于等于value的样本数（按桶上界近似）
+   */
+  uint64_t count_le(uint64_t value) const;
+
+  double mean() const {
+    return count ? static_cast<double>(sum) / static_cast<double>(count) : 0;
+  }
+};
+
+/**
+ * @brief 指标汇总快照
+ */
+struct MetricsSnapshot {
+  uint64_t counters[kCounterCount] = {};
+  HistogramSnapshot histograms[kHistogramCount];
+  size_t shard_count = 0;
+
+  uint64_t counter(Counter c) const {
+    return counters[static_cast<size_t>(c)];
+  }
+  const HistogramSnapshot &histogram(Histogram h) const {
+    return histograms[static_cast<size_t>(h)];
+  }
+};
+
+/**
+ * @brief 单线程的指标分片，按缓存行对齐避免伪共享
+ */
+struct alignas(64) MetricsShard {
+  std::atomic<uint64_t> counters[kCounterCount] = {};
+  HdrHistogram histograms[kHistogramCount];
+  bool in_use = true;
+
+  // C++14的new不保证超过16字节的对齐
+  static void *operator new(size_t size);
+  static void operator delete(void *ptr);
+};
+
+/**
+ * @brief 运行时指标注册表
+ *
+ * 每个线程（通常是调度器工作线程和IO线程）首次记录时领取一个分片，
+ * 之后只写自己的分片，记录路径是无锁且wait-free的。线程退出后分片
+ * 留给后续新线程复用，累计值保持不变。snapshot()汇总全部分片。
+ */
+class Metrics : public NonCopyable {
+public:
+  static Metrics &instance();
+
+  static void inc(Counter c, uint64_t n = 1) {
+    MetricsShard *shard = t_shard_;
+    if (__builtin_expect(shard != nullptr, 1)) {
+      std::atomic<uint64_t> &v = shard->counters[static_cast<size_t>(c)];
+      v.store(v.load(std::memory_order_relaxed) + n,
+              std::memory_order_relaxed);
+    } else {
+      inc_slow(c, n);
+    }
+  }
+
+  static void observe(Histogram h, uint64_t ns) {
+    MetricsShard *shard = t_shard_;
+    if (__builtin_expect(shard != nullptr, 1)) {
+      shard->histograms[static_cast<size_t>(h)].record(ns);
+    } else {
+      observe_slow(h, ns);
+    }
+  }
+
+  /**
+   * @brief 是否采集耗时类直方图（需要读时钟），默认开启
+   */
+  static bool timing_enabled() {
+    return s_timing_enabled_.load(std::memory_order_relaxed);
+  }
+  static void set_timing_enabled(bool enabled) {
+    s_timing_enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 单调时钟（纳秒）
+   */
+  static uint64_t now_ns();
+
+  /**
+   * @brief 汇总所有分片
+   */
+  MetricsSnapshot snapshot();
+
+  static const char *counter_name(Counter c);
+  static const char *histogram_name(Histogram h);
+
+private:
+  Metrics();
+
+  static void inc_slow(Counter c, uint64_t n);
+  static void observe_slow(Histogram h, uint64_t ns);
+
+  MetricsShard *acquire_shard();
+  void release_shard(MetricsShard *shard);
+
+  friend struct MetricsShardHolder;
+
+private:
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<MetricsShard>> shards_;
+  // 线程退出阶段的记录写入共享分片（使用原子加）
+  std::unique_ptr<MetricsShard> orphan_;
+
+  static thread_local MetricsShard *t_shard_;
+  static std::atomic<bool> s_timing_enabled_;
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_METRICS_H_
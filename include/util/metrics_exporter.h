@@ -0,0 +1,62 @@
+#ifndef ZCOROUTINE_METRICS_EXPORTER_H_
+#define ZCOROUTINE_METRICS_EXPORTER_H_
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "util/metrics.h"
+#include "util/noncopyable.h"
+
+namespace zcoroutine {
+
+/**
+ * @brief 以Prometheus文本格式导出运行时指标
+ *
+ * 计数器导出为zcoroutine_<name>_total，直方图导出为
+ * zcoroutine_<name>_seconds（固定的le边界，便于长期对比）。
+ * 可写入文件（供node_exporter的textfile collector采集），
+ * 也可在Unix域套接字上提供服务：每个连接写出一次当前指标后关闭。
+ */
+class MetricsExporter : public NonCopyable {
+public:
+  MetricsExporter() = default;
+  ~MetricsExporter();
+
+  /**
+   * @brief 格式化为Prometheus文本
+   */
+  static std::string to_prometheus(const MetricsSnapshot &snapshot);
+
+  /**
+   * @brief 写入文件（先写临时文件再rename，读方不会看到半个文件）
+   * @return 成功返回true
+   */
+  static bool write_file(const std::string &path);
+
+  /**
+   * @brief 在Unix域套接字上提供指标
+   * @return 成功返回0，失败返回-1并设置errno
+   */
+  int serve(const std::string &socket_path);
+
+  /**
+   * @brief 停止服务并删除套接字文件
+   */
+  void stop();
+
+  bool is_serving() const { return listen_fd_ >= 0; }
+
+private:
+  void serve_loop();
+
+private:
+  int listen_fd_ = -1;
+  std::string socket_path_;
+  std::thread thread_;
+  std::atomic<bool> stopping_{false};
+};
+
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_METRICS_EXPORTER_H_
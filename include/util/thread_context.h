@@ -26,6 +26,7 @@ struct SchedulerContext {
   std::weak_ptr<Fiber> current_fiber;   // 当前执行的协程
   std::weak_ptr<Fiber> scheduler_fiber; // 调度器协程
   Scheduler *scheduler = nullptr;       // 当前调度器
+  int worker_id = -1;                   // 调度器工作线程编号，-1表示非工作线程
 
   static constexpr int kMaxCallStackDepth = 128;
   std::array<std::weak_ptr<Fiber>, kMaxCallStackDepth> call_stack{};
@@ -98,6 +99,12 @@ public:
    */
   static Fiber::ptr get_current_fiber();
 
+  /**
+   * @brief 获取当前执行协程的裸指针（不访问weak_ptr、不分配内存）
+   * 可在信号处理函数中调用；返回值仅在该协程运行期间有效
+   */
+  static Fiber *current_fiber_raw();
+
   /**
    * @brief 设置调度器协程
    * @param fiber 调度器协程指针
@@ -122,6 +129,18 @@ public:
    */
   static Scheduler *get_scheduler();
 
+  /**
+   * @brief 设置当前线程的工作线程编号
+   * @param id 编号，-1表示非工作线程
+   */
+  static void set_worker_id(int id);
+
+  /**
+   * @brief 获取当前线程的工作线程编号
+   * @return 编号[0, thread_count)，非工作线程返回-1
+   */
+  static int get_worker_id();
+
   /**
    * @brief 设置当前线程的栈模式
    * @param mode 栈模式
@@ -0,0 +1,174 @@
+#ifndef ZCOROUTINE_TRACER_H_
+#define ZCOROUTINE_TRACER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "util/noncopyable.h"
+
+namespace zcoroutine {
+
+/**
+ * @brief 追踪事件类型
+ */
+enum class TraceEvent : uint8_t {
+  kFiberCreate = 0,    // arg: 1表示从FiberPool复用
+  kFiberResume,
+  kFiberYield,
+  kFiberTerminate,
+  kTaskEnqueue,        // fiber_id为0表示回调任务
+  kTaskDequeue,
+  kIoWait,             // arg: fd
+  kIoReady,            // arg: fd
+  kTimerFire,          // arg: 本轮到期的定时器数量
+};
+
+/**
+ * @brief 单条追踪记录（24字节）
+ */
+struct TraceRecord {
+  uint64_t tsc;
+  uint64_t fiber_id;
+  int32_t arg;
+  TraceEvent event;
+};
+
+/**
+ * @brief 单线程写入的环形追踪缓冲区
+ *
+ * 只有所属线程写入，写满后覆盖最旧的记录；读取方按写入计数校验，
+ * 丢弃读取期间被覆盖的记录，因此无需加锁。
+ */
+class TraceBuffer : public NonCopyable {
+public:
+  TraceBuffer(size_t capacity, std::string thread_name);
+
+  void append(TraceEvent event, uint64_t fiber_id, int32_t arg, uint64_t tsc) {
+    uint64_t pos = written_.load(std::memory_order_relaxed);
+    TraceRecord &record = records_[pos & mask_];
+    record.tsc = tsc;
+    record.fiber_id = fiber_id;
+    record.arg = arg;
+    record.event = event;
+    written_.store(pos + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief 拷贝当前仍有效的记录（按时间顺序）
+   * 缓冲区写满时最旧的一条可能正被写入方覆盖，因此最多返回capacity - 1条
+   */
+  std::vector<TraceRecord> snapshot() const;
+
+  const std::string &thread_name() const { return thread_name_; }
+  uint64_t written() const { return written_.load(std::memory_order_acquire); }
+
+private:
+  std::vector<TraceRecord> records_;
+  uint64_t mask_;
+  std::atomic<uint64_t> written_{0};
+  std::string thread_name_;
+};
+
+/**
+ * @brief 协程生命周期追踪器
+ *
+ * 每个线程首次记录时创建自己的TraceBuffer，记录路径无锁。
+ * 时间戳使用TSC（非x86平台退化为steady_clock），导出时换算为微秒。
+ * dump()输出Chrome/Perfetto可加载的JSON：协程每次运行是一个时间片，
+ * 入队到出队之间用flow箭头连接，其余事件为瞬时事件。
+ *
+ * 运行时的埋点通过ZCOROUTINE_TRACE宏调用，只有定义了
+ * ZCOROUTINE_ENABLE_TRACE（CMake选项ENABLE_TRACE）时才会编译进来。
+ */
+class Tracer : public NonCopyable {
+public:
+  static constexpr size_t kDefaultCapacity = 1 << 16;
+
+  static Tracer &instance();
+
+  /**
+   * @brief 记录一个事件到当前线程的缓冲区
+   */
+  static void record(TraceEvent event, uint64_t fiber_id, int32_t arg = 0);
+
+  /**
+   * @brief 运行时开关，默认开启
+   */
+  void set_enabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief 设置之后新建缓冲区的容量（向上取整为2的幂）
+   */
+  void set_buffer_capacity(size_t capacity);
+
+  /**
+   * @brief 导出为Chrome trace JSON文件
+   * @return 成功返回true
+   */
+  bool dump(const std::string &path);
+
+  /**
+   * @brief 导出为Chrome trace JSON字符串
+   */
+  std::string dump_to_string();
+
+  /**
+   * @brief 安装信号处理：收到signo后由后台线程导出到
+   *        <path_prefix>.<pid>.<序号>.json
+   * @return 成功返回true；重复安装返回false
+   */
+  bool install_signal_handler(int signo, const std::string &path_prefix);
+
+  /**
+   * @brief 已完成的信号触发导出次数
+   */
+  uint64_t signal_dump_count() const {
+    return signal_dumps_.load(std::memory_order_acquire);
+  }
+
+  static const char *event_name(TraceEvent event);
+
+  static uint64_t now_tsc();
+
+private:
+  Tracer();
+  ~Tracer();
+
+  TraceBuffer *local_buffer();
+  void dump_thread_func();
+
+private:
+  std::atomic<bool> enabled_{true};
+  std::atomic<size_t> capacity_{kDefaultCapacity};
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<TraceBuffer>> buffers_;
+
+  uint64_t base_tsc_;
+
+  std::string signal_prefix_;
+  std::thread dump_thread_;
+  std::atomic<uint64_t> signal_dumps_{0};
+};
+
+} // namespace zcoroutine
+
+#ifdef ZCOROUTINE_ENABLE_TRACE
+#define ZCOROUTINE_TRACE(event, fiber_id, arg)                                 \
+  ::zcoroutine::Tracer::record(::zcoroutine::TraceEvent::event, (fiber_id),    \
+                               static_cast<int32_t>(arg))
+#else
+#define ZCOROUTINE_TRACE(event, fiber_id, arg)                                 \
+  do {                                                                         \
+  } while (0)
+#endif
+
+#endif // ZCOROUTINE_TRACER_H_
@@ -1,8 +1,26 @@
 #ifndef ZCOROUTINE_LOGGER_H_
 #define ZCOROUTINE_LOGGER_H_
 
+#include <atomic>
+
 #include "zlog.h"
 
+/**
+ * @brief 编译期日志等级
+ * 低于ZCOROUTINE_ACTIVE_LEVEL的日志宏展开为永不执行的分支，调用被整体消除；
+ * 由CMake选项LOG_ACTIVE_LEVEL设置，默认保留全部等级。
+ */
+#define ZCOROUTINE_LEVEL_DEBUG 1
+#define ZCOROUTINE_LEVEL_INFO 2
+#define ZCOROUTINE_LEVEL_WARN 3
+#define ZCOROUTINE_LEVEL_ERROR 4
+#define ZCOROUTINE_LEVEL_FATAL 5
+#define ZCOROUTINE_LEVEL_OFF 6
+
+#ifndef ZCOROUTINE_ACTIVE_LEVEL
+#define ZCOROUTINE_ACTIVE_LEVEL ZCOROUTINE_LEVEL_DEBUG
+#endif
+
 namespace zcoroutine {
 
 /**
@@ -11,18 +29,79 @@ namespace zcoroutine {
  */
 void init_logger(zlog::LogLevel::value level = zlog::LogLevel::value::DEBUG);
 zlog::Logger::ptr get_logger();
+
+namespace detail {
+extern std::atomic<zlog::Logger *> g_logger;
+zlog::Logger *load_logger();
+} // namespace detail
+
+/**
+ * @brief 获取日志器裸指针
+ * 首次解析后缓存，热路径上没有shared_ptr拷贝；日志器尚未初始化时返回nullptr
+ */
+inline zlog::Logger *logger() {
+  zlog::Logger *logger = detail::g_logger.load(std::memory_order_acquire);
+  return logger ? logger : detail::load_logger();
+}
 } // namespace zcoroutine
 
+// 先判断等级再求值参数：等级未开启时fiber->name()等参数不会被计算
+#define ZCOROUTINE_LOG_IMPL(level, method, fmt, ...)                           \
+  do {                                                                         \
+    zlog::Logger *zcoroutine_logger_ = zcoroutine::logger();                   \
+    if (zcoroutine_logger_ &&                                                  \
+        zcoroutine_logger_->shouldLog(zlog::LogLevel::value::level)) {         \
+      zcoroutine_logger_->method(__FILE__, __LINE__, fmt, ##__VA_ARGS__);      \
+    }                                                                          \
+  } while (0)
+
+// 编译期关闭的等级：保留参数的语法检查，不生成调用
+#define ZCOROUTINE_LOG_NONE(method, fmt, ...)                                  \
+  do {                                                                         \
+    if (false) {                                                               \
+      zcoroutine::logger()->method(__FILE__, __LINE__, fmt, ##__VA_ARGS__);    \
+    }                                                                          \
+  } while (0)
+
 // 便利的日志宏定义
+#if ZCOROUTINE_ACTIVE_LEVEL <= ZCOROUTINE_LEVEL_DEBUG
+#define ZCOROUTINE_LOG_DEBUG(fmt, ...)                                         \
+  ZCOROUTINE_LOG_IMPL(DEBUG, debug, fmt, ##__VA_ARGS__)
+#else
 #define ZCOROUTINE_LOG_DEBUG(fmt, ...)                                         \
-  zcoroutine::get_logger()->ZLOG_DEBUG(fmt, ##__VA_ARGS__)
+  ZCOROUTINE_LOG_NONE(debug, fmt, ##__VA_ARGS__)
+#endif
+
+#if ZCOROUTINE_ACTIVE_LEVEL <= ZCOROUTINE_LEVEL_INFO
 #define ZCOROUTINE_LOG_INFO(fmt, ...)                                          \
-  zcoroutine::get_logger()->ZLOG_INFO(fmt, ##__VA_ARGS__)
+  ZCOROUTINE_LOG_IMPL(INFO, info, fmt, ##__VA_ARGS__)
+#else
+#define ZCOROUTINE_LOG_INFO(fmt, ...)                                          \
+  ZCOROUTINE_LOG_NONE(info, fmt, ##__VA_ARGS__)
+#endif
+
+#if ZCOROUTINE_ACTIVE_LEVEL <= ZCOROUTINE_LEVEL_WARN
 #define ZCOROUTINE_LOG_WARN(fmt, ...)                                          \
-  zcoroutine::get_logger()->ZLOG_WARN(fmt, ##__VA_ARGS__)
+  ZCOROUTINE_LOG_IMPL(WARNING, warning, fmt, ##__VA_ARGS__)
+#else
+#define ZCOROUTINE_LOG_WARN(fmt, ...)                                          \
+  ZCOROUTINE_LOG_NONE(warning, fmt, ##__VA_ARGS__)
+#endif
+
+#if ZCOROUTINE_ACTIVE_LEVEL <= ZCOROUTINE_LEVEL_ERROR
+#define ZCOROUTINE_LOG_ERROR(fmt, ...)                                         \
+  ZCOROUTINE_LOG_IMPL(ERROR, error, fmt, ##__VA_ARGS__)
+#else
 #define ZCOROUTINE_LOG_ERROR(fmt, ...)                                         \
-  zcoroutine::get_logger()->ZLOG_ERROR(fmt, ##__VA_ARGS__)
+  ZCOROUTINE_LOG_NONE(error, fmt, ##__VA_ARGS__)
+#endif
+
+#if ZCOROUTINE_ACTIVE_LEVEL <= ZCOROUTINE_LEVEL_FATAL
+#define ZCOROUTINE_LOG_FATAL(fmt, ...)                                         \
+  ZCOROUTINE_LOG_IMPL(FATAL, fatal, fmt, ##__VA_ARGS__)
+#else
 #define ZCOROUTINE_LOG_FATAL(fmt, ...)                                         \
-  zcoroutine::get_logger()->ZLOG_FATAL(fmt, ##__VA_ARGS__)
+  ZCOROUTINE_LOG_NONE(fatal, fmt, ##__VA_ARGS__)
+#endif
 
 #endif // ZCOROUTINE_LOGGER_H_
@@ -2,6 +2,7 @@
 #include "io/io_scheduler.h"
 #include "io/status_table.h"
 #include "runtime/fiber.h"
+#include "util/metrics.h"
 #include "util/thread_context.h"
 #include "util/zcoroutine_logger.h"
 #include <cerrno>
@@ -44,6 +45,7 @@ void hook_init() {
   XX(socketpair)
   XX(connect)
   XX(accept)
+  XX(accept4)
   XX(read)
   XX(readv)
   XX(recv)
@@ -79,6 +81,7 @@ socket_func socket_f = nullptr;
 socketpair_func socketpair_f = nullptr;
 connect_func connect_f = nullptr;
 accept_func accept_f = nullptr;
+accept4_func accept4_f = nullptr;
 read_func read_f = nullptr;
 readv_func readv_f = nullptr;
 recv_func recv_f = nullptr;
@@ -103,6 +106,20 @@ struct timer_info {
 // 默认连接超时时间（毫秒）
 static uint64_t s_connect_timeout = 5000;
 
+// hook创建的socket在内核层面一律带上的标志：
+// 创建时即为非阻塞，省去后续fstat+fcntl(F_GETFL/F_SETFL)三次系统调用
+static constexpr int kHookSocketFlags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+
+/**
+ * @brief hook内部的让出
+ * 协程可能被调度到另一个工作线程上恢复，而hook开关是线程级状态，
+ * 恢复后在新线程上重新启用，保证后续IO仍走hook路径。
+ */
+static void hook_yield() {
+  zcoroutine::Fiber::yield();
+  zcoroutine::set_hook_enable(true);
+}
+
 /**
  * @brief 通用IO Hook模板函数
  *
@@ -174,6 +191,7 @@ static ssize_t do_io_hook(int fd, OriginFun fun, const char *hook_fun_name,
       if (!iom) {
         return fun(fd, std::forward<Args>(args)...);
       }
+      zcoroutine::Metrics::inc(zcoroutine::Counter::kHookEagain);
 
       zcoroutine::Timer::ptr timer = nullptr;
       std::weak_ptr<timer_info> winfo(tinfo);
@@ -208,7 +226,7 @@ static ssize_t do_io_hook(int fd, OriginFun fun, const char *hook_fun_name,
       }
 
       // 让出协程，等待事件就绪或超时
-      zcoroutine::Fiber::yield();
+      hook_yield();
 
       // 协程被唤醒后，取消定时器
       if (timer) {
@@ -254,7 +272,7 @@ unsigned int sleep(unsigned int seconds) {
   // 必须在yield之前捕获shared_ptr，保持协程存活直到定时器触发
   iom->add_timer(seconds * 1000,
                  [iom, cur_fiber]() { iom->schedule(cur_fiber); });
-  zcoroutine::Fiber::yield();
+  hook_yield();
 
   return 0;
 }
@@ -276,7 +294,7 @@ int usleep(useconds_t usec) {
 
   // 必须在yield之前捕获shared_ptr，保持协程存活直到定时器触发
   iom->add_timer(usec / 1000, [iom, cur_fiber]() { iom->schedule(cur_fiber); });
-  zcoroutine::Fiber::yield();
+  hook_yield();
 
   return 0;
 }
@@ -301,7 +319,7 @@ int nanosleep(const struct timespec *req, struct timespec *rem) {
   uint64_t timeout_ms = req->tv_sec * 1000 + req->tv_nsec / 1000000;
   // 必须在yield之前捕获shared_ptr，保持协程存活直到定时器触发
   iom->add_timer(timeout_ms, [iom, cur_fiber]() { iom->schedule(cur_fiber); });
-  zcoroutine::Fiber::yield();
+  hook_yield();
 
   return 0;
 }
@@ -313,16 +331,15 @@ int socket(int domain, int type, int protocol) {
     return socket_f(domain, type, protocol);
   }
 
-  int fd = socket_f(domain, type, protocol);
+  int fd = socket_f(domain, type | kHookSocketFlags, protocol);
   if (fd < 0) {
     return fd;
   }
 
-  // 获取 StatusTable 并注册该fd
+  // 注册该fd：创建时已知其为非阻塞socket，无需再fstat/fcntl
   // 这一步很重要，因为我们需要追踪每个socket的状态（是否是非阻塞，超时设置等）
-  zcoroutine::StatusTable::ptr status_table =
-      zcoroutine::StatusTable::GetInstance();
-  status_table->get(fd, true); // auto_create = true
+  zcoroutine::StatusTable::GetInstance()->add_socket(
+      fd, (type & SOCK_NONBLOCK) != 0);
 
   ZCOROUTINE_LOG_DEBUG("hook::socket fd={}", fd);
   return fd;
@@ -333,16 +350,17 @@ int socketpair(int domain, int type, int protocol, int sv[2]) {
     return socketpair_f(domain, type, protocol, sv);
   }
 
-  int ret = socketpair_f(domain, type, protocol, sv);
+  int ret = socketpair_f(domain, type | kHookSocketFlags, protocol, sv);
   if (ret < 0) {
     return ret;
   }
 
-  // 获取 StatusTable 并注册两个fd
+  // 注册两个fd
+  const bool user_nonblock = (type & SOCK_NONBLOCK) != 0;
   zcoroutine::StatusTable::ptr status_table =
       zcoroutine::StatusTable::GetInstance();
-  status_table->get(sv[0], true); // auto_create = true
-  status_table->get(sv[1], true); // auto_create = true
+  status_table->add_socket(sv[0], user_nonblock);
+  status_table->add_socket(sv[1], user_nonblock);
 
   ZCOROUTINE_LOG_DEBUG("hook::socketpair sv[0]={}, sv[1]={}", sv[0], sv[1]);
   return ret;
@@ -427,7 +445,7 @@ int connect_with_timeout(int fd, const struct sockaddr *addr, socklen_t addrlen,
   }
 
   // 让出协程，等待连接完成或超时
-  zcoroutine::Fiber::yield();
+  hook_yield();
 
   // 取消定时器
   if (timer) {
@@ -459,17 +477,33 @@ int connect(int sockfd, const struct sockaddr *addr, socklen_t addrlen) {
   return connect_with_timeout(sockfd, addr, addrlen, s_connect_timeout);
 }
 
-int accept(int sockfd, struct sockaddr *addr, socklen_t *addrlen) {
-  int fd = static_cast<int>(do_io_hook(sockfd, accept_f, "accept",
-                                       zcoroutine::FdContext::kRead,
-                                       SO_RCVTIMEO, addr, addrlen));
+/**
+ * @brief accept/accept4的公共实现
+ *
+ * 统一通过accept4创建连接fd并带上SOCK_NONBLOCK|SOCK_CLOEXEC，
+ * 新fd的元数据直接写入StatusTable，不再额外发起fstat/fcntl。
+ */
+static int do_accept(int sockfd, struct sockaddr *addr, socklen_t *addrlen,
+                     int flags, const char *hook_fun_name) {
+  int fd = static_cast<int>(do_io_hook(
+      sockfd, accept4_f, hook_fun_name, zcoroutine::FdContext::kRead,
+      SO_RCVTIMEO, addr, addrlen, flags | kHookSocketFlags));
   if (fd >= 0) {
     // 注册新连接的fd
-    zcoroutine::StatusTable::GetInstance()->get(fd, true);
+    zcoroutine::StatusTable::GetInstance()->add_socket(
+        fd, (flags & SOCK_NONBLOCK) != 0);
   }
   return fd;
 }
 
+int accept(int sockfd, struct sockaddr *addr, socklen_t *addrlen) {
+  return do_accept(sockfd, addr, addrlen, 0, "accept");
+}
+
+int accept4(int sockfd, struct sockaddr *addr, socklen_t *addrlen, int flags) {
+  return do_accept(sockfd, addr, addrlen, flags, "accept4");
+}
+
 ssize_t read(int fd, void *buf, size_t count) {
   return do_io_hook(fd, read_f, "read", zcoroutine::FdContext::kRead,
                     SO_RCVTIMEO, buf, count);
@@ -0,0 +1,260 @@
+#include "http/http_parser.h"
+
+#include <cstring>
+
+namespace zcoroutine {
+
+static inline char ascii_lower(char c) {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+static inline bool is_ows(char c) { return c == ' ' || c == '\t'; }
+
+// RFC 7230 tchar：方法名与头部名允许的字符
+static inline bool is_tchar(char c) {
+  if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+      (c >= '0' && c <= '9')) {
+    return true;
+  }
+  return std::strchr("!#$%&'*+-.^_`|~", c) != nullptr && c != '\0';
+}
+
+bool HttpSlice::iequals(const char *str) const {
+  size_t n = std::strlen(str);
+  if (n != size) {
+    return false;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    if (ascii_lower(data[i]) != ascii_lower(str[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+HttpSlice HttpRequest::header(const char *name) const {
+  for (const auto &item : headers) {
+    if (item.first.iequals(name)) {
+      return item.second;
+    }
+  }
+  return HttpSlice();
+}
+
+void HttpRequest::clear() {
+  method = target = path = query = body = HttpSlice();
+  version_minor = 1;
+  headers.clear();
+  keep_alive = true;
+}
+
+/**
+ * @brief 在Connection头的逗号分隔列表中查找token
+ */
+static bool has_token(HttpSlice value, const char *token) {
+  const char *p = value.data;
+  const char *end = value.data + value.size;
+  while (p < end) {
+    while (p < end && (is_ows(*p) || *p == ',')) {
+      ++p;
+    }
+    const char *start = p;
+    while (p < end && *p != ',') {
+      ++p;
+    }
+    const char *stop = p;
+    while (stop > start && is_ows(stop[-1])) {
+      --stop;
+    }
+    if (stop > start &&
+        HttpSlice(start, static_cast<size_t>(stop - start)).iequals(token)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void HttpParser::reset() {
+  scan_pos_ = 0;
+  header_len_ = 0;
+  body_len_ = 0;
+  error_status_ = 0;
+}
+
+HttpParser::Status HttpParser::parse(const char *data, size_t len,
+                                     HttpRequest *req) {
+  bool header_parsed = false;
+  if (header_len_ == 0) {
+    // 从上次扫描位置继续查找头部结束标记（回退3字节以覆盖跨次到达的分隔符）
+    size_t start = scan_pos_ >= 3 ? scan_pos_ - 3 : 0;
+    const char *end = nullptr;
+    if (len >= start + 4) {
+      end = static_cast<const char *>(
+          memmem(data + start, len - start, "\r\n\r\n", 4));
+    }
+    if (!end) {
+      scan_pos_ = len;
+      if (len > options_.max_header_size) {
+        return fail(431);
+      }
+      return Status::kIncomplete;
+    }
+
+    header_len_ = static_cast<size_t>(end - data) + 4;
+    if (header_len_ > options_.max_header_size) {
+      return fail(431);
+    }
+    if (!parse_header(data, req)) {
+      return Status::kError;
+    }
+    if (body_len_ > options_.max_body_size) {
+      return fail(413);
+    }
+    header_parsed = true;
+  }
+
+  if (len < header_len_ + body_len_) {
+    return Status::kIncomplete;
+  }
+  // 请求体跨多次到达时数据可能已被搬移，按新地址重新生成头部片段
+  if (!header_parsed && !parse_header(data, req)) {
+    return Status::kError;
+  }
+  req->body = HttpSlice(data + header_len_, body_len_);
+  return Status::kComplete;
+}
+
+bool HttpParser::parse_header(const char *data, HttpRequest *req) {
+  req->clear();
+  const char *p = data;
+  const char *end = data + header_len_ - 2; // 指向结尾空行
+
+  // ---------- 请求行：method SP target SP HTTP/1.x CRLF ----------
+  const char *method = p;
+  while (p < end && is_tchar(*p)) {
+    ++p;
+  }
+  if (p == method || p >= end || *p != ' ') {
+    error_status_ = 400;
+    return false;
+  }
+  req->method = HttpSlice(method, static_cast<size_t>(p - method));
+  ++p;
+
+  const char *target = p;
+  const char *query = nullptr;
+  while (p < end && *p != ' ') {
+    if (static_cast<unsigned char>(*p) <= 0x20 || *p == 0x7f) {
+      error_status_ = 400;
+      return false;
+    }
+    if (*p == '?' && !query) {
+      query = p;
+    }
+    ++p;
+  }
+  if (p == target || p >= end) {
+    error_status_ = 400;
+    return false;
+  }
+  req->target = HttpSlice(target, static_cast<size_t>(p - target));
+  if (query) {
+    req->path = HttpSlice(target, static_cast<size_t>(query - target));
+    req->query = HttpSlice(query + 1, static_cast<size_t>(p - query - 1));
+  } else {
+    req->path = req->target;
+  }
+  ++p;
+
+  if (end - p < 10 || std::memcmp(p, "HTTP/", 5) != 0) {
+    error_status_ = 400;
+    return false;
+  }
+  if (p[5] != '1' || p[6] != '.') {
+    error_status_ = (p[5] >= '2' && p[5] <= '9') ? 505 : 400;
+    return false;
+  }
+  if (p[7] < '0' || p[7] > '9' || p[8] != '\r' || p[9] != '\n') {
+    error_status_ = 400;
+    return false;
+  }
+  req->version_minor = p[7] - '0';
+  p += 10;
+
+  // ---------- 头部：name ":" OWS value OWS CRLF ----------
+  bool has_length = false;
+  bool conn_close = false;
+  bool conn_keep_alive = false;
+  body_len_ = 0;
+  while (p < end) {
+    const char *line_end =
+        static_cast<const char *>(std::memchr(p, '\r', end - p + 1));
+    if (!line_end || line_end[1] != '\n') {
+      error_status_ = 400;
+      return false;
+    }
+
+    const char *name = p;
+    while (p < line_end && is_tchar(*p)) {
+      ++p;
+    }
+    // 名字为空、名字后有空白或缺少冒号（含obs-fold续行）都视为非法
+    if (p == name || p >= line_end || *p != ':') {
+      error_status_ = 400;
+      return false;
+    }
+    HttpSlice key(name, static_cast<size_t>(p - name));
+    ++p;
+    while (p < line_end && is_ows(*p)) {
+      ++p;
+    }
+    const char *value_end = line_end;
+    while (value_end > p && is_ows(value_end[-1])) {
+      --value_end;
+    }
+    HttpSlice value(p, static_cast<size_t>(value_end - p));
+
+    if (req->headers.size() >= options_.max_headers) {
+      error_status_ = 431;
+      return false;
+    }
+    req->headers.emplace_back(key, value);
+
+    if (key.iequals("content-length")) {
+      if (value.empty()) {
+        error_status_ = 400;
+        return false;
+      }
+      size_t n = 0;
+      for (size_t i = 0; i < value.size; ++i) {
+        char c = value.data[i];
+        if (c < '0' || c > '9' || n > (SIZE_MAX - 9) / 10) {
+          error_status_ = 400;
+          return false;
+        }
+        n = n * 10 + static_cast<size_t>(c - '0');
+      }
+      // 重复且不一致的Content-Length可能导致请求走私
+      if (has_length && n != body_len_) {
+        error_status_ = 400;
+        return false;
+      }
+      has_length = true;
+      body_len_ = n;
+    } else if (key.iequals("transfer-encoding")) {
+      error_status_ = 501;
+      return false;
+    } else if (key.iequals("connection")) {
+      conn_close = conn_close || has_token(value, "close");
+      conn_keep_alive = conn_keep_alive || has_token(value, "keep-alive");
+    }
+
+    p = line_end + 2;
+  }
+
+  req->keep_alive =
+      req->version_minor >= 1 ? !conn_close : (conn_keep_alive && !conn_close);
+  return true;
+}
+
+} // namespace zcoroutine
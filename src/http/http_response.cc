@@ -0,0 +1,156 @@
+#include "http/http_response.h"
+
+#include <sys/uio.h>
+
+#include <cstdio>
+#include <ctime>
+
+namespace zcoroutine {
+
+/**
+ * @brief 当前时间的HTTP Date头值，每个线程每秒格式化一次
+ */
+static const char *http_date(size_t *len) {
+  static thread_local time_t t_last = 0;
+  static thread_local char t_buf[64];
+  static thread_local size_t t_len = 0;
+
+  time_t now = time(nullptr);
+  if (now != t_last) {
+    struct tm tm;
+    gmtime_r(&now, &tm);
+    t_len = strftime(t_buf, sizeof(t_buf), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+    t_last = now;
+  }
+  *len = t_len;
+  return t_buf;
+}
+
+static bool status_has_body(int status) {
+  return status >= 200 && status != 204 && status != 304;
+}
+
+const char *HttpResponse::reason_phrase(int status) {
+  switch (status) {
+  case 100: return "Continue";
+  case 200: return "OK";
+  case 201: return "Created";
+  case 202: return "Accepted";
+  case 204: return "No Content";
+  case 206: return "Partial Content";
+  case 301: return "Moved Permanently";
+  case 302: return "Found";
+  case 304: return "Not Modified";
+  case 400: return "Bad Request";
+  case 401: return "Unauthorized";
+  case 403: return "Forbidden";
+  case 404: return "Not Found";
+  case 405: return "Method Not Allowed";
+  case 408: return "Request Timeout";
+  case 411: return "Length Required";
+  case 413: return "Payload Too Large";
+  case 429: return "Too Many Requests";
+  case 431: return "Request Header Fields Too Large";
+  case 500: return "Internal Server Error";
+  case 501: return "Not Implemented";
+  case 502: return "Bad Gateway";
+  case 503: return "Service Unavailable";
+  case 505: return "HTTP Version Not Supported";
+  default: return "Unknown";
+  }
+}
+
+void HttpResponse::reset(int version_minor, bool keep_alive, bool head_only) {
+  status_ = 200;
+  version_minor_ = version_minor;
+  keep_alive_ = keep_alive;
+  head_only_ = head_only;
+  headers_sent_ = false;
+  chunked_ = false;
+  headers_.clear();
+  body_.clear();
+}
+
+int HttpResponse::send_head(long long content_length) {
+  head_.clear();
+  char line[64];
+  int n = snprintf(line, sizeof(line), "HTTP/1.%d %d ", version_minor_ >= 1 ? 1 : 0,
+                   status_);
+  head_.append(line, static_cast<size_t>(n));
+  head_.append(reason_phrase(status_));
+  head_.append("\r\n");
+
+  for (const auto &header : headers_) {
+    head_.append(header.first);
+    head_.append(": ");
+    head_.append(header.second);
+    head_.append("\r\n");
+  }
+
+  size_t date_len;
+  const char *date = http_date(&date_len);
+  head_.append("Date: ");
+  head_.append(date, date_len);
+  head_.append("\r\n");
+
+  if (content_length < 0) {
+    head_.append("Transfer-Encoding: chunked\r\n");
+  } else if (status_has_body(status_)) {
+    n = snprintf(line, sizeof(line), "Content-Length: %lld\r\n",
+                 content_length);
+    head_.append(line, static_cast<size_t>(n));
+  }
+
+  if (!keep_alive_) {
+    head_.append("Connection: close\r\n");
+  } else if (version_minor_ == 0) {
+    head_.append("Connection: keep-alive\r\n");
+  }
+  head_.append("\r\n");
+
+  headers_sent_ = true;
+  return stream_->write(head_.data(), head_.size()) < 0 ? -1 : 0;
+}
+
+int HttpResponse::write_chunk(const char *data, size_t len) {
+  // HTTP/1.0不支持分块编码，HEAD请求不发送响应体
+  if (version_minor_ == 0 || head_only_ || !status_has_body(status_)) {
+    append_body(data, len);
+    return 0;
+  }
+  if (!headers_sent_) {
+    chunked_ = true;
+    if (send_head(-1) != 0) {
+      return -1;
+    }
+  }
+  if (len == 0) {
+    return 0; // 空块会被当作结束块
+  }
+
+  char size_line[32];
+  int n = snprintf(size_line, sizeof(size_line), "%zx\r\n", len);
+  struct iovec iov[3];
+  iov[0].iov_base = size_line;
+  iov[0].iov_len = static_cast<size_t>(n);
+  iov[1].iov_base = const_cast<char *>(data);
+  iov[1].iov_len = len;
+  iov[2].iov_base = const_cast<char *>("\r\n");
+  iov[2].iov_len = 2;
+  return stream_->writev(iov, 3) < 0 ? -1 : 0;
+}
+
+int HttpResponse::finish() {
+  if (chunked_) {
+    return stream_->write("0\r\n\r\n", 5) < 0 ? -1 : 0;
+  }
+  if (send_head(static_cast<long long>(body_.size())) != 0) {
+    return -1;
+  }
+  if (head_only_ || !status_has_body(status_) || body_.empty()) {
+    return 0;
+  }
+  return stream_->write(body_.data(), body_.size()) < 0 ? -1 : 0;
+}
+
+} // namespace zcoroutine
@@ -0,0 +1,91 @@
+#include "http/http_router.h"
+
+#include <algorithm>
+
+namespace zcoroutine {
+
+void HttpRouter::add(const std::string &method, const std::string &path,
+                     Handler handler) {
+  exact_[path].push_back(MethodHandler{method, std::move(handler)});
+}
+
+void HttpRouter::add_prefix(const std::string &method,
+                            const std::string &prefix, Handler handler) {
+  auto it = std::find_if(
+      prefixes_.begin(), prefixes_.end(),
+      [&prefix](const PrefixRoute &route) { return route.prefix == prefix; });
+  if (it == prefixes_.end()) {
+    // 保持前缀长度降序，最长前缀优先匹配
+    it = std::find_if(prefixes_.begin(), prefixes_.end(),
+                      [&prefix](const PrefixRoute &route) {
+                        return route.prefix.size() < prefix.size();
+                      });
+    it = prefixes_.insert(it, PrefixRoute{prefix, HandlerList()});
+  }
+  it->handlers.push_back(MethodHandler{method, std::move(handler)});
+}
+
+const HttpRouter::Handler *
+HttpRouter::match_method(const HandlerList &handlers, const HttpSlice &method) {
+  for (const MethodHandler &item : handlers) {
+    if (item.method == "*" || method.equals(item.method.c_str())) {
+      return &item.handler;
+    }
+  }
+  // HEAD请求未单独注册时使用GET处理函数，响应体由服务器丢弃
+  if (method.equals("HEAD")) {
+    return match_method(handlers, HttpSlice("GET", 3));
+  }
+  return nullptr;
+}
+
+void HttpRouter::dispatch(const HttpRequest &req, HttpResponse &resp) const {
+  const HandlerList *matched = nullptr;
+
+  if (!exact_.empty()) {
+    // 复用线程局部的键，避免每个请求分配字符串
+    static thread_local std::string t_key;
+    t_key.assign(req.path.data, req.path.size);
+    auto it = exact_.find(t_key);
+    if (it != exact_.end()) {
+      matched = &it->second;
+    }
+  }
+  if (!matched) {
+    for (const PrefixRoute &route : prefixes_) {
+      if (req.path.size >= route.prefix.size() &&
+          std::equal(route.prefix.begin(), route.prefix.end(), req.path.data)) {
+        matched = &route.handlers;
+        break;
+      }
+    }
+  }
+
+  if (matched) {
+    const Handler *handler = match_method(*matched, req.method);
+    if (handler) {
+      (*handler)(req, resp);
+      return;
+    }
+    resp.set_status(405);
+    std::string allow;
+    for (const MethodHandler &item : *matched) {
+      if (!allow.empty()) {
+        allow.append(", ");
+      }
+      allow.append(item.method);
+    }
+    resp.set_header("Allow", std::move(allow));
+    return;
+  }
+
+  if (not_found_) {
+    not_found_(req, resp);
+    return;
+  }
+  resp.set_status(404);
+  resp.set_content_type("text/plain");
+  resp.set_body("Not Found");
+}
+
+} // namespace zcoroutine
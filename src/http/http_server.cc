@@ -0,0 +1,138 @@
+#include "http/http_server.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "io/status_table.h"
+#include "util/zcoroutine_logger.h"
+
+namespace zcoroutine {
+
+HttpServer::HttpServer(IoScheduler *scheduler, Options options)
+    : scheduler_(scheduler), options_(std::move(options)) {
+  // 读缓冲区必须能容纳一个最大的完整请求，解析器才能零拷贝地引用它
+  options_.stream.max_read_buffer_size =
+      std::max(options_.stream.max_read_buffer_size,
+               options_.parser.max_header_size + options_.parser.max_body_size);
+}
+
+HttpServer::~HttpServer() { stop(); }
+
+bool HttpServer::start(const std::string &ip, uint16_t port) {
+  if (running_.exchange(true)) {
+    return true;
+  }
+
+  std::weak_ptr<HttpServer> weak_self = shared_from_this();
+  acceptor_ = std::make_shared<TcpAcceptor>(
+      scheduler_, ip, port,
+      [weak_self](int fd) {
+        HttpServer::ptr self = weak_self.lock();
+        if (!self) {
+          close(fd);
+          return;
+        }
+        self->handle_connection(fd);
+      },
+      options_.acceptor);
+  if (!acceptor_->start()) {
+    running_ = false;
+    acceptor_.reset();
+    return false;
+  }
+
+  ZCOROUTINE_LOG_INFO("HttpServer started: addr={}:{}", ip, acceptor_->port());
+  return true;
+}
+
+void HttpServer::stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+  if (acceptor_) {
+    acceptor_->stop();
+  }
+  ZCOROUTINE_LOG_INFO("HttpServer stopped: requests={}, connections={}",
+                      requests_.load(std::memory_order_relaxed),
+                      connections_.load(std::memory_order_relaxed));
+}
+
+void HttpServer::send_error(SocketStream &stream, int status) {
+  HttpResponse resp(&stream);
+  resp.reset(1, false, false);
+  resp.set_status(status);
+  resp.set_content_type("text/plain");
+  resp.set_body(HttpResponse::reason_phrase(status));
+  resp.finish();
+}
+
+void HttpServer::handle_connection(int fd) {
+  connections_.fetch_add(1, std::memory_order_relaxed);
+
+  // 空闲连接的超时由hook的读超时实现，不需要额外的定时器
+  if (options_.keepalive_timeout_ms > 0) {
+    SocketStatus::ptr status = StatusTable::GetInstance()->get(fd);
+    if (status) {
+      status->set_timeout(SO_RCVTIMEO, options_.keepalive_timeout_ms);
+    }
+  }
+
+  SocketStream stream(fd, options_.stream);
+  HttpParser parser(options_.parser);
+  HttpRequest req;
+  HttpResponse resp(&stream);
+  size_t served = 0;
+
+  while (true) {
+    HttpParser::Status status = HttpParser::Status::kIncomplete;
+    if (stream.readable() > 0) {
+      size_t len = 0;
+      const char *data = stream.peek(&len);
+      if (len < stream.readable()) {
+        // 请求跨越环形缓冲区末尾，线性化后解析
+        len = stream.readable();
+        data = stream.peek_exact(len);
+      }
+      status = parser.parse(data, len, &req);
+    }
+
+    if (status == HttpParser::Status::kIncomplete) {
+      // 即将阻塞：fill()会先把流水线上已生成的响应一次发出
+      if (stream.fill() <= 0) {
+        break; // 对端关闭、空闲超时或出错
+      }
+      continue;
+    }
+
+    if (status == HttpParser::Status::kError) {
+      parse_errors_.fetch_add(1, std::memory_order_relaxed);
+      ZCOROUTINE_LOG_DEBUG("HttpServer bad request, fd={}, status={}", fd,
+                           parser.error_status());
+      send_error(stream, parser.error_status());
+      break;
+    }
+
+    ++served;
+    const bool keep_alive =
+        req.keep_alive && running_.load(std::memory_order_relaxed) &&
+        (options_.max_keepalive_requests == 0 ||
+         served < options_.max_keepalive_requests);
+    resp.reset(req.version_minor, keep_alive, req.method.equals("HEAD"));
+    router_.dispatch(req, resp);
+    int ret = resp.finish();
+
+    stream.consume(parser.consumed());
+    parser.reset();
+    requests_.fetch_add(1, std::memory_order_relaxed);
+    if (ret != 0 || !resp.keep_alive()) {
+      break;
+    }
+  }
+
+  stream.close();
+}
+
+} // namespace zcoroutine
@@ -6,6 +6,8 @@
 #include <unistd.h>
 
 #include "io/fd_context_table.h"
+#include "util/metrics.h"
+#include "util/tracer.h"
 #include "util/zcoroutine_logger.h"
 namespace zcoroutine {
 FdContext::ptr IoScheduler::get_fd_context(int fd, bool auto_create) {
@@ -148,6 +150,7 @@ int IoScheduler::add_event(int fd, FdContext::Event event,
     return -1;
   }
 
+  ZCOROUTINE_TRACE(kIoWait, event_ctx.fiber ? event_ctx.fiber->id() : 0, fd);
   ZCOROUTINE_LOG_DEBUG(
       "IoScheduler::add_event success, fd={}, event={}, new_events={}", fd,
       FdContext::event_to_string(event), new_events);
@@ -237,6 +240,11 @@ int IoScheduler::cancel_all(int fd) {
     return 0;
   }
 
+  // 没有注册的事件时fd不在epoll中（事件触发后已删除），无需DEL
+  if (fd_ctx->events() == FdContext::kNone) {
+    return 0;
+  }
+
   // 取消所有事件
   fd_ctx->cancel_all();
 
@@ -296,6 +304,7 @@ void IoScheduler::trigger_event(int fd, FdContext::Event event) {
   }
 
   del_event(fd_ctx->fd(), event);
+  ZCOROUTINE_TRACE(kIoReady, fiber ? fiber->id() : 0, fd);
 
   // 最后触发回调或调度协程（epoll已更新，回调中可以安全地重新注册）
   if (callback) {
@@ -346,6 +355,7 @@ void IoScheduler::io_thread_func() {
 
     // 等待IO事件
     int nfds = epoll_poller_->wait(timeout, events);
+    Metrics::inc(Counter::kEpollWaits);
 
     if (nfds < 0) {
       ZCOROUTINE_LOG_ERROR(
@@ -359,6 +369,7 @@ void IoScheduler::io_thread_func() {
       ++idle_count;
     } else {
       idle_count = 0; // 有事件时重置
+      Metrics::inc(Counter::kEpollEvents, static_cast<uint64_t>(nfds));
       ZCOROUTINE_LOG_DEBUG(
           "IoScheduler::io_thread_func epoll_wait returned nfds={}", nfds);
     }
@@ -381,23 +392,25 @@ void IoScheduler::io_thread_func() {
       auto *fd_ctx = static_cast<FdContext *>(ev.data.ptr);
       int fd = fd_ctx->fd();
 
-      if (ev.events & EPOLLIN) {
+      // 错误/挂断事件：唤醒已注册的读写等待者，每个事件只触发一次
+      // （对端关闭时EPOLLIN与EPOLLHUP通常同时出现）
+      uint32_t real_events = ev.events;
+      if (real_events & (EPOLLERR | EPOLLHUP)) {
+        ZCOROUTINE_LOG_DEBUG(
+            "IoScheduler::io_thread_func error/hup event, fd={}", fd);
+        real_events |= (EPOLLIN | EPOLLOUT) & fd_ctx->events();
+      }
+
+      if (real_events & EPOLLIN) {
         ZCOROUTINE_LOG_DEBUG(
             "IoScheduler::io_thread_func triggering READ event, fd={}", fd);
         trigger_event(fd, FdContext::kRead);
       }
-      if (ev.events & EPOLLOUT) {
+      if (real_events & EPOLLOUT) {
         ZCOROUTINE_LOG_DEBUG(
             "IoScheduler::io_thread_func triggering WRITE event, fd={}", fd);
         trigger_event(fd, FdContext::kWrite);
       }
-      if (ev.events & (EPOLLERR | EPOLLHUP)) {
-        ZCOROUTINE_LOG_WARN(
-            "IoScheduler::io_thread_func error/hup event, fd={}", fd);
-        // 错误事件，同时触发读写
-        trigger_event(fd, FdContext::kRead);
-        trigger_event(fd, FdContext::kWrite);
-      }
     }
 
     // 处理超时定时器
@@ -406,6 +419,8 @@ void IoScheduler::io_thread_func() {
       ZCOROUTINE_LOG_DEBUG(
           "IoScheduler::io_thread_func processing {} expired timers",
           expired_cbs.size());
+      ZCOROUTINE_TRACE(kTimerFire, 0, expired_cbs.size());
+      Metrics::inc(Counter::kTimersFired, expired_cbs.size());
     }
     for (const auto &cb : expired_cbs) {
       Scheduler::schedule(cb);
@@ -11,6 +11,10 @@ namespace zcoroutine {
 
 SocketStatus::SocketStatus(const int fd) : fd_(fd) { init(); }
 
+SocketStatus::SocketStatus(const int fd, const bool user_nonblock)
+    : is_init_(true), is_socket_(true), sys_nonblock_(true),
+      user_nonblock_(user_nonblock), fd_(fd) {}
+
 SocketStatus::~SocketStatus() = default;
 
 bool SocketStatus::init() {
@@ -95,17 +99,7 @@ SocketStatus::ptr StatusTable::get(int fd, bool auto_create) {
   }
 
   RWMutex::WriteLock lock(mutex_);
-
-  if (static_cast<size_t>(fd) >= fd_datas_.size()) {
-    const size_t old = fd_datas_.size();
-    // 计算新的容量
-    // 新的容量至少是当前fd+1，或者当前容量的1.5倍
-    size_t want = std::max(static_cast<size_t>(fd + 1), old + old / 2);
-    if (want <= old) {
-      want = static_cast<size_t>(fd + 1); // 则新的容量设为当前fd+1
-    }
-    fd_datas_.resize(want);
-  }
+  ensure_capacity(fd);
 
   if (!fd_datas_[fd] && auto_create) {
     fd_datas_[fd] = std::make_shared<SocketStatus>(fd);
@@ -114,6 +108,34 @@ SocketStatus::ptr StatusTable::get(int fd, bool auto_create) {
   return fd_datas_[fd];
 }
 
+SocketStatus::ptr StatusTable::add_socket(int fd, bool user_nonblock) {
+  if (fd < 0) {
+    return nullptr;
+  }
+
+  // 在锁外构造，缩短写锁持有时间
+  auto status = std::make_shared<SocketStatus>(fd, user_nonblock);
+
+  RWMutex::WriteLock lock(mutex_);
+  ensure_capacity(fd);
+  fd_datas_[fd] = status;
+  return status;
+}
+
+void StatusTable::ensure_capacity(int fd) {
+  if (static_cast<size_t>(fd) < fd_datas_.size()) {
+    return;
+  }
+  const size_t old = fd_datas_.size();
+  // 计算新的容量
+  // 新的容量至少是当前fd+1，或者当前容量的1.5倍
+  size_t want = std::max(static_cast<size_t>(fd + 1), old + old / 2);
+  if (want <= old) {
+    want = static_cast<size_t>(fd + 1); // 则新的容量设为当前fd+1
+  }
+  fd_datas_.resize(want);
+}
+
 void StatusTable::del(const int fd) {
   RWMutex::WriteLock lock(mutex_);
   if (fd >= 0 && static_cast<size_t>(fd) < fd_datas_.size()) {
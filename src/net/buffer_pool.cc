@@ -0,0 +1,74 @@
+#include "net/buffer_pool.h"
+
+#include <vector>
+
+namespace zcoroutine {
+
+constexpr size_t BufferPool::kMinPooledSize;
+constexpr size_t BufferPool::kMaxPooledSize;
+constexpr size_t BufferPool::kMaxCachedBytes;
+
+namespace {
+
+// 4KB, 8KB, 16KB, 32KB, 64KB
+constexpr int kClassCount = 5;
+
+int size_class(size_t capacity) {
+  if (capacity < BufferPool::kMinPooledSize ||
+      capacity > BufferPool::kMaxPooledSize ||
+      (capacity & (capacity - 1)) != 0) {
+    return -1;
+  }
+  int idx = 0;
+  for (size_t size = BufferPool::kMinPooledSize; size < capacity; size <<= 1) {
+    ++idx;
+  }
+  return idx;
+}
+
+// 线程退出后仍可能有缓冲区归还（例如静态对象析构），此时直接释放
+thread_local bool t_pool_destroyed = false;
+
+struct PoolCache {
+  std::vector<std::unique_ptr<char[]>> free_lists[kClassCount];
+  size_t cached_bytes = 0;
+
+  ~PoolCache() { t_pool_destroyed = true; }
+};
+
+thread_local PoolCache t_pool;
+
+} // namespace
+
+std::unique_ptr<char[]> BufferPool::acquire(size_t capacity) {
+  int idx = size_class(capacity);
+  if (idx >= 0 && !t_pool_destroyed) {
+    auto &list = t_pool.free_lists[idx];
+    if (!list.empty()) {
+      std::unique_ptr<char[]> buffer = std::move(list.back());
+      list.pop_back();
+      t_pool.cached_bytes -= capacity;
+      return buffer;
+    }
+  }
+  return std::unique_ptr<char[]>(new char[capacity]);
+}
+
+void BufferPool::release(std::unique_ptr<char[]> buffer, size_t capacity) {
+  if (!buffer) {
+    return;
+  }
+  int idx = size_class(capacity);
+  if (idx < 0 || t_pool_destroyed ||
+      t_pool.cached_bytes + capacity > kMaxCachedBytes) {
+    return; // buffer析构时释放
+  }
+  t_pool.free_lists[idx].push_back(std::move(buffer));
+  t_pool.cached_bytes += capacity;
+}
+
+size_t BufferPool::cached_bytes() {
+  return t_pool_destroyed ? 0 : t_pool.cached_bytes;
+}
+
+} // namespace zcoroutine
@@ -0,0 +1,531 @@
+#include "net/connection_pool.h"
+
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+#include "hook/hook.h"
+#include "io/status_table.h"
+#include "util/zcoroutine_logger.h"
+
+namespace zcoroutine {
+
+static uint64_t now_ms() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static uint64_t now_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static void *aligned_new(size_t size, size_t alignment) {
+  void *ptr = nullptr;
+  if (posix_memalign(&ptr, alignment, size) != 0) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+// ==================== Shard / Endpoint ====================
+
+void *ConnectionPool::Shard::operator new[](size_t size) {
+  return aligned_new(size, alignof(Shard));
+}
+
+void ConnectionPool::Shard::operator delete[](void *ptr) { free(ptr); }
+
+void *ConnectionPool::Endpoint::operator new(size_t size) {
+  return aligned_new(size, alignof(Endpoint));
+}
+
+void ConnectionPool::Endpoint::operator delete(void *ptr) { free(ptr); }
+
+// ==================== Connection ====================
+
+ConnectionPool::Connection::Connection(Connection &&other) noexcept
+    : pool_(std::move(other.pool_)), endpoint_(other.endpoint_),
+      fd_(other.fd_), reused_(other.reused_), reusable_(other.reusable_) {
+  other.endpoint_ = nullptr;
+  other.fd_ = -1;
+}
+
+ConnectionPool::Connection &
+ConnectionPool::Connection::operator=(Connection &&other) noexcept {
+  if (this != &other) {
+    release();
+    pool_ = std::move(other.pool_);
+    endpoint_ = other.endpoint_;
+    fd_ = other.fd_;
+    reused_ = other.reused_;
+    reusable_ = other.reusable_;
+    other.endpoint_ = nullptr;
+    other.fd_ = -1;
+  }
+  return *this;
+}
+
+void ConnectionPool::Connection::release() {
+  if (pool_ && fd_ >= 0) {
+    pool_->release(endpoint_, fd_, reusable_);
+  }
+  pool_.reset();
+  endpoint_ = nullptr;
+  fd_ = -1;
+}
+
+// ==================== ConnectionPool ====================
+
+ConnectionPool::ConnectionPool(IoScheduler *scheduler, Options options)
+    : scheduler_(scheduler), options_(options),
+      // 每个工作线程一个分片，另加一个给非工作线程
+      shard_count_(static_cast<size_t>(
+                       scheduler ? std::max(scheduler->thread_count(), 1) : 1) +
+                   1) {}
+
+ConnectionPool::~ConnectionPool() {
+  stop();
+  // 与stop()并发的归还可能仍留在handoff中
+  for (auto &item : endpoints_) {
+    close_handoff(item.second.get());
+  }
+}
+
+void ConnectionPool::start() {
+  if (sweep_timer_ || !scheduler_ || options_.sweep_interval_ms == 0) {
+    return;
+  }
+  std::weak_ptr<ConnectionPool> weak_self = shared_from_this();
+  sweep_timer_ = scheduler_->add_timer(
+      options_.sweep_interval_ms,
+      [weak_self]() {
+        ConnectionPool::ptr self = weak_self.lock();
+        if (self) {
+          self->sweep();
+        }
+      },
+      true);
+}
+
+void ConnectionPool::stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+  if (sweep_timer_) {
+    sweep_timer_->cancel();
+    sweep_timer_.reset();
+  }
+
+  // 关闭全部空闲连接并唤醒等待者（等待者醒来后返回ESHUTDOWN）
+  ReadLockGuard<RWMutex> guard(endpoints_mutex_);
+  for (auto &item : endpoints_) {
+    Endpoint *endpoint = item.second.get();
+    for (size_t i = 0; i < shard_count_; ++i) {
+      std::vector<IdleConnection> idle;
+      {
+        std::lock_guard<Spinlock> lock(endpoint->shards[i].lock);
+        idle.swap(endpoint->shards[i].idle);
+        endpoint->idle.fetch_sub(idle.size(), std::memory_order_relaxed);
+      }
+      for (const IdleConnection &conn : idle) {
+        close_connection(endpoint, conn.fd);
+      }
+    }
+    close_handoff(endpoint);
+    endpoint->waiters.notify_all();
+  }
+}
+
+void ConnectionPool::close_handoff(Endpoint *endpoint) {
+  std::vector<int> handoff;
+  {
+    std::lock_guard<Spinlock> lock(endpoint->wait_lock);
+    handoff.swap(endpoint->handoff);
+  }
+  for (int fd : handoff) {
+    close_connection(endpoint, fd);
+  }
+}
+
+ConnectionPool::Endpoint *ConnectionPool::get_endpoint(const std::string &ip,
+                                                       uint16_t port) {
+  std::string key = ip + ":" + std::to_string(port);
+  {
+    ReadLockGuard<RWMutex> guard(endpoints_mutex_);
+    auto it = endpoints_.find(key);
+    if (it != endpoints_.end()) {
+      return it->second.get();
+    }
+  }
+
+  struct sockaddr_in addr {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (inet_pton(AF_INET, ip.c_str(), &addr.sin_addr) != 1) {
+    ZCOROUTINE_LOG_ERROR("ConnectionPool invalid address: {}", ip);
+    return nullptr;
+  }
+
+  WriteLockGuard<RWMutex> guard(endpoints_mutex_);
+  std::unique_ptr<Endpoint> &slot = endpoints_[key];
+  if (!slot) {
+    slot.reset(new Endpoint());
+    slot->addr = addr;
+    slot->shards.reset(new Shard[shard_count_]);
+    ZCOROUTINE_LOG_DEBUG("ConnectionPool new endpoint {}", key);
+  }
+  return slot.get();
+}
+
+size_t ConnectionPool::shard_index() const {
+  int worker_id = Scheduler::get_worker_id();
+  if (worker_id >= 0 && Scheduler::get_this() == scheduler_ &&
+      static_cast<size_t>(worker_id) < shard_count_ - 1) {
+    return static_cast<size_t>(worker_id);
+  }
+  return shard_count_ - 1;
+}
+
+bool ConnectionPool::is_healthy(int fd) {
+  char c;
+  ssize_t n = recv_f(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+  if (n == 0) {
+    return false; // 对端已关闭
+  }
+  if (n > 0) {
+    return false; // 有未读数据，连接上的协议状态不可信
+  }
+  return errno == EAGAIN || errno == EWOULDBLOCK;
+}
+
+int ConnectionPool::take_idle(Endpoint *endpoint) {
+  if (endpoint->idle.load(std::memory_order_relaxed) == 0) {
+    return -1;
+  }
+
+  // 先查本线程分片，再依次窃取其他分片
+  const size_t self = shard_index();
+  for (size_t i = 0; i < shard_count_; ++i) {
+    Shard &shard = endpoint->shards[(self + i) % shard_count_];
+    while (true) {
+      int fd;
+      {
+        std::lock_guard<Spinlock> lock(shard.lock);
+        if (shard.idle.empty()) {
+          break;
+        }
+        // 后进先出：最近归还的连接最可能仍然有效
+        fd = shard.idle.back().fd;
+        shard.idle.pop_back();
+        endpoint->idle.fetch_sub(1, std::memory_order_relaxed);
+      }
+      if (is_healthy(fd)) {
+        return fd;
+      }
+      health_failures_.fetch_add(1, std::memory_order_relaxed);
+      close_connection(endpoint, fd);
+    }
+  }
+  return -1;
+}
+
+int ConnectionPool::connect_endpoint(Endpoint *endpoint) {
+  int fd = socket_f(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    ZCOROUTINE_LOG_ERROR("ConnectionPool socket failed, errno={}", errno);
+    return -1;
+  }
+  StatusTable::GetInstance()->add_socket(fd, false);
+
+  int yes = 1;
+  setsockopt_f(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+  if (connect_with_timeout(fd, reinterpret_cast<sockaddr *>(&endpoint->addr),
+                           sizeof(endpoint->addr),
+                           options_.connect_timeout_ms) != 0) {
+    int err = errno;
+    ZCOROUTINE_LOG_DEBUG("ConnectionPool connect failed, fd={}, errno={}", fd,
+                         err);
+    StatusTable::GetInstance()->del(fd);
+    close_f(fd);
+    errno = err;
+    return -1;
+  }
+  return fd;
+}
+
+ConnectionPool::Connection ConnectionPool::acquire(const std::string &ip,
+                                                   uint16_t port) {
+  if (!running_.load(std::memory_order_acquire)) {
+    errno = ESHUTDOWN;
+    return Connection();
+  }
+  Endpoint *endpoint = get_endpoint(ip, port);
+  if (!endpoint) {
+    errno = EINVAL;
+    return Connection();
+  }
+
+  uint64_t wait_start = 0;
+  auto finish_wait = [&]() {
+    if (wait_start) {
+      wait_time_us_.fetch_add(now_us() - wait_start, std::memory_order_relaxed);
+    }
+  };
+
+  while (true) {
+    if (!running_.load(std::memory_order_acquire)) {
+      finish_wait();
+      errno = ESHUTDOWN;
+      return Connection();
+    }
+
+    // 1. 复用空闲连接
+    int fd = take_idle(endpoint);
+    if (fd >= 0) {
+      finish_wait();
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return Connection(shared_from_this(), endpoint, fd, true);
+    }
+
+    // 2. 未达上限时占一个名额新建连接
+    size_t total = endpoint->total.load(std::memory_order_relaxed);
+    while (total < options_.max_connections) {
+      if (endpoint->total.compare_exchange_weak(total, total + 1,
+                                                std::memory_order_acq_rel)) {
+        finish_wait();
+        fd = connect_endpoint(endpoint);
+        if (fd < 0) {
+          int err = errno;
+          connect_failures_.fetch_add(1, std::memory_order_relaxed);
+          endpoint->total.fetch_sub(1, std::memory_order_acq_rel);
+          notify_waiter(endpoint);
+          errno = err;
+          return Connection();
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return Connection(shared_from_this(), endpoint, fd, false);
+      }
+    }
+
+    // 3. 连接耗尽：挂起协程等待归还或名额释放
+    uint64_t now = now_us();
+    if (!wait_start) {
+      wait_start = now;
+      waits_.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint64_t elapsed_ms = (now - wait_start) / 1000;
+    if (elapsed_ms >= options_.acquire_timeout_ms) {
+      finish_wait();
+      wait_timeouts_.fetch_add(1, std::memory_order_relaxed);
+      errno = ETIMEDOUT;
+      return Connection();
+    }
+
+    std::unique_lock<Spinlock> lock(endpoint->wait_lock);
+    // 持锁复查条件：通知方在修改状态后获取同一把锁，不会丢失唤醒
+    if (endpoint->handoff.empty()) {
+      if (endpoint->idle.load(std::memory_order_relaxed) > 0 ||
+          endpoint->total.load(std::memory_order_relaxed) <
+              options_.max_connections ||
+          !running_.load(std::memory_order_acquire)) {
+        continue;
+      }
+      if (!endpoint->waiters.wait(lock,
+                                  options_.acquire_timeout_ms - elapsed_ms) &&
+          endpoint->handoff.empty()) {
+        lock.unlock();
+        finish_wait();
+        wait_timeouts_.fetch_add(1, std::memory_order_relaxed);
+        errno = ETIMEDOUT;
+        return Connection();
+      }
+      if (endpoint->handoff.empty()) {
+        continue; // 名额释放或停止，重新竞争
+      }
+    }
+
+    // 取走归还方直接交出的连接
+    fd = endpoint->handoff.back();
+    endpoint->handoff.pop_back();
+    lock.unlock();
+    finish_wait();
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return Connection(shared_from_this(), endpoint, fd, true);
+  }
+}
+
+void ConnectionPool::release(Endpoint *endpoint, int fd, bool reusable) {
+  if (!reusable || !running_.load(std::memory_order_acquire)) {
+    close_connection(endpoint, fd);
+    return;
+  }
+
+  if (handoff(endpoint, fd)) {
+    return;
+  }
+
+  bool cached = false;
+  Shard &shard = endpoint->shards[shard_index()];
+  {
+    std::lock_guard<Spinlock> lock(shard.lock);
+    if (shard.idle.size() < options_.max_idle_per_worker) {
+      shard.idle.push_back(IdleConnection{fd, now_ms()});
+      endpoint->idle.fetch_add(1, std::memory_order_relaxed);
+      cached = true;
+    }
+  }
+  if (!cached) {
+    close_connection(endpoint, fd);
+    return;
+  }
+  notify_waiter(endpoint);
+}
+
+bool ConnectionPool::handoff(Endpoint *endpoint, int fd) {
+  std::unique_lock<Spinlock> lock(endpoint->wait_lock);
+  // 等待者在wait_lock下入队，这里看到的等待者不会漏掉
+  if (endpoint->waiters.waiter_count() == 0) {
+    return false;
+  }
+  endpoint->handoff.push_back(fd);
+  lock.unlock();
+  if (endpoint->waiters.notify_one()) {
+    return true;
+  }
+
+  // 等待者恰好全部超时：连接若仍未被取走则收回
+  lock.lock();
+  auto it = std::find(endpoint->handoff.begin(), endpoint->handoff.end(), fd);
+  if (it == endpoint->handoff.end()) {
+    return true;
+  }
+  endpoint->handoff.erase(it);
+  return false;
+}
+
+void ConnectionPool::close_connection(Endpoint *endpoint, int fd) {
+  StatusTable::GetInstance()->del(fd);
+  close_f(fd);
+  endpoint->total.fetch_sub(1, std::memory_order_acq_rel);
+  notify_waiter(endpoint);
+}
+
+void ConnectionPool::notify_waiter(Endpoint *endpoint) {
+  {
+    // 与等待方的条件复查同步
+    std::lock_guard<Spinlock> lock(endpoint->wait_lock);
+  }
+  endpoint->waiters.notify_one();
+}
+
+size_t ConnectionPool::sweep() {
+  const uint64_t now = now_ms();
+  size_t closed = 0;
+
+  ReadLockGuard<RWMutex> guard(endpoints_mutex_);
+  for (auto &item : endpoints_) {
+    Endpoint *endpoint = item.second.get();
+    for (size_t i = 0; i < shard_count_; ++i) {
+      Shard &shard = endpoint->shards[i];
+      std::vector<IdleConnection> candidates;
+      {
+        std::lock_guard<Spinlock> lock(shard.lock);
+        candidates.swap(shard.idle);
+        endpoint->idle.fetch_sub(candidates.size(), std::memory_order_relaxed);
+      }
+      if (candidates.empty()) {
+        continue;
+      }
+
+      // 健康检查是一次recv系统调用，在锁外进行，避免本分片的借出/归还一直自旋
+      std::vector<int> expired;
+      size_t unhealthy = 0;
+      auto keep = candidates.begin();
+      for (auto it = candidates.begin(); it != candidates.end(); ++it) {
+        if (now - it->since_ms >= options_.idle_timeout_ms) {
+          expired.push_back(it->fd);
+        } else if (!is_healthy(it->fd)) {
+          expired.push_back(it->fd);
+          ++unhealthy;
+        } else {
+          *keep++ = *it;
+        }
+      }
+      candidates.erase(keep, candidates.end());
+
+      // 放回健康的连接：扫描期间归还的连接更新，保持在队尾以维持后进先出；
+      // 超出分片上限的部分关闭最旧的
+      size_t restored = 0;
+      if (!candidates.empty()) {
+        std::lock_guard<Spinlock> lock(shard.lock);
+        size_t room = 0;
+        if (running_.load(std::memory_order_acquire) &&
+            shard.idle.size() < options_.max_idle_per_worker) {
+          room = options_.max_idle_per_worker - shard.idle.size();
+        }
+        restored = std::min(room, candidates.size());
+        const size_t surplus = candidates.size() - restored;
+        for (size_t j = 0; j < surplus; ++j) {
+          expired.push_back(candidates[j].fd);
+        }
+        shard.idle.insert(shard.idle.begin(), candidates.begin() + surplus,
+                          candidates.end());
+        endpoint->idle.fetch_add(restored, std::memory_order_relaxed);
+      }
+      if (restored > 0) {
+        // 扫描期间空闲数暂时为0，可能有借出方因此进入等待
+        notify_waiter(endpoint);
+      }
+      for (int fd : expired) {
+        close_connection(endpoint, fd);
+      }
+      evicted_.fetch_add(expired.size() - unhealthy,
+                         std::memory_order_relaxed);
+      health_failures_.fetch_add(unhealthy, std::memory_order_relaxed);
+      closed += expired.size();
+    }
+  }
+
+  if (closed > 0) {
+    ZCOROUTINE_LOG_DEBUG("ConnectionPool sweep closed {} idle connections",
+                         closed);
+  }
+  return closed;
+}
+
+ConnectionPool::Stats ConnectionPool::stats() const {
+  Stats stats;
+  stats.hits = hits_.load(std::memory_order_relaxed);
+  stats.misses = misses_.load(std::memory_order_relaxed);
+  stats.waits = waits_.load(std::memory_order_relaxed);
+  stats.wait_time_us = wait_time_us_.load(std::memory_order_relaxed);
+  stats.wait_timeouts = wait_timeouts_.load(std::memory_order_relaxed);
+  stats.connect_failures = connect_failures_.load(std::memory_order_relaxed);
+  stats.health_failures = health_failures_.load(std::memory_order_relaxed);
+  stats.evicted = evicted_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+size_t ConnectionPool::total_count(const std::string &ip, uint16_t port) {
+  Endpoint *endpoint = get_endpoint(ip, port);
+  return endpoint ? endpoint->total.load(std::memory_order_relaxed) : 0;
+}
+
+size_t ConnectionPool::idle_count(const std::string &ip, uint16_t port) {
+  Endpoint *endpoint = get_endpoint(ip, port);
+  return endpoint ? endpoint->idle.load(std::memory_order_relaxed) : 0;
+}
+
+} // namespace zcoroutine
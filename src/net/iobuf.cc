@@ -0,0 +1,448 @@
+#include "net/iobuf.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <unistd.h>
+
+#include <algorithm>
+#include <new>
+
+namespace zcoroutine {
+
+// 单次writev/readv使用的iovec上限：不超过IOV_MAX，同时限制协程栈占用
+static constexpr int kMaxIov = IOV_MAX < 256 ? IOV_MAX : 256;
+
+// 每个线程缓存的空闲块上限
+static constexpr size_t kMaxCachedBlocks = 64;
+
+// append_from_fd单次最多使用的新块数
+static constexpr int kMaxReadBlocks = 16;
+
+static std::atomic<size_t> s_live_blocks{0};
+
+namespace {
+
+inline bool is_internal(const IOBuf::Block *block) {
+  return block->data == reinterpret_cast<const char *>(block + 1);
+}
+
+void free_internal_block(IOBuf::Block *block) {
+  block->~Block();
+  ::operator delete(block);
+  s_live_blocks.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// 线程本地空闲块缓存
+// 线程退出后仍可能有块被释放（例如静态对象析构），此时直接释放
+thread_local bool t_cache_destroyed = false;
+
+struct BlockCache {
+  std::vector<IOBuf::Block *> blocks;
+
+  ~BlockCache() {
+    for (IOBuf::Block *block : blocks) {
+      free_internal_block(block);
+    }
+    blocks.clear();
+    t_cache_destroyed = true;
+  }
+};
+
+thread_local BlockCache t_block_cache;
+
+} // namespace
+
+IOBuf::Block *IOBuf::acquire_block() {
+  if (!t_cache_destroyed && !t_block_cache.blocks.empty()) {
+    Block *block = t_block_cache.blocks.back();
+    t_block_cache.blocks.pop_back();
+    block->ref.store(1, std::memory_order_relaxed);
+    block->size = 0;
+    return block;
+  }
+
+  void *mem = ::operator new(sizeof(Block) + kBlockSize);
+  Block *block = new (mem) Block();
+  block->capacity = static_cast<uint32_t>(kBlockSize);
+  block->data = reinterpret_cast<char *>(block + 1);
+  s_live_blocks.fetch_add(1, std::memory_order_relaxed);
+  return block;
+}
+
+void IOBuf::unref_block(Block *block) {
+  if (block->ref.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+
+  if (!is_internal(block)) {
+    if (block->deleter) {
+      block->deleter(block->user);
+    }
+    delete block;
+    return;
+  }
+
+  if (!t_cache_destroyed && t_block_cache.blocks.size() < kMaxCachedBlocks) {
+    t_block_cache.blocks.push_back(block);
+    return;
+  }
+  free_internal_block(block);
+}
+
+size_t IOBuf::cached_block_count() {
+  return t_cache_destroyed ? 0 : t_block_cache.blocks.size();
+}
+
+size_t IOBuf::live_block_count() {
+  return s_live_blocks.load(std::memory_order_relaxed);
+}
+
+IOBuf::IOBuf(const IOBuf &other) { append(other); }
+
+IOBuf &IOBuf::operator=(const IOBuf &other) {
+  if (this != &other) {
+    clear();
+    append(other);
+  }
+  return *this;
+}
+
+IOBuf &IOBuf::operator=(IOBuf &&other) noexcept {
+  if (this != &other) {
+    clear();
+    refs_ = std::move(other.refs_);
+    size_ = other.size_;
+    other.refs_.clear();
+    other.size_ = 0;
+  }
+  return *this;
+}
+
+void IOBuf::push_back_ref(const BlockRef &ref) {
+  if (ref.length == 0) {
+    unref_block(ref.block);
+    return;
+  }
+  // 与尾部引用相邻时合并，合并后多出的一份引用计数需要释放
+  if (!refs_.empty()) {
+    BlockRef &tail = refs_.back();
+    if (tail.block == ref.block && tail.offset + tail.length == ref.offset) {
+      tail.length += ref.length;
+      size_ += ref.length;
+      unref_block(ref.block);
+      return;
+    }
+  }
+  refs_.push_back(ref);
+  size_ += ref.length;
+}
+
+void IOBuf::append(const void *data, size_t len) {
+  const char *src = static_cast<const char *>(data);
+  while (len > 0) {
+    // 独占尾块且尾部引用恰好到达块的写入位置时，直接在块内追加
+    if (!refs_.empty()) {
+      BlockRef &tail = refs_.back();
+      Block *block = tail.block;
+      if (is_internal(block) && tail.offset + tail.length == block->size &&
+          block->size < block->capacity &&
+          block->ref.load(std::memory_order_acquire) == 1) {
+        size_t n = std::min(len, static_cast<size_t>(block->capacity - block->size));
+        memcpy(block->data + block->size, src, n);
+        block->size += static_cast<uint32_t>(n);
+        tail.length += static_cast<uint32_t>(n);
+        size_ += n;
+        src += n;
+        len -= n;
+        continue;
+      }
+    }
+
+    Block *block = acquire_block();
+    size_t n = std::min(len, static_cast<size_t>(block->capacity));
+    memcpy(block->data, src, n);
+    block->size = static_cast<uint32_t>(n);
+    refs_.push_back(BlockRef{block, 0, static_cast<uint32_t>(n)});
+    size_ += n;
+    src += n;
+    len -= n;
+  }
+}
+
+void IOBuf::append(const IOBuf &other) {
+  if (this == &other) {
+    IOBuf copy(other);
+    append(std::move(copy));
+    return;
+  }
+  for (const BlockRef &ref : other.refs_) {
+    ref_block(ref.block);
+    push_back_ref(ref);
+  }
+}
+
+void IOBuf::append(IOBuf &&other) {
+  if (this == &other) {
+    IOBuf copy(other);
+    append(std::move(copy));
+    return;
+  }
+  for (const BlockRef &ref : other.refs_) {
+    push_back_ref(ref);
+  }
+  other.refs_.clear();
+  other.size_ = 0;
+}
+
+void IOBuf::append_user_data(const void *data, size_t len,
+                             void (*deleter)(void *), void *user) {
+  if (len == 0) {
+    if (deleter) {
+      deleter(user);
+    }
+    return;
+  }
+  auto *block = new Block();
+  block->data = const_cast<char *>(static_cast<const char *>(data));
+  block->size = static_cast<uint32_t>(len);
+  block->capacity = static_cast<uint32_t>(len);
+  block->deleter = deleter;
+  block->user = user;
+  refs_.push_back(BlockRef{block, 0, static_cast<uint32_t>(len)});
+  size_ += len;
+}
+
+void IOBuf::prepend(const void *data, size_t len) {
+  if (len == 0) {
+    return;
+  }
+  IOBuf head;
+  head.append(data, len);
+  head.append(std::move(*this));
+  *this = std::move(head);
+}
+
+size_t IOBuf::cutn(IOBuf *out, size_t n) {
+  size_t cut = 0;
+  size_t whole = 0; // 整段移交的引用数
+  for (; whole < refs_.size() && cut < n; ++whole) {
+    BlockRef &ref = refs_[whole];
+    size_t want = n - cut;
+    if (ref.length > want) {
+      // 拆分：前半部分共享给out，后半部分留在本链
+      ref_block(ref.block);
+      out->push_back_ref(BlockRef{ref.block, ref.offset, static_cast<uint32_t>(want)});
+      ref.offset += static_cast<uint32_t>(want);
+      ref.length -= static_cast<uint32_t>(want);
+      cut += want;
+      break;
+    }
+    out->push_back_ref(ref);
+    cut += ref.length;
+  }
+  refs_.erase(refs_.begin(), refs_.begin() + whole);
+  size_ -= cut;
+  return cut;
+}
+
+IOBuf IOBuf::slice(size_t offset, size_t len) const {
+  IOBuf out;
+  for (const BlockRef &ref : refs_) {
+    if (len == 0) {
+      break;
+    }
+    if (offset >= ref.length) {
+      offset -= ref.length;
+      continue;
+    }
+    size_t n = std::min(len, static_cast<size_t>(ref.length) - offset);
+    ref_block(ref.block);
+    out.push_back_ref(BlockRef{ref.block, static_cast<uint32_t>(ref.offset + offset),
+                               static_cast<uint32_t>(n)});
+    offset = 0;
+    len -= n;
+  }
+  return out;
+}
+
+size_t IOBuf::pop_front(size_t n) {
+  size_t popped = 0;
+  size_t whole = 0;
+  for (; whole < refs_.size() && popped < n; ++whole) {
+    BlockRef &ref = refs_[whole];
+    size_t want = n - popped;
+    if (ref.length > want) {
+      ref.offset += static_cast<uint32_t>(want);
+      ref.length -= static_cast<uint32_t>(want);
+      popped += want;
+      break;
+    }
+    popped += ref.length;
+    unref_block(ref.block);
+  }
+  refs_.erase(refs_.begin(), refs_.begin() + whole);
+  size_ -= popped;
+  return popped;
+}
+
+size_t IOBuf::pop_back(size_t n) {
+  size_t popped = 0;
+  while (!refs_.empty() && popped < n) {
+    BlockRef &ref = refs_.back();
+    size_t want = n - popped;
+    if (ref.length > want) {
+      ref.length -= static_cast<uint32_t>(want);
+      popped += want;
+      break;
+    }
+    popped += ref.length;
+    unref_block(ref.block);
+    refs_.pop_back();
+  }
+  size_ -= popped;
+  return popped;
+}
+
+void IOBuf::clear() {
+  for (const BlockRef &ref : refs_) {
+    unref_block(ref.block);
+  }
+  refs_.clear();
+  size_ = 0;
+}
+
+size_t IOBuf::copy_to(void *buf, size_t n, size_t offset) const {
+  char *dst = static_cast<char *>(buf);
+  size_t copied = 0;
+  for (const BlockRef &ref : refs_) {
+    if (copied == n) {
+      break;
+    }
+    if (offset >= ref.length) {
+      offset -= ref.length;
+      continue;
+    }
+    size_t len = std::min(n - copied, static_cast<size_t>(ref.length) - offset);
+    memcpy(dst + copied, ref.block->data + ref.offset + offset, len);
+    copied += len;
+    offset = 0;
+  }
+  return copied;
+}
+
+std::string IOBuf::to_string() const {
+  std::string out(size_, '\0');
+  copy_to(&out[0], size_);
+  return out;
+}
+
+int IOBuf::fill_iovec(struct iovec *iov, int max_iov) const {
+  int cnt = 0;
+  for (const BlockRef &ref : refs_) {
+    if (cnt >= max_iov) {
+      break;
+    }
+    iov[cnt].iov_base = ref.block->data + ref.offset;
+    iov[cnt].iov_len = ref.length;
+    ++cnt;
+  }
+  return cnt;
+}
+
+ssize_t IOBuf::cut_into_fd(int fd) {
+  if (empty()) {
+    return 0;
+  }
+  struct iovec iov[kMaxIov];
+  int cnt = fill_iovec(iov, kMaxIov);
+
+  ssize_t n;
+  do {
+    n = ::writev(fd, iov, cnt);
+  } while (n < 0 && errno == EINTR);
+
+  if (n > 0) {
+    pop_front(static_cast<size_t>(n));
+  }
+  return n;
+}
+
+int IOBuf::write_all(int fd) {
+  while (!empty()) {
+    if (cut_into_fd(fd) < 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+ssize_t IOBuf::append_from_fd(int fd, size_t max_count) {
+  struct iovec iov[kMaxReadBlocks + 1];
+  Block *blocks[kMaxReadBlocks];
+  int cnt = 0;
+  int new_blocks = 0;
+  size_t space = 0;
+
+  // 先利用独占尾块的剩余空间
+  bool use_tail = false;
+  if (!refs_.empty()) {
+    BlockRef &tail = refs_.back();
+    Block *block = tail.block;
+    if (is_internal(block) && tail.offset + tail.length == block->size &&
+        block->size < block->capacity &&
+        block->ref.load(std::memory_order_acquire) == 1) {
+      size_t n = std::min(max_count, static_cast<size_t>(block->capacity - block->size));
+      iov[cnt].iov_base = block->data + block->size;
+      iov[cnt].iov_len = n;
+      ++cnt;
+      space += n;
+      use_tail = true;
+    }
+  }
+
+  // 不足部分从块池取新块
+  while (space < max_count && new_blocks < kMaxReadBlocks) {
+    Block *block = acquire_block();
+    size_t n = std::min(max_count - space, static_cast<size_t>(block->capacity));
+    blocks[new_blocks++] = block;
+    iov[cnt].iov_base = block->data;
+    iov[cnt].iov_len = n;
+    ++cnt;
+    space += n;
+  }
+
+  ssize_t ret;
+  do {
+    ret = ::readv(fd, iov, cnt);
+  } while (ret < 0 && errno == EINTR);
+
+  size_t left = ret > 0 ? static_cast<size_t>(ret) : 0;
+  int i = 0;
+  if (use_tail) {
+    size_t n = std::min(left, iov[0].iov_len);
+    if (n > 0) {
+      BlockRef &tail = refs_.back();
+      tail.block->size += static_cast<uint32_t>(n);
+      tail.length += static_cast<uint32_t>(n);
+      size_ += n;
+      left -= n;
+    }
+    i = 1;
+  }
+  for (int b = 0; b < new_blocks; ++b, ++i) {
+    size_t n = std::min(left, iov[i].iov_len);
+    if (n == 0) {
+      // 未使用的块归还块池
+      unref_block(blocks[b]);
+      continue;
+    }
+    blocks[b]->size = static_cast<uint32_t>(n);
+    refs_.push_back(BlockRef{blocks[b], 0, static_cast<uint32_t>(n)});
+    size_ += n;
+    left -= n;
+  }
+  return ret;
+}
+
+} // namespace zcoroutine
@@ -0,0 +1,181 @@
+#include "net/ring_buffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "net/buffer_pool.h"
+
+namespace zcoroutine {
+
+// 向上取整为2的幂
+static size_t round_up_pow2(size_t n) {
+  size_t cap = 1;
+  while (cap < n) {
+    cap <<= 1;
+  }
+  return cap;
+}
+
+RingBuffer::RingBuffer(size_t initial_capacity) {
+  if (initial_capacity > 0) {
+    capacity_ = round_up_pow2(initial_capacity);
+    data_ = BufferPool::acquire(capacity_);
+  }
+}
+
+RingBuffer::~RingBuffer() { BufferPool::release(std::move(data_), capacity_); }
+
+RingBuffer::RingBuffer(RingBuffer &&other) noexcept
+    : data_(std::move(other.data_)), capacity_(other.capacity_),
+      read_pos_(other.read_pos_), write_pos_(other.write_pos_) {
+  other.capacity_ = 0;
+  other.read_pos_ = other.write_pos_ = 0;
+}
+
+RingBuffer &RingBuffer::operator=(RingBuffer &&other) noexcept {
+  if (this != &other) {
+    BufferPool::release(std::move(data_), capacity_);
+    data_ = std::move(other.data_);
+    capacity_ = other.capacity_;
+    read_pos_ = other.read_pos_;
+    write_pos_ = other.write_pos_;
+    other.capacity_ = 0;
+    other.read_pos_ = other.write_pos_ = 0;
+  }
+  return *this;
+}
+
+const char *RingBuffer::peek(size_t *len) const {
+  const size_t n = size();
+  if (n == 0) {
+    *len = 0;
+    return nullptr;
+  }
+  const size_t head = mask(read_pos_);
+  *len = std::min(n, capacity_ - head);
+  return data_.get() + head;
+}
+
+int RingBuffer::readable_segments(struct iovec *iov) const {
+  const size_t n = size();
+  if (n == 0) {
+    return 0;
+  }
+  const size_t head = mask(read_pos_);
+  const size_t first = std::min(n, capacity_ - head);
+  iov[0].iov_base = data_.get() + head;
+  iov[0].iov_len = first;
+  if (first == n) {
+    return 1;
+  }
+  iov[1].iov_base = data_.get();
+  iov[1].iov_len = n - first;
+  return 2;
+}
+
+int RingBuffer::writable_segments(struct iovec *iov) {
+  const size_t n = writable();
+  if (n == 0) {
+    return 0;
+  }
+  const size_t tail = mask(write_pos_);
+  const size_t first = std::min(n, capacity_ - tail);
+  iov[0].iov_base = data_.get() + tail;
+  iov[0].iov_len = first;
+  if (first == n) {
+    return 1;
+  }
+  iov[1].iov_base = data_.get();
+  iov[1].iov_len = n - first;
+  return 2;
+}
+
+const char *RingBuffer::linearize(size_t n) {
+  if (n > size()) {
+    return nullptr;
+  }
+  const size_t head = mask(read_pos_);
+  if (head + n <= capacity_) {
+    return data_.get() + head;
+  }
+
+  // 数据跨越环尾：整体旋转，使读位置回到0
+  const size_t len = size();
+  std::rotate(data_.get(), data_.get() + head, data_.get() + capacity_);
+  read_pos_ = 0;
+  write_pos_ = len;
+  return data_.get();
+}
+
+void RingBuffer::consume(size_t n) {
+  assert(n <= size());
+  read_pos_ += n;
+  // 读空时回到起点，让后续数据尽量连续
+  if (read_pos_ == write_pos_) {
+    read_pos_ = write_pos_ = 0;
+  }
+}
+
+void RingBuffer::commit(size_t n) {
+  assert(n <= writable());
+  write_pos_ += n;
+}
+
+void RingBuffer::append(const void *data, size_t len) {
+  if (len == 0) {
+    return;
+  }
+  reserve(len);
+  struct iovec iov[2];
+  int cnt = writable_segments(iov);
+  const char *src = static_cast<const char *>(data);
+  size_t left = len;
+  for (int i = 0; i < cnt && left > 0; ++i) {
+    size_t n = std::min(left, iov[i].iov_len);
+    memcpy(iov[i].iov_base, src, n);
+    src += n;
+    left -= n;
+  }
+  write_pos_ += len;
+}
+
+size_t RingBuffer::read(void *buf, size_t len) {
+  struct iovec iov[2];
+  int cnt = readable_segments(iov);
+  char *dst = static_cast<char *>(buf);
+  size_t copied = 0;
+  for (int i = 0; i < cnt && copied < len; ++i) {
+    size_t n = std::min(len - copied, iov[i].iov_len);
+    memcpy(dst + copied, iov[i].iov_base, n);
+    copied += n;
+  }
+  consume(copied);
+  return copied;
+}
+
+void RingBuffer::reserve(size_t n) {
+  if (writable() >= n) {
+    return;
+  }
+  grow(round_up_pow2(size() + n));
+}
+
+void RingBuffer::release() {
+  assert(empty());
+  BufferPool::release(std::move(data_), capacity_);
+  capacity_ = 0;
+  read_pos_ = write_pos_ = 0;
+}
+
+void RingBuffer::grow(size_t new_capacity) {
+  std::unique_ptr<char[]> data = BufferPool::acquire(new_capacity);
+  const size_t len = read(data.get(), size());
+  BufferPool::release(std::move(data_), capacity_);
+  data_ = std::move(data);
+  capacity_ = new_capacity;
+  read_pos_ = 0;
+  write_pos_ = len;
+}
+
+} // namespace zcoroutine
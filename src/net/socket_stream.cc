@@ -0,0 +1,277 @@
+#include "net/socket_stream.h"
+
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "hook/hook.h"
+#include "io/io_scheduler.h"
+#include "io/status_table.h"
+#include "runtime/fiber.h"
+#include "util/zcoroutine_logger.h"
+
+namespace zcoroutine {
+
+// 单次writev组装的iovec上限（写缓冲区两段 + 用户数据）
+static constexpr int kMaxIov = 64;
+
+SocketStream::SocketStream(int fd, Options options)
+    : fd_(fd), options_(options), read_buf_(0),
+      write_buf_(options.write_buffer_size) {
+  // hook创建的socket在内核层面一定是非阻塞的，可以先试读再决定是否挂起
+  SocketStatus::ptr status = StatusTable::GetInstance()->get(fd);
+  sys_nonblock_ = status && status->get_sys_nonblock();
+}
+
+SocketStream::~SocketStream() {
+  if (!is_closed()) {
+    close();
+  }
+}
+
+ssize_t SocketStream::read_into_buffer(bool nonblock) {
+  struct iovec iov[2];
+  int cnt = read_buf_.writable_segments(iov);
+  ssize_t n;
+  do {
+    ++read_syscalls_;
+    // 非阻塞试读直接调用原始readv，避免hook在EAGAIN时挂起协程
+    n = nonblock ? readv_f(fd_, iov, cnt) : ::readv(fd_, iov, cnt);
+  } while (n < 0 && errno == EINTR);
+
+  if (n > 0) {
+    read_buf_.commit(static_cast<size_t>(n));
+  }
+  return n;
+}
+
+ssize_t SocketStream::fill() {
+  if (is_closed()) {
+    errno = EBADF;
+    return -1;
+  }
+
+  // 保证有足够的可写空间，避免小块读取
+  if (read_buf_.writable() < options_.read_buffer_size / 2 &&
+      read_buf_.size() + options_.read_buffer_size <=
+          options_.max_read_buffer_size) {
+    read_buf_.reserve(options_.read_buffer_size);
+  }
+  if (read_buf_.writable() == 0) {
+    errno = ENOBUFS;
+    return -1;
+  }
+
+  // 有待发送数据时先试读：数据已到达则继续处理，不打断cork
+  bool tried = false;
+  if (write_buf_.size() > 0) {
+    if (sys_nonblock_) {
+      ssize_t n = read_into_buffer(true);
+      if (n >= 0 || errno != EAGAIN) {
+        return n;
+      }
+      tried = true;
+    }
+    // 即将挂起等待数据，这是让出点：先把聚合的响应发出去
+    if (flush() != 0) {
+      return -1;
+    }
+  }
+
+  // 空闲等待：确认没有数据后归还缓冲区再挂起
+  if (options_.idle_park && read_buf_.empty() && can_idle_park()) {
+    if (!tried) {
+      ssize_t n = read_into_buffer(true);
+      if (n >= 0 || errno != EAGAIN) {
+        return n;
+      }
+    }
+    if (park_idle() != 0) {
+      return -1;
+    }
+  }
+
+  return read_into_buffer(false);
+}
+
+bool SocketStream::can_idle_park() const {
+  if (!sys_nonblock_ || !is_hook_enabled() || !IoScheduler::get_this()) {
+    return false;
+  }
+  // 设置了读超时的fd交给hook处理超时
+  SocketStatus::ptr status = StatusTable::GetInstance()->get(fd_);
+  if (!status) {
+    return false;
+  }
+  uint64_t timeout = status->get_timeout(SO_RCVTIMEO);
+  return timeout == 0 || timeout == static_cast<uint64_t>(-1);
+}
+
+int SocketStream::park_idle() {
+  read_buf_.release();
+  write_buf_.release();
+  Fiber::ptr fiber = Fiber::get_this();
+  if (fiber && fiber->is_shared_stack()) {
+    fiber->get_shared_context()->request_compact();
+  }
+  ++idle_parks_;
+
+  if (IoScheduler::get_this()->add_event(fd_, FdContext::kRead) != 0) {
+    ZCOROUTINE_LOG_ERROR("SocketStream idle park add_event failed, fd={}", fd_);
+    return -1;
+  }
+  Fiber::yield();
+  set_hook_enable(true); // 可能在另一个工作线程上恢复
+
+  read_buf_.reserve(options_.read_buffer_size);
+  return 0;
+}
+
+const char *SocketStream::peek_exact(size_t n) {
+  while (read_buf_.size() < n) {
+    if (fill() <= 0) {
+      return nullptr;
+    }
+  }
+  return read_buf_.linearize(n);
+}
+
+ssize_t SocketStream::read(void *buf, size_t len) {
+  if (len == 0) {
+    return 0;
+  }
+  if (read_buf_.empty()) {
+    ssize_t n = fill();
+    if (n <= 0) {
+      return n;
+    }
+  }
+  return static_cast<ssize_t>(read_buf_.read(buf, len));
+}
+
+bool SocketStream::read_exact(void *buf, size_t len) {
+  char *dst = static_cast<char *>(buf);
+  size_t got = 0;
+  while (got < len) {
+    ssize_t n = read(dst + got, len - got);
+    if (n <= 0) {
+      return false;
+    }
+    got += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+ssize_t SocketStream::write(const void *buf, size_t len) {
+  struct iovec iov;
+  iov.iov_base = const_cast<void *>(buf);
+  iov.iov_len = len;
+  return writev(&iov, 1);
+}
+
+ssize_t SocketStream::writev(const struct iovec *iov, int iovcnt) {
+  if (is_closed()) {
+    errno = EBADF;
+    return -1;
+  }
+
+  size_t total = 0;
+  for (int i = 0; i < iovcnt; ++i) {
+    total += iov[i].iov_len;
+  }
+
+  // 未达到阈值：聚合到写缓冲区，等待让出点统一发送
+  if (write_buf_.size() + total < options_.cork_threshold) {
+    for (int i = 0; i < iovcnt; ++i) {
+      write_buf_.append(iov[i].iov_base, iov[i].iov_len);
+    }
+    return static_cast<ssize_t>(total);
+  }
+
+  // 达到阈值：缓冲区数据与本次数据一起writev，大块数据不经过拷贝
+  if (write_all(iov, iovcnt) != 0) {
+    return -1;
+  }
+  return static_cast<ssize_t>(total);
+}
+
+int SocketStream::flush() {
+  if (write_buf_.empty()) {
+    return 0;
+  }
+  if (is_closed()) {
+    errno = EBADF;
+    return -1;
+  }
+  return write_all(nullptr, 0);
+}
+
+int SocketStream::write_all(const struct iovec *extra, int extra_cnt) {
+  int extra_idx = 0;    // 当前未写完的额外数据段
+  size_t extra_off = 0; // 当前段内已写出的偏移
+
+  while (!write_buf_.empty() || extra_idx < extra_cnt) {
+    struct iovec iov[kMaxIov];
+    int cnt = write_buf_.readable_segments(iov);
+    for (int i = extra_idx; i < extra_cnt && cnt < kMaxIov; ++i) {
+      size_t off = i == extra_idx ? extra_off : 0;
+      if (extra[i].iov_len == off) {
+        continue;
+      }
+      iov[cnt].iov_base = static_cast<char *>(extra[i].iov_base) + off;
+      iov[cnt].iov_len = extra[i].iov_len - off;
+      ++cnt;
+    }
+    if (cnt == 0) {
+      break;
+    }
+
+    ssize_t n;
+    do {
+      ++write_syscalls_;
+      n = ::writev(fd_, iov, cnt);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+      ZCOROUTINE_LOG_DEBUG("SocketStream writev failed, fd={}, errno={}", fd_,
+                           errno);
+      return -1;
+    }
+
+    // 先消费写缓冲区，再推进额外数据
+    size_t written = static_cast<size_t>(n);
+    size_t from_buf = std::min(written, write_buf_.size());
+    write_buf_.consume(from_buf);
+    written -= from_buf;
+    while (written > 0 && extra_idx < extra_cnt) {
+      size_t left = extra[extra_idx].iov_len - extra_off;
+      if (written >= left) {
+        written -= left;
+        ++extra_idx;
+        extra_off = 0;
+      } else {
+        extra_off += written;
+        written = 0;
+      }
+    }
+    // 跳过空段
+    while (extra_idx < extra_cnt && extra[extra_idx].iov_len == extra_off) {
+      ++extra_idx;
+      extra_off = 0;
+    }
+  }
+  return 0;
+}
+
+int SocketStream::close() {
+  if (is_closed()) {
+    return 0;
+  }
+  flush();
+  int ret = ::close(fd_);
+  fd_ = -1;
+  return ret;
+}
+
+} // namespace zcoroutine
@@ -0,0 +1,219 @@
+#include "net/tcp_acceptor.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <utility>
+
+#include "hook/hook.h"
+#include "io/status_table.h"
+#include "runtime/fiber_pool.h"
+#include "util/thread_context.h"
+#include "util/zcoroutine_logger.h"
+
+namespace zcoroutine {
+
+// 连接fd在内核层面的标志，与hook创建的socket保持一致
+static constexpr int kAcceptFlags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+
+// fd耗尽等资源错误时的退避时间（微秒）
+static constexpr useconds_t kAcceptBackoffUs = 10 * 1000;
+
+TcpAcceptor::TcpAcceptor(IoScheduler *scheduler, std::string ip, uint16_t port,
+                         ConnectionHandler handler, Options options)
+    : scheduler_(scheduler), ip_(std::move(ip)), port_(port),
+      handler_(std::move(handler)), options_(options) {}
+
+TcpAcceptor::~TcpAcceptor() {
+  stop();
+  // accept协程持有自身引用，析构时它们都已退出，可以安全关闭监听fd
+  for (int fd : listen_fds_) {
+    close_f(fd);
+  }
+}
+
+int TcpAcceptor::create_listener() {
+  int fd = socket_f(AF_INET, SOCK_STREAM | kAcceptFlags, 0);
+  if (fd < 0) {
+    ZCOROUTINE_LOG_ERROR("TcpAcceptor socket failed, errno={}", errno);
+    return -1;
+  }
+
+  int yes = 1;
+  setsockopt_f(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+  if (options_.reuse_port &&
+      setsockopt_f(fd, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes)) != 0) {
+    ZCOROUTINE_LOG_ERROR("TcpAcceptor SO_REUSEPORT failed, fd={}, errno={}",
+                         fd, errno);
+    close_f(fd);
+    return -1;
+  }
+
+  struct sockaddr_in addr {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port_);
+  if (inet_pton(AF_INET, ip_.c_str(), &addr.sin_addr) != 1) {
+    ZCOROUTINE_LOG_ERROR("TcpAcceptor invalid address: {}", ip_);
+    close_f(fd);
+    return -1;
+  }
+
+  if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+      listen(fd, options_.backlog) != 0) {
+    ZCOROUTINE_LOG_ERROR("TcpAcceptor bind/listen failed, addr={}:{}, errno={}",
+                         ip_, port_, errno);
+    close_f(fd);
+    return -1;
+  }
+
+  // 端口为0时，后续监听socket复用第一个分配到的端口
+  if (port_ == 0) {
+    socklen_t len = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+  }
+  return fd;
+}
+
+bool TcpAcceptor::start() {
+  if (!scheduler_ || !handler_) {
+    ZCOROUTINE_LOG_ERROR("TcpAcceptor start failed: scheduler or handler null");
+    return false;
+  }
+  if (running_.load(std::memory_order_acquire)) {
+    ZCOROUTINE_LOG_WARN("TcpAcceptor already started, port={}", port_);
+    return true;
+  }
+
+  int count = options_.listener_count > 0 ? options_.listener_count
+                                          : scheduler_->thread_count();
+  // 不使用SO_REUSEPORT时只能有一个监听socket
+  if (!options_.reuse_port || count < 1) {
+    count = 1;
+  }
+
+  for (int i = 0; i < count; ++i) {
+    int fd = create_listener();
+    if (fd < 0) {
+      for (int opened : listen_fds_) {
+        close_f(opened);
+      }
+      listen_fds_.clear();
+      return false;
+    }
+    listen_fds_.push_back(fd);
+  }
+
+  running_.store(true, std::memory_order_release);
+
+  // 每个监听socket一个常驻accept协程，协程持有自身引用保证生命周期
+  auto self = shared_from_this();
+  for (int fd : listen_fds_) {
+    scheduler_->schedule(std::make_shared<Fiber>(
+        [self, fd]() { self->accept_loop(fd); },
+        StackAllocator::kDefaultStackSize, "acceptor"));
+  }
+
+  ZCOROUTINE_LOG_INFO("TcpAcceptor started: addr={}:{}, listeners={}", ip_,
+                      port_, listen_fds_.size());
+  return true;
+}
+
+void TcpAcceptor::stop() {
+  bool expected = true;
+  if (!running_.compare_exchange_strong(expected, false,
+                                        std::memory_order_acq_rel)) {
+    return;
+  }
+
+  // shutdown使监听socket变为可读且accept返回EINVAL，
+  // 正在等待的accept协程会被唤醒并退出，无需与add_event竞争
+  for (int fd : listen_fds_) {
+    shutdown(fd, SHUT_RDWR);
+  }
+
+  ZCOROUTINE_LOG_INFO("TcpAcceptor stopping: addr={}:{}, accepted={}", ip_,
+                      port_, accepted_.load(std::memory_order_relaxed));
+}
+
+void TcpAcceptor::accept_loop(int listen_fd) {
+  // 连接处理协程依赖hook提供阻塞语义
+  set_hook_enable(true);
+
+  while (running_.load(std::memory_order_acquire)) {
+    int fd = accept4_f(listen_fd, nullptr, nullptr, kAcceptFlags);
+    if (fd >= 0) {
+      accepted_.fetch_add(1, std::memory_order_relaxed);
+      dispatch(fd);
+      continue;
+    }
+
+    if (errno == EINTR || errno == ECONNABORTED) {
+      continue;
+    }
+
+    if (errno == EAGAIN) {
+      // backlog已清空，注册一次可读事件后让出
+      waits_.fetch_add(1, std::memory_order_relaxed);
+      if (scheduler_->add_event(listen_fd, FdContext::kRead) != 0) {
+        ZCOROUTINE_LOG_ERROR("TcpAcceptor add_event failed, listen_fd={}",
+                             listen_fd);
+        break;
+      }
+      Fiber::yield();
+      continue;
+    }
+
+    if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS ||
+        errno == ENOMEM) {
+      ZCOROUTINE_LOG_WARN("TcpAcceptor accept4 resource error, listen_fd={}, "
+                          "errno={}, backing off",
+                          listen_fd, errno);
+      usleep(kAcceptBackoffUs);
+      continue;
+    }
+
+    // stop() 中的shutdown会使accept4返回EINVAL
+    if (running_.load(std::memory_order_acquire)) {
+      ZCOROUTINE_LOG_ERROR("TcpAcceptor accept4 failed, listen_fd={}, errno={}",
+                           listen_fd, errno);
+    }
+    break;
+  }
+
+  scheduler_->cancel_all(listen_fd);
+  ZCOROUTINE_LOG_DEBUG("TcpAcceptor accept loop exited, listen_fd={}",
+                       listen_fd);
+}
+
+void TcpAcceptor::dispatch(int fd) {
+  // 内核已按非阻塞创建，直接登记元数据，用户视角为阻塞模式
+  StatusTable::GetInstance()->add_socket(fd, false);
+
+  auto self = shared_from_this();
+  auto func = [self, fd]() {
+    set_hook_enable(true);
+    self->handler_(fd);
+  };
+
+  const bool shared = ThreadContext::get_stack_mode() == StackMode::kShared;
+  Fiber::ptr fiber = FiberPool::get_instance().get_fiber(
+      std::move(func), options_.stack_size, "conn", shared);
+
+  if (!options_.inline_dispatch) {
+    scheduler_->schedule(std::move(fiber));
+    return;
+  }
+
+  // 直接在当前线程运行，连接协程第一次阻塞时切回accept协程
+  fiber->resume();
+  if (fiber->state() == Fiber::State::kTerminated) {
+    FiberPool::get_instance().return_fiber(fiber);
+  }
+}
+
+} // namespace zcoroutine
@@ -0,0 +1,248 @@
+#include "rpc/rpc_channel.h"
+
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "hook/hook.h"
+#include "runtime/fiber.h"
+#include "util/zcoroutine_logger.h"
+
+namespace zcoroutine {
+
+constexpr uint64_t RpcChannel::kDefaultTimeout;
+
+static uint64_t now_ms() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static int status_to_errno(uint8_t status) {
+  switch (status) {
+  case kRpcOk:
+    return 0;
+  case kRpcNoMethod:
+    return ENOSYS;
+  case kRpcDeadlineExceeded:
+    return ETIMEDOUT;
+  default:
+    return EREMOTEIO;
+  }
+}
+
+RpcChannel::RpcChannel(IoScheduler *scheduler, Options options)
+    : scheduler_(scheduler), options_(options) {}
+
+RpcChannel::~RpcChannel() { close(); }
+
+int RpcChannel::connect(const std::string &ip, uint16_t port) {
+  if (writer_) {
+    errno = EISCONN;
+    return -1;
+  }
+
+  struct sockaddr_in addr {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (inet_pton(AF_INET, ip.c_str(), &addr.sin_addr) != 1) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  int yes = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+  if (connect_with_timeout(fd, reinterpret_cast<sockaddr *>(&addr),
+                           sizeof(addr), options_.connect_timeout_ms) != 0) {
+    int err = errno;
+    ::close(fd);
+    errno = err;
+    return -1;
+  }
+
+  fd_ = fd;
+  writer_ = std::make_shared<RpcFrameWriter>(fd);
+  writer_->start(scheduler_);
+  connected_.store(true, std::memory_order_release);
+
+  // 读协程只持有弱引用，否则连接断开前通道永远不会析构
+  std::weak_ptr<RpcChannel> weak_self = shared_from_this();
+  const size_t max_body_size = options_.max_body_size;
+  RpcFrameWriter::ptr writer = writer_;
+  scheduler_->schedule(std::make_shared<Fiber>(
+      [weak_self, fd, max_body_size, writer]() {
+        read_loop(weak_self, fd, max_body_size, writer);
+      },
+      StackAllocator::kDefaultStackSize, "rpc_reader"));
+  ZCOROUTINE_LOG_DEBUG("RpcChannel connected: {}:{}, fd={}", ip, port, fd);
+  return 0;
+}
+
+void RpcChannel::close() {
+  if (connected_.exchange(false, std::memory_order_acq_rel)) {
+    // 唤醒读协程，由它完成剩余的清理；fd由发送协程关闭，经它shutdown不会误伤复用的fd
+    writer_->shutdown();
+  }
+}
+
+size_t RpcChannel::pending_count() const {
+  std::lock_guard<Spinlock> guard(pending_lock_);
+  return pending_.size();
+}
+
+int RpcChannel::call(const std::string &method, const std::string &request,
+                     std::string *response, uint64_t timeout_ms) {
+  if (!connected_.load(std::memory_order_acquire)) {
+    errno = ECONNRESET;
+    return -1;
+  }
+  if (method.size() > std::numeric_limits<uint16_t>::max() ||
+      method.size() + request.size() > options_.max_body_size) {
+    errno = EMSGSIZE;
+    return -1;
+  }
+  if (timeout_ms == kDefaultTimeout) {
+    timeout_ms = options_.default_timeout_ms;
+  }
+  calls_.fetch_add(1, std::memory_order_relaxed);
+
+  const uint64_t id = next_id_.fetch_add(1, std::memory_order_relaxed);
+  auto pending = std::make_shared<PendingCall>();
+  {
+    std::lock_guard<Spinlock> guard(pending_lock_);
+    if (closed_) {
+      errno = ECONNRESET;
+      return -1;
+    }
+    pending_.emplace(id, pending);
+  }
+
+  RpcFrameHeader header;
+  header.type = RpcFrameHeader::kRequest;
+  header.request_id = id;
+  header.timeout_ms = static_cast<uint32_t>(
+      std::min<uint64_t>(timeout_ms, std::numeric_limits<uint32_t>::max()));
+  header.method_len = static_cast<uint16_t>(method.size());
+  header.body_len = static_cast<uint32_t>(method.size() + request.size());
+  if (!writer_->send(header, method, request)) {
+    std::lock_guard<Spinlock> guard(pending_lock_);
+    pending_.erase(id);
+    errno = ECONNRESET;
+    return -1;
+  }
+
+  const uint64_t deadline = now_ms() + timeout_ms;
+  std::unique_lock<Spinlock> lock(pending->lock);
+  while (!pending->done) {
+    uint64_t now = now_ms();
+    if (now >= deadline) {
+      break;
+    }
+    pending->waiter.wait(lock, deadline - now);
+  }
+
+  if (!pending->done) {
+    lock.unlock();
+    {
+      std::lock_guard<Spinlock> guard(pending_lock_);
+      pending_.erase(id);
+    }
+    timeouts_.fetch_add(1, std::memory_order_relaxed);
+    errno = ETIMEDOUT;
+    return -1;
+  }
+  if (pending->error != 0) {
+    errno = pending->error;
+    return -1;
+  }
+  if (response) {
+    response->swap(pending->response);
+  }
+  return 0;
+}
+
+void RpcChannel::complete(const std::shared_ptr<PendingCall> &call, int error,
+                          std::string *response) {
+  {
+    std::lock_guard<Spinlock> guard(call->lock);
+    call->error = error;
+    if (response) {
+      call->response.swap(*response);
+    }
+    call->done = true;
+  }
+  call->waiter.notify_one();
+}
+
+void RpcChannel::fail_all() {
+  std::unordered_map<uint64_t, std::shared_ptr<PendingCall>> pending;
+  {
+    std::lock_guard<Spinlock> guard(pending_lock_);
+    closed_ = true;
+    pending.swap(pending_);
+  }
+  for (auto &item : pending) {
+    complete(item.second, ECONNRESET, nullptr);
+  }
+}
+
+bool RpcChannel::dispatch(RpcFrame *frame) {
+  if (frame->header.type != RpcFrameHeader::kResponse) {
+    ZCOROUTINE_LOG_WARN("RpcChannel unexpected frame type {}, fd={}",
+                        frame->header.type, fd_);
+    return false;
+  }
+
+  std::shared_ptr<PendingCall> pending;
+  {
+    std::lock_guard<Spinlock> guard(pending_lock_);
+    auto it = pending_.find(frame->header.request_id);
+    if (it != pending_.end()) {
+      pending = std::move(it->second);
+      pending_.erase(it);
+    }
+  }
+  // 找不到说明调用方已超时返回，丢弃迟到的响应
+  if (pending) {
+    complete(pending, status_to_errno(frame->header.status), &frame->payload);
+  }
+  return true;
+}
+
+void RpcChannel::read_loop(const std::weak_ptr<RpcChannel> &weak_self, int fd,
+                           size_t max_body_size, RpcFrameWriter::ptr writer) {
+  set_hook_enable(true);
+  RpcFrameReader reader(fd, max_body_size);
+  RpcFrame frame;
+
+  while (reader.read(&frame) > 0) {
+    RpcChannel::ptr self = weak_self.lock();
+    if (!self || !self->dispatch(&frame)) {
+      break;
+    }
+  }
+
+  // 通道已析构时不再有调用方，只需关闭连接
+  RpcChannel::ptr self = weak_self.lock();
+  if (self) {
+    self->connected_.store(false, std::memory_order_release);
+    self->fail_all();
+  }
+  // 发送协程写完剩余数据后关闭fd
+  writer->close();
+  ZCOROUTINE_LOG_DEBUG("RpcChannel reader exited, fd={}", fd);
+}
+
+} // namespace zcoroutine
@@ -0,0 +1,230 @@
+#include "rpc/rpc_frame.h"
+
+#include <arpa/inet.h>
+#include <endian.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "hook/hook.h"
+#include "runtime/fiber.h"
+#include "util/zcoroutine_logger.h"
+
+namespace zcoroutine {
+
+constexpr size_t RpcFrameHeader::kSize;
+constexpr uint16_t RpcFrameHeader::kMagic;
+
+// ==================== RpcFrameHeader ====================
+
+void RpcFrameHeader::encode(char *out) const {
+  uint32_t len = htonl(body_len);
+  uint16_t magic = htons(kMagic);
+  uint64_t id = htobe64(request_id);
+  uint32_t timeout = htonl(timeout_ms);
+  uint16_t mlen = htons(method_len);
+  uint16_t reserved = 0;
+
+  std::memcpy(out, &len, 4);
+  std::memcpy(out + 4, &magic, 2);
+  out[6] = static_cast<char>(type);
+  out[7] = static_cast<char>(status);
+  std::memcpy(out + 8, &id, 8);
+  std::memcpy(out + 16, &timeout, 4);
+  std::memcpy(out + 20, &mlen, 2);
+  std::memcpy(out + 22, &reserved, 2);
+}
+
+bool RpcFrameHeader::decode(const char *in) {
+  uint32_t len;
+  uint16_t magic;
+  uint64_t id;
+  uint32_t timeout;
+  uint16_t mlen;
+
+  std::memcpy(&len, in, 4);
+  std::memcpy(&magic, in + 4, 2);
+  std::memcpy(&id, in + 8, 8);
+  std::memcpy(&timeout, in + 16, 4);
+  std::memcpy(&mlen, in + 20, 2);
+  if (ntohs(magic) != kMagic) {
+    return false;
+  }
+
+  body_len = ntohl(len);
+  type = static_cast<uint8_t>(in[6]);
+  status = static_cast<uint8_t>(in[7]);
+  request_id = be64toh(id);
+  timeout_ms = ntohl(timeout);
+  method_len = ntohs(mlen);
+  return true;
+}
+
+// ==================== RpcFrameReader ====================
+
+int RpcFrameReader::fill() {
+  ssize_t n = buf_.append_from_fd(fd_);
+  if (n > 0) {
+    return 1;
+  }
+  return n == 0 ? 0 : -1;
+}
+
+int RpcFrameReader::read(RpcFrame *frame) {
+  while (buf_.size() < RpcFrameHeader::kSize) {
+    int ret = fill();
+    if (ret <= 0) {
+      return ret;
+    }
+  }
+
+  char head[RpcFrameHeader::kSize];
+  buf_.copy_to(head, sizeof(head));
+  RpcFrameHeader &header = frame->header;
+  if (!header.decode(head) || header.method_len > header.body_len) {
+    errno = EPROTO;
+    return -1;
+  }
+  if (header.body_len > max_body_size_) {
+    errno = EMSGSIZE;
+    return -1;
+  }
+
+  const size_t total = RpcFrameHeader::kSize + header.body_len;
+  while (buf_.size() < total) {
+    int ret = fill();
+    if (ret <= 0) {
+      return ret;
+    }
+  }
+
+  buf_.pop_front(RpcFrameHeader::kSize);
+  frame->method.resize(header.method_len);
+  if (header.method_len > 0) {
+    buf_.copy_to(&frame->method[0], header.method_len);
+    buf_.pop_front(header.method_len);
+  }
+  const size_t payload_len = header.body_len - header.method_len;
+  frame->payload.resize(payload_len);
+  if (payload_len > 0) {
+    buf_.copy_to(&frame->payload[0], payload_len);
+    buf_.pop_front(payload_len);
+  }
+  return 1;
+}
+
+// ==================== RpcFrameWriter ====================
+
+RpcFrameWriter::~RpcFrameWriter() {
+  // 发送协程持有自身引用，走到这里说明它从未启动
+  if (!started_.load(std::memory_order_acquire) && fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+void RpcFrameWriter::start(IoScheduler *scheduler) {
+  if (started_.exchange(true)) {
+    return;
+  }
+  RpcFrameWriter::ptr self = shared_from_this();
+  scheduler->schedule(std::make_shared<Fiber>([self]() { self->write_loop(); },
+                                              StackAllocator::kDefaultStackSize,
+                                              "rpc_writer"));
+}
+
+bool RpcFrameWriter::send(const RpcFrameHeader &header,
+                          const std::string &method,
+                          const std::string &payload) {
+  // 在锁外组装帧，锁内只移动块引用
+  char head[RpcFrameHeader::kSize];
+  header.encode(head);
+  IOBuf frame;
+  frame.append(head, sizeof(head));
+  frame.append(method);
+  frame.append(payload);
+
+  bool wake;
+  {
+    std::lock_guard<Spinlock> guard(lock_);
+    if (closed_ || broken_.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    queue_.append(std::move(frame));
+    wake = writer_waiting_;
+  }
+  frames_.fetch_add(1, std::memory_order_relaxed);
+  if (wake) {
+    wakeup_.notify_one();
+  }
+  return true;
+}
+
+void RpcFrameWriter::close() {
+  bool wake;
+  {
+    std::lock_guard<Spinlock> guard(lock_);
+    if (closed_) {
+      return;
+    }
+    closed_ = true;
+    wake = writer_waiting_;
+  }
+  if (wake) {
+    wakeup_.notify_one();
+  }
+}
+
+void RpcFrameWriter::shutdown() {
+  std::lock_guard<Spinlock> guard(lock_);
+  if (fd_ >= 0) {
+    ::shutdown(fd_, SHUT_RDWR);
+  }
+}
+
+void RpcFrameWriter::write_loop() {
+  set_hook_enable(true);
+
+  while (true) {
+    IOBuf batch;
+    bool closing;
+    {
+      std::unique_lock<Spinlock> lock(lock_);
+      while (queue_.empty() && !closed_) {
+        writer_waiting_ = true;
+        wakeup_.wait(lock);
+        writer_waiting_ = false;
+      }
+      batch = std::move(queue_);
+      queue_.clear();
+      closing = closed_;
+    }
+
+    if (!batch.empty() && !broken_.load(std::memory_order_relaxed)) {
+      batches_.fetch_add(1, std::memory_order_relaxed);
+      if (batch.write_all(fd_) != 0) {
+        ZCOROUTINE_LOG_DEBUG("RpcFrameWriter write failed, fd={}, errno={}",
+                             fd_, errno);
+        broken_.store(true, std::memory_order_release);
+        // 唤醒同一连接上阻塞在读方向的协程
+        ::shutdown(fd_, SHUT_RDWR);
+      }
+    }
+
+    // closed_之后send()不再入队，取走的这一批就是最后的数据
+    if (closing) {
+      break;
+    }
+  }
+
+  int fd;
+  {
+    std::lock_guard<Spinlock> guard(lock_);
+    fd = fd_;
+    fd_ = -1;
+  }
+  ::close(fd);
+}
+
+} // namespace zcoroutine
@@ -0,0 +1,134 @@
+#include "rpc/rpc_server.h"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <utility>
+
+#include "hook/hook.h"
+#include "runtime/fiber_pool.h"
+#include "util/thread_context.h"
+#include "util/zcoroutine_logger.h"
+
+namespace zcoroutine {
+
+static uint64_t now_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+RpcServer::RpcServer(IoScheduler *scheduler, Options options)
+    : scheduler_(scheduler), options_(std::move(options)) {}
+
+RpcServer::~RpcServer() { stop(); }
+
+bool RpcServer::start(const std::string &ip, uint16_t port) {
+  if (running_.exchange(true)) {
+    return true;
+  }
+
+  std::weak_ptr<RpcServer> weak_self = shared_from_this();
+  acceptor_ = std::make_shared<TcpAcceptor>(
+      scheduler_, ip, port,
+      [weak_self](int fd) {
+        RpcServer::ptr self = weak_self.lock();
+        if (!self) {
+          close(fd);
+          return;
+        }
+        self->handle_connection(fd);
+      },
+      options_.acceptor);
+  if (!acceptor_->start()) {
+    running_ = false;
+    acceptor_.reset();
+    return false;
+  }
+
+  ZCOROUTINE_LOG_INFO("RpcServer started: addr={}:{}, methods={}", ip,
+                      acceptor_->port(), methods_.size());
+  return true;
+}
+
+void RpcServer::stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+  if (acceptor_) {
+    acceptor_->stop();
+  }
+  ZCOROUTINE_LOG_INFO("RpcServer stopped: requests={}",
+                      requests_.load(std::memory_order_relaxed));
+}
+
+void RpcServer::handle_connection(int fd) {
+  RpcFrameWriter::ptr writer = std::make_shared<RpcFrameWriter>(fd);
+  writer->start(scheduler_);
+  RpcFrameReader reader(fd, options_.max_body_size);
+
+  while (true) {
+    auto frame = std::make_shared<RpcFrame>();
+    int ret = reader.read(frame.get());
+    if (ret <= 0) {
+      if (ret < 0 && !writer->is_broken()) {
+        ZCOROUTINE_LOG_DEBUG("RpcServer read failed, fd={}, errno={}", fd,
+                             errno);
+      }
+      break;
+    }
+    if (frame->header.type != RpcFrameHeader::kRequest) {
+      ZCOROUTINE_LOG_WARN("RpcServer unexpected frame type {}, fd={}",
+                          frame->header.type, fd);
+      break;
+    }
+
+    const uint64_t received_us = now_us();
+    if (options_.inline_handlers) {
+      process(writer, frame, received_us);
+      continue;
+    }
+
+    RpcServer::ptr self = shared_from_this();
+    auto func = [self, writer, frame, received_us]() {
+      self->process(writer, frame, received_us);
+    };
+    const bool shared = ThreadContext::get_stack_mode() == StackMode::kShared;
+    scheduler_->schedule(FiberPool::get_instance().get_fiber(
+        std::move(func), StackAllocator::kDefaultStackSize, "rpc_call",
+        shared));
+  }
+
+  // 仍在执行的请求持有writer，发送失败会被忽略；剩余响应写完后由发送协程关闭fd
+  writer->close();
+}
+
+void RpcServer::process(const RpcFrameWriter::ptr &writer,
+                        const std::shared_ptr<RpcFrame> &frame,
+                        uint64_t received_us) {
+  const RpcFrameHeader &req = frame->header;
+  RpcFrameHeader resp;
+  resp.type = RpcFrameHeader::kResponse;
+  resp.request_id = req.request_id;
+  std::string payload;
+
+  auto it = methods_.find(frame->method);
+  if (it == methods_.end()) {
+    resp.status = kRpcNoMethod;
+  } else if (req.timeout_ms > 0 &&
+             now_us() - received_us >= static_cast<uint64_t>(req.timeout_ms) * 1000) {
+    // 排队已超过调用方的预算，调用方已经放弃，不必再执行
+    resp.status = kRpcDeadlineExceeded;
+    deadline_dropped_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    set_hook_enable(true);
+    resp.status = it->second(frame->payload, &payload) == 0 ? kRpcOk
+                                                            : kRpcHandlerError;
+  }
+
+  resp.body_len = static_cast<uint32_t>(payload.size());
+  writer->send(resp, std::string(), payload);
+  requests_.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace zcoroutine
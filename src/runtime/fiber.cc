@@ -1,14 +1,24 @@
 #include "runtime/fiber.h"
 
+#include <algorithm>
 #include <cassert>
+#include <thread>
 #include <utility>
 
+#include "runtime/fiber_profiler.h"
+#include "runtime/stack_usage.h"
+#include "util/cycle_clock.h"
+#include "util/metrics.h"
 #include "util/thread_context.h"
+#include "util/tracer.h"
 #include "util/zcoroutine_logger.h"
 namespace zcoroutine {
 // 静态成员初始化
 std::atomic<uint64_t> Fiber::s_fiber_count_{0};
 
+// 当前resume窗口内嵌套resume的子协程累计耗时，用于计算自身CPU时间
+static thread_local uint64_t t_child_ticks = 0;
+
 // 主协程构造函数
 Fiber::Fiber()
     : state_(State::kRunning), id_(0), stack_ptr_(nullptr), stack_size_(0),
@@ -150,6 +160,10 @@ Fiber::Fiber(std::function<void()> func, size_t stack_size,
           stack_size_);
       abort();
     }
+    if (StackUsage::enabled()) {
+      StackUsage::paint(stack_ptr_, stack_size_);
+      stack_painted_ = true;
+    }
     ZCOROUTINE_LOG_DEBUG(
         "Fiber using independent stack: name={}, id={}, ptr={}, size={}", name_,
         id_, static_cast<void *>(stack_ptr_), stack_size_);
@@ -158,6 +172,7 @@ Fiber::Fiber(std::function<void()> func, size_t stack_size,
   // 创建上下文
   context_->make_context(stack_ptr_, stack_size_, Fiber::main_func);
 
+  ZCOROUTINE_TRACE(kFiberCreate, id_, 0);
   ZCOROUTINE_LOG_INFO("Fiber created: name={}, id={}, is_shared_stack={}",
                       name_, id_, shared_ctx_->is_shared_stack());
 }
@@ -204,19 +219,25 @@ Fiber::Fiber(std::function<void()> func, SharedStack *shared_stack,
   // 创建上下文
   context_->make_context(stack_ptr_, stack_size_, Fiber::main_func);
 
+  ZCOROUTINE_TRACE(kFiberCreate, id_, 0);
   ZCOROUTINE_LOG_INFO("Fiber created: name={}, id={}, is_shared_stack=true",
                       name_, id_);
 }
 
 Fiber::Fiber(Fiber &&other) noexcept
-    : state_(other.state_), id_(other.id_), stack_ptr_(other.stack_ptr_),
-      stack_size_(other.stack_size_), context_(std::move(other.context_)),
-      name_(std::move(other.name_)), callback_(std::move(other.callback_)),
-      shared_ctx_(std::move(other.shared_ctx_)) {}
+    : state_(other.state_),
+      on_cpu_(other.on_cpu_.load(std::memory_order_relaxed)), id_(other.id_),
+      stack_ptr_(other.stack_ptr_), stack_size_(other.stack_size_),
+      context_(std::move(other.context_)), name_(std::move(other.name_)),
+      callback_(std::move(other.callback_)),
+      shared_ctx_(std::move(other.shared_ctx_)),
+      stack_painted_(other.stack_painted_) {}
 
 Fiber &Fiber::operator=(Fiber &&other) noexcept {
   if (this != &other) {
     state_ = other.state_;
+    on_cpu_.store(other.on_cpu_.load(std::memory_order_relaxed),
+                  std::memory_order_relaxed);
     id_ = other.id_;
     stack_ptr_ = other.stack_ptr_;
     stack_size_ = other.stack_size_;
@@ -224,11 +245,15 @@ Fiber &Fiber::operator=(Fiber &&other) noexcept {
     name_ = std::move(other.name_);
     callback_ = std::move(other.callback_);
     shared_ctx_ = std::move(other.shared_ctx_);
+    stack_painted_ = other.stack_painted_;
   }
   return *this;
 }
 
 Fiber::~Fiber() {
+  if (run_count_ != 0 || wait_ns_ != 0) {
+    FiberProfiler::instance().collect(*this);
+  }
   ZCOROUTINE_LOG_DEBUG(
       "Fiber destroying: name={}, id={}, state={}, is_shared_stack={}", name_,
       id_, state_to_string(state_), shared_ctx_->is_shared_stack());
@@ -248,6 +273,12 @@ Fiber::~Fiber() {
 }
 
 void Fiber::resume() {
+  // 协程在yield前就可能被IO线程或定时器重新调度（先add_event再yield），
+  // 此时另一个线程可能仍在切出该协程的过程中，等待其完成切出
+  while (on_cpu_.exchange(true, std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+
   assert(state_ != State::kTerminated && "Cannot resume terminated fiber");
   assert(state_ != State::kRunning && "Fiber is already running");
 
@@ -275,11 +306,45 @@ void Fiber::resume() {
 
   // 调用栈入栈
   ThreadContext::push_call_stack(shared_from_this());
+  ZCOROUTINE_TRACE(kFiberResume, id_, 0);
+  Metrics::inc(Counter::kFiberSwitches);
+
+  const bool profiling = FiberProfiler::enabled();
+  uint64_t saved_child_ticks = 0;
+  uint64_t start_ticks = 0;
+  if (profiling) {
+    saved_child_ticks = t_child_ticks;
+    t_child_ticks = 0;
+    start_ticks = CycleClock::now();
+  }
+
   // 使用统一的切换函数（处理共享栈保存和恢复）
   co_swap(prev_fiber, shared_from_this());
 
+  if (profiling) {
+    uint64_t elapsed = CycleClock::now() - start_ticks;
+    cpu_ticks_ += elapsed - std::min(elapsed, t_child_ticks);
+    ++run_count_;
+    t_child_ticks = saved_child_ticks + elapsed;
+    if (state_ == State::kTerminated) {
+      FiberProfiler::instance().collect(*this);
+    }
+  }
+
+  if (stack_painted_ && state_ == State::kTerminated) {
+    // 协程已完全切出，栈上不再有活动帧
+    size_t used = StackUsage::high_water_mark(stack_ptr_, stack_size_);
+    StackUsage::instance().record(FiberProfiler::name_prefix(name_), used,
+                                  stack_size_);
+    // 只重新填充用过的部分，供协程池复用时继续测量
+    StackUsage::paint(static_cast<char *>(stack_ptr_) + stack_size_ - used,
+                      used);
+  }
+
   // 协程执行完毕后会切换回来，恢复前一个协程
   set_this(prev_fiber);
+  // 协程上下文（及共享栈内容）已保存完毕，允许其他线程恢复它
+  on_cpu_.store(false, std::memory_order_release);
 
   // 如果协程结束并且有异常，重新抛出
   if (exception_) {
@@ -302,6 +367,7 @@ void Fiber::yield() {
 
   ZCOROUTINE_LOG_DEBUG("Fiber yield: name={}, id={}", cur_fiber->name_,
                        cur_fiber->id_);
+  ZCOROUTINE_TRACE(kFiberYield, cur_fiber->id_, 0);
 
   // 确定切换目标协程
   cur_fiber->confirm_switch_target();
@@ -322,6 +388,7 @@ void Fiber::reset(std::function<void()> func) {
   // 重新创建上下文
   context_->make_context(stack_ptr_, stack_size_, Fiber::main_func);
 
+  ZCOROUTINE_TRACE(kFiberCreate, id_, 1);
   ZCOROUTINE_LOG_DEBUG("Fiber reset: name={}, id={}", name_, id_);
 }
 
@@ -364,6 +431,7 @@ void Fiber::main_func() {
       cur_fiber->shared_ctx_->is_shared_stack()) {
     cur_fiber->shared_ctx_->clear_occupy(cur_fiber.get());
   }
+  ZCOROUTINE_TRACE(kFiberTerminate, cur_fiber->id_, 0);
   cur_fiber->confirm_switch_target();
 }
 
@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <mutex>
 
+#include "runtime/fiber_profiler.h"
+#include "runtime/stack_usage.h"
 #include "util/zcoroutine_logger.h"
 
 namespace zcoroutine {
@@ -26,23 +28,25 @@ Fiber::ptr FiberPool::get_fiber(std::function<void()> func, size_t stack_size,
                                 bool use_shared_stack) {
   Fiber::ptr fiber = nullptr;
 
+  // 自适应模式：调用方未指定栈大小时，按同名协程观测到的用量选择
+  if (!use_shared_stack && !name.empty() &&
+      stack_size == StackAllocator::kDefaultStackSize &&
+      adaptive_stack_.load(std::memory_order_relaxed)) {
+    stack_size = StackUsage::instance().suggest_stack_size(name, stack_size);
+  }
+
   // 尝试从池中获取可复用的协程
   {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    // 查找栈大小匹配的协程
+    // 查找栈模式匹配、且独立栈不小于所需大小的协程
     auto it = std::find_if(pool_.begin(), pool_.end(),
                            [stack_size, use_shared_stack](const Fiber::ptr &f) {
-                             // 检查栈模式是否匹配
-                             bool stack_mode_match =
-                                 (use_shared_stack && f->is_shared_stack()) ||
-                                 (!use_shared_stack && !f->is_shared_stack());
-
                              if (use_shared_stack) {
-                               return stack_mode_match;
-                             } else {
-                               return stack_mode_match;
+                               return f->is_shared_stack();
                              }
+                             return !f->is_shared_stack() &&
+                                    f->stack_size() >= stack_size;
                            });
 
     if (it != pool_.end()) {
@@ -67,6 +71,10 @@ Fiber::ptr FiberPool::get_fiber(std::function<void()> func, size_t stack_size,
   } else {
     // 从池中复用协程，重置为新任务
     fiber->reset(func);
+    // 名称只用于统计归类；拼接名称要分配内存，未开启统计时不改名
+    if (FiberProfiler::enabled() || StackUsage::enabled()) {
+      fiber->set_name(name);
+    }
 
     ZCOROUTINE_LOG_DEBUG("FiberPool: reused fiber after reset, fiber_id={}, "
                          "pool_size={}",
@@ -123,6 +131,14 @@ void FiberPool::set_max_capacity(size_t capacity) {
   }
 }
 
+void FiberPool::set_adaptive_stack(bool enabled) {
+  if (enabled) {
+    StackUsage::set_enabled(true);
+  }
+  adaptive_stack_.store(enabled, std::memory_order_relaxed);
+  ZCOROUTINE_LOG_INFO("FiberPool::set_adaptive_stack: enabled={}", enabled);
+}
+
 size_t FiberPool::get_max_capacity() const {
   std::lock_guard<std::mutex> lock(mutex_);
   return max_capacity_;
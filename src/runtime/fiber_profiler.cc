@@ -0,0 +1,105 @@
+#include "runtime/fiber_profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "runtime/fiber.h"
+#include "util/cycle_clock.h"
+
+namespace zcoroutine {
+
+std::atomic<bool> FiberProfiler::s_enabled_{false};
+
+FiberProfiler &FiberProfiler::instance() {
+  // 不析构：协程可能在静态对象析构阶段才结束
+  static FiberProfiler *profiler = new FiberProfiler();
+  return *profiler;
+}
+
+std::string FiberProfiler::name_prefix(const std::string &name) {
+  size_t pos = name.size();
+  while (pos > 0 && name[pos - 1] >= '0' && name[pos - 1] <= '9') {
+    --pos;
+  }
+  if (pos < name.size() && pos > 0 && name[pos - 1] == '_') {
+    return name.substr(0, pos - 1);
+  }
+  return name;
+}
+
+void FiberProfiler::collect(Fiber &fiber) {
+  if (fiber.run_count_ == 0 && fiber.wait_ns_ == 0) {
+    return;
+  }
+  std::string prefix = name_prefix(fiber.name_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry &entry = entries_[prefix];
+    ++entry.fibers;
+    entry.runs += fiber.run_count_;
+    entry.cpu_ticks += fiber.cpu_ticks_;
+    entry.wait_ns += fiber.wait_ns_;
+  }
+  fiber.run_count_ = 0;
+  fiber.cpu_ticks_ = 0;
+  fiber.wait_ns_ = 0;
+}
+
+std::vector<FiberProfile> FiberProfiler::top(size_t n) {
+  std::vector<FiberProfile> result;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    result.reserve(entries_.size());
+    for (const auto &item : entries_) {
+      FiberProfile profile;
+      profile.name = item.first;
+      profile.fibers = item.second.fibers;
+      profile.runs = item.second.runs;
+      profile.cpu_ns = item.second.cpu_ticks;
+      profile.wait_ns = item.second.wait_ns;
+      result.push_back(std::move(profile));
+    }
+  }
+
+  // 汇总时只累加TSC计数，输出时再统一换算
+  const double ticks_per_ns = CycleClock::ticks_per_ns();
+  for (FiberProfile &profile : result) {
+    profile.cpu_ns = static_cast<uint64_t>(
+        static_cast<double>(profile.cpu_ns) / ticks_per_ns);
+  }
+
+  std::sort(result.begin(), result.end(),
+            [](const FiberProfile &a, const FiberProfile &b) {
+              return a.cpu_ns > b.cpu_ns;
+            });
+  if (n > 0 && result.size() > n) {
+    result.resize(n);
+  }
+  return result;
+}
+
+std::string FiberProfiler::report(size_t n) {
+  std::vector<FiberProfile> profiles = top(n);
+  std::string out;
+  char line[256];
+  snprintf(line, sizeof(line), "%-24s %10s %12s %12s %12s %12s\n", "name",
+           "fibers", "runs", "cpu_ms", "cpu_us/run", "wait_ms");
+  out += line;
+  for (const FiberProfile &p : profiles) {
+    snprintf(line, sizeof(line),
+             "%-24s %10llu %12llu %12.3f %12.3f %12.3f\n", p.name.c_str(),
+             static_cast<unsigned long long>(p.fibers),
+             static_cast<unsigned long long>(p.runs), p.cpu_ns / 1e6,
+             p.runs ? p.cpu_ns / 1e3 / static_cast<double>(p.runs) : 0.0,
+             p.wait_ns / 1e6);
+    out += line;
+  }
+  return out;
+}
+
+void FiberProfiler::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+}
+
+} // namespace zcoroutine
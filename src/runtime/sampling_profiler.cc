@@ -0,0 +1,300 @@
+#include "runtime/sampling_profiler.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <new>
+#include <unordered_map>
+
+#include "runtime/fiber.h"
+#include "runtime/fiber_profiler.h"
+#include "util/thread_context.h"
+#include "util/zcoroutine_logger.h"
+
+namespace zcoroutine {
+
+constexpr int SamplingProfiler::kMaxDepth;
+constexpr int SamplingProfiler::kMaxThreads;
+constexpr int SamplingProfiler::kNameSize;
+
+thread_local SamplingProfiler::SampleBuffer *SamplingProfiler::t_buffer_ =
+    nullptr;
+thread_local bool SamplingProfiler::t_buffer_failed_ = false;
+
+SamplingProfiler &SamplingProfiler::instance() {
+  // 不析构：信号可能在静态对象析构阶段到达
+  static SamplingProfiler *profiler = new SamplingProfiler();
+  return *profiler;
+}
+
+bool SamplingProfiler::start(int frequency_hz, size_t samples_per_thread) {
+  if (frequency_hz <= 0 || frequency_hz > 10000 || samples_per_thread == 0) {
+    return false;
+  }
+  if (running_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+
+  if (!handler_installed_) {
+    struct sigaction sa {};
+    sa.sa_sigaction = &SamplingProfiler::on_signal;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    if (sigaction(SIGPROF, &sa, nullptr) != 0) {
+      ZCOROUTINE_LOG_ERROR("SamplingProfiler::start sigaction failed, errno={}",
+                           errno);
+      return false;
+    }
+    handler_installed_ = true;
+  }
+
+  samples_per_thread_ = samples_per_thread;
+  running_.store(true, std::memory_order_release);
+
+  struct itimerval timer {};
+  timer.it_interval.tv_sec = 0;
+  timer.it_interval.tv_usec = 1000000 / frequency_hz;
+  timer.it_value = timer.it_interval;
+  if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+    running_.store(false, std::memory_order_relaxed);
+    ZCOROUTINE_LOG_ERROR("SamplingProfiler::start setitimer failed, errno={}",
+                         errno);
+    return false;
+  }
+
+  ZCOROUTINE_LOG_INFO("SamplingProfiler started: frequency={}Hz, "
+                      "samples_per_thread={}",
+                      frequency_hz, samples_per_thread);
+  return true;
+}
+
+void SamplingProfiler::stop() {
+  if (!running_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  struct itimerval timer {};
+  setitimer(ITIMER_PROF, &timer, nullptr);
+  // 处理函数保持安装，停止后到达的信号直接返回
+  running_.store(false, std::memory_order_relaxed);
+  ZCOROUTINE_LOG_INFO("SamplingProfiler stopped: samples={}, dropped={}",
+                      sample_count(), dropped_count());
+}
+
+SamplingProfiler::SampleBuffer *SamplingProfiler::attach_thread_buffer() {
+  // 运行在信号处理函数中：只用mmap和原子操作
+  size_t capacity = samples_per_thread_;
+  size_t size = sizeof(SampleBuffer) + capacity * sizeof(Sample);
+  void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mem == MAP_FAILED) {
+    t_buffer_failed_ = true;
+    return nullptr;
+  }
+  int index = buffer_count_.fetch_add(1, std::memory_order_relaxed);
+  if (index >= kMaxThreads) {
+    munmap(mem, size);
+    t_buffer_failed_ = true;
+    return nullptr;
+  }
+
+  SampleBuffer *buffer = new (mem) SampleBuffer();
+  buffer->count.store(0, std::memory_order_relaxed);
+  buffer->capacity = capacity;
+  buffer->mapped_size = size;
+  buffers_[index].store(buffer, std::memory_order_release);
+  t_buffer_ = buffer;
+  return buffer;
+}
+
+void SamplingProfiler::on_signal(int, siginfo_t *, void *ucontext) {
+  int saved_errno = errno;
+  SamplingProfiler &profiler = instance();
+  if (!profiler.running_.load(std::memory_order_acquire)) {
+    errno = saved_errno;
+    return;
+  }
+
+  SampleBuffer *buffer = t_buffer_;
+  if (!buffer && !t_buffer_failed_) {
+    buffer = profiler.attach_thread_buffer();
+  }
+  uint64_t n = buffer ? buffer->count.load(std::memory_order_relaxed) : 0;
+  if (!buffer || n >= buffer->capacity) {
+    profiler.dropped_.fetch_add(1, std::memory_order_relaxed);
+    errno = saved_errno;
+    return;
+  }
+
+  Sample &sample = buffer->samples()[n];
+  Fiber *fiber = ThreadContext::current_fiber_raw();
+  sample.fiber_id = fiber ? fiber->id_ : 0;
+  sample.fiber_name[0] = '\0';
+  if (fiber) {
+    size_t len = fiber->name_.size();
+    if (len >= static_cast<size_t>(kNameSize)) {
+      len = kNameSize - 1;
+    }
+    memcpy(sample.fiber_name, fiber->name_.data(), len);
+    sample.fiber_name[len] = '\0';
+  }
+
+  uintptr_t pc = 0;
+  uintptr_t fp = 0;
+  const ucontext_t *uc = static_cast<const ucontext_t *>(ucontext);
+#if defined(__x86_64__)
+  pc = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RIP]);
+  fp = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RBP]);
+#elif defined(__aarch64__)
+  pc = static_cast<uintptr_t>(uc->uc_mcontext.pc);
+  fp = static_cast<uintptr_t>(uc->uc_mcontext.regs[29]);
+#else
+  (void)uc;
+#endif
+
+  uint32_t depth = 0;
+  sample.pcs[depth++] = pc;
+
+  // 只在当前协程自己的栈内回溯：栈边界已知，不会访问非法地址
+  if (fiber && fiber->stack_ptr_ && fiber->stack_size_ > 0) {
+    uintptr_t lo = reinterpret_cast<uintptr_t>(fiber->stack_ptr_);
+    uintptr_t hi = lo + fiber->stack_size_;
+    while (depth < static_cast<uint32_t>(kMaxDepth) && fp >= lo &&
+           fp + 2 * sizeof(uintptr_t) <= hi && (fp & (sizeof(uintptr_t) - 1)) == 0) {
+      const uintptr_t *frame = reinterpret_cast<const uintptr_t *>(fp);
+      uintptr_t ret = frame[1];
+      if (ret == 0) {
+        break;
+      }
+      sample.pcs[depth++] = ret;
+      uintptr_t next = frame[0];
+      if (next <= fp) {
+        break;
+      }
+      fp = next;
+    }
+  }
+  sample.depth = depth;
+
+  buffer->count.store(n + 1, std::memory_order_release);
+  profiler.samples_.fetch_add(1, std::memory_order_relaxed);
+  errno = saved_errno;
+}
+
+std::string SamplingProfiler::symbolize(uintptr_t pc) {
+  Dl_info info;
+  char text[64];
+  if (dladdr(reinterpret_cast<void *>(pc), &info) == 0) {
+    snprintf(text, sizeof(text), "0x%lx", static_cast<unsigned long>(pc));
+    return text;
+  }
+
+  std::string name;
+  if (info.dli_sname) {
+    int status = 0;
+    char *demangled =
+        abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    name = (status == 0 && demangled) ? demangled : info.dli_sname;
+    free(demangled);
+  } else {
+    const char *module = info.dli_fname ? info.dli_fname : "?";
+    const char *slash = strrchr(module, '/');
+    snprintf(text, sizeof(text), "+0x%lx",
+             static_cast<unsigned long>(
+                 pc - reinterpret_cast<uintptr_t>(info.dli_fbase)));
+    name = std::string(slash ? slash + 1 : module) + text;
+  }
+  // 折叠栈格式以';'分隔帧
+  for (char &c : name) {
+    if (c == ';') {
+      c = ':';
+    }
+  }
+  return name;
+}
+
+std::string SamplingProfiler::folded() {
+  std::unordered_map<uintptr_t, std::string> symbols;
+  std::map<std::string, uint64_t> stacks;
+
+  auto symbol_of = [&symbols](uintptr_t pc) -> const std::string & {
+    auto it = symbols.find(pc);
+    if (it == symbols.end()) {
+      it = symbols.emplace(pc, symbolize(pc)).first;
+    }
+    return it->second;
+  };
+
+  int count = std::min(buffer_count_.load(std::memory_order_acquire),
+                       kMaxThreads);
+  for (int i = 0; i < count; ++i) {
+    SampleBuffer *buffer = buffers_[i].load(std::memory_order_acquire);
+    if (!buffer) {
+      continue;
+    }
+    uint64_t n = buffer->count.load(std::memory_order_acquire);
+    for (uint64_t j = 0; j < n; ++j) {
+      const Sample &sample = buffer->samples()[j];
+      std::string line;
+      if (sample.fiber_name[0] != '\0') {
+        line = "fiber:" + FiberProfiler::name_prefix(sample.fiber_name);
+      } else {
+        line = "[thread]";
+      }
+      // 由外向内输出；返回地址减1以落在调用指令内
+      for (int k = static_cast<int>(sample.depth) - 1; k >= 0; --k) {
+        uintptr_t pc = sample.pcs[k];
+        line += ';';
+        line += symbol_of(k == 0 ? pc : pc - 1);
+      }
+      ++stacks[line];
+    }
+  }
+
+  std::string out;
+  for (const auto &item : stacks) {
+    out += item.first;
+    out += ' ';
+    out += std::to_string(item.second);
+    out += '\n';
+  }
+  return out;
+}
+
+bool SamplingProfiler::dump_folded(const std::string &path) {
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  if (!file) {
+    ZCOROUTINE_LOG_ERROR("SamplingProfiler::dump_folded open failed: path={}",
+                         path);
+    return false;
+  }
+  file << folded();
+  return static_cast<bool>(file);
+}
+
+void SamplingProfiler::clear() {
+  if (running_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  int count = std::min(buffer_count_.load(std::memory_order_acquire),
+                       kMaxThreads);
+  for (int i = 0; i < count; ++i) {
+    SampleBuffer *buffer = buffers_[i].load(std::memory_order_acquire);
+    if (buffer) {
+      buffer->count.store(0, std::memory_order_relaxed);
+    }
+  }
+  samples_.store(0, std::memory_order_relaxed);
+  dropped_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace zcoroutine
@@ -4,6 +4,7 @@
 
 #include "runtime/fiber.h"
 #include "runtime/stack_allocator.h"
+#include "util/metrics.h"
 #include "util/thread_context.h"
 #include "util/zcoroutine_logger.h"
 
@@ -219,14 +220,21 @@ void SharedContext::save_stack_buffer(void *stack_sp) {
 
   size_t len = static_cast<size_t>(stack_top - sp);
 
-  // 优化：复用缓冲区，仅当需要更大空间时才重新分配
-  if (len > save_buffer_capacity_) {
+  // 收缩请求：按实际栈大小重新分配，不预留额外空间
+  const size_t exact_capacity = (len + 15) & ~15ULL;
+  const bool compact =
+      compact_requested_ && save_buffer_capacity_ > exact_capacity;
+  compact_requested_ = false;
+
+  // 优化：复用缓冲区，仅当需要更大空间或收缩时才重新分配
+  if (len > save_buffer_capacity_ || compact) {
     if (save_buffer_) {
       StackAllocator::deallocate(save_buffer_, save_buffer_capacity_);
     }
     // 分配时预留一些空间，减少重复分配
-    size_t new_capacity = len + (len >> 2);      // 额外25%空间
-    new_capacity = (new_capacity + 15) & ~15ULL; // 16字节对齐
+    size_t new_capacity =
+        compact ? exact_capacity : len + (len >> 2); // 额外25%空间
+    new_capacity = (new_capacity + 15) & ~15ULL;     // 16字节对齐
     save_buffer_ = static_cast<char *>(StackAllocator::allocate(new_capacity));
     if (!save_buffer_) {
       ZCOROUTINE_LOG_ERROR(
@@ -243,6 +251,7 @@ void SharedContext::save_stack_buffer(void *stack_sp) {
 
   // 使用memcpy复制栈数据
   memcpy(save_buffer_, sp, len);
+  Metrics::inc(Counter::kStackCopyBytes, len);
 
   ZCOROUTINE_LOG_DEBUG("SharedContext::save_stack_buffer: size={}", len);
 }
@@ -269,6 +278,7 @@ void SharedContext::restore_stack_buffer() {
 
   // 恢复栈内容
   memcpy(sp, save_buffer_, save_size_);
+  Metrics::inc(Counter::kStackCopyBytes, save_size_);
 
   ZCOROUTINE_LOG_DEBUG("SharedContext::restore_stack_buffer: size={}",
                        save_size_);
@@ -0,0 +1,138 @@
+#include "runtime/stack_usage.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "util/zcoroutine_logger.h"
+
+namespace zcoroutine {
+
+constexpr uint64_t StackUsage::kPaintPattern;
+constexpr size_t StackUsage::kMinStackSize;
+constexpr size_t StackUsage::kSafetyMargin;
+constexpr uint64_t StackUsage::kMinSamples;
+
+std::atomic<bool> StackUsage::s_enabled_{false};
+
+namespace {
+
+constexpr size_t kPageSize = 4096;
+// 每累计这么多样本重新计算一次建议值
+constexpr uint64_t kRecomputeInterval = 64;
+
+} // namespace
+
+StackUsage &StackUsage::instance() {
+  // 不析构：协程可能在静态对象析构阶段才结束
+  static StackUsage *usage = new StackUsage();
+  return *usage;
+}
+
+void StackUsage::paint(void *stack, size_t size) {
+  uint64_t *word = static_cast<uint64_t *>(stack);
+  uint64_t *end = word + size / sizeof(uint64_t);
+  std::fill(word, end, kPaintPattern);
+}
+
+size_t StackUsage::high_water_mark(const void *stack, size_t size) {
+  // 栈向低地址增长：从栈底向上找第一个被改写的字
+  const uint64_t *begin = static_cast<const uint64_t *>(stack);
+  const uint64_t *end = begin + size / sizeof(uint64_t);
+  const uint64_t *word = begin;
+  while (word < end && *word == kPaintPattern) {
+    ++word;
+  }
+  return size - static_cast<size_t>(word - begin) * sizeof(uint64_t);
+}
+
+size_t StackUsage::compute_suggestion(const HistogramSnapshot &used) {
+  size_t p99 = static_cast<size_t>(used.percentile(99));
+  size_t size = std::max(p99 + p99 / 2, static_cast<size_t>(used.max)) +
+                kSafetyMargin;
+  size = (size + kPageSize - 1) / kPageSize * kPageSize;
+  return std::max(size, kMinStackSize);
+}
+
+void StackUsage::record(const std::string &name, size_t used,
+                        size_t stack_size) {
+  if (used >= stack_size) {
+    ZCOROUTINE_LOG_WARN("StackUsage: stack fully used, possible overflow: "
+                        "name={}, stack_size={}",
+                        name, stack_size);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Entry &entry = entries_[name];
+  ++entry.used.buckets[HdrHistogram::bucket_index(used)];
+  ++entry.used.count;
+  entry.used.sum += used;
+  entry.used.max = std::max<uint64_t>(entry.used.max, used);
+  entry.stack_size = stack_size;
+
+  if (entry.used.count >= kMinSamples &&
+      (entry.suggested == 0 || entry.used.count % kRecomputeInterval == 0)) {
+    entry.suggested = compute_suggestion(entry.used);
+  }
+}
+
+size_t StackUsage::suggest_stack_size(const std::string &name,
+                                      size_t fallback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(name);
+  if (it == entries_.end() || it->second.suggested == 0) {
+    return fallback;
+  }
+  return std::min(it->second.suggested, fallback);
+}
+
+std::vector<StackUsageStat> StackUsage::stats() {
+  std::vector<StackUsageStat> result;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    result.reserve(entries_.size());
+    for (const auto &item : entries_) {
+      const HistogramSnapshot &used = item.second.used;
+      StackUsageStat stat;
+      stat.name = item.first;
+      stat.fibers = used.count;
+      stat.stack_size = item.second.stack_size;
+      stat.max_used = static_cast<size_t>(used.max);
+      stat.p50_used = static_cast<size_t>(used.percentile(50));
+      stat.p99_used = static_cast<size_t>(used.percentile(99));
+      stat.suggested = item.second.suggested;
+      result.push_back(std::move(stat));
+    }
+  }
+
+  std::sort(result.begin(), result.end(),
+            [](const StackUsageStat &a, const StackUsageStat &b) {
+              return a.max_used > b.max_used;
+            });
+  return result;
+}
+
+std::string StackUsage::report() {
+  std::vector<StackUsageStat> all = stats();
+  std::string out;
+  char line[256];
+  snprintf(line, sizeof(line), "%-24s %10s %10s %10s %10s %10s %10s\n",
+           "name", "fibers", "stack_kb", "max_kb", "p50_kb", "p99_kb",
+           "suggest_kb");
+  out += line;
+  for (const StackUsageStat &s : all) {
+    snprintf(line, sizeof(line),
+             "%-24s %10llu %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+             s.name.c_str(), static_cast<unsigned long long>(s.fibers),
+             s.stack_size / 1024.0, s.max_used / 1024.0, s.p50_used / 1024.0,
+             s.p99_used / 1024.0, s.suggested / 1024.0);
+    out += line;
+  }
+  return out;
+}
+
+void StackUsage::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+}
+
+} // namespace zcoroutine
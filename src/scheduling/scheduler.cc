@@ -3,6 +3,8 @@
 #include <utility>
 
 #include "runtime/fiber_pool.h"
+#include "runtime/fiber_profiler.h"
+#include "util/metrics.h"
 #include "util/thread_context.h"
 #include "util/zcoroutine_logger.h"
 
@@ -53,8 +55,12 @@ void Scheduler::start() {
   threads_.reserve(thread_count_);
   for (int i = 0; i < thread_count_; ++i) {
     auto thread = std::make_unique<std::thread>([this, i]() {
-      // 设置线程的调度器
+      // 设置线程的调度器与工作线程编号
       set_this(this);
+      ThreadContext::set_worker_id(i);
+      if (thread_init_cb_) {
+        thread_init_cb_(i);
+      }
 
       ZCOROUTINE_LOG_DEBUG("Scheduler[{}] worker thread {} started", name_, i);
       this->run();
@@ -134,6 +140,8 @@ void Scheduler::set_this(Scheduler *scheduler) {
   ThreadContext::set_scheduler(scheduler);
 }
 
+int Scheduler::get_worker_id() { return ThreadContext::get_worker_id(); }
+
 void Scheduler::run() {
   ZCOROUTINE_LOG_DEBUG("Scheduler[{}] worker thread entering run loop", name_);
 
@@ -240,6 +248,21 @@ void Scheduler::schedule_loop() {
       int active =
           active_thread_count_.fetch_add(1, std::memory_order_relaxed) + 1;
 
+      uint64_t start_ns = 0;
+      const bool timing = Metrics::timing_enabled();
+      if (timing || FiberProfiler::enabled()) {
+        start_ns = Metrics::now_ns();
+        if (task.enqueue_ns != 0 && start_ns > task.enqueue_ns) {
+          uint64_t wait_ns = start_ns - task.enqueue_ns;
+          if (timing) {
+            Metrics::observe(Histogram::kScheduleLatency, wait_ns);
+          }
+          if (task.fiber && FiberProfiler::enabled()) {
+            task.fiber->add_queue_wait(wait_ns);
+          }
+        }
+      }
+
       // 执行任务
       if (task.fiber) {
         // 执行协程
@@ -302,6 +325,11 @@ void Scheduler::schedule_loop() {
         }
       }
 
+      Metrics::inc(Counter::kTasksRun);
+      if (timing && start_ns != 0) {
+        Metrics::observe(Histogram::kRunDuration, Metrics::now_ns() - start_ns);
+      }
+
       // 减少活跃线程计数
       active_thread_count_.fetch_sub(1, std::memory_order_relaxed);
 
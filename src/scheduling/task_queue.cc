@@ -2,29 +2,45 @@
 #include <chrono>
 #include <mutex>
 
+#include "runtime/fiber_profiler.h"
+#include "util/metrics.h"
+#include "util/tracer.h"
+
 namespace zcoroutine {
 
 void TaskQueue::push(const Task &task) {
+  ZCOROUTINE_TRACE(kTaskEnqueue, task.fiber ? task.fiber->id() : 0, 0);
+  uint64_t now = (Metrics::timing_enabled() || FiberProfiler::enabled())
+                     ? Metrics::now_ns()
+                     : 0;
   {
     std::lock_guard<Spinlock> lock(spinlock_);
     tasks_.push(task);
+    tasks_.back().enqueue_ns = now;
   }
   size_.fetch_add(1, std::memory_order_relaxed);
   // 仅在有等待者时才唤醒，减少无效的notify调用
   if (waiters_.load(std::memory_order_acquire) > 0) {
     cv_.notify_one();
+    Metrics::inc(Counter::kWakeups);
   }
 }
 
 void TaskQueue::push(Task &&task) {
+  ZCOROUTINE_TRACE(kTaskEnqueue, task.fiber ? task.fiber->id() : 0, 0);
+  uint64_t now = (Metrics::timing_enabled() || FiberProfiler::enabled())
+                     ? Metrics::now_ns()
+                     : 0;
   {
     std::lock_guard<Spinlock> lock(spinlock_);
     tasks_.push(std::move(task));
+    tasks_.back().enqueue_ns = now;
   }
   size_.fetch_add(1, std::memory_order_relaxed);
   // 仅在有等待者时才唤醒，减少无效的notify调用
   if (waiters_.load(std::memory_order_acquire) > 0) {
     cv_.notify_one();
+    Metrics::inc(Counter::kWakeups);
   }
 }
 
@@ -39,6 +55,7 @@ bool TaskQueue::try_pop(Task &task) {
     task = std::move(tasks_.front());
     tasks_.pop();
     size_.fetch_sub(1, std::memory_order_relaxed);
+    ZCOROUTINE_TRACE(kTaskDequeue, task.fiber ? task.fiber->id() : 0, 0);
     return true;
   }
   return false;
@@ -66,6 +83,9 @@ bool TaskQueue::pop(Task &task, int timeout_ms) {
 
   // 增加等待者计数
   waiters_.fetch_add(1, std::memory_order_release);
+  if (!stopped_ && tasks_.empty()) {
+    Metrics::inc(Counter::kParks);
+  }
 
   bool result = false;
   if (timeout_ms > 0) {
@@ -86,6 +106,7 @@ bool TaskQueue::pop(Task &task, int timeout_ms) {
     task = std::move(tasks_.front());
     tasks_.pop();
     size_.fetch_sub(1, std::memory_order_relaxed);
+    ZCOROUTINE_TRACE(kTaskDequeue, task.fiber ? task.fiber->id() : 0, 0);
     result = true;
   }
 
@@ -0,0 +1,100 @@
+#include "sync/lock_profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "util/cycle_clock.h"
+
+namespace zcoroutine {
+
+LockProfiler &LockProfiler::instance() {
+  // 不析构：锁可能在静态对象析构阶段仍被使用
+  static LockProfiler *profiler = new LockProfiler();
+  return *profiler;
+}
+
+LockSite *LockProfiler::site(const char *name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unique_ptr<LockSite> &site = sites_[name];
+  if (!site) {
+    site.reset(new LockSite(name));
+  }
+  return site.get();
+}
+
+std::vector<LockStat> LockProfiler::top(size_t n) {
+  std::vector<LockStat> result;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    result.reserve(sites_.size());
+    for (const auto &item : sites_) {
+      const LockSite &site = *item.second;
+      LockStat stat;
+      stat.name = site.name_;
+      stat.acquisitions = site.acquisitions_.load(std::memory_order_relaxed);
+      if (stat.acquisitions == 0) {
+        continue;
+      }
+      stat.contended = site.contended_.load(std::memory_order_relaxed);
+      stat.spins = site.spins_.load(std::memory_order_relaxed);
+      stat.wait_ns = site.wait_ticks_.load(std::memory_order_relaxed);
+      stat.max_wait_ns = site.max_wait_ticks_.load(std::memory_order_relaxed);
+      result.push_back(std::move(stat));
+    }
+  }
+
+  for (LockStat &stat : result) {
+    stat.wait_ns = CycleClock::to_ns(stat.wait_ns);
+    stat.max_wait_ns = CycleClock::to_ns(stat.max_wait_ns);
+  }
+
+  std::sort(result.begin(), result.end(),
+            [](const LockStat &a, const LockStat &b) {
+              if (a.wait_ns != b.wait_ns) {
+                return a.wait_ns > b.wait_ns;
+              }
+              return a.contended > b.contended;
+            });
+  if (n > 0 && result.size() > n) {
+    result.resize(n);
+  }
+  return result;
+}
+
+std::string LockProfiler::report(size_t n) {
+  std::vector<LockStat> stats = top(n);
+  std::string out;
+  char line[256];
+  snprintf(line, sizeof(line), "%-28s %12s %12s %8s %12s %12s %12s\n", "lock",
+           "acquisitions", "contended", "cont%", "spins/cont", "wait_ms",
+           "max_wait_us");
+  out += line;
+  for (const LockStat &s : stats) {
+    snprintf(line, sizeof(line),
+             "%-28s %12llu %12llu %7.2f%% %12.1f %12.3f %12.1f\n",
+             s.name.c_str(), static_cast<unsigned long long>(s.acquisitions),
+             static_cast<unsigned long long>(s.contended),
+             100.0 * static_cast<double>(s.contended) /
+                 static_cast<double>(s.acquisitions),
+             s.contended ? static_cast<double>(s.spins) /
+                               static_cast<double>(s.contended)
+                         : 0.0,
+             s.wait_ns / 1e6, s.max_wait_ns / 1e3);
+    out += line;
+  }
+  return out;
+}
+
+void LockProfiler::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto &item : sites_) {
+    LockSite &site = *item.second;
+    site.acquisitions_.store(0, std::memory_order_relaxed);
+    site.contended_.store(0, std::memory_order_relaxed);
+    site.spins_.store(0, std::memory_order_relaxed);
+    site.wait_ticks_.store(0, std::memory_order_relaxed);
+    site.max_wait_ticks_.store(0, std::memory_order_relaxed);
+  }
+}
+
+} // namespace zcoroutine
@@ -0,0 +1,113 @@
+#include "sync/wait_queue.h"
+
+#include "io/io_scheduler.h"
+#include "util/thread_context.h"
+#include "util/zcoroutine_logger.h"
+
+namespace zcoroutine {
+
+constexpr uint64_t WaitQueue::kNoTimeout;
+
+WaitQueue::~WaitQueue() {
+  std::lock_guard<Spinlock> guard(lock_);
+  if (!waiters_.empty()) {
+    ZCOROUTINE_LOG_WARN("WaitQueue destroyed with {} waiters", waiters_.size());
+  }
+}
+
+std::shared_ptr<WaitQueue::Waiter> WaitQueue::enqueue(uint64_t timeout_ms) {
+  Fiber::ptr fiber = Fiber::get_this();
+  Scheduler *scheduler = Scheduler::get_this();
+  if (!fiber || !scheduler || fiber == ThreadContext::get_scheduler_fiber() ||
+      fiber == ThreadContext::get_main_fiber()) {
+    ZCOROUTINE_LOG_ERROR("WaitQueue::wait must be called in a scheduled fiber");
+    return nullptr;
+  }
+
+  IoScheduler *iom = IoScheduler::get_this();
+  if (timeout_ms != kNoTimeout && !iom) {
+    ZCOROUTINE_LOG_ERROR("WaitQueue::wait timeout requires IoScheduler");
+    return nullptr;
+  }
+
+  auto waiter = std::make_shared<Waiter>();
+  waiter->fiber = std::move(fiber);
+  waiter->scheduler = scheduler;
+
+  std::lock_guard<Spinlock> guard(lock_);
+  waiter->pos = waiters_.insert(waiters_.end(), waiter);
+  waiter->in_queue = true;
+  // 入队后再设置定时器，保证超时回调看到的等待项一定已在队列中
+  if (timeout_ms != kNoTimeout) {
+    std::weak_ptr<Waiter> weak_waiter = waiter;
+    waiter->timer = iom->add_timer(timeout_ms, [this, weak_waiter]() {
+      std::shared_ptr<Waiter> w = weak_waiter.lock();
+      if (w) {
+        on_timeout(w);
+      }
+    });
+  }
+  return waiter;
+}
+
+void WaitQueue::on_timeout(const std::shared_ptr<Waiter> &waiter) {
+  // 通知已生效时不再访问队列（队列所有者可能已经析构）
+  if (waiter->done.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  {
+    std::lock_guard<Spinlock> guard(lock_);
+    if (waiter->in_queue) {
+      waiters_.erase(waiter->pos);
+      waiter->in_queue = false;
+    }
+  }
+  wake(waiter);
+}
+
+std::shared_ptr<WaitQueue::Waiter> WaitQueue::pop_waiter() {
+  std::lock_guard<Spinlock> guard(lock_);
+  while (!waiters_.empty()) {
+    std::shared_ptr<Waiter> waiter = std::move(waiters_.front());
+    waiters_.pop_front();
+    waiter->in_queue = false;
+    // 超时回调已生效的等待项由超时回调负责唤醒
+    if (!waiter->done.exchange(true, std::memory_order_acq_rel)) {
+      waiter->notified = true;
+      return waiter;
+    }
+  }
+  return nullptr;
+}
+
+bool WaitQueue::notify_one() {
+  std::shared_ptr<Waiter> waiter = pop_waiter();
+  if (!waiter) {
+    return false;
+  }
+  wake(waiter);
+  return true;
+}
+
+size_t WaitQueue::notify_all() {
+  size_t count = 0;
+  while (notify_one()) {
+    ++count;
+  }
+  return count;
+}
+
+size_t WaitQueue::waiter_count() const {
+  std::lock_guard<Spinlock> guard(lock_);
+  return waiters_.size();
+}
+
+void WaitQueue::wake(const std::shared_ptr<Waiter> &waiter) {
+  if (waiter->timer) {
+    waiter->timer->cancel();
+  }
+  // 等待协程可能尚未完成让出，resume会等待它离开CPU
+  waiter->scheduler->schedule(std::move(waiter->fiber));
+}
+
+} // namespace zcoroutine
@@ -28,7 +28,7 @@ Timer::Timer(uint64_t ms) { next_time_ = get_current_ms() + ms; }
 
 bool Timer::cancel() {
   ZCOROUTINE_LOG_DEBUG("Timer::cancel called");
-  std::lock_guard<std::mutex> lock(manager_->mutex_);
+  std::lock_guard<Mutex> lock(manager_->mutex_);
 
   if (!callback_) {
     ZCOROUTINE_LOG_WARN("Timer::cancel failed, already canceled");
@@ -45,7 +45,7 @@ bool Timer::cancel() {
 
 bool Timer::refresh() {
   ZCOROUTINE_LOG_DEBUG("Timer::refresh called");
-  std::lock_guard<std::mutex> lock(manager_->mutex_);
+  std::lock_guard<Mutex> lock(manager_->mutex_);
 
   if (!callback_) {
     ZCOROUTINE_LOG_WARN("Timer::refresh failed, already canceled");
@@ -67,7 +67,7 @@ bool Timer::refresh() {
 
 bool Timer::reset(uint64_t ms, bool from_now) {
   ZCOROUTINE_LOG_DEBUG("Timer::reset called, ms={}, from_now={}", ms, from_now);
-  std::lock_guard<std::mutex> lock(manager_->mutex_);
+  std::lock_guard<Mutex> lock(manager_->mutex_);
 
   if (!callback_) {
     ZCOROUTINE_LOG_WARN("Timer::reset failed, already canceled");
@@ -15,7 +15,7 @@ static uint64_t get_current_ms() {
 // TimerManager 析构不需要执行未完成的定时器回调，
 // 因为这样可能会访问已经销毁栈上的对象
 TimerManager::~TimerManager() {
-  std::lock_guard<std::mutex> lock(mutex_);
+  std::lock_guard<Mutex> lock(mutex_);
   timers_.clear();
   ZCOROUTINE_LOG_DEBUG("TimerManager destroyed");
 }
@@ -60,7 +60,7 @@ Timer::ptr TimerManager::add_condition_timer(uint64_t timeout,
 int TimerManager::get_next_timeout() {
   is_ticked_ = false;
 
-  std::lock_guard<std::mutex> lock(mutex_);
+  std::lock_guard<Mutex> lock(mutex_);
   ZCOROUTINE_LOG_DEBUG("TimerManager::get_next_timeout called");
 
   if (timers_.empty()) {
@@ -84,7 +84,7 @@ std::vector<std::function<void()>> TimerManager::list_expired_callbacks() {
   uint64_t now = get_current_ms();
   std::vector<std::function<void()>> callbacks;
 
-  std::lock_guard<std::mutex> lock(mutex_);
+  std::lock_guard<Mutex> lock(mutex_);
   bool rollback = detect_clock_rollback();
 
   // 收集到期的定时器回调函数(包括回滞的情况)
@@ -113,7 +113,7 @@ std::vector<std::function<void()>> TimerManager::list_expired_callbacks() {
 }
 
 bool TimerManager::has_timer() const {
-  std::lock_guard<std::mutex> lock(mutex_);
+  std::lock_guard<Mutex> lock(mutex_);
   return !timers_.empty();
 }
 
@@ -122,7 +122,7 @@ void TimerManager::insert_timer(Timer::ptr timer) {
 
   // 插入定时器到集合中
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<Mutex> lock(mutex_);
     at_front =
         timers_.empty() || (timer->next_time_ < (*timers_.begin())->next_time_);
     ZCOROUTINE_LOG_DEBUG("Inserting timer, at_front={}", at_front);
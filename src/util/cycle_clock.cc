@@ -0,0 +1,36 @@
+#include "util/cycle_clock.h"
+
+#include <chrono>
+#include <thread>
+
+namespace zcoroutine {
+
+namespace {
+
+uint64_t steady_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+struct CalibrationBase {
+  uint64_t ticks = CycleClock::now();
+  uint64_t ns = steady_ns();
+};
+
+// 静态初始化阶段即记录基准，拉开与首次换算之间的距离
+CalibrationBase g_base;
+
+} // namespace
+
+double CycleClock::ticks_per_ns() {
+  uint64_t elapsed_ns = steady_ns() - g_base.ns;
+  if (elapsed_ns < 1000000) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    elapsed_ns = steady_ns() - g_base.ns;
+  }
+  return static_cast<double>(now() - g_base.ticks) /
+         static_cast<double>(elapsed_ns);
+}
+
+} // namespace zcoroutine
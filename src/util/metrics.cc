@@ -0,0 +1,233 @@
+#include "util/metrics.h"
+
+#include <time.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace zcoroutine {
+
+thread_local MetricsShard *Metrics::t_shard_ = nullptr;
+std::atomic<bool> Metrics::s_timing_enabled_{true};
+
+// 线程退出后改写共享分片，避免与复用该分片的新线程同时写
+static thread_local bool t_shard_released = false;
+
+/**
+ * @brief 线程退出时归还分片
+ */
+struct MetricsShardHolder {
+  MetricsShard *shard = nullptr;
+
+  ~MetricsShardHolder() {
+    if (shard) {
+      Metrics::t_shard_ = nullptr;
+      t_shard_released = true;
+      Metrics::instance().release_shard(shard);
+    }
+  }
+};
+
+static thread_local MetricsShardHolder t_holder;
+
+// ==================== HdrHistogram ====================
+
+uint64_t HdrHistogram::bucket_upper(size_t index) {
+  if (index < (1U << kSubBits)) {
+    return index;
+  }
+  int shift = static_cast<int>(index >> kSubBits) - 1;
+  uint64_t sub = index & ((1U << kSubBits) - 1);
+  uint64_t lower = ((1ULL << kSubBits) + sub) << shift;
+  return lower + (1ULL << shift) - 1;
+}
+
+void HdrHistogram::record_shared(uint64_t value) {
+  buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+  uint64_t prev = max_.load(std::memory_order_relaxed);
+  while (value > prev &&
+         !max_.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {
+  }
+}
+
+// ==================== HistogramSnapshot ====================
+
+void HistogramSnapshot::merge(const HdrHistogram &histogram) {
+  for (size_t i = 0; i < HdrHistogram::kBucketCount; ++i) {
+    buckets[i] += histogram.bucket(i).load(std::memory_order_relaxed);
+  }
+  count += histogram.count();
+  sum += histogram.sum();
+  max = std::max(max, histogram.max());
+}
+
+uint64_t HistogramSnapshot::percentile(double q) const {
+  // 读取期间写入方可能仍在更新，以桶内实际计数为准
+  uint64_t total = 0;
+  for (uint64_t n : buckets) {
+    total += n;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  uint64_t rank = static_cast<uint64_t>(q / 100.0 * static_cast<double>(total));
+  if (rank >= total) {
+    rank = total - 1;
+  }
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen > rank) {
+      return std::min(HdrHistogram::bucket_upper(i), max);
+    }
+  }
+  return max;
+}
+
+uint64_t HistogramSnapshot::count_le(uint64_t value) const {
+  uint64_t n = 0;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    if (HdrHistogram::bucket_upper(i) > value) {
+      break;
+    }
+    n += buckets[i];
+  }
+  return n;
+}
+
+// ==================== MetricsShard ====================
+
+void *MetricsShard::operator new(size_t size) {
+  void *ptr = nullptr;
+  if (posix_memalign(&ptr, alignof(MetricsShard), size) != 0) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void MetricsShard::operator delete(void *ptr) { free(ptr); }
+
+// ==================== Metrics ====================
+
+Metrics &Metrics::instance() {
+  // 不析构：线程退出阶段仍可能记录指标
+  static Metrics *metrics = new Metrics();
+  return *metrics;
+}
+
+Metrics::Metrics() : orphan_(new MetricsShard()) {}
+
+uint64_t Metrics::now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL +
+         static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void Metrics::inc_slow(Counter c, uint64_t n) {
+  Metrics &metrics = instance();
+  if (t_shard_released) {
+    metrics.orphan_->counters[static_cast<size_t>(c)].fetch_add(
+        n, std::memory_order_relaxed);
+    return;
+  }
+  t_shard_ = metrics.acquire_shard();
+  inc(c, n);
+}
+
+void Metrics::observe_slow(Histogram h, uint64_t ns) {
+  Metrics &metrics = instance();
+  if (t_shard_released) {
+    metrics.orphan_->histograms[static_cast<size_t>(h)].record_shared(ns);
+    return;
+  }
+  t_shard_ = metrics.acquire_shard();
+  observe(h, ns);
+}
+
+MetricsShard *Metrics::acquire_shard() {
+  MetricsShard *shard = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &candidate : shards_) {
+      if (!candidate->in_use) {
+        shard = candidate.get();
+        break;
+      }
+    }
+    if (!shard) {
+      shards_.emplace_back(new MetricsShard());
+      shard = shards_.back().get();
+    }
+    shard->in_use = true;
+  }
+  t_holder.shard = shard;
+  return shard;
+}
+
+void Metrics::release_shard(MetricsShard *shard) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  shard->in_use = false;
+}
+
+MetricsSnapshot Metrics::snapshot() {
+  MetricsSnapshot snap;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto merge = [&snap](const MetricsShard &shard) {
+    for (size_t i = 0; i < kCounterCount; ++i) {
+      snap.counters[i] += shard.counters[i].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < kHistogramCount; ++i) {
+      snap.histograms[i].merge(shard.histograms[i]);
+    }
+  };
+  for (const auto &shard : shards_) {
+    merge(*shard);
+  }
+  merge(*orphan_);
+  snap.shard_count = shards_.size();
+  return snap;
+}
+
+const char *Metrics::counter_name(Counter c) {
+  switch (c) {
+  case Counter::kTasksRun:
+    return "tasks_run";
+  case Counter::kFiberSwitches:
+    return "fiber_switches";
+  case Counter::kParks:
+    return "worker_parks";
+  case Counter::kWakeups:
+    return "worker_wakeups";
+  case Counter::kEpollWaits:
+    return "epoll_waits";
+  case Counter::kEpollEvents:
+    return "epoll_events";
+  case Counter::kTimersFired:
+    return "timers_fired";
+  case Counter::kHookEagain:
+    return "hook_eagain";
+  case Counter::kStackCopyBytes:
+    return "shared_stack_copy_bytes";
+  case Counter::kCount:
+    break;
+  }
+  return "unknown";
+}
+
+const char *Metrics::histogram_name(Histogram h) {
+  switch (h) {
+  case Histogram::kScheduleLatency:
+    return "schedule_latency";
+  case Histogram::kRunDuration:
+    return "run_duration";
+  case Histogram::kCount:
+    break;
+  }
+  return "unknown";
+}
+
+} // namespace zcoroutine
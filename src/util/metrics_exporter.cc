@@ -0,0 +1,216 @@
+#include "util/metrics_exporter.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include "util/zcoroutine_logger.h"
+
+namespace zcoroutine {
+
+// 直方图导出边界（纳秒）：1us ~ 1s 按1-2-5递增
+static const uint64_t kExportBoundsNs[] = {
+    1000,      2000,      5000,      10000,     20000,      50000,    100000,
+    200000,    500000,    1000000,   2000000,   5000000,    10000000, 20000000,
+    50000000,  100000000, 200000000, 500000000, 1000000000,
+};
+
+static const char *counter_help(Counter c) {
+  switch (c) {
+  case Counter::kTasksRun:
+    return "Tasks executed by scheduler workers";
+  case Counter::kFiberSwitches:
+    return "Fiber resumes";
+  case Counter::kParks:
+    return "Times a worker blocked on an empty task queue";
+  case Counter::kWakeups:
+    return "Times an enqueue woke a blocked worker";
+  case Counter::kEpollWaits:
+    return "epoll_wait calls made by IO threads";
+  case Counter::kEpollEvents:
+    return "Ready events returned by epoll_wait";
+  case Counter::kTimersFired:
+    return "Expired timers dispatched";
+  case Counter::kHookEagain:
+    return "Hooked IO calls that hit EAGAIN and parked the fiber";
+  case Counter::kStackCopyBytes:
+    return "Bytes copied saving and restoring shared stacks";
+  case Counter::kCount:
+    break;
+  }
+  return "";
+}
+
+static const char *histogram_help(Histogram h) {
+  switch (h) {
+  case Histogram::kScheduleLatency:
+    return "Delay from task enqueue to start of execution";
+  case Histogram::kRunDuration:
+    return "Time a task ran before finishing or yielding";
+  case Histogram::kCount:
+    break;
+  }
+  return "";
+}
+
+MetricsExporter::~MetricsExporter() { stop(); }
+
+std::string MetricsExporter::to_prometheus(const MetricsSnapshot &snapshot) {
+  std::string out;
+  char line[256];
+
+  for (size_t i = 0; i < kCounterCount; ++i) {
+    Counter c = static_cast<Counter>(i);
+    const char *name = Metrics::counter_name(c);
+    snprintf(line, sizeof(line),
+             "# HELP zcoroutine_%s_total %s\n"
+             "# TYPE zcoroutine_%s_total counter\n"
+             "zcoroutine_%s_total %llu\n",
+             name, counter_help(c), name, name,
+             static_cast<unsigned long long>(snapshot.counters[i]));
+    out += line;
+  }
+
+  for (size_t i = 0; i < kHistogramCount; ++i) {
+    Histogram h = static_cast<Histogram>(i);
+    const char *name = Metrics::histogram_name(h);
+    const HistogramSnapshot &hist = snapshot.histograms[i];
+    snprintf(line, sizeof(line),
+             "# HELP zcoroutine_%s_seconds %s\n"
+             "# TYPE zcoroutine_%s_seconds histogram\n",
+             name, histogram_help(h), name);
+    out += line;
+    for (uint64_t bound : kExportBoundsNs) {
+      snprintf(line, sizeof(line),
+               "zcoroutine_%s_seconds_bucket{le=\"%g\"} %llu\n", name,
+               static_cast<double>(bound) / 1e9,
+               static_cast<unsigned long long>(hist.count_le(bound)));
+      out += line;
+    }
+    snprintf(line, sizeof(line),
+             "zcoroutine_%s_seconds_bucket{le=\"+Inf\"} %llu\n"
+             "zcoroutine_%s_seconds_sum %.9f\n"
+             "zcoroutine_%s_seconds_count %llu\n",
+             name, static_cast<unsigned long long>(hist.count), name,
+             static_cast<double>(hist.sum) / 1e9, name,
+             static_cast<unsigned long long>(hist.count));
+    out += line;
+  }
+
+  snprintf(line, sizeof(line),
+           "# HELP zcoroutine_metric_shards Per-thread metric shards\n"
+           "# TYPE zcoroutine_metric_shards gauge\n"
+           "zcoroutine_metric_shards %zu\n",
+           snapshot.shard_count);
+  out += line;
+  return out;
+}
+
+bool MetricsExporter::write_file(const std::string &path) {
+  std::string text = to_prometheus(Metrics::instance().snapshot());
+  std::string tmp = path + ".tmp";
+
+  FILE *file = fopen(tmp.c_str(), "w");
+  if (!file) {
+    ZCOROUTINE_LOG_ERROR("MetricsExporter::write_file open failed: path={}, "
+                         "errno={}",
+                         tmp, errno);
+    return false;
+  }
+  bool ok = fwrite(text.data(), 1, text.size(), file) == text.size();
+  ok = (fclose(file) == 0) && ok;
+  if (!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+    ZCOROUTINE_LOG_ERROR("MetricsExporter::write_file failed: path={}, "
+                         "errno={}",
+                         path, errno);
+    unlink(tmp.c_str());
+    return false;
+  }
+  return true;
+}
+
+int MetricsExporter::serve(const std::string &socket_path) {
+  if (listen_fd_ >= 0) {
+    errno = EBUSY;
+    return -1;
+  }
+
+  struct sockaddr_un addr {};
+  if (socket_path.size() >= sizeof(addr.sun_path)) {
+    errno = ENAMETOOLONG;
+    return -1;
+  }
+  addr.sun_family = AF_UNIX;
+  memcpy(addr.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  unlink(socket_path.c_str());
+  if (bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0 ||
+      listen(fd, 16) != 0) {
+    int saved = errno;
+    ZCOROUTINE_LOG_ERROR("MetricsExporter::serve bind/listen failed: path={}, "
+                         "errno={}",
+                         socket_path, saved);
+    close(fd);
+    errno = saved;
+    return -1;
+  }
+
+  listen_fd_ = fd;
+  socket_path_ = socket_path;
+  stopping_.store(false, std::memory_order_relaxed);
+  thread_ = std::thread([this]() { serve_loop(); });
+  ZCOROUTINE_LOG_INFO("MetricsExporter serving on {}", socket_path);
+  return 0;
+}
+
+void MetricsExporter::serve_loop() {
+  while (!stopping_.load(std::memory_order_relaxed)) {
+    int client = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    std::string text = to_prometheus(Metrics::instance().snapshot());
+    size_t offset = 0;
+    while (offset < text.size()) {
+      ssize_t n = send(client, text.data() + offset, text.size() - offset,
+                       MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        break;
+      }
+      offset += static_cast<size_t>(n);
+    }
+    close(client);
+  }
+}
+
+void MetricsExporter::stop() {
+  if (listen_fd_ < 0) {
+    return;
+  }
+  stopping_.store(true, std::memory_order_relaxed);
+  // shutdown使阻塞中的accept返回
+  shutdown(listen_fd_, SHUT_RDWR);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  close(listen_fd_);
+  listen_fd_ = -1;
+  unlink(socket_path_.c_str());
+  ZCOROUTINE_LOG_INFO("MetricsExporter stopped serving {}", socket_path_);
+}
+
+} // namespace zcoroutine
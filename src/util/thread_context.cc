@@ -13,6 +13,9 @@ constexpr int ThreadContext::kMaxCallStackDepth;
 // 线程本地变量，存储当前线程的上下文
 thread_local std::unique_ptr<ThreadContext> t_thread_context = nullptr;
 
+// 当前协程的裸指针，供信号处理函数读取
+static thread_local Fiber *t_current_fiber_raw = nullptr;
+
 ThreadContext *ThreadContext::get_current() {
   if (!t_thread_context) {
     t_thread_context = std::make_unique<ThreadContext>();
@@ -34,9 +37,11 @@ void ThreadContext::set_main_fiber(const Fiber::ptr &fiber) {
           fiber;
     }
     ctx->scheduler_ctx_.current_fiber = fiber; // 设置当前协程为 current fiber
+    t_current_fiber_raw = fiber.get();
   } else {
     ctx->scheduler_ctx_.call_stack_size = 0;
     ctx->scheduler_ctx_.current_fiber.reset();
+    t_current_fiber_raw = nullptr;
   }
 }
 
@@ -46,8 +51,11 @@ Fiber::ptr ThreadContext::get_main_fiber() {
 
 void ThreadContext::set_current_fiber(const Fiber::ptr &fiber) {
   get_current()->scheduler_ctx_.current_fiber = fiber;
+  t_current_fiber_raw = fiber.get();
 }
 
+Fiber *ThreadContext::current_fiber_raw() { return t_current_fiber_raw; }
+
 Fiber::ptr ThreadContext::get_current_fiber() {
   return get_current()->scheduler_ctx_.current_fiber.lock();
 }
@@ -68,6 +76,14 @@ Scheduler *ThreadContext::get_scheduler() {
   return get_current()->scheduler_ctx_.scheduler;
 }
 
+void ThreadContext::set_worker_id(int id) {
+  get_current()->scheduler_ctx_.worker_id = id;
+}
+
+int ThreadContext::get_worker_id() {
+  return get_current()->scheduler_ctx_.worker_id;
+}
+
 void ThreadContext::set_stack_mode(StackMode mode) {
   get_current()->shared_stack_ctx_.stack_mode = mode;
 }
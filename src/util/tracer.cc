@@ -0,0 +1,295 @@
+#include "util/tracer.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+#include "scheduling/scheduler.h"
+#include "util/cycle_clock.h"
+#include "util/zcoroutine_logger.h"
+
+namespace zcoroutine {
+
+constexpr size_t Tracer::kDefaultCapacity;
+
+// ==================== TraceBuffer ====================
+
+TraceBuffer::TraceBuffer(size_t capacity, std::string thread_name)
+    : records_(capacity), mask_(capacity - 1),
+      thread_name_(std::move(thread_name)) {}
+
+std::vector<TraceRecord> TraceBuffer::snapshot() const {
+  const uint64_t capacity = mask_ + 1;
+  uint64_t end = written_.load(std::memory_order_acquire);
+  uint64_t begin = end > capacity ? end - capacity : 0;
+
+  std::vector<TraceRecord> out;
+  out.reserve(end - begin);
+  for (uint64_t i = begin; i < end; ++i) {
+    out.push_back(records_[i & mask_]);
+  }
+
+  // 拷贝期间写入方可能已覆盖最旧的一段，丢弃这部分。写入方在发布
+  // written_ = now + 1 之前就开始覆盖下标 now - capacity，它也可能不完整
+  uint64_t now = written_.load(std::memory_order_acquire);
+  if (now + 1 > capacity + begin) {
+    uint64_t overwritten =
+        std::min<uint64_t>(now + 1 - capacity - begin, out.size());
+    out.erase(out.begin(), out.begin() + overwritten);
+  }
+  return out;
+}
+
+// ==================== Tracer ====================
+
+static int g_signal_pipe[2] = {-1, -1};
+
+static void trace_signal_handler(int) {
+  // 只做异步信号安全的操作；绕过hook直接发起系统调用
+  char c = 1;
+  syscall(SYS_write, g_signal_pipe[1], &c, 1);
+}
+
+Tracer &Tracer::instance() {
+  // 不析构：信号导出线程与各线程的缓冲区可能在退出阶段仍被访问
+  static Tracer *tracer = new Tracer();
+  return *tracer;
+}
+
+Tracer::Tracer() : base_tsc_(now_tsc()) {}
+
+Tracer::~Tracer() = default;
+
+uint64_t Tracer::now_tsc() { return CycleClock::now(); }
+
+void Tracer::record(TraceEvent event, uint64_t fiber_id, int32_t arg) {
+  Tracer &tracer = instance();
+  if (!tracer.enabled()) {
+    return;
+  }
+  tracer.local_buffer()->append(event, fiber_id, arg, now_tsc());
+}
+
+void Tracer::set_buffer_capacity(size_t capacity) {
+  size_t rounded = 1;
+  while (rounded < capacity) {
+    rounded <<= 1;
+  }
+  capacity_.store(rounded, std::memory_order_relaxed);
+}
+
+TraceBuffer *Tracer::local_buffer() {
+  static thread_local TraceBuffer *t_buffer = nullptr;
+  if (t_buffer) {
+    return t_buffer;
+  }
+
+  std::string name;
+  Scheduler *scheduler = Scheduler::get_this();
+  if (scheduler) {
+    name = scheduler->name() + "_" + std::to_string(Scheduler::get_worker_id());
+  } else {
+    name = "thread_" + std::to_string(syscall(SYS_gettid));
+  }
+
+  auto buffer = std::unique_ptr<TraceBuffer>(new TraceBuffer(
+      capacity_.load(std::memory_order_relaxed), std::move(name)));
+  t_buffer = buffer.get();
+  std::lock_guard<std::mutex> lock(mutex_);
+  buffers_.push_back(std::move(buffer));
+  return t_buffer;
+}
+
+const char *Tracer::event_name(TraceEvent event) {
+  switch (event) {
+  case TraceEvent::kFiberCreate:
+    return "fiber_create";
+  case TraceEvent::kFiberResume:
+    return "fiber_resume";
+  case TraceEvent::kFiberYield:
+    return "fiber_yield";
+  case TraceEvent::kFiberTerminate:
+    return "fiber_terminate";
+  case TraceEvent::kTaskEnqueue:
+    return "task_enqueue";
+  case TraceEvent::kTaskDequeue:
+    return "task_dequeue";
+  case TraceEvent::kIoWait:
+    return "io_wait";
+  case TraceEvent::kIoReady:
+    return "io_ready";
+  case TraceEvent::kTimerFire:
+    return "timer_fire";
+  }
+  return "unknown";
+}
+
+std::string Tracer::dump_to_string() {
+  const double tpu = CycleClock::ticks_per_ns() * 1000.0;
+  const int pid = static_cast<int>(getpid());
+
+  std::vector<std::pair<std::string, std::vector<TraceRecord>>> threads;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &buffer : buffers_) {
+      threads.emplace_back(buffer->thread_name(), buffer->snapshot());
+    }
+  }
+
+  std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  char line[256];
+  auto emit = [&](const char *text) {
+    if (!first) {
+      out += ",\n";
+    }
+    first = false;
+    out += text;
+  };
+  auto ts_of = [&](uint64_t tsc) {
+    return (static_cast<double>(tsc) - static_cast<double>(base_tsc_)) / tpu;
+  };
+
+  for (size_t tid = 0; tid < threads.size(); ++tid) {
+    const std::vector<TraceRecord> &records = threads[tid].second;
+    snprintf(line, sizeof(line),
+             "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%zu,"
+             "\"args\":{\"name\":\"%s\"}}",
+             pid, tid, threads[tid].first.c_str());
+    emit(line);
+
+    // resume与随后的yield/terminate配对成一个时间片；切换遵循栈顺序
+    std::vector<std::pair<uint64_t, double>> running;
+    for (const TraceRecord &r : records) {
+      double ts = ts_of(r.tsc);
+      switch (r.event) {
+      case TraceEvent::kFiberResume:
+        running.emplace_back(r.fiber_id, ts);
+        break;
+      case TraceEvent::kFiberYield:
+      case TraceEvent::kFiberTerminate:
+        if (!running.empty() && running.back().first == r.fiber_id) {
+          snprintf(line, sizeof(line),
+                   "{\"name\":\"fiber %llu\",\"cat\":\"fiber\",\"ph\":\"X\","
+                   "\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%zu,"
+                   "\"args\":{\"end\":\"%s\"}}",
+                   static_cast<unsigned long long>(r.fiber_id),
+                   running.back().second, ts - running.back().second, pid, tid,
+                   r.event == TraceEvent::kFiberYield ? "yield" : "terminate");
+          emit(line);
+          running.pop_back();
+        }
+        break;
+      case TraceEvent::kTaskEnqueue:
+      case TraceEvent::kTaskDequeue:
+        if (r.fiber_id != 0) {
+          // 同一协程的入队与出队用flow箭头连接，显示排队延迟
+          bool enqueue = r.event == TraceEvent::kTaskEnqueue;
+          snprintf(line, sizeof(line),
+                   "{\"name\":\"queue\",\"cat\":\"sched\",\"ph\":\"%s\","
+                   "\"id\":%llu,\"ts\":%.3f,\"pid\":%d,\"tid\":%zu%s}",
+                   enqueue ? "s" : "f",
+                   static_cast<unsigned long long>(r.fiber_id), ts, pid, tid,
+                   enqueue ? "" : ",\"bp\":\"e\"");
+          emit(line);
+        }
+        break;
+      default:
+        break;
+      }
+
+      if (r.event != TraceEvent::kFiberResume &&
+          r.event != TraceEvent::kFiberYield) {
+        snprintf(line, sizeof(line),
+                 "{\"name\":\"%s\",\"cat\":\"event\",\"ph\":\"i\",\"s\":\"t\","
+                 "\"ts\":%.3f,\"pid\":%d,\"tid\":%zu,"
+                 "\"args\":{\"fiber\":%llu,\"arg\":%d}}",
+                 event_name(r.event), ts, pid, tid,
+                 static_cast<unsigned long long>(r.fiber_id), r.arg);
+        emit(line);
+      }
+    }
+
+    // 导出时仍在运行的协程，时间片截止到最后一条记录
+    double last_ts = records.empty() ? 0 : ts_of(records.back().tsc);
+    for (const auto &item : running) {
+      snprintf(line, sizeof(line),
+               "{\"name\":\"fiber %llu\",\"cat\":\"fiber\",\"ph\":\"X\","
+               "\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%zu,"
+               "\"args\":{\"end\":\"running\"}}",
+               static_cast<unsigned long long>(item.first), item.second,
+               last_ts - item.second, pid, tid);
+      emit(line);
+    }
+  }
+
+  out += "]}\n";
+  return out;
+}
+
+bool Tracer::dump(const std::string &path) {
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  if (!file) {
+    ZCOROUTINE_LOG_ERROR("Tracer::dump open failed: path={}", path);
+    return false;
+  }
+  file << dump_to_string();
+  ZCOROUTINE_LOG_INFO("Tracer dumped to {}", path);
+  return static_cast<bool>(file);
+}
+
+bool Tracer::install_signal_handler(int signo, const std::string &path_prefix) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (dump_thread_.joinable() || g_signal_pipe[0] >= 0) {
+    return false;
+  }
+  if (pipe2(g_signal_pipe, O_CLOEXEC) != 0) {
+    ZCOROUTINE_LOG_ERROR("Tracer::install_signal_handler pipe failed, errno={}",
+                         errno);
+    return false;
+  }
+
+  signal_prefix_ = path_prefix;
+  // 导出在独立线程中完成，信号处理函数只负责唤醒它
+  dump_thread_ = std::thread([this]() { dump_thread_func(); });
+  dump_thread_.detach();
+
+  struct sigaction sa {};
+  sa.sa_handler = trace_signal_handler;
+  sigemptyset(&sa.sa_mask);
+  sa.sa_flags = SA_RESTART;
+  if (sigaction(signo, &sa, nullptr) != 0) {
+    ZCOROUTINE_LOG_ERROR("Tracer::install_signal_handler sigaction failed, "
+                         "signo={}, errno={}",
+                         signo, errno);
+    return false;
+  }
+  ZCOROUTINE_LOG_INFO("Tracer signal handler installed: signo={}, prefix={}",
+                      signo, path_prefix);
+  return true;
+}
+
+void Tracer::dump_thread_func() {
+  char buf[16];
+  while (true) {
+    ssize_t n = syscall(SYS_read, g_signal_pipe[0], buf, sizeof(buf));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+    uint64_t seq = signal_dumps_.load(std::memory_order_relaxed);
+    std::string path = signal_prefix_ + "." + std::to_string(getpid()) + "." +
+                       std::to_string(seq) + ".json";
+    dump(path);
+    signal_dumps_.store(seq + 1, std::memory_order_release);
+  }
+}
+
+} // namespace zcoroutine
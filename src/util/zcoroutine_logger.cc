@@ -1,6 +1,21 @@
 #include "util/zcoroutine_logger.h"
 
 namespace zcoroutine {
+namespace detail {
+std::atomic<zlog::Logger *> g_logger{nullptr};
+
+zlog::Logger *load_logger() {
+  zlog::Logger::ptr logger = zlog::getLogger("zcoroutine_logger");
+  if (!logger) {
+    return nullptr;
+  }
+  // 管理器只保留首次注册的同名日志器；再持有一份引用，避免退出阶段析构后悬空
+  static zlog::Logger::ptr *holder = new zlog::Logger::ptr(logger);
+  g_logger.store(holder->get(), std::memory_order_release);
+  return holder->get();
+}
+} // namespace detail
+
 void init_logger(const zlog::LogLevel::value level) {
   auto builder = std::make_unique<zlog::GlobalLoggerBuilder>();
   builder->buildLoggerName("zcoroutine_logger");
@@ -11,9 +26,10 @@ void init_logger(const zlog::LogLevel::value level) {
   builder->buildLoggerSink<zlog::FileSink>("./logfile/zcoroutine.log");
   builder->buildLoggerSink<zlog::StdOutSink>();
   builder->build();
+  detail::load_logger();
 }
 zlog::Logger::ptr get_logger() {
   static zlog::Logger::ptr logger = zlog::getLogger("zcoroutine_logger");
   return logger;
 }
-} // namespace zcoroutine
\ No newline at end of file
+} // namespace zcoroutine
@@ -0,0 +1,227 @@
+/**
+ * @file accept_bench.cc
+ * @brief 回环地址上的建连速率基准（connections/sec）
+ *
+ * 对比两种accept方式：
+ *  - acceptor: TcpAcceptor，每个工作线程一个SO_REUSEPORT监听socket，批量accept4
+ *  - legacy:   单监听socket，每次可读事件只accept一个连接并重新add_event
+ *
+ * 客户端为普通阻塞线程：connect后等待服务端关闭连接（recv返回0），
+ * 保证每个计数的连接都经过了服务端处理。
+ */
+
+#include "hook/hook.h"
+#include "io/io_scheduler.h"
+#include "net/tcp_acceptor.h"
+#include "runtime/fiber.h"
+#include "util/zcoroutine_logger.h"
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <getopt.h>
+#include <iostream>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace zcoroutine;
+
+struct BenchConfig {
+  int server_threads = 4;
+  int client_threads = 4;
+  int duration = 5;
+  bool legacy = false;
+  bool shared_stack = false;
+};
+
+static std::atomic<uint64_t> g_handled{0};
+
+// ==================== legacy: 每次事件accept一个连接 ====================
+
+static IoScheduler *g_legacy_scheduler = nullptr;
+static int g_legacy_listen_fd = -1;
+static std::atomic<bool> g_legacy_running{false};
+
+static void legacy_accept_once() {
+  if (!g_legacy_running.load()) {
+    return;
+  }
+  set_hook_enable(true);
+  int fd = accept(g_legacy_listen_fd, nullptr, nullptr);
+  if (fd >= 0) {
+    g_legacy_scheduler->schedule(std::make_shared<Fiber>([fd]() {
+      g_handled.fetch_add(1, std::memory_order_relaxed);
+      close(fd);
+    }));
+  }
+  g_legacy_scheduler->add_event(g_legacy_listen_fd, FdContext::kRead,
+                                legacy_accept_once);
+}
+
+static uint16_t start_legacy(IoScheduler *scheduler) {
+  g_legacy_scheduler = scheduler;
+  g_legacy_listen_fd = socket_f(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  int yes = 1;
+  setsockopt(g_legacy_listen_fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+  struct sockaddr_in addr {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  bind(g_legacy_listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+  listen(g_legacy_listen_fd, 4096);
+  socklen_t len = sizeof(addr);
+  getsockname(g_legacy_listen_fd, reinterpret_cast<sockaddr *>(&addr), &len);
+
+  g_legacy_running = true;
+  scheduler->add_event(g_legacy_listen_fd, FdContext::kRead,
+                       legacy_accept_once);
+  return ntohs(addr.sin_port);
+}
+
+// ==================== 客户端 ====================
+
+static void client_loop(uint16_t port, const std::atomic<bool> &running,
+                        std::atomic<uint64_t> &connected,
+                        std::atomic<uint64_t> &failed) {
+  struct sockaddr_in addr {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  uint64_t local_ok = 0;
+  uint64_t local_failed = 0;
+  while (running.load(std::memory_order_relaxed)) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+      ++local_failed;
+      continue;
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+      ++local_failed;
+      ::close(fd);
+      continue;
+    }
+    char c;
+    // 等待服务端关闭，服务端先关闭使TIME_WAIT留在服务端，避免耗尽客户端端口
+    if (::recv(fd, &c, 1, 0) == 0) {
+      ++local_ok;
+    } else {
+      ++local_failed;
+    }
+    ::close(fd);
+  }
+  connected.fetch_add(local_ok);
+  failed.fetch_add(local_failed);
+}
+
+static void print_usage(const char *prog) {
+  std::cout << "用法: " << prog << " [选项]\n"
+            << "  -t <n>  服务端工作线程数 (默认4)\n"
+            << "  -c <n>  客户端线程数 (默认4)\n"
+            << "  -d <s>  测试时长秒数 (默认5)\n"
+            << "  -l      使用legacy单连接accept模式对比\n"
+            << "  -s      使用共享栈\n"
+            << "  -h      显示帮助\n";
+}
+
+int main(int argc, char *argv[]) {
+  signal(SIGPIPE, SIG_IGN);
+  zcoroutine::init_logger(zlog::LogLevel::value::ERROR);
+
+  BenchConfig config;
+  int opt;
+  while ((opt = getopt(argc, argv, "t:c:d:lsh")) != -1) {
+    switch (opt) {
+    case 't':
+      config.server_threads = atoi(optarg);
+      break;
+    case 'c':
+      config.client_threads = atoi(optarg);
+      break;
+    case 'd':
+      config.duration = atoi(optarg);
+      break;
+    case 'l':
+      config.legacy = true;
+      break;
+    case 's':
+      config.shared_stack = true;
+      break;
+    default:
+      print_usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  auto scheduler = std::make_shared<IoScheduler>(
+      config.server_threads, "AcceptBench", config.shared_stack);
+  scheduler->start();
+
+  TcpAcceptor::ptr acceptor;
+  uint16_t port = 0;
+  if (config.legacy) {
+    port = start_legacy(scheduler.get());
+  } else {
+    acceptor = std::make_shared<TcpAcceptor>(
+        scheduler.get(), "127.0.0.1", 0, [](int fd) {
+          g_handled.fetch_add(1, std::memory_order_relaxed);
+          close(fd);
+        });
+    if (!acceptor->start()) {
+      std::cerr << "TcpAcceptor 启动失败" << std::endl;
+      return 1;
+    }
+    port = acceptor->port();
+  }
+
+  std::cout << "模式: " << (config.legacy ? "legacy" : "acceptor")
+            << ", 服务端线程: " << config.server_threads
+            << ", 客户端线程: " << config.client_threads
+            << ", 时长: " << config.duration << "s" << std::endl;
+
+  std::atomic<bool> running{true};
+  std::atomic<uint64_t> connected{0};
+  std::atomic<uint64_t> failed{0};
+  std::vector<std::thread> clients;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < config.client_threads; ++i) {
+    clients.emplace_back(client_loop, port, std::cref(running),
+                         std::ref(connected), std::ref(failed));
+  }
+
+  std::this_thread::sleep_for(std::chrono::seconds(config.duration));
+  running = false;
+  for (auto &t : clients) {
+    t.join();
+  }
+  double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  if (acceptor) {
+    acceptor->stop();
+  }
+  g_legacy_running = false;
+  scheduler->stop();
+
+  std::cout << "完成连接: " << connected.load() << ", 失败: " << failed.load()
+            << ", 服务端处理: " << g_handled.load() << std::endl;
+  std::cout << "建连速率: " << static_cast<uint64_t>(connected.load() / elapsed)
+            << " conn/s" << std::endl;
+  if (acceptor) {
+    std::cout << "监听socket数: " << acceptor->listener_count()
+              << ", epoll等待次数: " << acceptor->wait_count()
+              << ", 平均每次等待accept: "
+              << (acceptor->wait_count()
+                      ? static_cast<double>(acceptor->accepted_count()) /
+                            static_cast<double>(acceptor->wait_count())
+                      : 0.0)
+              << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""比较两次 primitives_bench 的JSON结果，标出性能回退。
+
+用法:
+    compare_bench.py base.json new.json [-t 10]
+
+对每个同名基准比较 ns_per_op（延迟类另外比较 p99_ns），数值越小越好。
+变化超过阈值（百分比）的标为回退/提升；存在回退时退出码为1，便于在脚本中使用。
+"""
+
+import argparse
+import json
+import sys
+
+METRICS = ("ns_per_op", "p99_ns")
+
+
+def load(path):
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+    return {r["name"]: r for r in data.get("results", [])}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="比较两次基准结果")
+    parser.add_argument("base", help="基准结果JSON")
+    parser.add_argument("new", help="新结果JSON")
+    parser.add_argument("-t", "--threshold", type=float, default=10.0,
+                        help="判定回退的变化百分比 (默认10)")
+    args = parser.parse_args()
+
+    base = load(args.base)
+    new = load(args.new)
+
+    regressions = 0
+    print("%-36s %-10s %12s %12s %9s" % ("基准", "指标", "base", "new", "变化"))
+    for name in sorted(set(base) | set(new)):
+        if name not in base or name not in new:
+            print("%-36s %s" % (name, "仅在base中" if name in base else "仅在new中"))
+            continue
+        for metric in METRICS:
+            old_value = base[name].get(metric)
+            new_value = new[name].get(metric)
+            if old_value is None or new_value is None or old_value <= 0:
+                continue
+            change = (new_value - old_value) / old_value * 100.0
+            flag = ""
+            if change > args.threshold:
+                flag = "  <-- 回退"
+                regressions += 1
+            elif change < -args.threshold:
+                flag = "  提升"
+            print("%-36s %-10s %12.1f %12.1f %+8.1f%%%s"
+                  % (name, metric, old_value, new_value, change, flag))
+
+    if regressions:
+        print("\n发现 %d 项回退（阈值 %.1f%%）" % (regressions, args.threshold))
+        return 1
+    print("\n未发现回退（阈值 %.1f%%）" % args.threshold)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,210 @@
+/**
+ * @file connection_pool_bench.cc
+ * @brief 出站短调用吞吐基准（calls/sec）
+ *
+ * 客户端协程循环执行"取连接 -> 发送请求 -> 读取回显 -> 归还"：
+ *  - pool:   ConnectionPool借出/归还连接
+ *  - direct: 每次调用socket + connect_with_timeout + close
+ *
+ * 服务端为TcpAcceptor上的回显服务，运行在独立的IoScheduler中。
+ */
+
+#include "hook/hook.h"
+#include "io/io_scheduler.h"
+#include "net/connection_pool.h"
+#include "net/tcp_acceptor.h"
+#include "runtime/fiber.h"
+#include "util/zcoroutine_logger.h"
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <getopt.h>
+#include <iostream>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace zcoroutine;
+
+struct BenchConfig {
+  int server_threads = 2;
+  int client_threads = 2;
+  int fibers = 32;
+  int duration = 5;
+  size_t max_connections = 16;
+  bool direct = false;
+};
+
+static const char kRequest[] = "ping";
+static const size_t kRequestLen = sizeof(kRequest) - 1;
+
+static bool do_call(int fd) {
+  if (write(fd, kRequest, kRequestLen) != static_cast<ssize_t>(kRequestLen)) {
+    return false;
+  }
+  char buf[kRequestLen];
+  size_t got = 0;
+  while (got < kRequestLen) {
+    ssize_t n = read(fd, buf + got, kRequestLen - got);
+    if (n <= 0) {
+      return false;
+    }
+    got += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+static bool direct_call(const sockaddr_in &addr) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return false;
+  }
+  bool ok = connect_with_timeout(fd, reinterpret_cast<const sockaddr *>(&addr),
+                                 sizeof(addr), 1000) == 0 &&
+            do_call(fd);
+  close(fd);
+  return ok;
+}
+
+static void print_usage(const char *prog) {
+  std::cout << "用法: " << prog << " [选项]\n"
+            << "  -t <n>  服务端工作线程数 (默认2)\n"
+            << "  -c <n>  客户端工作线程数 (默认2)\n"
+            << "  -f <n>  客户端协程数 (默认32)\n"
+            << "  -m <n>  连接池每端点连接上限 (默认16)\n"
+            << "  -d <s>  测试时长秒数 (默认5)\n"
+            << "  -n      不使用连接池，每次调用新建连接\n"
+            << "  -h      显示帮助\n";
+}
+
+int main(int argc, char *argv[]) {
+  signal(SIGPIPE, SIG_IGN);
+  zcoroutine::init_logger(zlog::LogLevel::value::ERROR);
+
+  BenchConfig config;
+  int opt;
+  while ((opt = getopt(argc, argv, "t:c:f:m:d:nh")) != -1) {
+    switch (opt) {
+    case 't':
+      config.server_threads = atoi(optarg);
+      break;
+    case 'c':
+      config.client_threads = atoi(optarg);
+      break;
+    case 'f':
+      config.fibers = atoi(optarg);
+      break;
+    case 'm':
+      config.max_connections = static_cast<size_t>(atoi(optarg));
+      break;
+    case 'd':
+      config.duration = atoi(optarg);
+      break;
+    case 'n':
+      config.direct = true;
+      break;
+    default:
+      print_usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  auto server = std::make_shared<IoScheduler>(config.server_threads,
+                                              "PoolBenchServer");
+  server->start();
+  auto acceptor = std::make_shared<TcpAcceptor>(
+      server.get(), "127.0.0.1", 0, [](int fd) {
+        char buf[256];
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof(buf))) > 0) {
+          if (write(fd, buf, static_cast<size_t>(n)) != n) {
+            break;
+          }
+        }
+        close(fd);
+      });
+  if (!acceptor->start()) {
+    std::cerr << "TcpAcceptor 启动失败" << std::endl;
+    return 1;
+  }
+  uint16_t port = acceptor->port();
+
+  struct sockaddr_in addr {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  auto client = std::make_shared<IoScheduler>(config.client_threads,
+                                              "PoolBenchClient");
+  client->start();
+
+  ConnectionPool::Options options;
+  options.max_connections = config.max_connections;
+  options.acquire_timeout_ms = 5000;
+  auto pool = std::make_shared<ConnectionPool>(client.get(), options);
+  pool->start();
+
+  std::cout << "模式: " << (config.direct ? "direct" : "pool")
+            << ", 客户端协程: " << config.fibers
+            << ", 连接上限: " << config.max_connections
+            << ", 时长: " << config.duration << "s" << std::endl;
+
+  std::atomic<bool> running{true};
+  std::atomic<int> finished{0};
+  std::atomic<uint64_t> calls{0};
+  std::atomic<uint64_t> failed{0};
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < config.fibers; ++i) {
+    client->schedule(std::make_shared<Fiber>([&]() {
+      set_hook_enable(true);
+      uint64_t local_ok = 0;
+      uint64_t local_failed = 0;
+      while (running.load(std::memory_order_relaxed)) {
+        bool ok;
+        if (config.direct) {
+          ok = direct_call(addr);
+        } else {
+          ConnectionPool::Connection conn = pool->acquire("127.0.0.1", port);
+          ok = conn && do_call(conn.fd());
+          if (conn && !ok) {
+            conn.mark_broken();
+          }
+        }
+        ok ? ++local_ok : ++local_failed;
+      }
+      calls.fetch_add(local_ok);
+      failed.fetch_add(local_failed);
+      ++finished;
+    }));
+  }
+
+  std::this_thread::sleep_for(std::chrono::seconds(config.duration));
+  running = false;
+  while (finished.load() < config.fibers) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  std::cout << "成功调用: " << calls.load() << ", 失败: " << failed.load()
+            << std::endl;
+  std::cout << "吞吐: " << static_cast<uint64_t>(calls.load() / elapsed)
+            << " calls/sec" << std::endl;
+  if (!config.direct) {
+    ConnectionPool::Stats stats = pool->stats();
+    std::cout << "命中率: " << stats.hit_rate() * 100 << "%"
+              << ", 新建连接: " << stats.misses << ", 等待次数: " << stats.waits
+              << ", 平均等待: " << stats.avg_wait_us() << "us"
+              << ", 等待超时: " << stats.wait_timeouts << std::endl;
+  }
+
+  pool->stop();
+  client->stop();
+  acceptor->stop();
+  server->stop();
+  return 0;
+}
@@ -0,0 +1,362 @@
+/**
+ * @file fiber_memory_bench.cc
+ * @brief 大量挂起协程在不同栈模式下的内存占用与唤醒开销
+ *
+ * 每个协程先在栈上占用-d字节，再在hook后的socketpair读端上挂起；
+ * 全部挂起后由主线程逐个写入1字节唤醒。每种栈模式在独立的子进程中运行，
+ * 以免前一次运行的内存残留影响VmRSS。输出：
+ *  - 创建速率：从创建协程到全部挂起
+ *  - 每协程内存：全部挂起后相对基线的VmRSS增量
+ *  - 唤醒吞吐：写入到全部协程恢复并结束
+ *  - 复制字节数：共享栈切换时保存/恢复的总字节（Metrics计数）
+ *
+ * 共享栈由本基准按-b创建（每个缓冲区数量一次运行），协程只能在同一线程上
+ * 恢复，因此只使用一个工作线程。新增栈模式时在kStackModes中登记。
+ *
+ * 100万协程需要约200万个fd，请先调大 ulimit -n 与 fs.nr_open。
+ */
+
+#include "hook/hook.h"
+#include "io/io_scheduler.h"
+#include "io/status_table.h"
+#include "runtime/fiber.h"
+#include "runtime/shared_stack.h"
+#include "util/metrics.h"
+#include "util/zcoroutine_logger.h"
+
+#include <alloca.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <getopt.h>
+#include <iostream>
+#include <malloc.h>
+#include <signal.h>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace zcoroutine;
+
+/**
+ * @brief 栈模式描述
+ */
+struct StackModeSpec {
+  const char *name;
+  bool shared; // 是否使用共享栈（按缓冲区数量分别运行）
+};
+
+static const StackModeSpec kStackModes[] = {
+    {"independent", false},
+    {"shared", true},
+};
+
+struct BenchConfig {
+  int fibers = 10000;
+  size_t depth = 2048;                              // 每个协程占用的栈字节数
+  size_t stack_size = StackAllocator::kDefaultStackSize; // 独立栈大小
+  std::vector<std::string> modes;
+  std::vector<int> buffer_counts = {1, 4, 16};
+};
+
+/**
+ * @brief 单次运行的结果，经管道从子进程传回
+ */
+struct RunResult {
+  char mode[32];
+  int buffers;
+  int fibers;
+  double create_per_sec;
+  double wake_per_sec;
+  long rss_kb;
+  uint64_t bytes_copied;
+  bool ok;
+};
+
+static std::atomic<int> g_parked{0};
+static std::atomic<int> g_woken{0};
+
+// 读取/proc/self/status中的VmRSS（KB）
+static long read_rss_kb() {
+  std::ifstream in("/proc/self/status");
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.compare(0, 6, "VmRSS:") == 0) {
+      return atol(line.c_str() + 6);
+    }
+  }
+  return -1;
+}
+
+// 尝试把fd上限调到need，返回实际上限
+static long raise_nofile(long need) {
+  struct rlimit rl;
+  getrlimit(RLIMIT_NOFILE, &rl);
+  if (static_cast<long>(rl.rlim_cur) < need) {
+    rl.rlim_cur = std::min<rlim_t>(static_cast<rlim_t>(need), rl.rlim_max);
+    setrlimit(RLIMIT_NOFILE, &rl);
+    getrlimit(RLIMIT_NOFILE, &rl);
+  }
+  return static_cast<long>(rl.rlim_cur);
+}
+
+static bool wait_for(const std::atomic<int> &counter, int target) {
+  for (int i = 0; i < 120000 && counter.load() < target; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return counter.load() >= target;
+}
+
+// 在栈上占用depth字节后挂起在fd上，恢复后栈内容仍需有效
+static void __attribute__((noinline)) park_on(int fd, size_t depth) {
+  char *frame = static_cast<char *>(alloca(depth));
+  for (size_t i = 0; i < depth; i += 64) {
+    frame[i] = static_cast<char>(i);
+  }
+  g_parked.fetch_add(1, std::memory_order_relaxed);
+
+  char c;
+  ::read(fd, &c, 1);
+  __asm__ __volatile__("" : : "r"(frame) : "memory");
+  ::close(fd);
+  g_woken.fetch_add(1, std::memory_order_relaxed);
+}
+
+static RunResult run_once(const BenchConfig &config, const StackModeSpec &mode,
+                          int buffers) {
+  RunResult result{};
+  snprintf(result.mode, sizeof(result.mode), "%s", mode.name);
+  result.buffers = mode.shared ? buffers : 0;
+
+  auto scheduler =
+      std::make_shared<IoScheduler>(1, "FiberMemoryBench", false);
+  scheduler->start();
+  SharedStack::ptr shared_stack;
+  if (mode.shared) {
+    shared_stack = std::make_shared<SharedStack>(buffers);
+  }
+
+  // socketpair先建好，基线只包含协程以外的开销
+  std::vector<int> clients;
+  std::vector<int> servers;
+  clients.reserve(config.fibers);
+  servers.reserve(config.fibers);
+  for (int i = 0; i < config.fibers; ++i) {
+    int sv[2];
+    if (socketpair_f(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) != 0) {
+      std::cerr << "socketpair失败: " << strerror(errno) << ", 已建立 " << i
+                << std::endl;
+      break;
+    }
+    // 服务端一端交给hook托管（内核非阻塞），客户端一端保持阻塞
+    fcntl_f(sv[0], F_SETFL, fcntl_f(sv[0], F_GETFL) | O_NONBLOCK);
+    StatusTable::GetInstance()->add_socket(sv[0], false);
+    servers.push_back(sv[0]);
+    clients.push_back(sv[1]);
+  }
+  const int n = static_cast<int>(servers.size());
+  result.fibers = n;
+
+  malloc_trim(0);
+  const long base_kb = read_rss_kb();
+  const uint64_t copied_before =
+      Metrics::instance().snapshot().counter(Counter::kStackCopyBytes);
+
+  // ==================== 创建并挂起 ====================
+  const size_t depth = config.depth;
+  auto start = std::chrono::steady_clock::now();
+  for (int fd : servers) {
+    auto func = [fd, depth]() {
+      set_hook_enable(true);
+      park_on(fd, depth);
+    };
+    if (mode.shared) {
+      scheduler->schedule(
+          std::make_shared<Fiber>(func, shared_stack.get(), "park"));
+    } else {
+      scheduler->schedule(
+          std::make_shared<Fiber>(func, config.stack_size, "park"));
+    }
+  }
+  bool ok = wait_for(g_parked, n);
+  double create_s = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+  // 等最后一批协程完成挂起
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  malloc_trim(0);
+  result.rss_kb = read_rss_kb() - base_kb;
+  result.create_per_sec = n / create_s;
+
+  // ==================== 逐个唤醒 ====================
+  start = std::chrono::steady_clock::now();
+  for (int fd : clients) {
+    if (::write(fd, "w", 1) != 1) {
+      ok = false;
+    }
+  }
+  ok = wait_for(g_woken, n) && ok;
+  double wake_s = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  result.wake_per_sec = n / wake_s;
+  result.bytes_copied =
+      Metrics::instance().snapshot().counter(Counter::kStackCopyBytes) -
+      copied_before;
+  result.ok = ok;
+
+  for (int fd : clients) {
+    ::close(fd);
+  }
+  scheduler->stop();
+  return result;
+}
+
+// 在子进程中运行，避免多次运行之间的内存残留
+static bool run_in_child(const BenchConfig &config, const StackModeSpec &mode,
+                         int buffers, RunResult *result) {
+  int pipefd[2];
+  if (pipe(pipefd) != 0) {
+    return false;
+  }
+  pid_t pid = fork();
+  if (pid < 0) {
+    close(pipefd[0]);
+    close(pipefd[1]);
+    return false;
+  }
+  if (pid == 0) {
+    close(pipefd[0]);
+    RunResult r = run_once(config, mode, buffers);
+    ssize_t written = write(pipefd[1], &r, sizeof(r));
+    // 跳过大量协程和fd的析构
+    _exit(written == static_cast<ssize_t>(sizeof(r)) ? 0 : 1);
+  }
+
+  close(pipefd[1]);
+  ssize_t got = read(pipefd[0], result, sizeof(*result));
+  close(pipefd[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return got == static_cast<ssize_t>(sizeof(*result));
+}
+
+static std::vector<std::string> split(const std::string &text) {
+  std::vector<std::string> parts;
+  std::stringstream ss(text);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) {
+      parts.push_back(item);
+    }
+  }
+  return parts;
+}
+
+static void print_usage(const char *prog) {
+  std::cout << "用法: " << prog << " [选项]\n"
+            << "  -n <n>     协程数 (默认10000)\n"
+            << "  -d <n>     每个协程占用的栈字节数 (默认2048)\n"
+            << "  -S <kb>    独立栈大小KB (默认128)\n"
+            << "  -m <list>  栈模式，逗号分隔 (默认全部:";
+  for (const StackModeSpec &mode : kStackModes) {
+    std::cout << " " << mode.name;
+  }
+  std::cout << ")\n"
+            << "  -b <list>  共享栈缓冲区数量，逗号分隔 (默认1,4,16)\n"
+            << "  -h         显示帮助\n";
+}
+
+int main(int argc, char *argv[]) {
+  signal(SIGPIPE, SIG_IGN);
+  zcoroutine::init_logger(zlog::LogLevel::value::ERROR);
+
+  BenchConfig config;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:d:S:m:b:h")) != -1) {
+    switch (opt) {
+    case 'n':
+      config.fibers = atoi(optarg);
+      break;
+    case 'd':
+      config.depth = static_cast<size_t>(atol(optarg));
+      break;
+    case 'S':
+      config.stack_size = static_cast<size_t>(atol(optarg)) * 1024;
+      break;
+    case 'm':
+      config.modes = split(optarg);
+      break;
+    case 'b':
+      config.buffer_counts.clear();
+      for (const std::string &count : split(optarg)) {
+        config.buffer_counts.push_back(atoi(count.c_str()));
+      }
+      break;
+    default:
+      print_usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+  if (config.modes.empty()) {
+    for (const StackModeSpec &mode : kStackModes) {
+      config.modes.push_back(mode.name);
+    }
+  }
+
+  long limit = raise_nofile(2L * config.fibers + 1024);
+  if (2L * config.fibers + 1024 > limit) {
+    config.fibers = static_cast<int>((limit - 1024) / 2);
+    std::cout << "fd上限为 " << limit << "，协程数调整为 " << config.fibers
+              << std::endl;
+  }
+
+  std::cout << "协程数: " << config.fibers << ", 栈占用: " << config.depth
+            << " B, 独立栈大小: " << config.stack_size / 1024 << " KB"
+            << std::endl;
+
+  std::vector<RunResult> results;
+  for (const std::string &name : config.modes) {
+    const StackModeSpec *mode = nullptr;
+    for (const StackModeSpec &spec : kStackModes) {
+      if (name == spec.name) {
+        mode = &spec;
+      }
+    }
+    if (!mode) {
+      std::cerr << "未知栈模式: " << name << std::endl;
+      return 1;
+    }
+
+    std::vector<int> buffer_counts =
+        mode->shared ? config.buffer_counts : std::vector<int>{0};
+    for (int buffers : buffer_counts) {
+      RunResult result{};
+      if (!run_in_child(config, *mode, buffers, &result)) {
+        std::cerr << "运行失败: " << name << ", buffers=" << buffers
+                  << std::endl;
+        continue;
+      }
+      results.push_back(result);
+    }
+  }
+
+  printf("\n%-12s %8s %10s %12s %12s %10s %10s %12s\n", "mode", "buffers",
+         "fibers", "create/s", "wake/s", "rss_MB", "KB/fiber", "copied_MB");
+  for (const RunResult &r : results) {
+    printf("%-12s %8d %10d %12.0f %12.0f %10.1f %10.2f %12.1f%s\n", r.mode,
+           r.buffers, r.fibers, r.create_per_sec, r.wake_per_sec,
+           r.rss_kb / 1024.0,
+           r.fibers ? static_cast<double>(r.rss_kb) / r.fibers : 0.0,
+           r.bytes_copied / 1048576.0, r.ok ? "" : "  (超时)");
+  }
+  return 0;
+}
@@ -8,10 +8,12 @@
  * 3. 定时器密集场景
  * 4. IO事件密集场景
  *
- * 使用fork创建子进程运行wrk进行压测
+ * HTTP场景使用进程内的LoadGenerator压测（见load_generator.h），
+ * 支持闭环/开环两种模式，客户端与服务端可分别绑定到不同CPU。
  */
 
 #include "hook/hook.h"
+#include "load_generator.h"
 #include "io/io_scheduler.h"
 #include "runtime/fiber.h"
 #include "runtime/shared_stack.h"
@@ -29,19 +31,24 @@
 #include <sstream>
 #include <sys/resource.h>
 #include <sys/socket.h>
-#include <sys/wait.h>
 #include <thread>
 #include <unistd.h>
 
 using namespace zcoroutine;
+using zcoroutine::bench::LoadGenerator;
+using zcoroutine::bench::LoadOptions;
+using zcoroutine::bench::LoadResult;
 
 // ========================= 全局配置 =========================
 struct BenchConfig {
   int port = 9000;               // 服务器端口
   int thread_num = 4;            // 工作线程数
-  int wrk_threads = 4;           // wrk压测线程数
-  int wrk_connections = 100;     // wrk并发连接数
-  int wrk_duration = 10;         // wrk压测时长（秒）
+  int client_threads = 2;        // 压测客户端线程数
+  int client_connections = 100;  // 压测并发连接数
+  int duration = 10;             // 压测时长（秒）
+  double rate = 0;               // 开环总速率（请求/秒），0为闭环
+  std::vector<int> server_cpus;  // 服务端线程绑定的CPU
+  std::vector<int> client_cpus;  // 客户端线程绑定的CPU
   bool use_shared_stack = false; // 是否使用共享栈
   std::string test_name;         // 测试名称
 };
@@ -174,11 +181,8 @@ void accept_connection() {
 
   g_stats.connections_accepted.fetch_add(1, std::memory_order_relaxed);
 
-  // 设置客户端socket为非阻塞
-  int flags = fcntl(client_fd, F_GETFL, 0);
-  if (flags >= 0) {
-    fcntl(client_fd, F_SETFL, flags | O_NONBLOCK);
-  }
+  // hook后的accept已把fd登记为非阻塞；不要再由用户设置O_NONBLOCK，
+  // 否则recv在请求尚未到达时直接返回EAGAIN而不是挂起协程
 
   // 创建Fiber处理客户端
   if (g_io_scheduler) {
@@ -242,6 +246,7 @@ void start_server(const BenchConfig &config) {
   // 创建IoScheduler
   g_io_scheduler = std::make_shared<IoScheduler>(
       config.thread_num, "BenchServer", config.use_shared_stack);
+  bench::pin_scheduler(g_io_scheduler.get(), config.server_cpus);
   g_io_scheduler->start();
 
   set_hook_enable(true);
@@ -271,46 +276,26 @@ void stop_server() {
   }
 }
 
-// ========================= WRK压测 =========================
+// ========================= 压测客户端 =========================
 
-struct WrkResult {
-  double requests_per_sec = 0;
-  double avg_latency_ms = 0;
-  double max_latency_ms = 0;
-  uint64_t total_requests = 0;
-  double transfer_rate_mb = 0;
-  bool success = false;
-};
+LoadResult run_load(const BenchConfig &config) {
+  LoadOptions options;
+  options.port = static_cast<uint16_t>(config.port);
+  options.threads = config.client_threads;
+  options.connections = config.client_connections;
+  options.duration_s = config.duration;
+  options.rate = config.rate;
+  options.cpus = config.client_cpus;
 
-WrkResult run_wrk(const BenchConfig &config) {
-  WrkResult result;
-
-  std::ostringstream cmd;
-  cmd << "wrk -t" << config.wrk_threads << " -c" << config.wrk_connections
-      << " -d" << config.wrk_duration << "s"
-      << " http://127.0.0.1:" << config.port << "/" << " 2>&1";
-
-  std::cout << "Running: " << cmd.str() << std::endl;
-
-  pid_t pid = fork();
-  if (pid == 0) {
-    // 子进程
-    // 等待服务器完全启动
-    usleep(500000); // 500ms
-
-    execlp("sh", "sh", "-c", cmd.str().c_str(), nullptr);
-    _exit(1);
-  } else if (pid > 0) {
-    // 父进程等待
-    int status;
-    waitpid(pid, &status, 0);
-    result.success = WIFEXITED(status) && WEXITSTATUS(status) == 0;
-  } else {
-    std::cerr << "fork failed" << std::endl;
-    result.success = false;
+  std::cout << "压测: " << (config.rate > 0 ? "开环" : "闭环") << ", 连接数 "
+            << options.connections;
+  if (config.rate > 0) {
+    std::cout << ", 目标速率 " << config.rate << " req/s";
   }
+  std::cout << std::endl;
 
-  return result;
+  LoadGenerator generator(options);
+  return generator.run();
 }
 
 // ========================= 定时器密集测试 =========================
@@ -455,112 +440,104 @@ void run_http_benchmark(BenchConfig config) {
   std::cout << "  工作线程: " << config.thread_num << std::endl;
   std::cout << "  共享栈: " << (config.use_shared_stack ? "是" : "否")
             << std::endl;
-  std::cout << "  wrk线程: " << config.wrk_threads << std::endl;
-  std::cout << "  wrk连接: " << config.wrk_connections << std::endl;
-  std::cout << "  wrk时长: " << config.wrk_duration << "s" << std::endl;
+  std::cout << "  客户端线程: " << config.client_threads << std::endl;
+  std::cout << "  客户端连接: " << config.client_connections << std::endl;
+  std::cout << "  压测时长: " << config.duration << "s" << std::endl;
   std::cout << "========================================\n" << std::endl;
 
   // 启动服务器
   start_server(config);
 
-  // 运行wrk压测
-  run_wrk(config);
+  // 运行压测
+  LoadResult result = run_load(config);
 
   // 停止服务器
   stop_server();
 
   // 打印统计
   g_stats.print(config.test_name);
+  std::cout << "---------- 客户端统计 ----------" << std::endl;
+  result.print(std::cout);
+}
+
+// 场景列表为空时运行全部场景，否则只运行列出的场景
+static bool scenario_enabled(const std::string &scenarios,
+                             const std::string &name) {
+  if (scenarios.empty() || scenarios == "all") {
+    return true;
+  }
+  std::stringstream ss(scenarios);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (item == name) {
+      return true;
+    }
+  }
+  return false;
 }
 
-void run_all_benchmarks(int wrk_duration, int thread_num) {
+void run_all_benchmarks(const BenchConfig &base, const std::string &scenarios) {
   std::cout << "\n" << std::string(60, '=') << std::endl;
   std::cout << "zcoroutine 性能基准测试" << std::endl;
   std::cout << std::string(60, '=') << std::endl;
   std::cout << "测试时间: "
             << std::chrono::system_clock::now().time_since_epoch().count()
             << std::endl;
-  std::cout << "线程数: " << thread_num << std::endl;
-  std::cout << "wrk测试时长: " << wrk_duration << "s" << std::endl;
+  std::cout << "线程数: " << base.thread_num << std::endl;
+  std::cout << "压测时长: " << base.duration << "s" << std::endl;
   std::cout << std::string(60, '=') << "\n" << std::endl;
 
   // 测试1: 独立栈HTTP测试
-  {
-    BenchConfig config;
+  if (scenario_enabled(scenarios, "http")) {
+    BenchConfig config = base;
     config.port = 9001;
-    config.thread_num = thread_num;
     config.use_shared_stack = false;
-    config.wrk_duration = wrk_duration;
-    config.wrk_threads = 4;
-    config.wrk_connections = 100;
     config.test_name = "独立栈HTTP测试";
     run_http_benchmark(config);
+    std::this_thread::sleep_for(std::chrono::seconds(2));
   }
 
-  std::this_thread::sleep_for(std::chrono::seconds(2));
-
   // 测试2: 共享栈HTTP测试
-  {
-    BenchConfig config;
+  if (scenario_enabled(scenarios, "http_shared")) {
+    BenchConfig config = base;
     config.port = 9002;
-    config.thread_num = thread_num;
     config.use_shared_stack = true;
-    config.wrk_duration = wrk_duration;
-    config.wrk_threads = 4;
-    config.wrk_connections = 100;
     config.test_name = "共享栈HTTP测试";
     run_http_benchmark(config);
+    std::this_thread::sleep_for(std::chrono::seconds(1));
   }
 
-  std::this_thread::sleep_for(std::chrono::seconds(1));
-
-  // 测试3: 独立栈Fiber密集测试
-  {
-    BenchConfig config;
-    config.thread_num = thread_num;
+  // 测试3、4: Fiber密集测试
+  if (scenario_enabled(scenarios, "fiber")) {
+    BenchConfig config = base;
     config.use_shared_stack = false;
     config.test_name = "独立栈";
     fiber_intensive_test(config);
-  }
 
-  // 测试4: 共享栈Fiber密集测试
-  {
-    BenchConfig config;
-    config.thread_num = thread_num;
     config.use_shared_stack = true;
     config.test_name = "共享栈";
     fiber_intensive_test(config);
   }
 
-  // 测试5: 独立栈上下文切换测试
-  {
-    BenchConfig config;
+  // 测试5、6: 上下文切换测试
+  if (scenario_enabled(scenarios, "switch")) {
+    BenchConfig config = base;
     config.use_shared_stack = false;
     config.test_name = "独立栈";
     context_switch_test(config);
-  }
 
-  // 测试6: 共享栈上下文切换测试
-  {
-    BenchConfig config;
     config.use_shared_stack = true;
     config.test_name = "共享栈";
     context_switch_test(config);
   }
 
-  // 测试7: 独立栈定时器测试
-  {
-    BenchConfig config;
-    config.thread_num = thread_num;
+  // 测试7、8: 定时器测试
+  if (scenario_enabled(scenarios, "timer")) {
+    BenchConfig config = base;
     config.use_shared_stack = false;
     config.test_name = "独立栈";
     timer_intensive_test(config);
-  }
 
-  // 测试8: 共享栈定时器测试
-  {
-    BenchConfig config;
-    config.thread_num = thread_num;
     config.use_shared_stack = true;
     config.test_name = "共享栈";
     timer_intensive_test(config);
@@ -576,8 +553,15 @@ void run_all_benchmarks(int wrk_duration, int thread_num) {
 void print_usage(const char *prog) {
   std::cout << "Usage: " << prog << " [options]\n"
             << "Options:\n"
-            << "  -t <threads>    工作线程数 (default: 4)\n"
-            << "  -d <duration>   wrk测试时长秒 (default: 10)\n"
+            << "  -t <threads>    服务端工作线程数 (default: 4)\n"
+            << "  -d <duration>   压测时长秒 (default: 10)\n"
+            << "  -c <conns>      压测并发连接数 (default: 100)\n"
+            << "  -l <threads>    压测客户端线程数 (default: 2)\n"
+            << "  -R <rate>       开环模式总速率req/s，0为闭环 (default: 0)\n"
+            << "  -S <cpus>       服务端线程绑定的CPU，如 0-3\n"
+            << "  -C <cpus>       客户端线程绑定的CPU，如 4-5\n"
+            << "  -s <scenarios>  运行的场景，逗号分隔: "
+               "http,http_shared,fiber,switch,timer (default: all)\n"
             << "  -h              显示帮助\n";
 }
 
@@ -588,18 +572,36 @@ int main(int argc, char *argv[]) {
   // 初始化日志系统（WARNING级别以避免太多日志输出）
   zcoroutine::init_logger(zlog::LogLevel::value::WARNING);
 
-  int thread_num = 4;
-  int wrk_duration = 10;
+  BenchConfig config;
+  std::string scenarios;
 
   // 解析命令行参数
   int opt;
-  while ((opt = getopt(argc, argv, "t:d:h")) != -1) {
+  while ((opt = getopt(argc, argv, "t:d:c:l:R:S:C:s:h")) != -1) {
     switch (opt) {
     case 't':
-      thread_num = std::atoi(optarg);
+      config.thread_num = std::atoi(optarg);
       break;
     case 'd':
-      wrk_duration = std::atoi(optarg);
+      config.duration = std::atoi(optarg);
+      break;
+    case 'c':
+      config.client_connections = std::atoi(optarg);
+      break;
+    case 'l':
+      config.client_threads = std::atoi(optarg);
+      break;
+    case 'R':
+      config.rate = std::atof(optarg);
+      break;
+    case 'S':
+      config.server_cpus = bench::parse_cpu_list(optarg);
+      break;
+    case 'C':
+      config.client_cpus = bench::parse_cpu_list(optarg);
+      break;
+    case 's':
+      scenarios = optarg;
       break;
     case 'h':
       print_usage(argv[0]);
@@ -610,15 +612,8 @@ int main(int argc, char *argv[]) {
     }
   }
 
-  // 检查wrk是否可用
-  if (system("which wrk > /dev/null 2>&1") != 0) {
-    std::cerr << "错误: 未找到wrk命令，请先安装wrk" << std::endl;
-    std::cerr << "Ubuntu/Debian: sudo apt-get install wrk" << std::endl;
-    return 1;
-  }
-
   // 运行所有基准测试
-  run_all_benchmarks(wrk_duration, thread_num);
+  run_all_benchmarks(config, scenarios);
 
   return 0;
 }
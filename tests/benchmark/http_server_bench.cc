@@ -0,0 +1,273 @@
+/**
+ * @file http_server_bench.cc
+ * @brief HttpServer 吞吐与延迟基准
+ *
+ * 服务端：HttpServer，路由 /plaintext（固定响应）与 /chunked（分块响应）。
+ * 客户端：每个连接一个阻塞线程，keep-alive，每批发送pipeline个请求后
+ * 读回全部响应；单个请求的延迟记为从本批发送到其响应完整到达的时间。
+ *
+ * -x 只启动服务端，供wrk等外部压测工具使用。
+ */
+
+#include "http/http_server.h"
+#include "io/io_scheduler.h"
+#include "util/zcoroutine_logger.h"
+
+#include <arpa/inet.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace zcoroutine;
+
+struct BenchConfig {
+  int server_threads = 2;
+  int connections = 4;
+  int pipeline = 1;
+  int duration = 5;
+  int port = 0;
+  bool shared_stack = false;
+  bool server_only = false;
+  std::string path = "/plaintext";
+};
+
+struct ClientResult {
+  uint64_t requests = 0;
+  uint64_t errors = 0;
+  std::vector<uint32_t> latencies_us;
+};
+
+/**
+ * @brief 读取一个完整响应（只处理Content-Length与分块两种格式）
+ * @return 成功返回true
+ */
+static bool read_response(int fd, std::string &buf) {
+  while (true) {
+    size_t head_end = buf.find("\r\n\r\n");
+    if (head_end != std::string::npos) {
+      size_t pos = head_end + 4;
+      size_t cl = buf.find("Content-Length: ");
+      if (cl != std::string::npos && cl < head_end) {
+        size_t len = std::strtoul(buf.c_str() + cl + 16, nullptr, 10);
+        if (buf.size() >= pos + len) {
+          buf.erase(0, pos + len);
+          return true;
+        }
+      } else {
+        size_t end = buf.find("\r\n0\r\n\r\n", head_end);
+        if (end != std::string::npos) {
+          buf.erase(0, end + 7);
+          return true;
+        }
+      }
+    }
+    char tmp[16384];
+    ssize_t n = ::recv(fd, tmp, sizeof(tmp), 0);
+    if (n <= 0) {
+      return false;
+    }
+    buf.append(tmp, static_cast<size_t>(n));
+  }
+}
+
+static void client_loop(const BenchConfig &config, uint16_t port,
+                        const std::atomic<bool> &running,
+                        ClientResult *result) {
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+    ++result->errors;
+    ::close(fd);
+    return;
+  }
+  int yes = 1;
+  ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+  std::string request =
+      "GET " + config.path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+  std::string batch;
+  for (int i = 0; i < config.pipeline; ++i) {
+    batch += request;
+  }
+
+  std::string buf;
+  result->latencies_us.reserve(1 << 20);
+  while (running.load(std::memory_order_relaxed)) {
+    auto start = std::chrono::steady_clock::now();
+    if (::send(fd, batch.data(), batch.size(), 0) !=
+        static_cast<ssize_t>(batch.size())) {
+      ++result->errors;
+      break;
+    }
+    for (int i = 0; i < config.pipeline; ++i) {
+      if (!read_response(fd, buf)) {
+        ++result->errors;
+        ::close(fd);
+        return;
+      }
+      auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+      result->latencies_us.push_back(static_cast<uint32_t>(us));
+      ++result->requests;
+    }
+  }
+  ::close(fd);
+}
+
+static void print_usage(const char *prog) {
+  std::cout << "用法: " << prog << " [选项]\n"
+            << "  -t <n>    服务端工作线程数 (默认2)\n"
+            << "  -c <n>    客户端连接数，每个连接一个线程 (默认4)\n"
+            << "  -P <n>    每批流水线请求数 (默认1)\n"
+            << "  -d <s>    测试时长秒数 (默认5)\n"
+            << "  -u <path> 请求路径: /plaintext 或 /chunked (默认/plaintext)\n"
+            << "  -p <port> 监听端口 (默认由内核分配)\n"
+            << "  -s        使用共享栈\n"
+            << "  -x        只启动服务端，供外部压测工具使用\n"
+            << "  -h        显示帮助\n";
+}
+
+int main(int argc, char *argv[]) {
+  signal(SIGPIPE, SIG_IGN);
+  zcoroutine::init_logger(zlog::LogLevel::value::ERROR);
+
+  BenchConfig config;
+  int opt;
+  while ((opt = getopt(argc, argv, "t:c:P:d:u:p:sxh")) != -1) {
+    switch (opt) {
+    case 't':
+      config.server_threads = atoi(optarg);
+      break;
+    case 'c':
+      config.connections = atoi(optarg);
+      break;
+    case 'P':
+      config.pipeline = std::max(1, atoi(optarg));
+      break;
+    case 'd':
+      config.duration = atoi(optarg);
+      break;
+    case 'u':
+      config.path = optarg;
+      break;
+    case 'p':
+      config.port = atoi(optarg);
+      break;
+    case 's':
+      config.shared_stack = true;
+      break;
+    case 'x':
+      config.server_only = true;
+      break;
+    default:
+      print_usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  auto scheduler = std::make_shared<IoScheduler>(
+      config.server_threads, "HttpBenchServer", config.shared_stack);
+  scheduler->start();
+
+  auto server = std::make_shared<HttpServer>(scheduler.get());
+  server->route("GET", "/plaintext",
+                [](const HttpRequest &, HttpResponse &resp) {
+                  resp.set_content_type("text/plain");
+                  resp.set_body("Hello, World!");
+                });
+  server->route("GET", "/chunked", [](const HttpRequest &, HttpResponse &resp) {
+    resp.set_content_type("text/plain");
+    resp.write_chunk("Hello, ");
+    resp.write_chunk("World!");
+  });
+  if (!server->start(config.server_only ? "0.0.0.0" : "127.0.0.1",
+                     static_cast<uint16_t>(config.port))) {
+    std::cerr << "HttpServer 启动失败" << std::endl;
+    return 1;
+  }
+  uint16_t port = server->port();
+
+  if (config.server_only) {
+    std::cout << "服务端已启动, 端口: " << port << ", 时长: " << config.duration
+              << "s" << std::endl;
+    std::this_thread::sleep_for(std::chrono::seconds(config.duration));
+    std::cout << "处理请求: " << server->request_count()
+              << ", 连接: " << server->connection_count() << std::endl;
+    server->stop();
+    scheduler->stop();
+    return 0;
+  }
+
+  std::cout << "路径: " << config.path
+            << ", 服务端线程: " << config.server_threads
+            << ", 连接: " << config.connections
+            << ", 流水线: " << config.pipeline
+            << ", 共享栈: " << (config.shared_stack ? "是" : "否")
+            << ", 时长: " << config.duration << "s" << std::endl;
+
+  std::atomic<bool> running{true};
+  std::vector<ClientResult> results(config.connections);
+  std::vector<std::thread> clients;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < config.connections; ++i) {
+    clients.emplace_back(client_loop, std::cref(config), port,
+                         std::cref(running), &results[i]);
+  }
+  std::this_thread::sleep_for(std::chrono::seconds(config.duration));
+  running = false;
+  for (auto &t : clients) {
+    t.join();
+  }
+  double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  uint64_t requests = 0;
+  uint64_t errors = 0;
+  std::vector<uint32_t> latencies;
+  for (auto &r : results) {
+    requests += r.requests;
+    errors += r.errors;
+    latencies.insert(latencies.end(), r.latencies_us.begin(),
+                     r.latencies_us.end());
+  }
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies](double p) -> uint32_t {
+    if (latencies.empty()) {
+      return 0;
+    }
+    size_t idx = static_cast<size_t>(p * (latencies.size() - 1));
+    return latencies[idx];
+  };
+
+  std::cout << "请求数: " << requests << ", 错误: " << errors << std::endl;
+  std::cout << "吞吐: " << std::fixed << std::setprecision(0)
+            << requests / elapsed << " req/s" << std::endl;
+  std::cout << "延迟(us): p50=" << percentile(0.50)
+            << " p90=" << percentile(0.90) << " p99=" << percentile(0.99)
+            << " p999=" << percentile(0.999)
+            << " max=" << (latencies.empty() ? 0 : latencies.back())
+            << std::endl;
+  std::cout << "服务端: 请求 " << server->request_count() << ", 连接 "
+            << server->connection_count() << std::endl;
+
+  server->stop();
+  scheduler->stop();
+  return 0;
+}
@@ -0,0 +1,263 @@
+/**
+ * @file idle_conn_bench.cc
+ * @brief 大量空闲连接的内存占用基准（VmRSS）
+ *
+ * 每个连接是一对socketpair：服务端一端由协程持有SocketStream，循环读取
+ * "4字节长度 + 负载"格式的请求并回复2字节"ok"；客户端一端由主线程直接读写。
+ *
+ * 阶段：
+ *  1. 建立N个连接，所有协程挂起等待第一个请求
+ *  2. 每个连接收发一次较大的请求（把读缓冲区撑大），之后回到空闲等待
+ *  3. 关闭全部连接
+ *
+ * 每个阶段后输出进程VmRSS与每连接平均内存。对比：
+ *  - 默认/-s共享栈：挂起协程的栈开销（独立栈128KB按需分页 vs 共享栈保存区）
+ *  - -l：关闭idle_park，空闲连接继续持有读写缓冲区
+ *
+ * 100万连接需要约200万个fd，请先调大 ulimit -n 与 fs.nr_open。
+ */
+
+#include "hook/hook.h"
+#include "io/io_scheduler.h"
+#include "io/status_table.h"
+#include "net/buffer_pool.h"
+#include "net/socket_stream.h"
+#include "runtime/fiber.h"
+#include "util/zcoroutine_logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <getopt.h>
+#include <iostream>
+#include <malloc.h>
+#include <signal.h>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace zcoroutine;
+
+struct BenchConfig {
+  int connections = 10000;
+  int threads = 1;
+  size_t message_size = 16 * 1024;
+  bool shared_stack = false;
+  bool legacy = false;
+};
+
+static std::atomic<int> g_started{0};
+static std::atomic<int> g_finished{0};
+
+// 读取/proc/self/status中的VmRSS（KB）
+static long read_rss_kb() {
+  std::ifstream in("/proc/self/status");
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.compare(0, 6, "VmRSS:") == 0) {
+      return atol(line.c_str() + 6);
+    }
+  }
+  return -1;
+}
+
+static void report(const char *phase, long base_kb, int connections) {
+  // 归还glibc缓存的空闲内存，只统计真正被占用的部分
+  malloc_trim(0);
+  long rss = read_rss_kb();
+  std::cout << phase << ": VmRSS=" << rss / 1024 << " MB";
+  if (connections > 0) {
+    std::cout << ", 每连接 "
+              << static_cast<double>(rss - base_kb) / connections << " KB";
+  }
+  std::cout << std::endl;
+}
+
+// 尝试把fd上限调到need，返回实际上限
+static long raise_nofile(long need) {
+  struct rlimit rl;
+  getrlimit(RLIMIT_NOFILE, &rl);
+  if (static_cast<long>(rl.rlim_cur) < need) {
+    rl.rlim_cur = std::min<rlim_t>(static_cast<rlim_t>(need), rl.rlim_max);
+    setrlimit(RLIMIT_NOFILE, &rl);
+    getrlimit(RLIMIT_NOFILE, &rl);
+  }
+  return static_cast<long>(rl.rlim_cur);
+}
+
+static void serve(int fd, bool idle_park) {
+  set_hook_enable(true);
+  SocketStream::Options options;
+  options.idle_park = idle_park;
+  SocketStream stream(fd, options);
+  g_started.fetch_add(1, std::memory_order_relaxed);
+
+  while (true) {
+    const char *head = stream.peek_exact(4);
+    if (!head) {
+      break;
+    }
+    uint32_t len;
+    memcpy(&len, head, sizeof(len));
+    stream.consume(4);
+    if (!stream.peek_exact(len)) {
+      break;
+    }
+    stream.consume(len);
+    stream.write("ok", 2);
+  }
+  g_finished.fetch_add(1, std::memory_order_relaxed);
+}
+
+static bool wait_for(const std::atomic<int> &counter, int target) {
+  for (int i = 0; i < 60000 && counter.load() < target; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return counter.load() >= target;
+}
+
+static void print_usage(const char *prog) {
+  std::cout << "用法: " << prog << " [选项]\n"
+            << "  -n <n>  连接数 (默认10000)\n"
+            << "  -t <n>  工作线程数 (默认1)\n"
+            << "  -m <n>  唤醒阶段的请求负载字节数 (默认16384)\n"
+            << "  -s      使用共享栈\n"
+            << "  -l      关闭空闲挂起（对比）\n"
+            << "  -h      显示帮助\n";
+}
+
+int main(int argc, char *argv[]) {
+  signal(SIGPIPE, SIG_IGN);
+  zcoroutine::init_logger(zlog::LogLevel::value::ERROR);
+
+  BenchConfig config;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:t:m:slh")) != -1) {
+    switch (opt) {
+    case 'n':
+      config.connections = atoi(optarg);
+      break;
+    case 't':
+      config.threads = atoi(optarg);
+      break;
+    case 'm':
+      config.message_size = static_cast<size_t>(atol(optarg));
+      break;
+    case 's':
+      config.shared_stack = true;
+      break;
+    case 'l':
+      config.legacy = true;
+      break;
+    default:
+      print_usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  long limit = raise_nofile(2L * config.connections + 1024);
+  if (2L * config.connections + 1024 > limit) {
+    config.connections = static_cast<int>((limit - 1024) / 2);
+    std::cout << "fd上限为 " << limit << "，连接数调整为 "
+              << config.connections << std::endl;
+  }
+
+  std::cout << "连接数: " << config.connections
+            << ", 线程: " << config.threads
+            << ", 栈模式: " << (config.shared_stack ? "共享栈" : "独立栈")
+            << ", 空闲挂起: " << (config.legacy ? "关闭" : "开启") << std::endl;
+
+  auto scheduler = std::make_shared<IoScheduler>(
+      config.threads, "IdleConnBench", config.shared_stack);
+  scheduler->start();
+
+  long base_kb = read_rss_kb();
+  report("初始", 0, 0);
+
+  // ==================== 阶段1：建立连接 ====================
+  auto start = std::chrono::steady_clock::now();
+  std::vector<int> clients;
+  clients.reserve(config.connections);
+  const bool idle_park = !config.legacy;
+  for (int i = 0; i < config.connections; ++i) {
+    int sv[2];
+    if (socketpair_f(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) != 0) {
+      std::cerr << "socketpair失败: " << strerror(errno) << ", 已建立 " << i
+                << std::endl;
+      config.connections = i;
+      break;
+    }
+    // 服务端一端交给hook托管（内核非阻塞），客户端一端保持阻塞
+    fcntl_f(sv[0], F_SETFL, fcntl_f(sv[0], F_GETFL) | O_NONBLOCK);
+    StatusTable::GetInstance()->add_socket(sv[0], false);
+    clients.push_back(sv[1]);
+
+    int server_fd = sv[0];
+    // 在工作线程上创建协程，共享栈模式下使用工作线程的共享栈
+    scheduler->schedule([scheduler, server_fd, idle_park]() {
+      scheduler->schedule(std::make_shared<Fiber>(
+          [server_fd, idle_park]() { serve(server_fd, idle_park); },
+          StackAllocator::kDefaultStackSize, "conn"));
+    });
+  }
+  if (!wait_for(g_started, config.connections)) {
+    std::cerr << "连接协程启动超时" << std::endl;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  double setup_s = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  std::cout << "建立耗时: " << setup_s << " s" << std::endl;
+  report("阶段1 全部空闲", base_kb, config.connections);
+
+  // ==================== 阶段2：每个连接一次请求 ====================
+  std::string request(4 + config.message_size, 'r');
+  uint32_t len = static_cast<uint32_t>(config.message_size);
+  memcpy(&request[0], &len, sizeof(len));
+
+  start = std::chrono::steady_clock::now();
+  uint64_t ok = 0;
+  for (int fd : clients) {
+    size_t sent = 0;
+    while (sent < request.size()) {
+      ssize_t n = ::write(fd, request.data() + sent, request.size() - sent);
+      if (n <= 0) {
+        break;
+      }
+      sent += static_cast<size_t>(n);
+    }
+    char rsp[2];
+    size_t got = 0;
+    while (got < sizeof(rsp)) {
+      ssize_t n = ::read(fd, rsp + got, sizeof(rsp) - got);
+      if (n <= 0) {
+        break;
+      }
+      got += static_cast<size_t>(n);
+    }
+    if (got == sizeof(rsp)) {
+      ++ok;
+    }
+  }
+  double wake_s = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  std::cout << "请求完成: " << ok << ", 耗时: " << wake_s << " s, "
+            << static_cast<uint64_t>(ok / wake_s) << " req/s" << std::endl;
+  report("阶段2 请求后空闲", base_kb, config.connections);
+
+  // ==================== 阶段3：关闭 ====================
+  for (int fd : clients) {
+    ::close(fd);
+  }
+  wait_for(g_finished, config.connections);
+  scheduler->stop();
+  report("阶段3 全部关闭", base_kb, config.connections);
+  return 0;
+}
@@ -0,0 +1,450 @@
+/**
+ * @file load_generator.h
+ * @brief 基准测试用的进程内HTTP压测客户端（替代外部wrk）
+ *
+ * 客户端运行在独立的IoScheduler中，每个连接一个协程，keep-alive复用连接，
+ * 服务端返回Connection: close或断开时自动重连。两种模式：
+ *  - 闭环（rate=0）：每个连接收到响应后立即发送下一个请求
+ *  - 开环（rate>0）：按固定总速率发送，每个请求有计划发送时间，
+ *    延迟从计划时间算起，服务端变慢时排队时间计入延迟
+ *
+ * 延迟直方图做协调遗漏（coordinated omission）校正：
+ * 开环模式本身按计划时间计时；闭环模式按平均延迟作为期望间隔，
+ * 为每个慢样本补记被"挡住"而没有发出的请求。
+ *
+ * 可通过cpus把客户端工作线程绑定到指定CPU，避免与服务端争抢。
+ */
+
+#ifndef ZCOROUTINE_BENCH_LOAD_GENERATOR_H_
+#define ZCOROUTINE_BENCH_LOAD_GENERATOR_H_
+
+#include "hook/hook.h"
+#include "io/io_scheduler.h"
+#include "runtime/fiber.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sched.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace zcoroutine {
+namespace bench {
+
+/**
+ * @brief 对数-线性分桶的延迟直方图（单位微秒），相对误差小于1%
+ *
+ * 值小于kSubCount时每个值一个桶；更大的值按2的幂分段，
+ * 每段kSubCount/2个桶。
+ */
+class LatencyHistogram {
+public:
+  static constexpr int kSubBits = 8;
+  static constexpr uint64_t kSubCount = 1ULL << kSubBits;
+  static constexpr uint64_t kHalfCount = kSubCount / 2;
+  static constexpr size_t kBucketCount = kSubCount + (64 - kSubBits) * kHalfCount;
+
+  LatencyHistogram() : counts_(kBucketCount, 0) {}
+
+  void record(uint64_t value, uint64_t count = 1) {
+    counts_[index_of(value)] += count;
+    total_ += count;
+    sum_ += value * count;
+    max_ = std::max(max_, value);
+  }
+
+  void merge(const LatencyHistogram &other) {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      counts_[i] += other.counts_[i];
+    }
+    total_ += other.total_;
+    sum_ += other.sum_;
+    max_ = std::max(max_, other.max_);
+  }
+
+  /**
+   * @brief 按期望间隔生成校正后的副本（用于闭环模式的事后校正）
+   */
+  LatencyHistogram corrected(uint64_t expected_interval) const {
+    LatencyHistogram result;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      if (counts_[i] == 0) {
+        continue;
+      }
+      uint64_t value = highest_equivalent(i);
+      result.record(std::min(value, max_), counts_[i]);
+      if (expected_interval == 0) {
+        continue;
+      }
+      for (uint64_t missing = value >= expected_interval ? value - expected_interval : 0;
+           missing >= expected_interval; missing -= expected_interval) {
+        result.record(missing, counts_[i]);
+      }
+    }
+    return result;
+  }
+
+  uint64_t count() const { return total_; }
+  uint64_t max() const { return max_; }
+  double mean() const {
+    return total_ ? static_cast<double>(sum_) / total_ : 0;
+  }
+
+  /**
+   * @param p 百分位，取值[0, 100]
+   */
+  uint64_t percentile(double p) const {
+    if (total_ == 0) {
+      return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(p / 100.0 * total_ + 0.5);
+    target = std::max<uint64_t>(1, std::min(target, total_));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      seen += counts_[i];
+      if (seen >= target) {
+        return std::min(highest_equivalent(i), max_);
+      }
+    }
+    return max_;
+  }
+
+private:
+  static size_t index_of(uint64_t value) {
+    if (value < kSubCount) {
+      return static_cast<size_t>(value);
+    }
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - kSubBits + 1;
+    uint64_t top = value >> shift; // [kHalfCount, kSubCount)
+    return kSubCount + (shift - 1) * kHalfCount + (top - kHalfCount);
+  }
+
+  static uint64_t highest_equivalent(size_t index) {
+    if (index < kSubCount) {
+      return index;
+    }
+    size_t offset = index - kSubCount;
+    int shift = static_cast<int>(offset / kHalfCount) + 1;
+    uint64_t top = offset % kHalfCount + kHalfCount;
+    return ((top + 1) << shift) - 1;
+  }
+
+  std::vector<uint64_t> counts_;
+  uint64_t total_ = 0;
+  uint64_t sum_ = 0;
+  uint64_t max_ = 0;
+};
+
+/**
+ * @brief 解析CPU列表，如"0-3,6"
+ */
+inline std::vector<int> parse_cpu_list(const std::string &spec) {
+  std::vector<int> cpus;
+  std::stringstream ss(spec);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (item.empty()) {
+      continue;
+    }
+    size_t dash = item.find('-');
+    int lo = std::atoi(item.substr(0, dash).c_str());
+    int hi = dash == std::string::npos ? lo : std::atoi(item.c_str() + dash + 1);
+    for (int cpu = lo; cpu <= hi; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+/**
+ * @brief 把调度器的工作线程依次绑定到cpus中的CPU，需在start()之前调用
+ */
+inline void pin_scheduler(Scheduler *scheduler, const std::vector<int> &cpus) {
+  if (cpus.empty()) {
+    return;
+  }
+  scheduler->set_thread_init_callback([cpus](int worker_id) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus[worker_id % cpus.size()], &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  });
+}
+
+struct LoadOptions {
+  std::string host = "127.0.0.1";
+  uint16_t port = 0;
+  std::string path = "/";
+  int threads = 2;        // 客户端工作线程数
+  int connections = 64;   // 并发连接数
+  int duration_s = 5;     // 压测时长
+  double rate = 0;        // 开环总速率（请求/秒），0为闭环
+  uint64_t timeout_ms = 2000; // 单个请求的超时，超时后关闭连接并计为错误
+  std::vector<int> cpus;  // 客户端线程绑定的CPU，为空不绑定
+};
+
+struct LoadResult {
+  uint64_t requests = 0;
+  uint64_t errors = 0;
+  uint64_t timeouts = 0; // 包含在errors中
+  uint64_t connects = 0;
+  double elapsed_s = 0;
+  LatencyHistogram latency; // 已做协调遗漏校正
+
+  double throughput() const { return elapsed_s > 0 ? requests / elapsed_s : 0; }
+
+  void print(std::ostream &os) const {
+    os << "请求数: " << requests << ", 错误: " << errors
+       << " (超时 " << timeouts << ")"
+       << ", 建立连接: " << connects << std::endl;
+    os << "吞吐: " << std::fixed << std::setprecision(2) << throughput()
+       << " req/s" << std::endl;
+    os << "延迟(us, 已校正): p50=" << latency.percentile(50)
+       << " p99=" << latency.percentile(99)
+       << " p999=" << latency.percentile(99.9) << " max=" << latency.max()
+       << " mean=" << std::setprecision(1) << latency.mean() << std::endl;
+  }
+};
+
+/**
+ * @brief 协程化的HTTP压测客户端
+ *
+ * run()阻塞调用线程直到压测结束，不能在调度器协程中调用。
+ */
+class LoadGenerator {
+public:
+  explicit LoadGenerator(LoadOptions options) : options_(std::move(options)) {}
+
+  LoadResult run() {
+    request_ = "GET " + options_.path + " HTTP/1.1\r\nHost: " + options_.host +
+               "\r\n\r\n";
+    addr_ = {};
+    addr_.sin_family = AF_INET;
+    addr_.sin_port = htons(options_.port);
+    inet_pton(AF_INET, options_.host.c_str(), &addr_.sin_addr);
+
+    auto scheduler = std::make_shared<IoScheduler>(options_.threads, "LoadGen");
+    pin_scheduler(scheduler.get(), options_.cpus);
+    scheduler->start();
+
+    const bool open_loop = options_.rate > 0;
+    interval_us_ =
+        open_loop ? static_cast<uint64_t>(options_.connections * 1e6 /
+                                          options_.rate)
+                  : 0;
+    start_ = std::chrono::steady_clock::now();
+    end_ = start_ + std::chrono::seconds(options_.duration_s);
+
+    std::atomic<int> finished{0};
+    for (int i = 0; i < options_.connections; ++i) {
+      // 开环模式下各连接的发送时刻错开，避免同时突发
+      uint64_t phase_us =
+          open_loop ? interval_us_ * i / options_.connections : 0;
+      scheduler->schedule(std::make_shared<Fiber>([this, phase_us, &finished]() {
+        connection_loop(phase_us);
+        ++finished;
+      }));
+    }
+    while (finished.load() < options_.connections) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    result_.elapsed_s = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start_)
+                            .count();
+    scheduler->stop();
+
+    if (!open_loop) {
+      result_.latency =
+          merged_.corrected(static_cast<uint64_t>(merged_.mean()));
+    } else {
+      result_.latency = merged_;
+    }
+    return result_;
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  static uint64_t us_between(Clock::time_point a, Clock::time_point b) {
+    return b > a ? std::chrono::duration_cast<std::chrono::microseconds>(b - a)
+                       .count()
+                 : 0;
+  }
+
+  int open_connection() {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+      return -1;
+    }
+    if (connect_with_timeout(fd, reinterpret_cast<sockaddr *>(&addr_),
+                             sizeof(addr_), 1000) != 0) {
+      close(fd);
+      return -1;
+    }
+    int yes = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    // hook后的setsockopt记录读超时，recv挂起超过该时间返回ETIMEDOUT
+    struct timeval tv;
+    tv.tv_sec = static_cast<time_t>(options_.timeout_ms / 1000);
+    tv.tv_usec = static_cast<suseconds_t>(options_.timeout_ms % 1000 * 1000);
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return fd;
+  }
+
+  /**
+   * @brief 读取一个完整响应（Content-Length或读到EOF）
+   * @param keep_alive 输出：连接能否继续复用
+   */
+  static bool read_response(int fd, std::string &buf, bool *keep_alive) {
+    size_t head_end = std::string::npos;
+    while (true) {
+      if (head_end == std::string::npos) {
+        head_end = buf.find("\r\n\r\n");
+      }
+      if (head_end != std::string::npos) {
+        const char *cl = find_header(buf, head_end, "content-length:");
+        *keep_alive = find_header(buf, head_end, "connection: close") == nullptr;
+        if (cl) {
+          size_t total = head_end + 4 + std::strtoul(cl, nullptr, 10);
+          if (buf.size() >= total) {
+            buf.erase(0, total);
+            return true;
+          }
+        }
+      }
+      char tmp[16384];
+      ssize_t n = recv(fd, tmp, sizeof(tmp), 0);
+      if (n <= 0) {
+        // 无Content-Length的响应以EOF结束
+        if (n == 0 && head_end != std::string::npos &&
+            !find_header(buf, head_end, "content-length:")) {
+          buf.clear();
+          *keep_alive = false;
+          return true;
+        }
+        return false;
+      }
+      buf.append(tmp, static_cast<size_t>(n));
+    }
+  }
+
+  // 在头部中大小写不敏感地查找name，返回其后的位置
+  static const char *find_header(const std::string &buf, size_t head_end,
+                                 const char *name) {
+    size_t len = strlen(name);
+    for (size_t pos = buf.find("\r\n"); pos != std::string::npos && pos < head_end;
+         pos = buf.find("\r\n", pos + 2)) {
+      if (strncasecmp(buf.c_str() + pos + 2, name, len) == 0) {
+        return buf.c_str() + pos + 2 + len;
+      }
+    }
+    return nullptr;
+  }
+
+  void connection_loop(uint64_t phase_us) {
+    set_hook_enable(true);
+    LatencyHistogram hist;
+    uint64_t requests = 0;
+    uint64_t errors = 0;
+    uint64_t timeouts = 0;
+    uint64_t connects = 0;
+    std::string buf;
+    int fd = -1;
+    Clock::time_point next = start_ + std::chrono::microseconds(phase_us);
+
+    while (Clock::now() < end_) {
+      Clock::time_point intended = Clock::now();
+      if (interval_us_ > 0) {
+        intended = next;
+        next += std::chrono::microseconds(interval_us_);
+        uint64_t wait_us = us_between(Clock::now(), intended);
+        if (wait_us >= 1000) {
+          // hook后的usleep精度为毫秒，不足1ms的部分提前发送
+          usleep(static_cast<useconds_t>(wait_us));
+        }
+        if (intended >= end_) {
+          break;
+        }
+      }
+
+      // 短连接服务端每个请求后关闭连接，建连时间计入延迟
+      if (fd < 0) {
+        fd = open_connection();
+        if (fd < 0) {
+          ++errors;
+          usleep(10 * 1000);
+          continue;
+        }
+        ++connects;
+        buf.clear();
+      }
+
+      // 落后于计划时从计划时间计时，否则从实际发送时间计时
+      Clock::time_point send_time = std::min(intended, Clock::now());
+      bool keep_alive = true;
+      if (write(fd, request_.data(), request_.size()) !=
+              static_cast<ssize_t>(request_.size()) ||
+          !read_response(fd, buf, &keep_alive)) {
+        ++errors;
+        if (errno == ETIMEDOUT || errno == EAGAIN) {
+          ++timeouts;
+        }
+        close(fd);
+        fd = -1;
+        continue;
+      }
+      hist.record(us_between(send_time, Clock::now()));
+      ++requests;
+      if (!keep_alive) {
+        close(fd);
+        fd = -1;
+      }
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    merged_.merge(hist);
+    result_.requests += requests;
+    result_.errors += errors;
+    result_.timeouts += timeouts;
+    result_.connects += connects;
+  }
+
+  LoadOptions options_;
+  std::string request_;
+  struct sockaddr_in addr_ {};
+  uint64_t interval_us_ = 0; // 开环模式下单个连接的发送间隔
+  Clock::time_point start_;
+  Clock::time_point end_;
+
+  std::mutex mutex_;
+  LatencyHistogram merged_; // 未校正的原始样本
+  LoadResult result_;
+};
+
+} // namespace bench
+} // namespace zcoroutine
+
+#endif // ZCOROUTINE_BENCH_LOAD_GENERATOR_H_
@@ -1,17 +1,23 @@
 /**
  * @file perf_server_bench.cc
  * @brief 用于perf热点分析的HTTP服务器
+ *
+ * 基于HttpServer（keep-alive、流水线），配合wrk等外部压测工具使用。
+ * -P <file> 开启内置的协程采样分析，结束时把按协程名称分组的折叠栈写入file，
+ * 可用 flamegraph.pl file > flame.svg 生成火焰图。
  */
 
 #include "hook/hook.h"
 #include "io/io_scheduler.h"
+#include "http/http_server.h"
 #include "runtime/fiber.h"
+#include "runtime/sampling_profiler.h"
+#include "sync/lock_profiler.h"
 #include "util/zcoroutine_logger.h"
 
 #include <atomic>
 #include <chrono>
 #include <cstring>
-#include <fcntl.h>
 #include <iostream>
 #include <netinet/in.h>
 #include <signal.h>
@@ -21,58 +27,8 @@
 
 using namespace zcoroutine;
 
-static int g_listen_fd = -1;
 static IoScheduler::ptr g_io_scheduler = nullptr;
 static std::atomic<bool> g_running{true};
-static std::atomic<uint64_t> g_requests{0};
-
-static const char *HTTP_RESPONSE = "HTTP/1.1 200 OK\r\n"
-                                   "Content-Type: text/plain\r\n"
-                                   "Content-Length: 13\r\n"
-                                   "Connection: close\r\n"
-                                   "\r\n"
-                                   "Hello, World!";
-static const size_t HTTP_RESPONSE_LEN = strlen(HTTP_RESPONSE);
-
-void handle_client(int client_fd) {
-  set_hook_enable(true);
-  char buffer[4096];
-
-  int ret = recv(client_fd, buffer, sizeof(buffer), 0);
-  if (ret > 0) {
-    send(client_fd, HTTP_RESPONSE, HTTP_RESPONSE_LEN, 0);
-    g_requests.fetch_add(1, std::memory_order_relaxed);
-  }
-  close(client_fd);
-}
-
-void accept_connection();
-
-void register_accept() {
-  if (g_io_scheduler && g_running.load()) {
-    g_io_scheduler->add_event(g_listen_fd, FdContext::kRead, accept_connection);
-  }
-}
-
-void accept_connection() {
-  if (!g_running.load())
-    return;
-
-  set_hook_enable(true);
-  struct sockaddr_in addr;
-  socklen_t len = sizeof(addr);
-
-  int client_fd = accept(g_listen_fd, (struct sockaddr *)&addr, &len);
-  if (client_fd >= 0) {
-    int flags = fcntl(client_fd, F_GETFL, 0);
-    fcntl(client_fd, F_SETFL, flags | O_NONBLOCK);
-
-    auto fiber =
-        std::make_shared<Fiber>([client_fd]() { handle_client(client_fd); });
-    g_io_scheduler->schedule(std::move(fiber));
-  }
-  register_accept();
-}
 
 void signal_handler(int) { g_running.store(false); }
 
@@ -87,6 +43,7 @@ int main(int argc, char *argv[]) {
   int threads = 4;
   bool shared_stack = false;
   int duration = 30;
+  std::string folded_path;
 
   for (int i = 1; i < argc; i++) {
     if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
@@ -97,6 +54,8 @@ int main(int argc, char *argv[]) {
       shared_stack = true;
     } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
       duration = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-P") == 0 && i + 1 < argc) {
+      folded_path = argv[++i];
     }
   }
 
@@ -104,32 +63,24 @@ int main(int argc, char *argv[]) {
             << ", shared_stack=" << (shared_stack ? "true" : "false")
             << ", duration=" << duration << "s" << std::endl;
 
-  // 创建socket
-  g_listen_fd = socket(AF_INET, SOCK_STREAM, 0);
-  int yes = 1;
-  setsockopt(g_listen_fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
-  setsockopt(g_listen_fd, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes));
-
-  struct sockaddr_in addr;
-  memset(&addr, 0, sizeof(addr));
-  addr.sin_family = AF_INET;
-  addr.sin_port = htons(port);
-  addr.sin_addr.s_addr = INADDR_ANY;
-
-  if (bind(g_listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
-    std::cerr << "bind failed: " << strerror(errno) << std::endl;
-    return 1;
-  }
-  listen(g_listen_fd, 4096);
-  fcntl(g_listen_fd, F_SETFL, fcntl(g_listen_fd, F_GETFL) | O_NONBLOCK);
-
   // 创建调度器
   g_io_scheduler =
       std::make_shared<IoScheduler>(threads, "PerfServer", shared_stack);
   g_io_scheduler->start();
-  set_hook_enable(true);
 
-  g_io_scheduler->add_event(g_listen_fd, FdContext::kRead, accept_connection);
+  auto server = std::make_shared<HttpServer>(g_io_scheduler.get());
+  server->route("GET", "/", [](const HttpRequest &, HttpResponse &resp) {
+    resp.set_content_type("text/plain");
+    resp.set_body("Hello, World!");
+  });
+  if (!server->start("0.0.0.0", static_cast<uint16_t>(port))) {
+    std::cerr << "listen failed on port " << port << std::endl;
+    return 1;
+  }
+
+  if (!folded_path.empty() && !SamplingProfiler::instance().start(499)) {
+    std::cerr << "sampling profiler start failed" << std::endl;
+  }
 
   std::cout << "Server running, press Ctrl+C to stop or wait " << duration
             << "s..." << std::endl;
@@ -146,10 +97,23 @@ int main(int argc, char *argv[]) {
   }
 
   g_running.store(false);
+  server->stop();
   g_io_scheduler->stop();
-  close(g_listen_fd);
 
-  std::cout << "Total requests: " << g_requests.load() << std::endl;
+  if (LockProfiler::compiled_in()) {
+    std::cout << "\nLock contention:\n" << LockProfiler::instance().report(10);
+  }
+
+  if (!folded_path.empty()) {
+    SamplingProfiler::instance().stop();
+    SamplingProfiler::instance().dump_folded(folded_path);
+    std::cout << "Fiber samples: " << SamplingProfiler::instance().sample_count()
+              << ", dropped: " << SamplingProfiler::instance().dropped_count()
+              << ", folded stacks: " << folded_path << std::endl;
+  }
+
+  std::cout << "Total requests: " << server->request_count()
+            << ", connections: " << server->connection_count() << std::endl;
 
   return 0;
 }
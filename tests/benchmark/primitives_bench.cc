@@ -0,0 +1,482 @@
+/**
+ * @file primitives_bench.cc
+ * @brief 运行时基础原语微基准，结果输出为JSON
+ *
+ * 覆盖：协程创建/销毁、FiberPool借还、resume/yield往返（独立栈/共享栈）、
+ * TaskQueue多线程争用、schedule到执行的延迟、定时器添加/取消/到期、
+ * hook后系统调用的额外开销、FdContextTable查找、运行期关闭的DEBUG日志。
+ *
+ * 每项重复-r次取最快一次的ns/op（延迟类取中位那次的分位数）。
+ * -o 指定JSON输出文件，配合compare_bench.py比较两次运行、标出性能回退。
+ */
+
+#include "hook/hook.h"
+#include "io/fd_context_table.h"
+#include "io/io_scheduler.h"
+#include "runtime/fiber.h"
+#include "runtime/fiber_pool.h"
+#include "runtime/shared_stack.h"
+#include "scheduling/scheduler.h"
+#include "scheduling/task_queue.h"
+#include "timer/timer_manager.h"
+#include "util/zcoroutine_logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <signal.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace zcoroutine;
+using Clock = std::chrono::steady_clock;
+
+struct BenchResult {
+  std::string name;
+  uint64_t iterations = 0;
+  double ns_per_op = 0;
+  double p50_ns = -1; // 仅延迟类基准
+  double p99_ns = -1;
+};
+
+static double ns_since(Clock::time_point start) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - start)
+      .count();
+}
+
+class BenchRunner {
+public:
+  BenchRunner(std::string filter, int repeats, double scale)
+      : filter_(std::move(filter)), repeats_(std::max(1, repeats)),
+        scale_(scale) {}
+
+  bool enabled(const std::string &name) const {
+    return filter_.empty() || name.find(filter_) != std::string::npos;
+  }
+
+  uint64_t scaled(uint64_t iterations) const {
+    return std::max<uint64_t>(1, static_cast<uint64_t>(iterations * scale_));
+  }
+
+  /**
+   * @brief 吞吐类基准：body(n)执行n次操作并返回耗时（纳秒）
+   */
+  void run(const std::string &name, uint64_t iterations,
+           const std::function<double(uint64_t)> &body) {
+    if (!enabled(name)) {
+      return;
+    }
+    iterations = scaled(iterations);
+    double best = -1;
+    for (int r = 0; r < repeats_; ++r) {
+      double ns = body(iterations) / iterations;
+      best = best < 0 ? ns : std::min(best, ns);
+    }
+    BenchResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.ns_per_op = best;
+    report(result);
+  }
+
+  /**
+   * @brief 延迟类基准：body(n)返回n个样本（纳秒）
+   */
+  void run_latency(const std::string &name, uint64_t iterations,
+                   const std::function<std::vector<double>(uint64_t)> &body) {
+    if (!enabled(name)) {
+      return;
+    }
+    iterations = scaled(iterations);
+    std::vector<BenchResult> runs;
+    for (int r = 0; r < repeats_; ++r) {
+      std::vector<double> samples = body(iterations);
+      if (samples.empty()) {
+        continue;
+      }
+      std::sort(samples.begin(), samples.end());
+      double sum = 0;
+      for (double s : samples) {
+        sum += s;
+      }
+      BenchResult result;
+      result.name = name;
+      result.iterations = samples.size();
+      result.ns_per_op = sum / samples.size();
+      result.p50_ns = samples[samples.size() / 2];
+      result.p99_ns = samples[samples.size() * 99 / 100];
+      runs.push_back(result);
+    }
+    if (runs.empty()) {
+      return;
+    }
+    std::sort(runs.begin(), runs.end(),
+              [](const BenchResult &a, const BenchResult &b) {
+                return a.p50_ns < b.p50_ns;
+              });
+    report(runs[runs.size() / 2]);
+  }
+
+  const std::vector<BenchResult> &results() const { return results_; }
+
+private:
+  void report(const BenchResult &result) {
+    std::cout << std::left << std::setw(36) << result.name << std::right
+              << std::setw(12) << std::fixed << std::setprecision(1)
+              << result.ns_per_op << " ns/op";
+    if (result.p50_ns >= 0) {
+      std::cout << "  p50=" << result.p50_ns << "ns p99=" << result.p99_ns
+                << "ns";
+    }
+    std::cout << std::endl;
+    results_.push_back(result);
+  }
+
+  std::string filter_;
+  int repeats_;
+  double scale_;
+  std::vector<BenchResult> results_;
+};
+
+// ========================= 协程 =========================
+
+static void bench_fiber(BenchRunner &runner) {
+  runner.run("fiber_create_destroy", 20000, [](uint64_t n) {
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < n; ++i) {
+      auto fiber = std::make_shared<Fiber>([]() {});
+    }
+    return ns_since(start);
+  });
+
+  runner.run("fiber_create_run_destroy", 20000, [](uint64_t n) {
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < n; ++i) {
+      auto fiber = std::make_shared<Fiber>([]() {});
+      fiber->resume();
+    }
+    return ns_since(start);
+  });
+
+  runner.run("fiber_pool_get_run_return", 50000, [](uint64_t n) {
+    FiberPool &pool = FiberPool::get_instance();
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < n; ++i) {
+      Fiber::ptr fiber = pool.get_fiber([]() {});
+      fiber->resume();
+      pool.return_fiber(fiber);
+    }
+    return ns_since(start);
+  });
+
+  runner.run("resume_yield_independent", 200000, [](uint64_t n) {
+    bool stop = false;
+    auto fiber = std::make_shared<Fiber>([&stop]() {
+      while (!stop) {
+        Fiber::yield();
+      }
+    });
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < n; ++i) {
+      fiber->resume();
+    }
+    double ns = ns_since(start);
+    stop = true;
+    fiber->resume();
+    return ns;
+  });
+
+  runner.run("resume_yield_shared", 200000, [](uint64_t n) {
+    SharedStack stack(1);
+    bool stop = false;
+    auto fiber = std::make_shared<Fiber>(
+        [&stop]() {
+          while (!stop) {
+            Fiber::yield();
+          }
+        },
+        &stack);
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < n; ++i) {
+      fiber->resume();
+    }
+    double ns = ns_since(start);
+    stop = true;
+    fiber->resume();
+    return ns;
+  });
+}
+
+// ========================= 调度 =========================
+
+static void bench_task_queue(BenchRunner &runner, int threads) {
+  std::string name = "task_queue_push_pop_t" + std::to_string(threads);
+  runner.run(name, 200000, [threads](uint64_t n) {
+    TaskQueue queue;
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    uint64_t per_thread = n / threads;
+    for (int t = 0; t < threads; ++t) {
+      workers.emplace_back([&queue, &go, per_thread]() {
+        while (!go.load(std::memory_order_acquire)) {
+        }
+        Task task;
+        for (uint64_t i = 0; i < per_thread; ++i) {
+          queue.push(Task(std::function<void()>([]() {})));
+          queue.try_pop(task);
+        }
+      });
+    }
+    auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    // 报告总吞吐对应的每次push+pop耗时
+    return ns_since(start) * n / (per_thread * threads);
+  });
+}
+
+static void bench_schedule(BenchRunner &runner) {
+  // 工作线程空闲时，从schedule()到任务开始执行的唤醒延迟
+  runner.run_latency("schedule_to_run_latency", 5000, [](uint64_t n) {
+    Scheduler scheduler(2, "PrimBench");
+    scheduler.start();
+    std::vector<double> samples;
+    samples.reserve(n);
+    for (uint64_t i = 0; i < n; ++i) {
+      std::atomic<bool> done{false};
+      double latency = 0;
+      auto start = Clock::now();
+      scheduler.schedule([&]() {
+        latency = ns_since(start);
+        done.store(true, std::memory_order_release);
+      });
+      while (!done.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      samples.push_back(latency);
+    }
+    scheduler.stop();
+    return samples;
+  });
+
+  runner.run("schedule_throughput", 200000, [](uint64_t n) {
+    Scheduler scheduler(2, "PrimBench");
+    scheduler.start();
+    std::atomic<uint64_t> done{0};
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < n; ++i) {
+      scheduler.schedule([&done]() { done.fetch_add(1); });
+    }
+    while (done.load() < n) {
+      std::this_thread::yield();
+    }
+    double ns = ns_since(start);
+    scheduler.stop();
+    return ns;
+  });
+}
+
+// ========================= 定时器 =========================
+
+static void bench_timer(BenchRunner &runner) {
+  runner.run("timer_add_cancel", 100000, [](uint64_t n) {
+    TimerManager manager;
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < n; ++i) {
+      Timer::ptr timer = manager.add_timer(60000 + i % 1000, []() {});
+      timer->cancel();
+    }
+    return ns_since(start);
+  });
+
+  runner.run("timer_add_expire", 100000, [](uint64_t n) {
+    TimerManager manager;
+    uint64_t fired = 0;
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < n; ++i) {
+      manager.add_timer(0, [&fired]() { ++fired; });
+    }
+    while (fired < n) {
+      for (auto &cb : manager.list_expired_callbacks()) {
+        cb();
+      }
+    }
+    return ns_since(start);
+  });
+}
+
+// ========================= hook与fd表 =========================
+
+static void bench_hook(BenchRunner &runner) {
+  // 在IoScheduler协程中对有数据可读的socketpair执行write+read，
+  // 分别测量启用与关闭hook，两者之差即hook的额外开销
+  auto measure = [](uint64_t n, bool hooked) {
+    auto scheduler = std::make_shared<IoScheduler>(1, "HookBench");
+    scheduler->start();
+    std::atomic<bool> done{false};
+    double ns = 0;
+    scheduler->schedule(std::make_shared<Fiber>([&]() {
+      set_hook_enable(true);
+      int fds[2];
+      if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        done = true;
+        return;
+      }
+      set_hook_enable(hooked);
+      char c = 'x';
+      auto start = Clock::now();
+      for (uint64_t i = 0; i < n; ++i) {
+        if (write(fds[0], &c, 1) != 1 || read(fds[1], &c, 1) != 1) {
+          break;
+        }
+      }
+      ns = ns_since(start);
+      set_hook_enable(true);
+      close(fds[0]);
+      close(fds[1]);
+      done = true;
+    }));
+    while (!done.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    scheduler->stop();
+    return ns;
+  };
+
+  runner.run("syscall_write_read_raw", 100000,
+             [&](uint64_t n) { return measure(n, false); });
+  runner.run("syscall_write_read_hooked", 100000,
+             [&](uint64_t n) { return measure(n, true); });
+}
+
+static void bench_fd_table(BenchRunner &runner) {
+  runner.run("fd_context_table_get", 1000000, [](uint64_t n) {
+    FdContextTable table;
+    for (int fd = 0; fd < 1024; ++fd) {
+      table.get_or_create(fd);
+    }
+    uint64_t found = 0;
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < n; ++i) {
+      found += table.get(static_cast<int>(i & 1023)) != nullptr;
+    }
+    double ns = ns_since(start);
+    if (found != n) {
+      std::cerr << "fd_context_table_get: lookup miss" << std::endl;
+    }
+    return ns;
+  });
+}
+
+// ========================= 日志 =========================
+
+static void bench_logging(BenchRunner &runner) {
+  // 日志器等级为ERROR：DEBUG日志只应付出一次等级判断，不求值参数
+  runner.run("log_debug_disabled", 10000000, [](uint64_t n) {
+    auto fiber = std::make_shared<Fiber>([]() {});
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < n; ++i) {
+      ZCOROUTINE_LOG_DEBUG("bench: name={}, id={}, i={}", fiber->name(),
+                           fiber->id(), i);
+    }
+    return ns_since(start);
+  });
+}
+
+// ========================= 输出 =========================
+
+static bool write_json(const std::string &path,
+                       const std::vector<BenchResult> &results) {
+  std::ofstream out(path);
+  if (!out) {
+    return false;
+  }
+  out << "{\n  \"suite\": \"primitives_bench\",\n"
+      << "  \"timestamp\": " << time(nullptr) << ",\n"
+      << "  \"hardware_concurrency\": " << std::thread::hardware_concurrency()
+      << ",\n  \"results\": [\n";
+  out << std::fixed << std::setprecision(2);
+  for (size_t i = 0; i < results.size(); ++i) {
+    const BenchResult &r = results[i];
+    out << "    {\"name\": \"" << r.name << "\", \"iterations\": "
+        << r.iterations << ", \"ns_per_op\": " << r.ns_per_op;
+    if (r.p50_ns >= 0) {
+      out << ", \"p50_ns\": " << r.p50_ns << ", \"p99_ns\": " << r.p99_ns;
+    }
+    out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  out << "  ]\n}\n";
+  return true;
+}
+
+static void print_usage(const char *prog) {
+  std::cout << "用法: " << prog << " [选项]\n"
+            << "  -o <file>  JSON结果输出文件\n"
+            << "  -f <str>   只运行名称包含str的基准\n"
+            << "  -r <n>     每项重复次数，取最好结果 (默认3)\n"
+            << "  -s <x>     迭代次数缩放系数 (默认1.0)\n"
+            << "  -h         显示帮助\n"
+            << "比较两次结果: compare_bench.py base.json new.json\n";
+}
+
+int main(int argc, char *argv[]) {
+  signal(SIGPIPE, SIG_IGN);
+  zcoroutine::init_logger(zlog::LogLevel::value::ERROR);
+
+  std::string output;
+  std::string filter;
+  int repeats = 3;
+  double scale = 1.0;
+  int opt;
+  while ((opt = getopt(argc, argv, "o:f:r:s:h")) != -1) {
+    switch (opt) {
+    case 'o':
+      output = optarg;
+      break;
+    case 'f':
+      filter = optarg;
+      break;
+    case 'r':
+      repeats = atoi(optarg);
+      break;
+    case 's':
+      scale = atof(optarg);
+      break;
+    default:
+      print_usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  BenchRunner runner(filter, repeats, scale);
+  bench_fiber(runner);
+  for (int threads : {1, 2, 4}) {
+    bench_task_queue(runner, threads);
+  }
+  bench_schedule(runner);
+  bench_timer(runner);
+  bench_hook(runner);
+  bench_fd_table(runner);
+  bench_logging(runner);
+
+  if (!output.empty()) {
+    if (!write_json(output, runner.results())) {
+      std::cerr << "写入JSON失败: " << output << std::endl;
+      return 1;
+    }
+    std::cout << "JSON结果已写入 " << output << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,226 @@
+/**
+ * @file rpc_bench.cc
+ * @brief 回环RPC吞吐与延迟基准（calls/sec、p50/p99）
+ *
+ * 客户端协程循环调用服务端的echo方法：
+ *  - mux:    -c 条连接被全部协程共享，每条连接上有多个并发调用，
+ *            请求帧由发送协程批量writev
+ *  - single: 每个协程独占一条连接，连接上同一时刻只有一个调用
+ *
+ * 服务端为RpcServer，运行在独立的IoScheduler中。
+ */
+
+#include "hook/hook.h"
+#include "io/io_scheduler.h"
+#include "rpc/rpc_channel.h"
+#include "rpc/rpc_server.h"
+#include "runtime/fiber.h"
+#include "util/zcoroutine_logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <getopt.h>
+#include <iostream>
+#include <mutex>
+#include <signal.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace zcoroutine;
+
+struct BenchConfig {
+  int server_threads = 2;
+  int client_threads = 2;
+  int fibers = 64;
+  int channels = 1;
+  int duration = 5;
+  size_t payload = 64;
+  bool single = false;
+  bool inline_handlers = false;
+};
+
+static void print_usage(const char *prog) {
+  std::cout << "用法: " << prog << " [选项]\n"
+            << "  -t <n>  服务端工作线程数 (默认2)\n"
+            << "  -c <n>  客户端工作线程数 (默认2)\n"
+            << "  -f <n>  客户端协程数 (默认64)\n"
+            << "  -m <n>  多路复用模式下的连接数 (默认1)\n"
+            << "  -d <s>  测试时长秒数 (默认5)\n"
+            << "  -s <n>  请求负载字节数 (默认64)\n"
+            << "  -n      每个协程独占一条连接，每连接只有一个未完成调用\n"
+            << "  -i      服务端在读协程中直接执行处理函数\n"
+            << "  -h      显示帮助\n";
+}
+
+static double percentile(const std::vector<uint32_t> &sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  size_t idx = static_cast<size_t>(p * (sorted.size() - 1));
+  return sorted[idx];
+}
+
+int main(int argc, char *argv[]) {
+  signal(SIGPIPE, SIG_IGN);
+  zcoroutine::init_logger(zlog::LogLevel::value::ERROR);
+
+  BenchConfig config;
+  int opt;
+  while ((opt = getopt(argc, argv, "t:c:f:m:d:s:nih")) != -1) {
+    switch (opt) {
+    case 't':
+      config.server_threads = atoi(optarg);
+      break;
+    case 'c':
+      config.client_threads = atoi(optarg);
+      break;
+    case 'f':
+      config.fibers = atoi(optarg);
+      break;
+    case 'm':
+      config.channels = std::max(1, atoi(optarg));
+      break;
+    case 'd':
+      config.duration = atoi(optarg);
+      break;
+    case 's':
+      config.payload = static_cast<size_t>(atoi(optarg));
+      break;
+    case 'n':
+      config.single = true;
+      break;
+    case 'i':
+      config.inline_handlers = true;
+      break;
+    default:
+      print_usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  auto server_sched = std::make_shared<IoScheduler>(config.server_threads,
+                                                    "RpcBenchServer");
+  server_sched->start();
+  RpcServer::Options server_options;
+  server_options.inline_handlers = config.inline_handlers;
+  auto server = std::make_shared<RpcServer>(server_sched.get(), server_options);
+  server->register_method("echo", [](const std::string &req, std::string *resp) {
+    *resp = req;
+    return 0;
+  });
+  if (!server->start("127.0.0.1", 0)) {
+    std::cerr << "RpcServer 启动失败" << std::endl;
+    return 1;
+  }
+  const uint16_t port = server->port();
+
+  auto client = std::make_shared<IoScheduler>(config.client_threads,
+                                              "RpcBenchClient");
+  client->start();
+
+  // 建立连接：single模式每协程一条，mux模式-m条
+  const int num_channels = config.single ? config.fibers : config.channels;
+  std::vector<RpcChannel::ptr> channels;
+  std::atomic<int> connected{0};
+  std::atomic<int> connect_failed{0};
+  for (int i = 0; i < num_channels; ++i) {
+    channels.push_back(std::make_shared<RpcChannel>(client.get()));
+  }
+  for (int i = 0; i < num_channels; ++i) {
+    RpcChannel::ptr channel = channels[i];
+    client->schedule(std::make_shared<Fiber>([&, channel]() {
+      set_hook_enable(true);
+      channel->connect("127.0.0.1", port) == 0 ? ++connected
+                                               : ++connect_failed;
+    }));
+  }
+  while (connected.load() + connect_failed.load() < num_channels) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  if (connect_failed.load() > 0) {
+    std::cerr << "连接失败: " << connect_failed.load() << std::endl;
+    return 1;
+  }
+
+  std::cout << "模式: " << (config.single ? "single" : "mux")
+            << ", 客户端协程: " << config.fibers << ", 连接数: " << num_channels
+            << ", 负载: " << config.payload << "B"
+            << ", 时长: " << config.duration << "s" << std::endl;
+
+  const std::string request(config.payload, 'x');
+  std::atomic<bool> running{true};
+  std::atomic<int> finished{0};
+  std::atomic<uint64_t> calls{0};
+  std::atomic<uint64_t> failed{0};
+  std::mutex latency_mutex;
+  std::vector<uint32_t> latencies; // 微秒
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < config.fibers; ++i) {
+    RpcChannel::ptr channel = channels[i % num_channels];
+    client->schedule(std::make_shared<Fiber>([&, channel]() {
+      set_hook_enable(true);
+      std::vector<uint32_t> local;
+      local.reserve(1 << 16);
+      uint64_t local_ok = 0;
+      uint64_t local_failed = 0;
+      std::string response;
+      while (running.load(std::memory_order_relaxed)) {
+        auto t0 = std::chrono::steady_clock::now();
+        if (channel->call("echo", request, &response, 5000) == 0) {
+          ++local_ok;
+          local.push_back(static_cast<uint32_t>(
+              std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::steady_clock::now() - t0)
+                  .count()));
+        } else {
+          ++local_failed;
+        }
+      }
+      calls.fetch_add(local_ok);
+      failed.fetch_add(local_failed);
+      {
+        std::lock_guard<std::mutex> guard(latency_mutex);
+        latencies.insert(latencies.end(), local.begin(), local.end());
+      }
+      ++finished;
+    }));
+  }
+
+  std::this_thread::sleep_for(std::chrono::seconds(config.duration));
+  running = false;
+  while (finished.load() < config.fibers) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  uint64_t frames = 0;
+  uint64_t batches = 0;
+  for (auto &channel : channels) {
+    frames += channel->frames_sent();
+    batches += channel->write_batches();
+  }
+  std::sort(latencies.begin(), latencies.end());
+
+  std::cout << "成功调用: " << calls.load() << ", 失败: " << failed.load()
+            << std::endl;
+  std::cout << "吞吐: " << static_cast<uint64_t>(calls.load() / elapsed)
+            << " calls/sec" << std::endl;
+  std::cout << "延迟: p50=" << percentile(latencies, 0.50)
+            << "us, p99=" << percentile(latencies, 0.99) << "us" << std::endl;
+  std::cout << "客户端每次writev平均帧数: "
+            << (batches ? static_cast<double>(frames) / batches : 0)
+            << std::endl;
+
+  for (auto &channel : channels) {
+    channel->close();
+  }
+  client->stop();
+  server->stop();
+  server_sched->stop();
+  return 0;
+}
@@ -27,7 +27,7 @@ run_perf_test() {
     echo "=========================================="
     
     # 构建启动命令
-    local cmd="./tests/perf_server_bench -p $PORT -t $THREADS -d $DURATION"
+    local cmd="./tests/perf_server_bench -p $PORT -t $THREADS -d $DURATION -P ${output_dir}/fiber_stacks.folded"
     if [ "$use_shared" = "true" ]; then
         cmd="$cmd -s"
     fi
@@ -59,8 +59,8 @@ run_perf_test() {
     # 等待1秒让perf开始记录
     sleep 1
     
-    echo "[4] 运行wrk压测..."
-    wrk -t4 -c200 -d15s http://localhost:$PORT/ > ${output_dir}/wrk_result.txt 2>&1 || echo "wrk执行完成"
+    echo "[4] 运行压测..."
+    ./tests/load_gen_bench -p $PORT -l 4 -c 200 -d 15 > ${output_dir}/load_result.txt 2>&1 || echo "压测执行完成"
     
     # 等待perf完成
     echo "[5] 等待perf记录完成..."
@@ -76,8 +76,8 @@ run_perf_test() {
     echo "=========================================="
     
     echo ""
-    echo "=== WRK压测结果 ==="
-    cat ${output_dir}/wrk_result.txt
+    echo "=== 压测结果 ==="
+    cat ${output_dir}/load_result.txt
     
     echo ""
     echo "=== Perf Stat缓存统计 ==="
@@ -92,6 +92,15 @@ run_perf_test() {
     else
         echo "perf_cpu.data文件不存在"
     fi
+
+    echo ""
+    echo "=== 按协程名称的CPU采样 ==="
+    if [ -s ${output_dir}/fiber_stacks.folded ]; then
+        awk '{n=$NF; split($1,f,";"); s[f[1]]+=n; t+=n} END {for (k in s) printf "%-32s %8d %6.1f%%\n", k, s[k], 100*s[k]/t}' \
+            ${output_dir}/fiber_stacks.folded | sort -k2 -nr
+    else
+        echo "fiber_stacks.folded为空"
+    fi
     
     echo ""
     echo "=========================================="
@@ -100,10 +109,11 @@ run_perf_test() {
     echo "数据文件:"
     echo "  - perf_cpu.data: CPU性能数据"
     echo "  - perf_stat.txt: 缓存统计"
+    echo "  - fiber_stacks.folded: 按协程名称分组的折叠栈（flamegraph.pl可直接使用）"
     echo ""
     echo "报告文件:"
     echo "  - perf_functions.txt: 所有函数性能数据"
-    echo "  - wrk_result.txt: 压测结果"
+    echo "  - load_result.txt: 压测结果"
     echo "  - server.log: 服务器日志"
     echo "=========================================="
 }
@@ -127,11 +137,11 @@ case $MODE in
         echo "=========================================="
         echo ""
         echo "--- 独立栈模式 ---"
-        find perf_results -name "normal_*" -type d | sort | tail -1 | xargs -I {} sh -c 'grep -E "Requests/sec|Transfer/sec" {}/wrk_result.txt || true'
+        find perf_results -name "normal_*" -type d | sort | tail -1 | xargs -I {} sh -c 'grep -E "吞吐|延迟" {}/load_result.txt || true'
         find perf_results -name "normal_*" -type d | sort | tail -1 | xargs -I {} sh -c 'grep -E "cache-misses|L1-dcache-load-misses" {}/perf_stat.txt | head -2 || true'
         echo ""
         echo "--- 共享栈模式 ---"
-        find perf_results -name "shared_*" -type d | sort | tail -1 | xargs -I {} sh -c 'grep -E "Requests/sec|Transfer/sec" {}/wrk_result.txt || true'
+        find perf_results -name "shared_*" -type d | sort | tail -1 | xargs -I {} sh -c 'grep -E "吞吐|延迟" {}/load_result.txt || true'
         find perf_results -name "shared_*" -type d | sort | tail -1 | xargs -I {} sh -c 'grep -E "cache-misses|L1-dcache-load-misses" {}/perf_stat.txt | head -2 || true'
         ;;
     *)
@@ -0,0 +1,274 @@
+/**
+ * @file connection_pool_integration_test.cc
+ * @brief ConnectionPool 集成测试
+ * 测试连接复用、连接数上限与协程挂起等待、等待超时、健康检查与空闲清理
+ */
+
+#include "hook/hook.h"
+#include "io/io_scheduler.h"
+#include "net/connection_pool.h"
+#include "net/tcp_acceptor.h"
+#include "util/zcoroutine_logger.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+
+using namespace zcoroutine;
+
+class ConnectionPoolTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    scheduler_ = std::make_shared<IoScheduler>(2, "PoolTestScheduler");
+    scheduler_->start();
+  }
+
+  void TearDown() override {
+    if (acceptor_) {
+      acceptor_->stop();
+      acceptor_.reset();
+    }
+    if (scheduler_) {
+      scheduler_->stop();
+      scheduler_.reset();
+    }
+  }
+
+  // 启动echo服务端；close_after_accept为true时接受后立即关闭连接
+  uint16_t start_server(bool close_after_accept = false) {
+    acceptor_ = std::make_shared<TcpAcceptor>(
+        scheduler_.get(), "127.0.0.1", 0, [close_after_accept](int fd) {
+          if (!close_after_accept) {
+            char buf[64];
+            ssize_t n;
+            while ((n = read(fd, buf, sizeof(buf))) > 0) {
+              write(fd, buf, n);
+            }
+          }
+          close(fd);
+        });
+    EXPECT_TRUE(acceptor_->start());
+    return acceptor_->port();
+  }
+
+  // 在调度器协程中运行func并等待完成
+  void run_in_fiber(std::function<void()> func) {
+    std::atomic<bool> done{false};
+    scheduler_->schedule(std::make_shared<Fiber>([&]() {
+      set_hook_enable(true);
+      func();
+      done = true;
+    }));
+    ASSERT_TRUE(wait_until([&] { return done.load(); }, 5000));
+  }
+
+  template <typename Pred>
+  static bool wait_until(Pred pred, int timeout_ms = 2000) {
+    for (int i = 0; i < timeout_ms / 10; ++i) {
+      if (pred()) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return pred();
+  }
+
+  // 通过连接完成一次echo
+  static bool echo(int fd) {
+    if (write(fd, "ping", 4) != 4) {
+      return false;
+    }
+    char buf[4];
+    return read(fd, buf, 4) == 4;
+  }
+
+  std::shared_ptr<IoScheduler> scheduler_;
+  TcpAcceptor::ptr acceptor_;
+};
+
+// 测试1：归还的连接被再次借出（同一个fd），统计命中
+TEST_F(ConnectionPoolTest, ReuseIdleConnection) {
+  uint16_t port = start_server();
+  auto pool = std::make_shared<ConnectionPool>(scheduler_.get());
+
+  run_in_fiber([&]() {
+    int first_fd;
+    {
+      ConnectionPool::Connection conn = pool->acquire("127.0.0.1", port);
+      ASSERT_TRUE(conn.valid());
+      EXPECT_FALSE(conn.reused());
+      EXPECT_TRUE(echo(conn.fd()));
+      first_fd = conn.fd();
+    }
+    EXPECT_EQ(pool->idle_count("127.0.0.1", port), 1u);
+
+    ConnectionPool::Connection conn = pool->acquire("127.0.0.1", port);
+    ASSERT_TRUE(conn.valid());
+    EXPECT_TRUE(conn.reused());
+    EXPECT_EQ(conn.fd(), first_fd);
+    EXPECT_TRUE(echo(conn.fd()));
+  });
+
+  ConnectionPool::Stats stats = pool->stats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_DOUBLE_EQ(stats.hit_rate(), 0.5);
+  EXPECT_EQ(pool->total_count("127.0.0.1", port), 1u);
+}
+
+// 测试2：达到连接上限时挂起协程，归还后被唤醒并复用该连接
+TEST_F(ConnectionPoolTest, ExhaustedPoolParksFiber) {
+  uint16_t port = start_server();
+  ConnectionPool::Options options;
+  options.max_connections = 1;
+  options.acquire_timeout_ms = 2000;
+  auto pool = std::make_shared<ConnectionPool>(scheduler_.get(), options);
+
+  std::atomic<bool> holder_ready{false};
+  std::atomic<bool> waiter_ok{false};
+  std::atomic<int> done{0};
+
+  scheduler_->schedule(std::make_shared<Fiber>([&]() {
+    set_hook_enable(true);
+    ConnectionPool::Connection conn = pool->acquire("127.0.0.1", port);
+    holder_ready = conn.valid();
+    usleep(100 * 1000); // hook后的usleep只挂起协程
+    conn.release();
+    ++done;
+  }));
+  ASSERT_TRUE(wait_until([&] { return holder_ready.load(); }));
+
+  scheduler_->schedule(std::make_shared<Fiber>([&]() {
+    set_hook_enable(true);
+    ConnectionPool::Connection conn = pool->acquire("127.0.0.1", port);
+    waiter_ok = conn.valid() && conn.reused() && echo(conn.fd());
+    ++done;
+  }));
+
+  ASSERT_TRUE(wait_until([&] { return done.load() == 2; }));
+  EXPECT_TRUE(waiter_ok.load());
+  ConnectionPool::Stats stats = pool->stats();
+  EXPECT_EQ(stats.waits, 1u);
+  EXPECT_GT(stats.wait_time_us, 0u);
+  EXPECT_EQ(stats.wait_timeouts, 0u);
+  EXPECT_EQ(pool->total_count("127.0.0.1", port), 1u);
+}
+
+// 测试3：等待超时返回ETIMEDOUT
+TEST_F(ConnectionPoolTest, AcquireTimeout) {
+  uint16_t port = start_server();
+  ConnectionPool::Options options;
+  options.max_connections = 1;
+  options.acquire_timeout_ms = 50;
+  auto pool = std::make_shared<ConnectionPool>(scheduler_.get(), options);
+
+  run_in_fiber([&]() {
+    ConnectionPool::Connection held = pool->acquire("127.0.0.1", port);
+    ASSERT_TRUE(held.valid());
+
+    auto start = std::chrono::steady_clock::now();
+    ConnectionPool::Connection conn = pool->acquire("127.0.0.1", port);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    EXPECT_FALSE(conn.valid());
+    EXPECT_EQ(errno, ETIMEDOUT);
+    EXPECT_GE(elapsed, 40);
+  });
+
+  EXPECT_EQ(pool->stats().wait_timeouts, 1u);
+}
+
+// 测试4：对端关闭的空闲连接在借出前被健康检查剔除
+TEST_F(ConnectionPoolTest, HealthCheckDropsClosedConnection) {
+  uint16_t port = start_server(true);
+  auto pool = std::make_shared<ConnectionPool>(scheduler_.get());
+
+  run_in_fiber([&]() {
+    {
+      ConnectionPool::Connection conn = pool->acquire("127.0.0.1", port);
+      ASSERT_TRUE(conn.valid());
+    }
+    usleep(50 * 1000); // 等待服务端关闭连接
+
+    ConnectionPool::Connection conn = pool->acquire("127.0.0.1", port);
+    ASSERT_TRUE(conn.valid());
+    EXPECT_FALSE(conn.reused());
+  });
+
+  ConnectionPool::Stats stats = pool->stats();
+  EXPECT_EQ(stats.health_failures, 1u);
+  EXPECT_EQ(stats.hits, 0u);
+  EXPECT_EQ(stats.misses, 2u);
+}
+
+// 测试5：空闲超时的连接由周期扫描关闭
+TEST_F(ConnectionPoolTest, IdleEviction) {
+  uint16_t port = start_server();
+  ConnectionPool::Options options;
+  options.idle_timeout_ms = 50;
+  options.sweep_interval_ms = 20;
+  auto pool = std::make_shared<ConnectionPool>(scheduler_.get(), options);
+  pool->start();
+
+  run_in_fiber([&]() {
+    ConnectionPool::Connection conn = pool->acquire("127.0.0.1", port);
+    ASSERT_TRUE(conn.valid());
+  });
+  EXPECT_EQ(pool->idle_count("127.0.0.1", port), 1u);
+
+  EXPECT_TRUE(wait_until(
+      [&] { return pool->total_count("127.0.0.1", port) == 0; }, 2000));
+  EXPECT_EQ(pool->idle_count("127.0.0.1", port), 0u);
+  EXPECT_EQ(pool->stats().evicted, 1u);
+  pool->stop();
+}
+
+// 测试6：非法地址与停止后借出失败
+TEST_F(ConnectionPoolTest, InvalidAddressAndStopped) {
+  auto pool = std::make_shared<ConnectionPool>(scheduler_.get());
+  run_in_fiber([&]() {
+    ConnectionPool::Connection conn = pool->acquire("not-an-ip", 80);
+    EXPECT_FALSE(conn.valid());
+    EXPECT_EQ(errno, EINVAL);
+
+    pool->stop();
+    conn = pool->acquire("127.0.0.1", 80);
+    EXPECT_FALSE(conn.valid());
+    EXPECT_EQ(errno, ESHUTDOWN);
+  });
+}
+
+// 测试7：扫描在锁外做健康检查后放回健康的空闲连接
+TEST_F(ConnectionPoolTest, SweepKeepsHealthyConnections) {
+  uint16_t port = start_server();
+  auto pool = std::make_shared<ConnectionPool>(scheduler_.get());
+
+  run_in_fiber([&]() {
+    ConnectionPool::Connection a = pool->acquire("127.0.0.1", port);
+    ConnectionPool::Connection b = pool->acquire("127.0.0.1", port);
+    ASSERT_TRUE(a.valid());
+    ASSERT_TRUE(b.valid());
+  });
+  EXPECT_EQ(pool->idle_count("127.0.0.1", port), 2u);
+
+  EXPECT_EQ(pool->sweep(), 0u);
+  EXPECT_EQ(pool->idle_count("127.0.0.1", port), 2u);
+  EXPECT_EQ(pool->total_count("127.0.0.1", port), 2u);
+
+  run_in_fiber([&]() {
+    ConnectionPool::Connection conn = pool->acquire("127.0.0.1", port);
+    ASSERT_TRUE(conn.valid());
+    EXPECT_TRUE(conn.reused());
+  });
+  EXPECT_EQ(pool->stats().hits, 1u);
+  pool->stop();
+}
+
+int main(int argc, char **argv) {
+  zcoroutine::init_logger(zlog::LogLevel::value::DEBUG);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
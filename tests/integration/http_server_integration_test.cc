@@ -0,0 +1,288 @@
+/**
+ * @file http_server_integration_test.cc
+ * @brief HttpServer 集成测试
+ * 测试keep-alive、流水线请求、分块响应、路由匹配与错误处理
+ */
+
+#include "http/http_server.h"
+#include "io/io_scheduler.h"
+#include "util/zcoroutine_logger.h"
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace zcoroutine;
+
+class HttpServerTest : public ::testing::Test {
+protected:
+  struct Response {
+    int status = 0;
+    std::string headers;
+    std::string body;
+  };
+
+  void SetUp() override {
+    scheduler_ = std::make_shared<IoScheduler>(2, "HttpTestScheduler");
+    scheduler_->start();
+
+    server_ = std::make_shared<HttpServer>(scheduler_.get());
+    server_->route("GET", "/hello",
+                   [](const HttpRequest &, HttpResponse &resp) {
+                     resp.set_content_type("text/plain");
+                     resp.set_body("Hello, World!");
+                   });
+    server_->route("POST", "/echo",
+                   [](const HttpRequest &req, HttpResponse &resp) {
+                     resp.set_body(req.body.to_string());
+                   });
+    server_->route("GET", "/query",
+                   [](const HttpRequest &req, HttpResponse &resp) {
+                     resp.set_body(req.query.to_string());
+                   });
+    server_->route("GET", "/chunked",
+                   [](const HttpRequest &, HttpResponse &resp) {
+                     resp.write_chunk("first,");
+                     resp.write_chunk("second,");
+                     resp.write_chunk("third");
+                   });
+    server_->route_prefix("*", "/static/",
+                          [](const HttpRequest &req, HttpResponse &resp) {
+                            resp.set_body("static:" + req.path.to_string());
+                          });
+    ASSERT_TRUE(server_->start("127.0.0.1", 0));
+  }
+
+  void TearDown() override {
+    server_->stop();
+    server_.reset();
+    scheduler_->stop();
+    scheduler_.reset();
+  }
+
+  int connect_server() {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(server_->port());
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    EXPECT_EQ(::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)),
+              0);
+    struct timeval tv {2, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return fd;
+  }
+
+  static void send_all(int fd, const std::string &data) {
+    ASSERT_EQ(::send(fd, data.data(), data.size(), 0),
+              static_cast<ssize_t>(data.size()));
+  }
+
+  // 从buf_中取出一个完整响应，数据不足时继续读取
+  bool read_response(int fd, Response *resp) {
+    while (true) {
+      if (try_parse(resp)) {
+        return true;
+      }
+      char tmp[4096];
+      ssize_t n = ::recv(fd, tmp, sizeof(tmp), 0);
+      if (n <= 0) {
+        return false;
+      }
+      buf_.append(tmp, static_cast<size_t>(n));
+    }
+  }
+
+  bool try_parse(Response *resp) {
+    size_t head_end = buf_.find("\r\n\r\n");
+    if (head_end == std::string::npos) {
+      return false;
+    }
+    std::string head = buf_.substr(0, head_end + 2);
+    size_t pos = head_end + 4;
+    std::string body;
+
+    size_t cl = head.find("Content-Length: ");
+    if (cl != std::string::npos) {
+      size_t len = std::stoul(head.substr(cl + 16));
+      if (buf_.size() < pos + len) {
+        return false;
+      }
+      body = buf_.substr(pos, len);
+      pos += len;
+    } else if (head.find("Transfer-Encoding: chunked") != std::string::npos) {
+      while (true) {
+        size_t line_end = buf_.find("\r\n", pos);
+        if (line_end == std::string::npos) {
+          return false;
+        }
+        size_t len = std::stoul(buf_.substr(pos, line_end - pos), nullptr, 16);
+        if (buf_.size() < line_end + 2 + len + 2) {
+          return false;
+        }
+        body.append(buf_, line_end + 2, len);
+        pos = line_end + 2 + len + 2;
+        if (len == 0) {
+          break;
+        }
+      }
+    }
+
+    resp->status = std::stoi(head.substr(9, 3));
+    resp->headers = head;
+    resp->body = body;
+    buf_.erase(0, pos);
+    return true;
+  }
+
+  // 对端关闭返回true
+  static bool wait_closed(int fd) {
+    char c;
+    return ::recv(fd, &c, 1, 0) == 0;
+  }
+
+  std::shared_ptr<IoScheduler> scheduler_;
+  HttpServer::ptr server_;
+  std::string buf_;
+};
+
+// 测试1：同一连接上的多个keep-alive请求
+TEST_F(HttpServerTest, KeepAlive) {
+  int fd = connect_server();
+  for (int i = 0; i < 3; ++i) {
+    send_all(fd, "GET /hello HTTP/1.1\r\nHost: x\r\n\r\n");
+    Response resp;
+    ASSERT_TRUE(read_response(fd, &resp));
+    EXPECT_EQ(resp.status, 200);
+    EXPECT_EQ(resp.body, "Hello, World!");
+    EXPECT_NE(resp.headers.find("Content-Type: text/plain"), std::string::npos);
+    EXPECT_NE(resp.headers.find("Date: "), std::string::npos);
+    EXPECT_EQ(resp.headers.find("Connection: close"), std::string::npos);
+  }
+  ::close(fd);
+  EXPECT_EQ(server_->connection_count(), 1u);
+  EXPECT_EQ(server_->request_count(), 3u);
+}
+
+// 测试2：一次写入的流水线请求按顺序得到响应
+TEST_F(HttpServerTest, Pipelining) {
+  int fd = connect_server();
+  std::string batch;
+  for (int i = 0; i < 10; ++i) {
+    batch += "POST /echo HTTP/1.1\r\nContent-Length: " +
+             std::to_string(std::to_string(i).size()) + "\r\n\r\n" +
+             std::to_string(i);
+  }
+  batch += "GET /query?last=1 HTTP/1.1\r\nConnection: close\r\n\r\n";
+  send_all(fd, batch);
+
+  for (int i = 0; i < 10; ++i) {
+    Response resp;
+    ASSERT_TRUE(read_response(fd, &resp));
+    EXPECT_EQ(resp.status, 200);
+    EXPECT_EQ(resp.body, std::to_string(i));
+  }
+  Response last;
+  ASSERT_TRUE(read_response(fd, &last));
+  EXPECT_EQ(last.body, "last=1");
+  EXPECT_NE(last.headers.find("Connection: close"), std::string::npos);
+  EXPECT_TRUE(wait_closed(fd));
+  ::close(fd);
+}
+
+// 测试3：分块响应；HTTP/1.0请求退化为Content-Length
+TEST_F(HttpServerTest, ChunkedResponse) {
+  int fd = connect_server();
+  send_all(fd, "GET /chunked HTTP/1.1\r\n\r\n");
+  Response resp;
+  ASSERT_TRUE(read_response(fd, &resp));
+  EXPECT_NE(resp.headers.find("Transfer-Encoding: chunked"),
+            std::string::npos);
+  EXPECT_EQ(resp.body, "first,second,third");
+
+  send_all(fd, "GET /chunked HTTP/1.0\r\n\r\n");
+  ASSERT_TRUE(read_response(fd, &resp));
+  EXPECT_EQ(resp.headers.find("Transfer-Encoding"), std::string::npos);
+  EXPECT_EQ(resp.body, "first,second,third");
+  EXPECT_NE(resp.headers.find("Connection: close"), std::string::npos);
+  EXPECT_TRUE(wait_closed(fd));
+  ::close(fd);
+}
+
+// 测试4：前缀路由、404与405
+TEST_F(HttpServerTest, Routing) {
+  int fd = connect_server();
+  send_all(fd, "DELETE /static/css/a.css HTTP/1.1\r\n\r\n"
+               "GET /nothing HTTP/1.1\r\n\r\n"
+               "POST /hello HTTP/1.1\r\nContent-Length: 0\r\n\r\n"
+               "HEAD /hello HTTP/1.1\r\n\r\n");
+
+  Response resp;
+  ASSERT_TRUE(read_response(fd, &resp));
+  EXPECT_EQ(resp.status, 200);
+  EXPECT_EQ(resp.body, "static:/static/css/a.css");
+
+  ASSERT_TRUE(read_response(fd, &resp));
+  EXPECT_EQ(resp.status, 404);
+
+  ASSERT_TRUE(read_response(fd, &resp));
+  EXPECT_EQ(resp.status, 405);
+  EXPECT_NE(resp.headers.find("Allow: GET"), std::string::npos);
+
+  // HEAD响应带Content-Length但没有响应体，后面的数据不应被当作响应体
+  send_all(fd, "GET /hello HTTP/1.1\r\n\r\n");
+  size_t head_end;
+  while ((head_end = buf_.find("\r\n\r\n")) == std::string::npos) {
+    char tmp[1024];
+    ssize_t n = ::recv(fd, tmp, sizeof(tmp), 0);
+    ASSERT_GT(n, 0);
+    buf_.append(tmp, static_cast<size_t>(n));
+  }
+  EXPECT_NE(buf_.find("Content-Length: 13"), std::string::npos);
+  buf_.erase(0, head_end + 4);
+  ASSERT_TRUE(read_response(fd, &resp));
+  EXPECT_EQ(resp.body, "Hello, World!");
+  ::close(fd);
+}
+
+// 测试5：非法请求返回错误状态并关闭连接
+TEST_F(HttpServerTest, BadRequestClosesConnection) {
+  int fd = connect_server();
+  send_all(fd, "GET / HTTP/1.1\r\nBad Header\r\n\r\n");
+  Response resp;
+  ASSERT_TRUE(read_response(fd, &resp));
+  EXPECT_EQ(resp.status, 400);
+  EXPECT_NE(resp.headers.find("Connection: close"), std::string::npos);
+  EXPECT_TRUE(wait_closed(fd));
+  ::close(fd);
+  EXPECT_EQ(server_->parse_error_count(), 1u);
+}
+
+// 测试6：分多次到达且跨越读缓冲区末尾的请求
+TEST_F(HttpServerTest, FragmentedLargeRequest) {
+  int fd = connect_server();
+  std::string body(20000, 'x');
+  std::string req = "POST /echo HTTP/1.1\r\nContent-Length: " +
+                    std::to_string(body.size()) + "\r\n\r\n" + body;
+  for (size_t off = 0; off < req.size(); off += 3000) {
+    send_all(fd, req.substr(off, 3000));
+    usleep(1000);
+  }
+  Response resp;
+  ASSERT_TRUE(read_response(fd, &resp));
+  EXPECT_EQ(resp.status, 200);
+  EXPECT_EQ(resp.body, body);
+  ::close(fd);
+}
+
+int main(int argc, char **argv) {
+  zcoroutine::init_logger(zlog::LogLevel::value::DEBUG);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
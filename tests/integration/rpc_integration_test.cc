@@ -0,0 +1,258 @@
+/**
+ * @file rpc_integration_test.cc
+ * @brief RpcServer/RpcChannel 集成测试
+ * 测试单连接多路复用、乱序响应匹配、调用超时、错误状态与连接关闭
+ */
+
+#include "hook/hook.h"
+#include "io/io_scheduler.h"
+#include "rpc/rpc_channel.h"
+#include "rpc/rpc_server.h"
+#include "util/zcoroutine_logger.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <dirent.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace zcoroutine;
+
+class RpcTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    scheduler_ = std::make_shared<IoScheduler>(2, "RpcTestScheduler");
+    scheduler_->start();
+
+    server_ = std::make_shared<RpcServer>(scheduler_.get());
+    server_->register_method("echo",
+                             [](const std::string &req, std::string *resp) {
+                               *resp = req;
+                               return 0;
+                             });
+    // 请求格式："<毫秒>:<内容>"，睡眠后原样返回内容
+    server_->register_method("sleep",
+                             [](const std::string &req, std::string *resp) {
+                               size_t sep = req.find(':');
+                               usleep(std::stoul(req.substr(0, sep)) * 1000);
+                               *resp = req.substr(sep + 1);
+                               return 0;
+                             });
+    server_->register_method("fail", [](const std::string &, std::string *) {
+      return -1;
+    });
+    ASSERT_TRUE(server_->start("127.0.0.1", 0));
+  }
+
+  void TearDown() override {
+    server_->stop();
+    server_.reset();
+    scheduler_->stop();
+    scheduler_.reset();
+  }
+
+  // 在调度器协程中运行func并等待完成
+  void run_in_fiber(std::function<void()> func) {
+    std::atomic<bool> done{false};
+    scheduler_->schedule(std::make_shared<Fiber>([&]() {
+      set_hook_enable(true);
+      func();
+      done = true;
+    }));
+    ASSERT_TRUE(wait_until([&] { return done.load(); }, 5000));
+  }
+
+  template <typename Pred>
+  static bool wait_until(Pred pred, int timeout_ms = 2000) {
+    for (int i = 0; i < timeout_ms / 10; ++i) {
+      if (pred()) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return pred();
+  }
+
+  // 当前进程打开的fd数
+  static size_t open_fd_count() {
+    size_t count = 0;
+    DIR *dir = opendir("/proc/self/fd");
+    if (!dir) {
+      return 0;
+    }
+    while (readdir(dir)) {
+      ++count;
+    }
+    closedir(dir);
+    return count;
+  }
+
+  RpcChannel::ptr connect_channel() {
+    auto channel = std::make_shared<RpcChannel>(scheduler_.get());
+    run_in_fiber([&]() {
+      EXPECT_EQ(channel->connect("127.0.0.1", server_->port()), 0);
+    });
+    return channel;
+  }
+
+  std::shared_ptr<IoScheduler> scheduler_;
+  RpcServer::ptr server_;
+};
+
+// 测试1：基本调用，同一连接上连续调用
+TEST_F(RpcTest, EchoCall) {
+  RpcChannel::ptr channel = connect_channel();
+  ASSERT_TRUE(channel->is_connected());
+
+  run_in_fiber([&]() {
+    for (int i = 0; i < 10; ++i) {
+      std::string resp;
+      std::string req = "hello-" + std::to_string(i);
+      ASSERT_EQ(channel->call("echo", req, &resp), 0);
+      EXPECT_EQ(resp, req);
+    }
+    std::string big(256 * 1024, 'x');
+    std::string resp;
+    ASSERT_EQ(channel->call("echo", big, &resp), 0);
+    EXPECT_EQ(resp, big);
+  });
+
+  EXPECT_EQ(channel->call_count(), 11u);
+  EXPECT_EQ(channel->pending_count(), 0u);
+  channel->close();
+  EXPECT_TRUE(wait_until([&] { return server_->request_count() == 11; }));
+}
+
+// 测试2：100个协程共享一个连接，响应乱序到达仍按request_id匹配
+TEST_F(RpcTest, ConcurrentCallsOutOfOrder) {
+  RpcChannel::ptr channel = connect_channel();
+  constexpr int kCalls = 100;
+  std::atomic<int> ok{0};
+  std::atomic<int> done{0};
+
+  for (int i = 0; i < kCalls; ++i) {
+    scheduler_->schedule(std::make_shared<Fiber>([&, i]() {
+      set_hook_enable(true);
+      // 先发出的调用睡得更久，响应顺序与请求顺序相反
+      std::string req =
+          std::to_string((kCalls - i) % 20) + ":" + std::to_string(i);
+      std::string resp;
+      if (channel->call("sleep", req, &resp, 3000) == 0 &&
+          resp == std::to_string(i)) {
+        ++ok;
+      }
+      ++done;
+    }));
+  }
+
+  ASSERT_TRUE(wait_until([&] { return done.load() == kCalls; }, 5000));
+  EXPECT_EQ(ok.load(), kCalls);
+  EXPECT_EQ(channel->pending_count(), 0u);
+  EXPECT_EQ(channel->frames_sent(), static_cast<uint64_t>(kCalls));
+  EXPECT_LE(channel->write_batches(), channel->frames_sent());
+  channel->close();
+}
+
+// 测试3：调用超时返回ETIMEDOUT，迟到的响应被丢弃，连接仍可继续使用
+TEST_F(RpcTest, DeadlineTimeout) {
+  RpcChannel::ptr channel = connect_channel();
+
+  run_in_fiber([&]() {
+    std::string resp;
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(channel->call("sleep", "300:late", &resp, 50), -1);
+    EXPECT_EQ(errno, ETIMEDOUT);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    EXPECT_LT(elapsed, 250);
+
+    ASSERT_EQ(channel->call("echo", "after", &resp), 0);
+    EXPECT_EQ(resp, "after");
+
+    // 等待迟到的响应到达并被丢弃
+    usleep(400 * 1000);
+    ASSERT_EQ(channel->call("echo", "again", &resp), 0);
+    EXPECT_EQ(resp, "again");
+  });
+
+  EXPECT_EQ(channel->timeout_count(), 1u);
+  EXPECT_EQ(channel->pending_count(), 0u);
+  channel->close();
+}
+
+// 测试4：方法不存在返回ENOSYS，处理函数失败返回EREMOTEIO
+TEST_F(RpcTest, ErrorStatus) {
+  RpcChannel::ptr channel = connect_channel();
+
+  run_in_fiber([&]() {
+    std::string resp;
+    EXPECT_EQ(channel->call("missing", "x", &resp), -1);
+    EXPECT_EQ(errno, ENOSYS);
+    EXPECT_EQ(channel->call("fail", "x", &resp), -1);
+    EXPECT_EQ(errno, EREMOTEIO);
+    ASSERT_EQ(channel->call("echo", "ok", &resp), 0);
+    EXPECT_EQ(resp, "ok");
+  });
+  channel->close();
+}
+
+// 测试5：关闭连接时未完成的调用以ECONNRESET失败，之后的调用立即失败
+TEST_F(RpcTest, CloseFailsPendingCalls) {
+  RpcChannel::ptr channel = connect_channel();
+  constexpr int kCalls = 5;
+  std::atomic<int> reset{0};
+  std::atomic<int> done{0};
+
+  for (int i = 0; i < kCalls; ++i) {
+    scheduler_->schedule(std::make_shared<Fiber>([&]() {
+      set_hook_enable(true);
+      std::string resp;
+      if (channel->call("sleep", "1000:x", &resp, 3000) == -1 &&
+          errno == ECONNRESET) {
+        ++reset;
+      }
+      ++done;
+    }));
+  }
+
+  ASSERT_TRUE(
+      wait_until([&] { return channel->pending_count() == kCalls; }, 2000));
+  channel->close();
+
+  ASSERT_TRUE(wait_until([&] { return done.load() == kCalls; }, 2000));
+  EXPECT_EQ(reset.load(), kCalls);
+  EXPECT_FALSE(channel->is_connected());
+
+  run_in_fiber([&]() {
+    std::string resp;
+    EXPECT_EQ(channel->call("echo", "x", &resp), -1);
+    EXPECT_EQ(errno, ECONNRESET);
+  });
+}
+
+// 测试6：不调用close()直接释放通道，析构函数关闭连接并释放fd
+TEST_F(RpcTest, DropWithoutCloseReleasesFd) {
+  const size_t before = open_fd_count();
+  RpcChannel::ptr channel = connect_channel();
+  run_in_fiber([&]() {
+    std::string resp;
+    ASSERT_EQ(channel->call("echo", "x", &resp), 0);
+  });
+  EXPECT_GT(open_fd_count(), before);
+
+  std::weak_ptr<RpcChannel> weak = channel;
+  channel.reset();
+  EXPECT_TRUE(weak.expired());
+  // 客户端fd由发送协程关闭，服务端随后读到EOF关闭自己的fd
+  EXPECT_TRUE(wait_until([&] { return open_fd_count() == before; }));
+}
+
+int main(int argc, char **argv) {
+  zcoroutine::init_logger(zlog::LogLevel::value::DEBUG);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
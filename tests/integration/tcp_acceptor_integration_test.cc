@@ -0,0 +1,223 @@
+/**
+ * @file tcp_acceptor_integration_test.cc
+ * @brief TcpAcceptor 集成测试
+ * 测试SO_REUSEPORT分片监听、批量accept、连接分发与停止
+ */
+
+#include "hook/hook.h"
+#include "io/io_scheduler.h"
+#include "io/status_table.h"
+#include "net/tcp_acceptor.h"
+#include "util/zcoroutine_logger.h"
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace zcoroutine;
+
+class TcpAcceptorTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    scheduler_ = std::make_shared<IoScheduler>(2, "AcceptorTestScheduler");
+    scheduler_->start();
+  }
+
+  void TearDown() override {
+    if (scheduler_) {
+      scheduler_->stop();
+      scheduler_.reset();
+    }
+  }
+
+  // 阻塞方式连接并完成一次echo，返回是否成功
+  static bool echo_once(uint16_t port, const char *msg) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+      return false;
+    }
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+      ::close(fd);
+      return false;
+    }
+    size_t len = strlen(msg);
+    bool ok = ::send(fd, msg, len, 0) == static_cast<ssize_t>(len);
+    char buf[64] = {0};
+    ok = ok && ::recv(fd, buf, sizeof(buf), MSG_WAITALL) ==
+                   static_cast<ssize_t>(len);
+    ok = ok && memcmp(buf, msg, len) == 0;
+    ::close(fd);
+    return ok;
+  }
+
+  // 等待条件成立，最多等待timeout_ms
+  template <typename Pred>
+  static bool wait_until(Pred pred, int timeout_ms = 2000) {
+    for (int i = 0; i < timeout_ms / 10; ++i) {
+      if (pred()) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return pred();
+  }
+
+  std::shared_ptr<IoScheduler> scheduler_;
+};
+
+// echo处理函数：读取固定长度后原样写回
+static void echo_handler(int fd, std::atomic<int> *handled) {
+  char buf[64];
+  ssize_t n = read(fd, buf, 5);
+  if (n > 0) {
+    write(fd, buf, n);
+  }
+  handled->fetch_add(1);
+  close(fd);
+}
+
+// 测试1：默认每个工作线程一个监听socket，并能正常处理连接
+TEST_F(TcpAcceptorTest, ListenerPerWorker) {
+  std::atomic<int> handled{0};
+  auto acceptor = std::make_shared<TcpAcceptor>(
+      scheduler_.get(), "127.0.0.1", 0,
+      [&handled](int fd) { echo_handler(fd, &handled); });
+  ASSERT_TRUE(acceptor->start());
+  EXPECT_EQ(acceptor->listener_count(), 2u);
+  EXPECT_GT(acceptor->port(), 0);
+
+  EXPECT_TRUE(echo_once(acceptor->port(), "hello"));
+  EXPECT_TRUE(wait_until([&] { return handled.load() == 1; }));
+  EXPECT_EQ(acceptor->accepted_count(), 1u);
+
+  acceptor->stop();
+}
+
+// 测试2：连接fd已登记为hook托管的阻塞socket
+TEST_F(TcpAcceptorTest, ConnectionRegisteredInStatusTable) {
+  std::atomic<bool> registered{false};
+  std::atomic<bool> done{false};
+  auto acceptor = std::make_shared<TcpAcceptor>(
+      scheduler_.get(), "127.0.0.1", 0, [&](int fd) {
+        auto ctx = StatusTable::GetInstance()->get(fd);
+        registered = ctx && ctx->is_socket() && ctx->get_sys_nonblock() &&
+                     !ctx->get_user_nonblock() && is_hook_enabled();
+        close(fd);
+        done = true;
+      });
+  ASSERT_TRUE(acceptor->start());
+
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(acceptor->port());
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)),
+            0);
+
+  EXPECT_TRUE(wait_until([&] { return done.load(); }));
+  EXPECT_TRUE(registered.load());
+  ::close(fd);
+  acceptor->stop();
+}
+
+// 测试3：并发连接突发，批量accept处理全部连接
+TEST_F(TcpAcceptorTest, BurstOfConnections) {
+  constexpr int kClients = 4;
+  constexpr int kPerClient = 50;
+  std::atomic<int> handled{0};
+  auto acceptor = std::make_shared<TcpAcceptor>(
+      scheduler_.get(), "127.0.0.1", 0,
+      [&handled](int fd) { echo_handler(fd, &handled); });
+  ASSERT_TRUE(acceptor->start());
+
+  std::atomic<int> ok{0};
+  std::vector<std::thread> clients;
+  for (int i = 0; i < kClients; ++i) {
+    clients.emplace_back([&]() {
+      for (int j = 0; j < kPerClient; ++j) {
+        if (echo_once(acceptor->port(), "burst")) {
+          ok.fetch_add(1);
+        }
+      }
+    });
+  }
+  for (auto &t : clients) {
+    t.join();
+  }
+
+  EXPECT_EQ(ok.load(), kClients * kPerClient);
+  EXPECT_TRUE(wait_until([&] { return handled.load() == kClients * kPerClient; }));
+  EXPECT_EQ(acceptor->accepted_count(),
+            static_cast<uint64_t>(kClients * kPerClient));
+  // 每次等待至少对应一个连接，批量accept时等待次数不会超过连接数
+  EXPECT_LE(acceptor->wait_count(),
+            static_cast<uint64_t>(kClients * kPerClient) +
+                acceptor->listener_count());
+
+  acceptor->stop();
+}
+
+// 测试4：关闭inline_dispatch时通过调度队列分发
+TEST_F(TcpAcceptorTest, QueuedDispatch) {
+  std::atomic<int> handled{0};
+  TcpAcceptor::Options options;
+  options.inline_dispatch = false;
+  options.listener_count = 1;
+  auto acceptor = std::make_shared<TcpAcceptor>(
+      scheduler_.get(), "127.0.0.1", 0,
+      [&handled](int fd) { echo_handler(fd, &handled); }, options);
+  ASSERT_TRUE(acceptor->start());
+  EXPECT_EQ(acceptor->listener_count(), 1u);
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(echo_once(acceptor->port(), "queue"));
+  }
+  EXPECT_TRUE(wait_until([&] { return handled.load() == 10; }));
+
+  acceptor->stop();
+}
+
+// 测试5：stop后accept协程退出，不再接受新连接
+TEST_F(TcpAcceptorTest, StopRejectsNewConnections) {
+  std::atomic<int> handled{0};
+  auto acceptor = std::make_shared<TcpAcceptor>(
+      scheduler_.get(), "127.0.0.1", 0,
+      [&handled](int fd) { echo_handler(fd, &handled); });
+  ASSERT_TRUE(acceptor->start());
+  uint16_t port = acceptor->port();
+  EXPECT_TRUE(echo_once(port, "first"));
+
+  acceptor->stop();
+  EXPECT_FALSE(acceptor->is_running());
+  // accept协程退出后释放自身引用
+  EXPECT_TRUE(wait_until([&] { return acceptor.use_count() == 1; }));
+  acceptor.reset();
+
+  EXPECT_FALSE(echo_once(port, "again"));
+}
+
+// 测试6：无效地址启动失败
+TEST_F(TcpAcceptorTest, InvalidAddress) {
+  auto acceptor = std::make_shared<TcpAcceptor>(scheduler_.get(), "not-an-ip",
+                                                0, [](int fd) { close(fd); });
+  EXPECT_FALSE(acceptor->start());
+  EXPECT_EQ(acceptor->listener_count(), 0u);
+}
+
+int main(int argc, char **argv) {
+  zcoroutine::init_logger(zlog::LogLevel::value::DEBUG);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
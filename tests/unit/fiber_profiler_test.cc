@@ -0,0 +1,159 @@
+#include "runtime/fiber.h"
+#include "runtime/fiber_pool.h"
+#include "runtime/fiber_profiler.h"
+#include "scheduling/scheduler.h"
+#include "util/zcoroutine_logger.h"
+#include <chrono>
+#include <gtest/gtest.h>
+
+using namespace zcoroutine;
+
+class FiberProfilerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    FiberProfiler::instance().reset();
+    FiberProfiler::set_enabled(true);
+  }
+
+  void TearDown() override {
+    FiberProfiler::set_enabled(false);
+    FiberProfiler::instance().reset();
+  }
+
+  static void busy_wait_ms(int ms) {
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+    }
+  }
+
+  static const FiberProfile *find(const std::vector<FiberProfile> &profiles,
+                                  const std::string &name) {
+    for (const auto &profile : profiles) {
+      if (profile.name == name) {
+        return &profile;
+      }
+    }
+    return nullptr;
+  }
+};
+
+// 测试1：名称前缀去掉_<id>后缀
+TEST_F(FiberProfilerTest, NamePrefix) {
+  EXPECT_EQ(FiberProfiler::name_prefix("worker_12"), "worker");
+  EXPECT_EQ(FiberProfiler::name_prefix("fiber_3"), "fiber");
+  EXPECT_EQ(FiberProfiler::name_prefix("http_conn"), "http_conn");
+  EXPECT_EQ(FiberProfiler::name_prefix("v2"), "v2");
+}
+
+// 测试2：关闭时不累加
+TEST_F(FiberProfilerTest, DisabledRecordsNothing) {
+  FiberProfiler::set_enabled(false);
+  auto fiber = std::make_shared<Fiber>([]() { Fiber::yield(); });
+  fiber->resume();
+  EXPECT_EQ(fiber->run_count(), 0u);
+  EXPECT_EQ(fiber->cpu_ticks(), 0u);
+  fiber->resume();
+  EXPECT_TRUE(FiberProfiler::instance().top().empty());
+}
+
+// 测试3：累加CPU时间和切入次数，结束时按前缀汇总
+TEST_F(FiberProfilerTest, AccumulatesCpuAndRuns) {
+  for (int i = 0; i < 2; ++i) {
+    auto fiber = std::make_shared<Fiber>(
+        []() {
+          busy_wait_ms(5);
+          Fiber::yield();
+          busy_wait_ms(5);
+        },
+        StackAllocator::kDefaultStackSize, "busy");
+    fiber->resume();
+    EXPECT_EQ(fiber->run_count(), 1u);
+    EXPECT_GT(fiber->cpu_ticks(), 0u);
+    fiber->resume();
+    // 结束后已汇总并清零
+    EXPECT_EQ(fiber->run_count(), 0u);
+  }
+
+  auto profiles = FiberProfiler::instance().top();
+  const FiberProfile *busy = find(profiles, "busy");
+  ASSERT_NE(busy, nullptr);
+  EXPECT_EQ(busy->fibers, 2u);
+  EXPECT_EQ(busy->runs, 4u);
+  EXPECT_GE(busy->cpu_ns, 18000000u);
+  EXPECT_LT(busy->cpu_ns, 1000000000u);
+}
+
+// 测试4：嵌套resume时父协程只统计自身时间
+TEST_F(FiberProfilerTest, NestedTimeIsExclusive) {
+  auto outer = std::make_shared<Fiber>(
+      []() {
+        auto inner = std::make_shared<Fiber>([]() { busy_wait_ms(20); },
+                                             StackAllocator::kDefaultStackSize,
+                                             "inner");
+        inner->resume();
+        busy_wait_ms(2);
+      },
+      StackAllocator::kDefaultStackSize, "outer");
+  outer->resume();
+
+  auto profiles = FiberProfiler::instance().top();
+  ASSERT_EQ(profiles.size(), 2u);
+  EXPECT_EQ(profiles[0].name, "inner");
+  EXPECT_EQ(profiles[1].name, "outer");
+  EXPECT_GE(profiles[0].cpu_ns, 18000000u);
+  EXPECT_LT(profiles[1].cpu_ns, 15000000u);
+
+  EXPECT_EQ(FiberProfiler::instance().top(1).size(), 1u);
+}
+
+// 测试5：调度器记录队列等待时间，池化协程按复用时的名称汇总
+TEST_F(FiberProfilerTest, SchedulerQueueWaitAndPooledNames) {
+  FiberPool::get_instance().clear();
+  Scheduler scheduler(1, "ProfilerTest");
+  scheduler.start();
+
+  scheduler.schedule(FiberPool::get_instance().get_fiber(
+      []() { busy_wait_ms(20); }, StackAllocator::kDefaultStackSize, "blocker"));
+  for (int i = 0; i < 5; ++i) {
+    scheduler.schedule(FiberPool::get_instance().get_fiber(
+        []() {}, StackAllocator::kDefaultStackSize, "queued"));
+  }
+  scheduler.stop();
+
+  // 复用池中的协程后，统计计入新名称
+  auto reused = FiberPool::get_instance().get_fiber(
+      []() {}, StackAllocator::kDefaultStackSize, "reused");
+  EXPECT_EQ(FiberProfiler::name_prefix(reused->name()), "reused");
+  reused->resume();
+
+  auto profiles = FiberProfiler::instance().top(0);
+  const FiberProfile *blocker = find(profiles, "blocker");
+  const FiberProfile *queued = find(profiles, "queued");
+  ASSERT_NE(blocker, nullptr);
+  ASSERT_NE(queued, nullptr);
+  EXPECT_NE(find(profiles, "reused"), nullptr);
+  EXPECT_EQ(queued->fibers, 5u);
+  // 排在blocker之后的任务至少等待了它的运行时间
+  EXPECT_GE(queued->wait_ns, 5u * 15000000u);
+  EXPECT_GE(blocker->cpu_ns, 15000000u);
+  FiberPool::get_instance().clear();
+}
+
+// 测试6：报告包含表头和各项名称
+TEST_F(FiberProfilerTest, Report) {
+  auto fiber = std::make_shared<Fiber>([]() { busy_wait_ms(1); },
+                                       StackAllocator::kDefaultStackSize,
+                                       "report");
+  fiber->resume();
+
+  std::string report = FiberProfiler::instance().report(5);
+  EXPECT_NE(report.find("cpu_ms"), std::string::npos);
+  EXPECT_NE(report.find("report"), std::string::npos);
+}
+
+int main(int argc, char **argv) {
+  zcoroutine::init_logger(zlog::LogLevel::value::DEBUG);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
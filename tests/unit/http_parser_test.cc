@@ -0,0 +1,170 @@
+/**
+ * @file http_parser_test.cc
+ * @brief HttpParser 单元测试
+ * 测试请求行/头部解析、增量解析、流水线请求、请求体与各类错误状态码
+ */
+
+#include "http/http_parser.h"
+#include "util/zcoroutine_logger.h"
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace zcoroutine;
+
+class HttpParserTest : public ::testing::Test {
+protected:
+  HttpParser::Status parse(const std::string &data) {
+    return parser_.parse(data.data(), data.size(), &req_);
+  }
+
+  HttpParser parser_;
+  HttpRequest req_;
+};
+
+// 测试1：简单GET请求
+TEST_F(HttpParserTest, SimpleGet) {
+  std::string data = "GET /index.html?a=1&b=2 HTTP/1.1\r\n"
+                     "Host: localhost\r\n"
+                     "User-Agent:  test \r\n"
+                     "\r\n";
+  ASSERT_EQ(parse(data), HttpParser::Status::kComplete);
+  EXPECT_EQ(parser_.consumed(), data.size());
+  EXPECT_TRUE(req_.method.equals("GET"));
+  EXPECT_TRUE(req_.target.equals("/index.html?a=1&b=2"));
+  EXPECT_TRUE(req_.path.equals("/index.html"));
+  EXPECT_TRUE(req_.query.equals("a=1&b=2"));
+  EXPECT_EQ(req_.version_minor, 1);
+  ASSERT_EQ(req_.headers.size(), 2u);
+  EXPECT_TRUE(req_.header("host").equals("localhost"));
+  EXPECT_TRUE(req_.header("USER-AGENT").equals("test"));
+  EXPECT_TRUE(req_.header("missing").empty());
+  EXPECT_TRUE(req_.body.empty());
+  EXPECT_TRUE(req_.keep_alive);
+}
+
+// 测试2：逐字节到达的增量解析
+TEST_F(HttpParserTest, IncrementalByteByByte) {
+  std::string data = "POST /submit HTTP/1.1\r\n"
+                     "Content-Length: 5\r\n"
+                     "\r\n"
+                     "hello";
+  for (size_t i = 1; i < data.size(); ++i) {
+    ASSERT_EQ(parser_.parse(data.data(), i, &req_),
+              HttpParser::Status::kIncomplete)
+        << "prefix " << i;
+  }
+  ASSERT_EQ(parse(data), HttpParser::Status::kComplete);
+  EXPECT_TRUE(req_.method.equals("POST"));
+  EXPECT_TRUE(req_.body.equals("hello"));
+  EXPECT_EQ(parser_.consumed(), data.size());
+}
+
+// 测试3：请求体到达前数据被搬移，头部片段指向新地址
+TEST_F(HttpParserTest, BodyAfterBufferMove) {
+  std::string head = "PUT /x HTTP/1.1\r\nContent-Length: 3\r\n\r\n";
+  ASSERT_EQ(parse(head + "a"), HttpParser::Status::kIncomplete);
+
+  std::string moved = head + "abc";
+  ASSERT_EQ(parse(moved), HttpParser::Status::kComplete);
+  EXPECT_EQ(req_.method.data, moved.data());
+  EXPECT_TRUE(req_.body.equals("abc"));
+}
+
+// 测试4：流水线上的多个请求依次解析
+TEST_F(HttpParserTest, PipelinedRequests) {
+  std::string data = "GET /a HTTP/1.1\r\n\r\n"
+                     "GET /b HTTP/1.1\r\nConnection: close\r\n\r\n"
+                     "GET /c HTT";
+  size_t offset = 0;
+
+  ASSERT_EQ(parser_.parse(data.data() + offset, data.size() - offset, &req_),
+            HttpParser::Status::kComplete);
+  EXPECT_TRUE(req_.path.equals("/a"));
+  offset += parser_.consumed();
+  parser_.reset();
+
+  ASSERT_EQ(parser_.parse(data.data() + offset, data.size() - offset, &req_),
+            HttpParser::Status::kComplete);
+  EXPECT_TRUE(req_.path.equals("/b"));
+  EXPECT_FALSE(req_.keep_alive);
+  offset += parser_.consumed();
+  parser_.reset();
+
+  EXPECT_EQ(parser_.parse(data.data() + offset, data.size() - offset, &req_),
+            HttpParser::Status::kIncomplete);
+}
+
+// 测试5：HTTP/1.0的keep-alive协商
+TEST_F(HttpParserTest, Http10KeepAlive) {
+  ASSERT_EQ(parse("GET / HTTP/1.0\r\n\r\n"), HttpParser::Status::kComplete);
+  EXPECT_EQ(req_.version_minor, 0);
+  EXPECT_FALSE(req_.keep_alive);
+
+  parser_.reset();
+  ASSERT_EQ(parse("GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n"),
+            HttpParser::Status::kComplete);
+  EXPECT_TRUE(req_.keep_alive);
+
+  parser_.reset();
+  ASSERT_EQ(parse("GET / HTTP/1.1\r\nConnection: upgrade, close\r\n\r\n"),
+            HttpParser::Status::kComplete);
+  EXPECT_FALSE(req_.keep_alive);
+}
+
+// 测试6：非法请求返回对应状态码
+TEST_F(HttpParserTest, MalformedRequests) {
+  struct Case {
+    const char *data;
+    int status;
+  } cases[] = {
+      {"GET\r\n\r\n", 400},
+      {" / HTTP/1.1\r\n\r\n", 400},
+      {"GET / FTP/1.1\r\n\r\n", 400},
+      {"GET / HTTP/2.0\r\n\r\n", 505},
+      {"GET / HTTP/1.1\r\nBad Header: x\r\n\r\n", 400},
+      {"GET / HTTP/1.1\r\nNoColon\r\n\r\n", 400},
+      {"GET / HTTP/1.1\r\nContent-Length: abc\r\n\r\n", 400},
+      {"GET / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n",
+       400},
+      {"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n", 501},
+  };
+  for (const Case &c : cases) {
+    parser_.reset();
+    EXPECT_EQ(parse(c.data), HttpParser::Status::kError) << c.data;
+    EXPECT_EQ(parser_.error_status(), c.status) << c.data;
+  }
+}
+
+// 测试7：头部与请求体大小限制
+TEST_F(HttpParserTest, SizeLimits) {
+  HttpParser::Options options;
+  options.max_header_size = 64;
+  options.max_body_size = 16;
+  options.max_headers = 2;
+  HttpParser parser(options);
+
+  // 头部结束标记尚未到达但已超过上限
+  std::string big(100, 'a');
+  EXPECT_EQ(parser.parse(big.data(), big.size(), &req_),
+            HttpParser::Status::kError);
+  EXPECT_EQ(parser.error_status(), 431);
+
+  parser.reset();
+  std::string body = "POST / HTTP/1.1\r\nContent-Length: 17\r\n\r\n";
+  EXPECT_EQ(parser.parse(body.data(), body.size(), &req_),
+            HttpParser::Status::kError);
+  EXPECT_EQ(parser.error_status(), 413);
+
+  parser.reset();
+  std::string headers = "GET / HTTP/1.1\r\nA: 1\r\nB: 2\r\nC: 3\r\n\r\n";
+  EXPECT_EQ(parser.parse(headers.data(), headers.size(), &req_),
+            HttpParser::Status::kError);
+  EXPECT_EQ(parser.error_status(), 431);
+}
+
+int main(int argc, char **argv) {
+  zcoroutine::init_logger(zlog::LogLevel::value::DEBUG);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,246 @@
+/**
+ * @file iobuf_test.cc
+ * @brief IOBuf 单元测试
+ * 测试引用计数块链的追加、共享、切分、前插，以及writev/readv辅助函数
+ */
+
+#include "net/iobuf.h"
+#include "util/zcoroutine_logger.h"
+#include <gtest/gtest.h>
+
+#include <climits>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace zcoroutine;
+
+class IOBufTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, sv_), 0);
+  }
+
+  void TearDown() override {
+    for (int fd : sv_) {
+      if (fd >= 0) {
+        ::close(fd);
+      }
+    }
+  }
+
+  // 从fd读取恰好len字节
+  static std::string read_n(int fd, size_t len) {
+    std::string out(len, '\0');
+    size_t got = 0;
+    while (got < len) {
+      ssize_t n = ::read(fd, &out[got], len - got);
+      if (n <= 0) {
+        break;
+      }
+      got += static_cast<size_t>(n);
+    }
+    out.resize(got);
+    return out;
+  }
+
+  int sv_[2]{-1, -1};
+};
+
+static int g_deleted = 0;
+static void count_deleter(void *) { ++g_deleted; }
+
+// 测试1：小块追加合并到同一个尾块
+TEST_F(IOBufTest, AppendCoalescesIntoTailBlock) {
+  IOBuf buf;
+  buf.append("hello ", 6);
+  buf.append(std::string("world"));
+  EXPECT_EQ(buf.size(), 11u);
+  EXPECT_EQ(buf.block_count(), 1u);
+  EXPECT_EQ(buf.to_string(), "hello world");
+}
+
+// 测试2：大数据跨越多个块
+TEST_F(IOBufTest, AppendSpansBlocks) {
+  std::string data(IOBuf::kBlockSize * 2 + 100, 'a');
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>('a' + i % 26);
+  }
+  IOBuf buf;
+  buf.append(data);
+  EXPECT_EQ(buf.block_count(), 3u);
+  EXPECT_EQ(buf.to_string(), data);
+}
+
+// 测试3：共享追加不拷贝数据，共享后的尾块不再原地追加
+TEST_F(IOBufTest, SharedAppendDoesNotCopy) {
+  IOBuf body;
+  body.append("cached-body", 11);
+
+  IOBuf rsp;
+  rsp.append("header|", 7);
+  rsp.append(body);
+  EXPECT_EQ(rsp.ref_at(1).block, body.ref_at(0).block);
+  EXPECT_EQ(rsp.ref_at(1).block->ref.load(), 2);
+
+  // 原链与共享链各自追加，互不影响
+  body.append("X", 1);
+  rsp.append("Y", 1);
+  EXPECT_EQ(body.to_string(), "cached-bodyX");
+  EXPECT_EQ(rsp.to_string(), "header|cached-bodyY");
+}
+
+// 测试4：cutn在块中间切分，两侧共享同一块
+TEST_F(IOBufTest, CutnSplitsBlock) {
+  IOBuf buf;
+  buf.append("0123456789", 10);
+  IOBuf head;
+  EXPECT_EQ(buf.cutn(&head, 4), 4u);
+  EXPECT_EQ(head.to_string(), "0123");
+  EXPECT_EQ(buf.to_string(), "456789");
+  EXPECT_EQ(head.ref_at(0).block, buf.ref_at(0).block);
+
+  IOBuf rest;
+  EXPECT_EQ(buf.cutn(&rest, 100), 6u);
+  EXPECT_TRUE(buf.empty());
+  EXPECT_EQ(rest.to_string(), "456789");
+}
+
+// 测试5：slice与pop_front/pop_back
+TEST_F(IOBufTest, SliceAndPop) {
+  IOBuf buf;
+  buf.append("abc", 3);
+  IOBuf other;
+  other.append("defgh", 5);
+  buf.append(std::move(other));
+  EXPECT_TRUE(other.empty());
+
+  EXPECT_EQ(buf.slice(2, 4).to_string(), "cdef");
+  EXPECT_EQ(buf.slice(6, 100).to_string(), "gh");
+
+  EXPECT_EQ(buf.pop_front(1), 1u);
+  EXPECT_EQ(buf.pop_back(2), 2u);
+  EXPECT_EQ(buf.to_string(), "bcdef");
+
+  char out[3];
+  EXPECT_EQ(buf.copy_to(out, 3, 2), 3u);
+  EXPECT_EQ(std::string(out, 3), "def");
+}
+
+// 测试6：prepend在头部插入协议头
+TEST_F(IOBufTest, PrependHeader) {
+  IOBuf buf;
+  buf.append("payload", 7);
+  uint32_t len = 7;
+  buf.prepend(&len, sizeof(len));
+  EXPECT_EQ(buf.size(), 11u);
+
+  uint32_t got = 0;
+  buf.copy_to(&got, sizeof(got));
+  EXPECT_EQ(got, 7u);
+  EXPECT_EQ(buf.slice(4, 7).to_string(), "payload");
+}
+
+// 测试7：用户内存在最后一个引用释放时调用deleter
+TEST_F(IOBufTest, UserDataDeleter) {
+  static const char kStatic[] = "static-data";
+  g_deleted = 0;
+  {
+    IOBuf buf;
+    buf.append_user_data(kStatic, sizeof(kStatic) - 1, count_deleter, nullptr);
+    IOBuf copy(buf);
+    buf.clear();
+    EXPECT_EQ(g_deleted, 0);
+    EXPECT_EQ(copy.to_string(), "static-data");
+  }
+  EXPECT_EQ(g_deleted, 1);
+}
+
+// 测试8：释放的块回到线程缓存并被复用
+TEST_F(IOBufTest, BlocksAreRecycled) {
+  {
+    IOBuf warm;
+    warm.append("x", 1);
+  }
+  size_t live = IOBuf::live_block_count();
+  size_t cached = IOBuf::cached_block_count();
+  ASSERT_GT(cached, 0u);
+  {
+    IOBuf buf;
+    buf.append("y", 1);
+    EXPECT_EQ(IOBuf::cached_block_count(), cached - 1);
+  }
+  EXPECT_EQ(IOBuf::live_block_count(), live);
+  EXPECT_EQ(IOBuf::cached_block_count(), cached);
+}
+
+// 测试9：整条链一次writev发出
+TEST_F(IOBufTest, CutIntoFdSingleWritev) {
+  IOBuf body;
+  body.append("BODY", 4);
+  IOBuf rsp;
+  rsp.append("HEAD|", 5);
+  rsp.append(body);
+  rsp.append("|TAIL", 5);
+  ASSERT_EQ(rsp.block_count(), 3u);
+
+  EXPECT_EQ(rsp.cut_into_fd(sv_[0]), 14);
+  EXPECT_TRUE(rsp.empty());
+  EXPECT_EQ(read_n(sv_[1], 14), "HEAD|BODY|TAIL");
+  EXPECT_EQ(body.to_string(), "BODY");
+}
+
+// 测试10：超过IOV_MAX段的链与部分写由write_all处理
+TEST_F(IOBufTest, WriteAllHandlesIovMaxAndPartialWrites) {
+  static const char kPiece[] = "0123456789";
+  IOBuf buf;
+  std::string expect;
+  const int pieces = IOV_MAX + 100;
+  for (int i = 0; i < pieces; ++i) {
+    // 外部块不会合并，每段对应一个iovec
+    buf.append_user_data(kPiece, 10, nullptr, nullptr);
+    expect.append(kPiece, 10);
+  }
+  ASSERT_EQ(buf.block_count(), static_cast<size_t>(pieces));
+
+  // 缩小发送缓冲区制造部分写
+  int sndbuf = 4096;
+  ::setsockopt(sv_[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+
+  std::string got;
+  std::thread reader([&]() { got = read_n(sv_[1], expect.size()); });
+  EXPECT_EQ(buf.write_all(sv_[0]), 0);
+  reader.join();
+  EXPECT_TRUE(buf.empty());
+  EXPECT_EQ(got, expect);
+}
+
+// 测试11：readv直接读入尾块剩余空间与池化块
+TEST_F(IOBufTest, AppendFromFd) {
+  IOBuf buf;
+  buf.append("prefix:", 7);
+
+  std::string data(IOBuf::kBlockSize + 500, 'z');
+  ASSERT_EQ(::write(sv_[1], data.data(), data.size()),
+            static_cast<ssize_t>(data.size()));
+
+  size_t total = 0;
+  while (total < data.size()) {
+    ssize_t n = buf.append_from_fd(sv_[0]);
+    ASSERT_GT(n, 0);
+    total += static_cast<size_t>(n);
+  }
+  EXPECT_EQ(buf.to_string(), "prefix:" + data);
+
+  ::close(sv_[1]);
+  sv_[1] = -1;
+  EXPECT_EQ(buf.append_from_fd(sv_[0]), 0);
+}
+
+int main(int argc, char **argv) {
+  zcoroutine::init_logger(zlog::LogLevel::value::DEBUG);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
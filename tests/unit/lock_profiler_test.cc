@@ -0,0 +1,147 @@
+#include "sync/lock_profiler.h"
+#include "sync/mutex.h"
+#include "sync/rw_mutex.h"
+#include "sync/spinlock.h"
+#include "util/zcoroutine_logger.h"
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace zcoroutine;
+
+class LockProfilerTest : public ::testing::Test {
+protected:
+  void SetUp() override { LockProfiler::instance().reset(); }
+
+  void TearDown() override { LockProfiler::instance().reset(); }
+
+  static const LockStat *find(const std::vector<LockStat> &stats,
+                              const std::string &name) {
+    for (const auto &stat : stats) {
+      if (stat.name == name) {
+        return &stat;
+      }
+    }
+    return nullptr;
+  }
+};
+
+// 测试1：同名统计点合并，按等待时间排序，reset清零
+TEST_F(LockProfilerTest, SitesAggregateByName) {
+  auto &profiler = LockProfiler::instance();
+  LockSite *hot = profiler.site("test.hot");
+  EXPECT_EQ(profiler.site("test.hot"), hot);
+  LockSite *cold = profiler.site("test.cold");
+
+  hot->record_acquire();
+  hot->record_contended(10, 5000000);
+  hot->record_contended(30, 1000);
+  cold->record_acquire();
+  cold->record_contended(1, 100);
+
+  auto stats = profiler.top(0);
+  const LockStat *h = find(stats, "test.hot");
+  ASSERT_NE(h, nullptr);
+  EXPECT_EQ(h->acquisitions, 3u);
+  EXPECT_EQ(h->contended, 2u);
+  EXPECT_EQ(h->spins, 40u);
+  EXPECT_GT(h->wait_ns, 0u);
+  EXPECT_LE(h->max_wait_ns, h->wait_ns);
+  EXPECT_EQ(profiler.top(1).front().name, "test.hot");
+
+  std::string report = profiler.report(5);
+  EXPECT_NE(report.find("contended"), std::string::npos);
+  EXPECT_NE(report.find("test.cold"), std::string::npos);
+
+  profiler.reset();
+  EXPECT_EQ(find(profiler.top(0), "test.hot"), nullptr);
+}
+
+// 测试2：自旋锁竞争计入统计（需ENABLE_LOCK_PROFILE）
+TEST_F(LockProfilerTest, SpinlockContention) {
+  if (!LockProfiler::compiled_in()) {
+    GTEST_SKIP() << "built without ENABLE_LOCK_PROFILE";
+  }
+  Spinlock lock("test.spinlock");
+  const int kThreads = 4;
+  const int kIterations = 20000;
+  uint64_t counter = 0;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < kIterations; ++i) {
+        std::lock_guard<Spinlock> guard(lock);
+        ++counter;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(counter, static_cast<uint64_t>(kThreads * kIterations));
+
+  const LockStat *stat = find(LockProfiler::instance().top(0), "test.spinlock");
+  ASSERT_NE(stat, nullptr);
+  EXPECT_EQ(stat->acquisitions, static_cast<uint64_t>(kThreads * kIterations));
+  EXPECT_LE(stat->contended, stat->acquisitions);
+}
+
+// 测试3：读写锁和互斥锁被持有时，等待方计入竞争和等待时间
+TEST_F(LockProfilerTest, BlockingLockContention) {
+  if (!LockProfiler::compiled_in()) {
+    GTEST_SKIP() << "built without ENABLE_LOCK_PROFILE";
+  }
+  RWMutex rwmutex("test.rwmutex");
+  Mutex mutex("test.mutex");
+
+  rwmutex.wrlock();
+  mutex.lock();
+  std::thread waiter([&]() {
+    rwmutex.rdlock();
+    rwmutex.unlock();
+    std::lock_guard<Mutex> guard(mutex);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  rwmutex.unlock();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  mutex.unlock();
+  waiter.join();
+
+  auto stats = LockProfiler::instance().top(0);
+  const LockStat *rw = find(stats, "test.rwmutex");
+  const LockStat *mx = find(stats, "test.mutex");
+  ASSERT_NE(rw, nullptr);
+  ASSERT_NE(mx, nullptr);
+  EXPECT_EQ(rw->acquisitions, 2u);
+  EXPECT_EQ(rw->contended, 1u);
+  EXPECT_GE(rw->wait_ns, 10000000u);
+  EXPECT_EQ(mx->contended, 1u);
+  EXPECT_GE(mx->max_wait_ns, 10000000u);
+}
+
+// 测试4：频繁构造的锁使用ZCOROUTINE_LOCK_SITE，与按名称构造的锁共享统计点
+TEST_F(LockProfilerTest, PreResolvedSite) {
+  if (!LockProfiler::compiled_in()) {
+    GTEST_SKIP() << "built without ENABLE_LOCK_PROFILE";
+  }
+  for (int i = 0; i < 100; ++i) {
+    Spinlock lock{ZCOROUTINE_LOCK_SITE("test.per_call")};
+    std::lock_guard<Spinlock> guard(lock);
+  }
+  Spinlock named("test.per_call");
+  named.lock();
+  named.unlock();
+
+  const LockStat *stat = find(LockProfiler::instance().top(0), "test.per_call");
+  ASSERT_NE(stat, nullptr);
+  EXPECT_EQ(stat->acquisitions, 101u);
+}
+
+int main(int argc, char **argv) {
+  zcoroutine::init_logger(zlog::LogLevel::value::DEBUG);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,185 @@
+#include "scheduling/scheduler.h"
+#include "util/metrics.h"
+#include "util/metrics_exporter.h"
+#include "util/zcoroutine_logger.h"
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace zcoroutine;
+
+class MetricsTest : public ::testing::Test {
+protected:
+  static uint64_t counter(Counter c) {
+    return Metrics::instance().snapshot().counter(c);
+  }
+};
+
+// 测试1：桶的上界落在自身桶内，且小值精确
+TEST_F(MetricsTest, HistogramBucketBounds) {
+  for (uint64_t v = 0; v < 16; ++v) {
+    EXPECT_EQ(HdrHistogram::bucket_index(v), v);
+  }
+  for (size_t i = 0; i + 1 < HdrHistogram::kBucketCount; ++i) {
+    uint64_t upper = HdrHistogram::bucket_upper(i);
+    ASSERT_EQ(HdrHistogram::bucket_index(upper), i);
+    ASSERT_EQ(HdrHistogram::bucket_index(upper + 1), i + 1);
+  }
+  EXPECT_EQ(HdrHistogram::bucket_index(~0ULL), HdrHistogram::kBucketCount - 1);
+}
+
+// 测试2：百分位数误差在桶精度以内
+TEST_F(MetricsTest, HistogramPercentile) {
+  HdrHistogram histogram;
+  for (uint64_t v = 1; v <= 10000; ++v) {
+    histogram.record(v * 1000);
+  }
+  HistogramSnapshot snap;
+  snap.merge(histogram);
+  EXPECT_EQ(snap.count, 10000u);
+  EXPECT_EQ(snap.max, 10000000u);
+  EXPECT_NEAR(static_cast<double>(snap.percentile(50)), 5e6, 5e6 / 16);
+  EXPECT_NEAR(static_cast<double>(snap.percentile(99)), 9.9e6, 9.9e6 / 16);
+  EXPECT_EQ(snap.percentile(100), 10000000u);
+  // 边界所在的桶不计入，误差同样在桶精度以内
+  EXPECT_LE(snap.count_le(1000000), 1000u);
+  EXPECT_GE(snap.count_le(1000000), 1000u - 1000u / 16);
+}
+
+// 测试3：多线程计数汇总，退出线程的分片被复用
+TEST_F(MetricsTest, ShardedCounters) {
+  uint64_t before = counter(Counter::kHookEagain);
+  auto run_threads = []() {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([]() {
+        for (int i = 0; i < 10000; ++i) {
+          Metrics::inc(Counter::kHookEagain);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  };
+
+  run_threads();
+  EXPECT_EQ(counter(Counter::kHookEagain), before + 40000);
+
+  // 依次启动的线程复用已退出线程的分片
+  size_t shards = Metrics::instance().snapshot().shard_count;
+  for (int t = 0; t < 4; ++t) {
+    std::thread([]() { Metrics::inc(Counter::kHookEagain, 10000); }).join();
+  }
+  EXPECT_EQ(counter(Counter::kHookEagain), before + 80000);
+  EXPECT_EQ(Metrics::instance().snapshot().shard_count, shards);
+}
+
+// 测试4：调度器记录任务数、切换次数和调度延迟
+TEST_F(MetricsTest, SchedulerRecordsMetrics) {
+  MetricsSnapshot before = Metrics::instance().snapshot();
+
+  Scheduler scheduler(2, "MetricsTest");
+  scheduler.start();
+  std::atomic<int> done{0};
+  for (int i = 0; i < 100; ++i) {
+    scheduler.schedule([&done]() { done.fetch_add(1); });
+  }
+  for (int i = 0; i < 10; ++i) {
+    scheduler.schedule(std::make_shared<Fiber>([&done]() { done.fetch_add(1); }));
+  }
+  scheduler.stop();
+  ASSERT_EQ(done.load(), 110);
+
+  MetricsSnapshot after = Metrics::instance().snapshot();
+  EXPECT_GE(after.counter(Counter::kTasksRun) -
+                before.counter(Counter::kTasksRun),
+            110u);
+  EXPECT_GE(after.counter(Counter::kFiberSwitches) -
+                before.counter(Counter::kFiberSwitches),
+            10u);
+  EXPECT_GE(after.histogram(Histogram::kScheduleLatency).count -
+                before.histogram(Histogram::kScheduleLatency).count,
+            110u);
+  EXPECT_GE(after.histogram(Histogram::kRunDuration).count -
+                before.histogram(Histogram::kRunDuration).count,
+            110u);
+}
+
+// 测试5：Prometheus文本格式
+TEST_F(MetricsTest, PrometheusFormat) {
+  Metrics::inc(Counter::kTimersFired, 3);
+  Metrics::observe(Histogram::kRunDuration, 1500);
+
+  std::string text =
+      MetricsExporter::to_prometheus(Metrics::instance().snapshot());
+  EXPECT_NE(text.find("# TYPE zcoroutine_tasks_run_total counter"),
+            std::string::npos);
+  EXPECT_NE(text.find("zcoroutine_timers_fired_total "), std::string::npos);
+  EXPECT_NE(text.find("# TYPE zcoroutine_run_duration_seconds histogram"),
+            std::string::npos);
+  EXPECT_NE(text.find("zcoroutine_run_duration_seconds_bucket{le=\"2e-06\"}"),
+            std::string::npos);
+  EXPECT_NE(text.find("zcoroutine_run_duration_seconds_bucket{le=\"+Inf\"}"),
+            std::string::npos);
+  EXPECT_NE(text.find("zcoroutine_schedule_latency_seconds_count "),
+            std::string::npos);
+}
+
+// 测试6：导出到文件
+TEST_F(MetricsTest, WriteFile) {
+  std::string path = "/tmp/zcoroutine_metrics_test.prom";
+  ASSERT_TRUE(MetricsExporter::write_file(path));
+  std::ifstream file(path);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  EXPECT_NE(ss.str().find("zcoroutine_epoll_waits_total"), std::string::npos);
+  unlink(path.c_str());
+
+  EXPECT_FALSE(MetricsExporter::write_file("/nonexistent_dir/metrics.prom"));
+}
+
+// 测试7：通过Unix域套接字提供指标
+TEST_F(MetricsTest, ServeUnixSocket) {
+  std::string path = "/tmp/zcoroutine_metrics_test.sock";
+  MetricsExporter exporter;
+  ASSERT_EQ(exporter.serve(path), 0);
+  EXPECT_TRUE(exporter.is_serving());
+  EXPECT_EQ(exporter.serve(path), -1);
+
+  for (int round = 0; round < 2; ++round) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    struct sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    ASSERT_EQ(connect(fd, reinterpret_cast<struct sockaddr *>(&addr),
+                      sizeof(addr)),
+              0);
+    std::string text;
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+      text.append(buf, static_cast<size_t>(n));
+    }
+    close(fd);
+    EXPECT_NE(text.find("zcoroutine_metric_shards"), std::string::npos);
+  }
+
+  exporter.stop();
+  EXPECT_FALSE(exporter.is_serving());
+  EXPECT_NE(access(path.c_str(), F_OK), 0);
+}
+
+int main(int argc, char **argv) {
+  zcoroutine::init_logger(zlog::LogLevel::value::DEBUG);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,129 @@
+#include "runtime/fiber.h"
+#include "runtime/sampling_profiler.h"
+#include "scheduling/scheduler.h"
+#include "util/zcoroutine_logger.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace zcoroutine;
+
+class SamplingProfilerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    SamplingProfiler::instance().stop();
+    SamplingProfiler::instance().clear();
+  }
+
+  void TearDown() override { SamplingProfiler::instance().stop(); }
+
+  // 消耗CPU时间（ITIMER_PROF按CPU时间计时）
+  static void burn_cpu_ms(int ms) {
+    volatile uint64_t sink = 0;
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+      for (int i = 0; i < 1000; ++i) {
+        sink = sink + static_cast<uint64_t>(i);
+      }
+    }
+  }
+
+  static uint64_t samples_with_prefix(const std::string &folded,
+                                      const std::string &prefix) {
+    uint64_t total = 0;
+    std::istringstream in(folded);
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.compare(0, prefix.size(), prefix) == 0) {
+        total += std::stoull(line.substr(line.rfind(' ') + 1));
+      }
+    }
+    return total;
+  }
+};
+
+// 测试1：参数校验与重复启动
+TEST_F(SamplingProfilerTest, StartStop) {
+  auto &profiler = SamplingProfiler::instance();
+  EXPECT_FALSE(profiler.start(0));
+  EXPECT_FALSE(profiler.start(100, 0));
+  ASSERT_TRUE(profiler.start(100));
+  EXPECT_TRUE(profiler.is_running());
+  EXPECT_FALSE(profiler.start(100));
+  profiler.stop();
+  EXPECT_FALSE(profiler.is_running());
+}
+
+// 测试2：样本归属到协程名称，并回溯到协程入口
+TEST_F(SamplingProfilerTest, AttributesSamplesToFiber) {
+  auto &profiler = SamplingProfiler::instance();
+  ASSERT_TRUE(profiler.start(1000));
+  auto fiber = std::make_shared<Fiber>([]() { burn_cpu_ms(300); },
+                                       StackAllocator::kDefaultStackSize,
+                                       "hot_loop");
+  fiber->resume();
+  profiler.stop();
+
+  EXPECT_GT(profiler.sample_count(), 10u);
+  std::string folded = profiler.folded();
+  EXPECT_GT(samples_with_prefix(folded, "fiber:hot_loop;"),
+            profiler.sample_count() / 2);
+  EXPECT_NE(folded.find(";zcoroutine::Fiber::main_func();"),
+            std::string::npos);
+}
+
+// 测试3：调度器多线程下按协程名称分组
+TEST_F(SamplingProfilerTest, SchedulerFibersGroupedByName) {
+  auto &profiler = SamplingProfiler::instance();
+  ASSERT_TRUE(profiler.start(1000));
+
+  Scheduler scheduler(2, "SamplerTest");
+  scheduler.start();
+  for (int i = 0; i < 4; ++i) {
+    scheduler.schedule(std::make_shared<Fiber>(
+        []() { burn_cpu_ms(60); }, StackAllocator::kDefaultStackSize,
+        i % 2 ? "odd" : "even"));
+  }
+  scheduler.stop();
+  profiler.stop();
+
+  std::string folded = profiler.folded();
+  EXPECT_GT(samples_with_prefix(folded, "fiber:odd;"), 0u);
+  EXPECT_GT(samples_with_prefix(folded, "fiber:even;"), 0u);
+}
+
+// 测试4：缓冲区写满后丢弃，clear后重新计数
+TEST_F(SamplingProfilerTest, BufferFullDropsAndClear) {
+  auto &profiler = SamplingProfiler::instance();
+  // 新线程使用新容量的缓冲区
+  std::thread worker([&profiler]() {
+    ASSERT_TRUE(profiler.start(1000, 4));
+    burn_cpu_ms(100);
+    profiler.stop();
+  });
+  worker.join();
+  EXPECT_GT(profiler.dropped_count(), 0u);
+
+  std::string path = "/tmp/zcoroutine_sampling_test.folded";
+  ASSERT_TRUE(profiler.dump_folded(path));
+  std::ifstream file(path);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  EXPECT_EQ(ss.str(), profiler.folded());
+  std::remove(path.c_str());
+
+  profiler.clear();
+  EXPECT_EQ(profiler.sample_count(), 0u);
+  EXPECT_EQ(profiler.dropped_count(), 0u);
+  EXPECT_TRUE(profiler.folded().empty());
+}
+
+int main(int argc, char **argv) {
+  zcoroutine::init_logger(zlog::LogLevel::value::DEBUG);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
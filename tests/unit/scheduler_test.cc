@@ -144,6 +144,24 @@ TEST_F(SchedulerTest, ScheduleWithBind) {
   EXPECT_EQ(result.load(), 30);
 }
 
+// 测试：工作线程启动回调在每个线程进入调度循环前执行一次
+TEST_F(SchedulerTest, ThreadInitCallback) {
+  Scheduler scheduler(3);
+  std::atomic<int> mask{0};
+  std::atomic<bool> id_ok{true};
+  scheduler.set_thread_init_callback([&](int worker_id) {
+    mask.fetch_or(1 << worker_id);
+    if (Scheduler::get_worker_id() != worker_id) {
+      id_ok = false;
+    }
+  });
+  scheduler.start();
+  scheduler.stop();
+
+  EXPECT_EQ(mask.load(), 0x7);
+  EXPECT_TRUE(id_ok.load());
+}
+
 int main(int argc, char **argv) {
   // 初始化日志系统
   zcoroutine::init_logger(zlog::LogLevel::value::DEBUG);
@@ -929,6 +929,31 @@ TEST_F(SharedStackTest, SharedContextReset) {
   EXPECT_EQ(ctx.saved_stack_sp(), nullptr);
 }
 
+TEST_F(SharedStackTest, SharedContextCompact) {
+  SharedContext ctx;
+  size_t stack_size = 64 * 1024;
+  SharedStackBuffer buffer(stack_size);
+  ctx.init_shared(&buffer);
+
+  // 深调用留下的大保存缓冲区
+  ctx.save_stack_buffer(buffer.stack_top() - 32 * 1024);
+  size_t deep_capacity = ctx.save_buffer_capacity();
+  EXPECT_GE(deep_capacity, 32u * 1024);
+
+  // 未请求收缩时复用大缓冲区
+  ctx.save_stack_buffer(buffer.stack_top() - 256);
+  EXPECT_EQ(ctx.save_buffer_capacity(), deep_capacity);
+
+  // 请求收缩后按实际大小重新分配，且只生效一次
+  ctx.request_compact();
+  ctx.save_stack_buffer(buffer.stack_top() - 256);
+  EXPECT_EQ(ctx.save_buffer_capacity(), 256u);
+  EXPECT_EQ(ctx.save_size(), 256u);
+
+  ctx.save_stack_buffer(buffer.stack_top() - 1024);
+  EXPECT_EQ(ctx.save_buffer_capacity(), 1280u);
+}
+
 TEST_F(SharedStackTest, SwitchStackAllocation) {
   // 覆盖 SwitchStack 构造函数
   SwitchStack ss(4096);
@@ -0,0 +1,333 @@
+/**
+ * @file socket_stream_test.cc
+ * @brief RingBuffer 与 SocketStream 单元测试
+ * 测试环形缓冲区分段/扩容/整理，以及流的自动cork、零拷贝peek与读写
+ */
+
+#include "hook/hook.h"
+#include "io/io_scheduler.h"
+#include "io/status_table.h"
+#include "net/buffer_pool.h"
+#include "net/ring_buffer.h"
+#include "net/socket_stream.h"
+#include "util/zcoroutine_logger.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace zcoroutine;
+
+class SocketStreamTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, sv_), 0);
+  }
+
+  void TearDown() override {
+    if (sv_[1] >= 0) {
+      ::close(sv_[1]);
+    }
+    // sv_[0] 由 SocketStream 关闭
+  }
+
+  // 从对端读取恰好len字节
+  std::string peer_read(size_t len) {
+    std::string out(len, '\0');
+    size_t got = 0;
+    while (got < len) {
+      ssize_t n = ::read(sv_[1], &out[got], len - got);
+      if (n <= 0) {
+        break;
+      }
+      got += static_cast<size_t>(n);
+    }
+    out.resize(got);
+    return out;
+  }
+
+  int sv_[2]{-1, -1};
+};
+
+// ==================== RingBuffer 测试 ====================
+
+// 测试1：追加与读取
+TEST(RingBufferTest, AppendAndRead) {
+  RingBuffer buf(16);
+  EXPECT_EQ(buf.capacity(), 16u);
+  buf.append("hello", 5);
+  EXPECT_EQ(buf.size(), 5u);
+
+  char out[8] = {0};
+  EXPECT_EQ(buf.read(out, sizeof(out)), 5u);
+  EXPECT_STREQ(out, "hello");
+  EXPECT_TRUE(buf.empty());
+}
+
+// 测试2：跨越环尾时可读区域为两段，linearize后连续
+TEST(RingBufferTest, WrapAroundSegmentsAndLinearize) {
+  RingBuffer buf(16);
+  buf.append("0123456789AB", 12);
+  buf.consume(10); // 剩余 "AB"，读位置在10
+  buf.append("CDEFGHIJ", 8);
+
+  struct iovec iov[2];
+  ASSERT_EQ(buf.readable_segments(iov), 2);
+  EXPECT_EQ(iov[0].iov_len, 6u);
+  EXPECT_EQ(iov[1].iov_len, 4u);
+
+  size_t len = 0;
+  buf.peek(&len);
+  EXPECT_EQ(len, 6u);
+
+  const char *data = buf.linearize(10);
+  ASSERT_NE(data, nullptr);
+  EXPECT_EQ(std::string(data, 10), "ABCDEFGHIJ");
+  EXPECT_EQ(buf.capacity(), 16u);
+  EXPECT_EQ(buf.linearize(11), nullptr);
+}
+
+// 测试3：扩容保留数据顺序
+TEST(RingBufferTest, GrowPreservesData) {
+  RingBuffer buf(8);
+  buf.append("abcdef", 6);
+  buf.consume(4);
+  buf.append("ghijklmnop", 10);
+  EXPECT_GE(buf.capacity(), 12u);
+
+  std::string out(buf.size(), '\0');
+  buf.read(&out[0], out.size());
+  EXPECT_EQ(out, "efghijklmnop");
+}
+
+// 测试4：通过writable_segments写入后commit
+TEST(RingBufferTest, WritableSegmentsCommit) {
+  RingBuffer buf(8);
+  buf.append("xxxxxx", 6);
+  buf.consume(6); // 读空后位置回到起点
+
+  struct iovec iov[2];
+  ASSERT_EQ(buf.writable_segments(iov), 1);
+  EXPECT_EQ(iov[0].iov_len, 8u);
+  memcpy(iov[0].iov_base, "abc", 3);
+  buf.commit(3);
+  EXPECT_EQ(buf.size(), 3u);
+
+  buf.clear();
+  buf.release();
+  EXPECT_EQ(buf.capacity(), 0u);
+}
+
+// ==================== SocketStream 测试 ====================
+
+// 测试5：小块写入被聚合，flush时一次writev发出
+TEST_F(SocketStreamTest, SmallWritesAreCorked) {
+  SocketStream stream(sv_[0]);
+  EXPECT_EQ(stream.write("GET ", 4), 4);
+  EXPECT_EQ(stream.write("/a ", 3), 3);
+  struct iovec iov[2] = {{const_cast<char *>("HTTP"), 4},
+                         {const_cast<char *>("/1.1"), 4}};
+  EXPECT_EQ(stream.writev(iov, 2), 8);
+
+  EXPECT_EQ(stream.write_syscalls(), 0u);
+  EXPECT_EQ(stream.pending_write(), 15u);
+
+  EXPECT_EQ(stream.flush(), 0);
+  EXPECT_EQ(stream.write_syscalls(), 1u);
+  EXPECT_EQ(stream.pending_write(), 0u);
+  EXPECT_EQ(peer_read(15), "GET /a HTTP/1.1");
+}
+
+// 测试6：达到阈值时立即发送，缓冲数据与大块数据合并为一次writev
+TEST_F(SocketStreamTest, ThresholdTriggersWritev) {
+  SocketStream::Options options;
+  options.cork_threshold = 64;
+  SocketStream stream(sv_[0], options);
+
+  stream.write("head:", 5);
+  std::string big(100, 'x');
+  EXPECT_EQ(stream.write(big.data(), big.size()), 100);
+  EXPECT_EQ(stream.write_syscalls(), 1u);
+  EXPECT_EQ(stream.pending_write(), 0u);
+  EXPECT_EQ(peer_read(105), "head:" + big);
+}
+
+// 测试7：读方向即将阻塞时先flush写缓冲区（请求-响应不会死锁）
+TEST_F(SocketStreamTest, FillFlushesBeforeBlocking) {
+  SocketStream stream(sv_[0]);
+  stream.write("ping", 4);
+
+  std::thread peer([this]() {
+    std::string req = peer_read(4);
+    if (req == "ping") {
+      ::write(sv_[1], "pong", 4);
+    }
+  });
+
+  char buf[4];
+  ASSERT_TRUE(stream.read_exact(buf, 4));
+  EXPECT_EQ(std::string(buf, 4), "pong");
+  EXPECT_EQ(stream.write_syscalls(), 1u);
+  peer.join();
+}
+
+// 测试8：peek_exact/consume 零拷贝解析
+TEST_F(SocketStreamTest, PeekExactAndConsume) {
+  SocketStream stream(sv_[0]);
+  ASSERT_EQ(::write(sv_[1], "LEN5:hello", 10), 10);
+
+  const char *head = stream.peek_exact(5);
+  ASSERT_NE(head, nullptr);
+  EXPECT_EQ(std::string(head, 5), "LEN5:");
+  stream.consume(5);
+
+  size_t len = 0;
+  const char *body = stream.peek(&len);
+  ASSERT_GE(len, 5u);
+  EXPECT_EQ(std::string(body, 5), "hello");
+  stream.consume(5);
+  EXPECT_EQ(stream.readable(), 0u);
+}
+
+// 测试9：对端关闭时read_exact返回false
+TEST_F(SocketStreamTest, ReadExactEof) {
+  SocketStream stream(sv_[0]);
+  ASSERT_EQ(::write(sv_[1], "ab", 2), 2);
+  ::close(sv_[1]);
+  sv_[1] = -1;
+
+  char buf[4];
+  EXPECT_FALSE(stream.read_exact(buf, 4));
+}
+
+// 测试10：读缓冲区达到上限时返回ENOBUFS
+TEST_F(SocketStreamTest, ReadBufferLimit) {
+  SocketStream::Options options;
+  options.read_buffer_size = 16;
+  options.max_read_buffer_size = 16;
+  SocketStream stream(sv_[0], options);
+
+  std::string data(32, 'y');
+  ASSERT_EQ(::write(sv_[1], data.data(), data.size()), 32);
+  EXPECT_EQ(stream.peek_exact(32), nullptr);
+  EXPECT_EQ(errno, ENOBUFS);
+  EXPECT_EQ(stream.readable(), 16u);
+}
+
+// 测试11：hook托管的socket在数据已到达时试读，不打断cork
+TEST(SocketStreamHookTest, PipelinedReadKeepsCork) {
+  set_hook_enable(true);
+  int sv[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+  set_hook_enable(false);
+
+  ASSERT_EQ(::write(sv[1], "req1", 4), 4);
+  {
+    SocketStream stream(sv[0]);
+    char buf[4];
+    ASSERT_TRUE(stream.read_exact(buf, 4));
+    stream.write("rsp1", 4);
+    // 下一个流水线请求在响应发出前到达，试读成功，无需flush
+    ASSERT_EQ(::write(sv[1], "req2", 4), 4);
+    ASSERT_TRUE(stream.read_exact(buf, 4));
+    EXPECT_EQ(std::string(buf, 4), "req2");
+    stream.write("rsp2", 4);
+    // 两个响应仍在写缓冲区中
+    EXPECT_EQ(stream.write_syscalls(), 0u);
+    EXPECT_EQ(stream.pending_write(), 8u);
+    EXPECT_EQ(stream.flush(), 0);
+    EXPECT_EQ(stream.write_syscalls(), 1u);
+  }
+
+  char out[8];
+  ASSERT_EQ(::read(sv[1], out, 8), 8);
+  EXPECT_EQ(std::string(out, 8), "rsp1rsp2");
+  ::close(sv[1]);
+  StatusTable::GetInstance()->del(sv[0]);
+  StatusTable::GetInstance()->del(sv[1]);
+}
+
+// 测试12：释放的缓冲区回到BufferPool并被复用
+TEST(BufferPoolTest, ReleasedBuffersAreReused) {
+  size_t before = BufferPool::cached_bytes();
+  {
+    RingBuffer buf(8192);
+    buf.append("x", 1);
+  }
+  EXPECT_EQ(BufferPool::cached_bytes(), before + 8192);
+
+  RingBuffer reused(8192);
+  EXPECT_EQ(BufferPool::cached_bytes(), before);
+
+  // 超出分级范围的缓冲区不缓存
+  {
+    RingBuffer big(BufferPool::kMaxPooledSize * 2);
+  }
+  EXPECT_EQ(BufferPool::cached_bytes(), before);
+}
+
+// 测试13：空闲挂起时归还缓冲区，数据到达后重新获取
+TEST(SocketStreamHookTest, IdleParkReleasesBuffers) {
+  auto scheduler = std::make_shared<IoScheduler>(1, "IdlePark");
+  scheduler->start();
+
+  set_hook_enable(true);
+  int sv[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+  set_hook_enable(false);
+
+  std::atomic<int> stage{0};
+  std::atomic<uint64_t> parks{0};
+  std::string got;
+  SocketStream *stream_ptr = nullptr;
+
+  scheduler->schedule(std::make_shared<Fiber>([&]() {
+    set_hook_enable(true);
+    SocketStream::Options options;
+    options.idle_park = true;
+    SocketStream stream(sv[0], options);
+    stream_ptr = &stream;
+    stage = 1;
+
+    char buf[5];
+    if (stream.read_exact(buf, 5)) {
+      got.assign(buf, 5);
+    }
+    parks = stream.idle_parks();
+    stream_ptr = nullptr;
+    stage = 2;
+  }));
+
+  // 等待协程进入空闲挂起
+  for (int i = 0; i < 200 && stage.load() < 1; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_EQ(stage.load(), 1);
+  EXPECT_EQ(stream_ptr->buffer_bytes(), 0u);
+  EXPECT_EQ(stream_ptr->idle_parks(), 1u);
+
+  ASSERT_EQ(::write(sv[1], "hello", 5), 5);
+  for (int i = 0; i < 200 && stage.load() < 2; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(stage.load(), 2);
+  EXPECT_EQ(got, "hello");
+  EXPECT_EQ(parks.load(), 1u);
+
+  scheduler->stop();
+  ::close(sv[1]);
+  StatusTable::GetInstance()->del(sv[0]);
+  StatusTable::GetInstance()->del(sv[1]);
+}
+
+int main(int argc, char **argv) {
+  zcoroutine::init_logger(zlog::LogLevel::value::DEBUG);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
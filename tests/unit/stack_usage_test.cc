@@ -0,0 +1,164 @@
+#include "runtime/fiber.h"
+#include "runtime/fiber_pool.h"
+#include "runtime/stack_usage.h"
+#include "util/zcoroutine_logger.h"
+#include <alloca.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace zcoroutine;
+
+class StackUsageTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    StackUsage::instance().reset();
+    StackUsage::set_enabled(true);
+    FiberPool::get_instance().clear();
+  }
+
+  void TearDown() override {
+    FiberPool::get_instance().set_adaptive_stack(false);
+    FiberPool::get_instance().clear();
+    StackUsage::set_enabled(false);
+    StackUsage::instance().reset();
+  }
+
+  // 在栈上占用约bytes字节
+  static void __attribute__((noinline)) use_stack(size_t bytes) {
+    volatile char *buffer = static_cast<char *>(alloca(bytes));
+    for (size_t i = 0; i < bytes; i += 64) {
+      buffer[i] = 1;
+    }
+    buffer[0] = 1;
+  }
+
+  static const StackUsageStat *find(const std::vector<StackUsageStat> &stats,
+                                    const std::string &name) {
+    for (const auto &stat : stats) {
+      if (stat.name == name) {
+        return &stat;
+      }
+    }
+    return nullptr;
+  }
+};
+
+// 测试1：填充后从栈顶写入，高水位等于写入深度
+TEST_F(StackUsageTest, PaintAndHighWaterMark) {
+  std::vector<uint64_t> stack(1024);
+  size_t size = stack.size() * sizeof(uint64_t);
+  StackUsage::paint(stack.data(), size);
+  EXPECT_EQ(StackUsage::high_water_mark(stack.data(), size), 0u);
+
+  stack[stack.size() - 10] = 0;
+  EXPECT_EQ(StackUsage::high_water_mark(stack.data(), size), 80u);
+
+  stack[0] = 0;
+  EXPECT_EQ(StackUsage::high_water_mark(stack.data(), size), size);
+}
+
+// 测试2：协程结束时按名称记录栈使用量，关闭时不填充
+TEST_F(StackUsageTest, RecordsUsageOnTermination) {
+  auto deep = std::make_shared<Fiber>([]() { use_stack(20 * 1024); },
+                                      StackAllocator::kDefaultStackSize,
+                                      "deep");
+  deep->resume();
+
+  StackUsage::set_enabled(false);
+  auto unpainted = std::make_shared<Fiber>([]() {},
+                                           StackAllocator::kDefaultStackSize,
+                                           "unpainted");
+  unpainted->resume();
+
+  auto stats = StackUsage::instance().stats();
+  const StackUsageStat *stat = find(stats, "deep");
+  ASSERT_NE(stat, nullptr);
+  EXPECT_EQ(stat->fibers, 1u);
+  EXPECT_GE(stat->max_used, 20u * 1024);
+  EXPECT_LT(stat->max_used, StackAllocator::kDefaultStackSize);
+  EXPECT_EQ(stat->stack_size, StackAllocator::kDefaultStackSize);
+  EXPECT_EQ(find(stats, "unpainted"), nullptr);
+  EXPECT_NE(StackUsage::instance().report().find("deep"), std::string::npos);
+}
+
+// 测试3：复用前重新填充，新用途的测量不受上次影响
+TEST_F(StackUsageTest, RepaintOnReuse) {
+  auto &pool = FiberPool::get_instance();
+  auto fiber = pool.get_fiber([]() { use_stack(24 * 1024); },
+                              StackAllocator::kDefaultStackSize, "deep");
+  fiber->resume();
+  ASSERT_TRUE(pool.return_fiber(fiber));
+
+  auto reused = pool.get_fiber([]() {}, StackAllocator::kDefaultStackSize,
+                               "shallow");
+  EXPECT_EQ(reused.get(), fiber.get());
+  reused->resume();
+
+  auto stats = StackUsage::instance().stats();
+  const StackUsageStat *shallow = find(stats, "shallow");
+  ASSERT_NE(shallow, nullptr);
+  EXPECT_LT(shallow->max_used, 16u * 1024);
+}
+
+// 测试4：样本足够后给出建议值，覆盖最大使用量和余量
+TEST_F(StackUsageTest, SuggestStackSize) {
+  auto &usage = StackUsage::instance();
+  const size_t fallback = StackAllocator::kDefaultStackSize;
+  for (uint64_t i = 0; i + 1 < StackUsage::kMinSamples; ++i) {
+    usage.record("handler", 4000 + i * 10, fallback);
+  }
+  EXPECT_EQ(usage.suggest_stack_size("handler", fallback), fallback);
+  EXPECT_EQ(usage.suggest_stack_size("unknown", fallback), fallback);
+
+  usage.record("handler", 9000, fallback);
+  size_t suggested = usage.suggest_stack_size("handler", fallback);
+  EXPECT_GE(suggested, 9000u + StackUsage::kSafetyMargin);
+  EXPECT_GE(suggested, StackUsage::kMinStackSize);
+  EXPECT_EQ(suggested % 4096, 0u);
+  EXPECT_LE(suggested * 4, fallback);
+
+  // 建议值不超过调用方给出的上限
+  for (uint64_t i = 0; i < StackUsage::kMinSamples; ++i) {
+    usage.record("huge", 120 * 1024, fallback);
+  }
+  EXPECT_EQ(usage.suggest_stack_size("huge", fallback), fallback);
+}
+
+// 测试5：自适应模式下按观测用量分配较小的栈，复用时不选过小的栈
+TEST_F(StackUsageTest, AdaptivePoolStackSize) {
+  auto &pool = FiberPool::get_instance();
+  pool.set_adaptive_stack(true);
+  EXPECT_TRUE(StackUsage::enabled());
+
+  for (uint64_t i = 0; i < StackUsage::kMinSamples; ++i) {
+    auto fiber = pool.get_fiber([]() { use_stack(4 * 1024); },
+                                StackAllocator::kDefaultStackSize, "small");
+    fiber->resume();
+  }
+  pool.clear();
+
+  auto small = pool.get_fiber([]() { use_stack(4 * 1024); },
+                              StackAllocator::kDefaultStackSize, "small");
+  EXPECT_LT(small->stack_size(), StackAllocator::kDefaultStackSize / 4);
+  EXPECT_GE(small->stack_size(), StackUsage::kMinStackSize);
+  small->resume();
+  ASSERT_TRUE(pool.return_fiber(small));
+
+  // 未统计过的名称仍使用默认大小，且不会复用更小的栈
+  auto other = pool.get_fiber([]() {}, StackAllocator::kDefaultStackSize,
+                              "other");
+  EXPECT_NE(other.get(), small.get());
+  EXPECT_EQ(other->stack_size(), StackAllocator::kDefaultStackSize);
+
+  // 关闭后恢复默认大小
+  pool.set_adaptive_stack(false);
+  auto plain = pool.get_fiber([]() {}, StackAllocator::kDefaultStackSize,
+                              "small");
+  EXPECT_EQ(plain->stack_size(), StackAllocator::kDefaultStackSize);
+}
+
+int main(int argc, char **argv) {
+  zcoroutine::init_logger(zlog::LogLevel::value::DEBUG);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
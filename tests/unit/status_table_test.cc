@@ -9,7 +9,9 @@
 #include "util/zcoroutine_logger.h"
 #include <gtest/gtest.h>
 
+#include <arpa/inet.h>
 #include <fcntl.h>
+#include <netinet/in.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -440,6 +442,112 @@ TEST_F(StatusTableTest, IoctlWorkWithSocketFdContext) {
   ::close(sockfd);
 }
 
+// ==================== 新建fd元数据测试 ====================
+
+// 测试26：add_socket 直接写入已知属性
+TEST_F(StatusTableTest, AddSocketWithKnownMetadata) {
+  // 使用一个非socket的fd，证明 add_socket 不会通过fstat探测类型
+  int pipefd[2];
+  ASSERT_EQ(pipe(pipefd), 0);
+
+  auto ctx = status_table_->add_socket(pipefd[0], true);
+  ASSERT_NE(ctx, nullptr);
+  EXPECT_TRUE(ctx->is_init());
+  EXPECT_TRUE(ctx->is_socket());
+  EXPECT_TRUE(ctx->get_sys_nonblock());
+  EXPECT_TRUE(ctx->get_user_nonblock());
+  EXPECT_EQ(status_table_->get(pipefd[0]), ctx);
+
+  // 覆盖已存在的上下文
+  auto ctx2 = status_table_->add_socket(pipefd[0], false);
+  EXPECT_NE(ctx2, ctx);
+  EXPECT_FALSE(ctx2->get_user_nonblock());
+
+  status_table_->del(pipefd[0]);
+  ::close(pipefd[0]);
+  ::close(pipefd[1]);
+}
+
+// 测试27：hook的socket在内核层面创建即为非阻塞且带CLOEXEC
+TEST_F(StatusTableTest, HookedSocketCreatedNonblockCloexec) {
+  int sockfd = ::socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_GT(sockfd, 0);
+
+  EXPECT_TRUE(fcntl_f(sockfd, F_GETFL) & O_NONBLOCK);
+  EXPECT_TRUE(fcntl_f(sockfd, F_GETFD) & FD_CLOEXEC);
+
+  auto ctx = status_table_->get(sockfd);
+  ASSERT_NE(ctx, nullptr);
+  EXPECT_FALSE(ctx->get_user_nonblock());
+  // 用户视角仍是阻塞的
+  EXPECT_FALSE(::fcntl(sockfd, F_GETFL) & O_NONBLOCK);
+
+  ::close(sockfd);
+}
+
+// 测试28：用户传入SOCK_NONBLOCK时记录为用户非阻塞
+TEST_F(StatusTableTest, HookedSocketUserNonblockFlag) {
+  int sockfd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  ASSERT_GT(sockfd, 0);
+
+  auto ctx = status_table_->get(sockfd);
+  ASSERT_NE(ctx, nullptr);
+  EXPECT_TRUE(ctx->get_user_nonblock());
+  EXPECT_TRUE(::fcntl(sockfd, F_GETFL) & O_NONBLOCK);
+
+  int sv[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+  for (int fd : sv) {
+    auto pair_ctx = status_table_->get(fd);
+    ASSERT_NE(pair_ctx, nullptr);
+    EXPECT_TRUE(pair_ctx->get_sys_nonblock());
+    EXPECT_FALSE(pair_ctx->get_user_nonblock());
+    EXPECT_TRUE(fcntl_f(fd, F_GETFL) & O_NONBLOCK);
+    ::close(fd);
+  }
+
+  ::close(sockfd);
+}
+
+// 测试29：accept4 hook 注册新连接并保留用户标志
+TEST_F(StatusTableTest, HookedAccept4RegistersFd) {
+  int listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_GT(listen_fd, 0);
+
+  struct sockaddr_in addr {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  ASSERT_EQ(::bind(listen_fd, reinterpret_cast<sockaddr *>(&addr),
+                   sizeof(addr)),
+            0);
+  ASSERT_EQ(::listen(listen_fd, 4), 0);
+  socklen_t len = sizeof(addr);
+  ::getsockname(listen_fd, reinterpret_cast<sockaddr *>(&addr), &len);
+
+  // 客户端使用原始阻塞connect，保证连接已完成
+  set_hook_enable(false);
+  int client_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_EQ(::connect(client_fd, reinterpret_cast<sockaddr *>(&addr),
+                      sizeof(addr)),
+            0);
+  set_hook_enable(true);
+
+  int conn_fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK);
+  ASSERT_GT(conn_fd, 0);
+
+  auto ctx = status_table_->get(conn_fd);
+  ASSERT_NE(ctx, nullptr);
+  EXPECT_TRUE(ctx->is_socket());
+  EXPECT_TRUE(ctx->get_sys_nonblock());
+  EXPECT_TRUE(ctx->get_user_nonblock());
+  EXPECT_TRUE(fcntl_f(conn_fd, F_GETFD) & FD_CLOEXEC);
+
+  ::close(conn_fd);
+  ::close(client_fd);
+  ::close(listen_fd);
+}
+
 int main(int argc, char **argv) {
   // 初始化日志系统
   zcoroutine::init_logger(zlog::LogLevel::value::DEBUG);
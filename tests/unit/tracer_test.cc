@@ -0,0 +1,147 @@
+#include "runtime/fiber.h"
+#include "util/tracer.h"
+#include "util/zcoroutine_logger.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+using namespace zcoroutine;
+
+class TracerTest : public ::testing::Test {
+protected:
+  void SetUp() override { Tracer::instance().set_enabled(true); }
+
+  static size_t count(const std::string &text, const std::string &pattern) {
+    size_t n = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos;
+         pos = text.find(pattern, pos + 1)) {
+      ++n;
+    }
+    return n;
+  }
+};
+
+// 测试1：环形缓冲区写满后覆盖最旧记录
+TEST_F(TracerTest, RingBufferOverwrite) {
+  TraceBuffer buffer(8, "ring");
+  for (uint64_t i = 0; i < 20; ++i) {
+    buffer.append(TraceEvent::kTaskEnqueue, i, 0, i);
+  }
+  // 下一次写入的槽位存放最旧的记录，可能正被覆盖，不计入快照
+  auto records = buffer.snapshot();
+  ASSERT_EQ(records.size(), 7u);
+  EXPECT_EQ(records.front().tsc, 13u);
+  EXPECT_EQ(records.back().tsc, 19u);
+  EXPECT_EQ(buffer.written(), 20u);
+}
+
+// 测试2：resume/yield配对成一个时间片
+TEST_F(TracerTest, ResumeYieldBecomesSlice) {
+  Tracer::record(TraceEvent::kFiberResume, 424242);
+  Tracer::record(TraceEvent::kFiberYield, 424242);
+
+  std::string json = Tracer::instance().dump_to_string();
+  EXPECT_EQ(json.find("{\"displayTimeUnit\""), 0u);
+  EXPECT_NE(json.find("\"name\":\"fiber 424242\",\"cat\":\"fiber\",\"ph\":\"X\""),
+            std::string::npos);
+  EXPECT_NE(json.find("\"end\":\"yield\""), std::string::npos);
+}
+
+// 测试3：入队/出队生成flow事件，其余事件为瞬时事件
+TEST_F(TracerTest, FlowAndInstantEvents) {
+  Tracer::record(TraceEvent::kTaskEnqueue, 515151);
+  Tracer::record(TraceEvent::kTaskDequeue, 515151);
+  Tracer::record(TraceEvent::kIoWait, 515151, 37);
+  Tracer::record(TraceEvent::kTimerFire, 0, 3);
+
+  std::string json = Tracer::instance().dump_to_string();
+  EXPECT_NE(json.find("\"ph\":\"s\",\"id\":515151"), std::string::npos);
+  EXPECT_NE(json.find("\"ph\":\"f\",\"id\":515151"), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"io_wait\""), std::string::npos);
+  EXPECT_NE(json.find("\"fiber\":515151,\"arg\":37"), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"timer_fire\""), std::string::npos);
+}
+
+// 测试4：每个线程使用独立缓冲区并导出线程名
+TEST_F(TracerTest, PerThreadBuffers) {
+  size_t before =
+      count(Tracer::instance().dump_to_string(), "\"name\":\"thread_name\"");
+  std::thread worker(
+      []() { Tracer::record(TraceEvent::kFiberCreate, 616161, 0); });
+  worker.join();
+
+  std::string json = Tracer::instance().dump_to_string();
+  EXPECT_EQ(count(json, "\"name\":\"thread_name\""), before + 1);
+  EXPECT_NE(json.find("\"name\":\"fiber_create\""), std::string::npos);
+}
+
+// 测试5：关闭后不再记录
+TEST_F(TracerTest, DisableStopsRecording) {
+  Tracer::instance().set_enabled(false);
+  Tracer::record(TraceEvent::kIoReady, 717171, 5);
+  Tracer::instance().set_enabled(true);
+
+  std::string json = Tracer::instance().dump_to_string();
+  EXPECT_EQ(json.find("717171"), std::string::npos);
+}
+
+// 测试6：导出到文件
+TEST_F(TracerTest, DumpToFile) {
+  Tracer::record(TraceEvent::kFiberTerminate, 818181);
+  std::string path = "/tmp/zcoroutine_tracer_test.json";
+  ASSERT_TRUE(Tracer::instance().dump(path));
+
+  std::ifstream file(path);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  EXPECT_NE(ss.str().find("fiber_terminate"), std::string::npos);
+  std::remove(path.c_str());
+
+  EXPECT_FALSE(Tracer::instance().dump("/nonexistent_dir/trace.json"));
+}
+
+// 测试7：信号触发导出
+TEST_F(TracerTest, SignalTriggeredDump) {
+  std::string prefix = "/tmp/zcoroutine_tracer_signal";
+  ASSERT_TRUE(Tracer::instance().install_signal_handler(SIGUSR2, prefix));
+  EXPECT_FALSE(Tracer::instance().install_signal_handler(SIGUSR2, prefix));
+
+  uint64_t before = Tracer::instance().signal_dump_count();
+  raise(SIGUSR2);
+  for (int i = 0; i < 200 && Tracer::instance().signal_dump_count() == before;
+       ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(Tracer::instance().signal_dump_count(), before + 1);
+
+  std::string path = prefix + "." + std::to_string(getpid()) + "." +
+                     std::to_string(before) + ".json";
+  std::ifstream file(path);
+  EXPECT_TRUE(file.good());
+  std::remove(path.c_str());
+}
+
+#ifdef ZCOROUTINE_ENABLE_TRACE
+// 测试8：运行时埋点记录协程的创建、运行与结束
+TEST_F(TracerTest, FiberInstrumentation) {
+  auto fiber = std::make_shared<Fiber>([]() { Fiber::yield(); });
+  fiber->resume();
+  fiber->resume();
+
+  std::string json = Tracer::instance().dump_to_string();
+  std::string slice = "\"name\":\"fiber " + std::to_string(fiber->id()) + "\"";
+  EXPECT_EQ(count(json, slice), 2u);
+  EXPECT_NE(json.find("\"end\":\"terminate\""), std::string::npos);
+}
+#endif
+
+int main(int argc, char **argv) {
+  zcoroutine::init_logger(zlog::LogLevel::value::DEBUG);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,128 @@
+#ifndef ZLOG_ASYNC_SINK_H_
+#define ZLOG_ASYNC_SINK_H_
+/**
+ * @brief 独立后台线程的落地器包装模块
+ * 把一个落地器放到自己的线程和队列上，慢落地器（如网络文件系统）
+ * 不会拖慢同一日志器的其他落地器，也不会让日志器的缓冲区堆满
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "buffer.h"
+#include "looper.h"
+#include "sink.h"
+#include "util.h"
+
+namespace zlog {
+/**
+ * @brief 单个落地器的运行指标快照
+ */
+struct SinkMetrics {
+  uint64_t bytes = 0;            // 已写入下游落地器的字节数
+  uint64_t batches = 0;          // 批次数（下游log调用次数）
+  uint64_t dropped = 0;          // 丢弃的写入次数
+  uint64_t droppedBytes = 0;     // 丢弃的字节数
+  uint64_t writeNanos = 0;       // 下游log调用累计耗时（纳秒）
+  uint64_t maxWriteNanos = 0;    // 单批下游log调用最大耗时（纳秒）
+  uint64_t maxLatencyNanos = 0;  // 数据从入队到写完的最大延迟（纳秒）
+};
+
+/**
+ * @brief 异步落地器
+ * 包装任意落地器：log()只把数据拷贝进本落地器的队列，
+ * 由独立的后台线程成批写入下游落地器，队列清空时调用下游的flush()。
+ * 队列超过上限时按策略处理：BLOCK等待、DROP丢弃并计数、
+ * SPILL继续扩容直到MAX_BUFFER_SIZE，之后同BLOCK等待。
+ * 任何策略下，超过MAX_BUFFER_SIZE的单条数据都会被丢弃并计数。
+ */
+class AsyncSink final : public LogSink, public NonCopyable {
+public:
+  /**
+   * @brief 构造函数
+   * @param sink 下游落地器
+   * @param policy 队列超过上限时的处理策略
+   * @param maxQueueBytes 队列上限（字节），超过MAX_BUFFER_SIZE时按其截断
+   * @param maxDelay 攒批的最长等待时间，0表示有数据就写；
+   *                 大于0时攒够FLUSH_BUFFER_SIZE或超时才写
+   */
+  explicit AsyncSink(LogSink::ptr sink,
+                     OverflowPolicy policy = OverflowPolicy::BLOCK,
+                     size_t maxQueueBytes = DEFAULT_BUFFER_SIZE,
+                     std::chrono::milliseconds maxDelay =
+                         std::chrono::milliseconds(0));
+
+  /**
+   * @brief 析构函数
+   * 写完队列中剩余的数据后停止后台线程
+   */
+  ~AsyncSink() override;
+
+  void log(const char *data, size_t len) override;
+
+  /**
+   * @brief 不做任何事：后台线程在队列清空时自行flush下游落地器
+   */
+  void flush() override {}
+
+  /**
+   * @brief 获取运行指标快照
+   */
+  SinkMetrics metrics() const;
+
+  /**
+   * @brief 获取下游落地器
+   */
+  const LogSink::ptr &sink() const { return sink_; }
+
+private:
+  /**
+   * @brief 后台线程入口
+   */
+  void threadEntry();
+
+  /**
+   * @brief 写一批数据到下游落地器并记录指标
+   */
+  void writeBatch(std::chrono::steady_clock::time_point oldest);
+
+  /**
+   * @brief 生产缓冲区能否按当前策略写入len字节，调用者需持有mutex_
+   */
+  bool hasRoom(size_t len) const;
+
+  /**
+   * @brief 原子地更新最大值
+   */
+  static void updateMax(std::atomic<uint64_t> &target, uint64_t value);
+
+  LogSink::ptr sink_;                   // 下游落地器
+  OverflowPolicy policy_;               // 队列满策略
+  size_t maxQueueBytes_;                // 队列上限
+  std::chrono::milliseconds maxDelay_;  // 攒批最长等待时间
+
+  std::mutex mutex_;                    // 保护proBuf_、oldest_、stop_
+  std::condition_variable condPro_;     // 生产者等待空间
+  std::condition_variable condCon_;     // 后台线程等待数据
+  Buffer proBuf_;                       // 生产缓冲区
+  Buffer conBuf_;                       // 消费缓冲区，仅后台线程访问
+  std::chrono::steady_clock::time_point oldest_; // 生产缓冲区最早数据的入队时间
+  bool stop_;                           // 停止标志
+
+  std::atomic<uint64_t> bytes_;          // 已写入字节数
+  std::atomic<uint64_t> batches_;        // 批次数
+  std::atomic<uint64_t> dropped_;        // 丢弃次数
+  std::atomic<uint64_t> droppedBytes_;   // 丢弃字节数
+  std::atomic<uint64_t> writeNanos_;     // 累计写入耗时
+  std::atomic<uint64_t> maxWriteNanos_;  // 最大单批写入耗时
+  std::atomic<uint64_t> maxLatencyNanos_; // 最大入队到写完延迟
+
+  std::thread thread_;                  // 后台线程
+};
+} // namespace zlog
+
+#endif // ZLOG_ASYNC_SINK_H_
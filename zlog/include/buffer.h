@@ -93,6 +93,12 @@ public:
    */
   size_t capacity() const { return capacity_; }
 
+  /**
+   * @brief 按缓存行对齐分配（C++11的new不保证超过16字节的对齐）
+   */
+  static void *operator new(size_t size);
+  static void operator delete(void *ptr);
+
 private:
   /**
    * @brief 确保缓冲区有足够空间
@@ -0,0 +1,239 @@
+#ifndef ZLOG_DEFERRED_H_
+#define ZLOG_DEFERRED_H_
+/**
+ * @brief 延迟格式化（二进制日志）模块
+ * 调用线程只写入调用点描述符指针和参数的原始字节，
+ * 后台线程解码参数并完成消息格式化与Formatter流水线。
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include <fmt/format.h>
+
+#include "level.h"
+#include "message.h"
+
+namespace zlog {
+/**
+ * @brief 日志调用点描述符
+ * 必须具有静态存储期（通常由ZLOG_CALL_SITE在调用处生成），
+ * 记录中只保存其地址，后台线程格式化时再读取
+ */
+struct CallSite {
+  LogLevel::value level; // 日志等级
+  const char *file;      // 源文件名
+  size_t line;           // 源文件行号
+  const char *fmt;       // 格式化字符串
+};
+
+/**
+ * @brief 后台格式化函数：按参数类型解码并格式化消息主体
+ * @param out 输出缓冲区
+ * @param fmt 格式化字符串
+ * @param data 参数编码起始位置
+ */
+using DeferredFormatFn = void (*)(fmt::memory_buffer &out, const char *fmt,
+                                  const char *data);
+
+/**
+ * @brief 二进制日志记录头
+ * 记录在环形缓冲区中可能不对齐，读写都通过memcpy
+ */
+struct DeferredHeader {
+  uint32_t size;           // 整条记录字节数（含记录头）
+  const CallSite *site;    // 调用点，nullptr表示后面是已格式化好的文本
+  DeferredFormatFn format; // 参数解码格式化函数
+  time_t curtime;          // 日志时间
+  threadId tid;            // 线程ID
+};
+
+namespace detail {
+template <size_t... I> struct IndexSeq {};
+
+template <size_t N, size_t... I>
+struct MakeIndexSeq : MakeIndexSeq<N - 1, N - 1, I...> {};
+
+template <size_t... I> struct MakeIndexSeq<0, I...> {
+  using type = IndexSeq<I...>;
+};
+
+/**
+ * @brief 字符串参数编码：4字节长度 + 内容，解码为指向记录内部的string_view
+ */
+struct StringCodec {
+  using Decoded = fmt::string_view;
+
+  static size_t size(size_t len) { return sizeof(uint32_t) + len; }
+
+  static void encode(char *&out, const char *data, size_t len) {
+    const uint32_t n = static_cast<uint32_t>(len);
+    std::memcpy(out, &n, sizeof(n));
+    std::memcpy(out + sizeof(n), data, len);
+    out += sizeof(n) + len;
+  }
+
+  static Decoded decode(const char *&in) {
+    uint32_t n = 0;
+    std::memcpy(&n, in, sizeof(n));
+    const Decoded result(in + sizeof(n), n);
+    in += sizeof(n) + n;
+    return result;
+  }
+};
+
+/**
+ * @brief 参数编解码器
+ * 默认：无法按值安全拷贝的类型在调用线程格式化为字符串
+ */
+template <typename T, typename Enable = void> struct ArgCodec {
+  using Decoded = fmt::string_view;
+
+  static size_t size(const T &value) {
+    return StringCodec::size(fmt::formatted_size("{}", value));
+  }
+
+  static void encode(char *&out, const T &value) {
+    const uint32_t n =
+        static_cast<uint32_t>(fmt::formatted_size("{}", value));
+    std::memcpy(out, &n, sizeof(n));
+    fmt::format_to(out + sizeof(n), "{}", value);
+    out += sizeof(n) + n;
+  }
+
+  static Decoded decode(const char *&in) { return StringCodec::decode(in); }
+};
+
+/**
+ * @brief 算术类型和无类型指针：按值拷贝原始字节
+ */
+template <typename T>
+struct ArgCodec<T, typename std::enable_if<
+                       std::is_arithmetic<T>::value ||
+                       std::is_same<T, const void *>::value ||
+                       std::is_same<T, void *>::value>::type> {
+  using Decoded = T;
+
+  static size_t size(const T &) { return sizeof(T); }
+
+  static void encode(char *&out, const T &value) {
+    std::memcpy(out, &value, sizeof(T));
+    out += sizeof(T);
+  }
+
+  static Decoded decode(const char *&in) {
+    T value;
+    std::memcpy(&value, in, sizeof(T));
+    in += sizeof(T);
+    return value;
+  }
+};
+
+/**
+ * @brief C字符串：拷贝内容，调用返回后原缓冲区可以释放
+ */
+template <typename T>
+struct ArgCodec<T, typename std::enable_if<
+                       std::is_same<T, const char *>::value ||
+                       std::is_same<T, char *>::value>::type> {
+  using Decoded = fmt::string_view;
+
+  static const char *str(const char *value) {
+    return value ? value : "(null)";
+  }
+
+  static size_t size(const char *value) {
+    return StringCodec::size(std::strlen(str(value)));
+  }
+
+  static void encode(char *&out, const char *value) {
+    StringCodec::encode(out, str(value), std::strlen(str(value)));
+  }
+
+  static Decoded decode(const char *&in) { return StringCodec::decode(in); }
+};
+
+template <> struct ArgCodec<std::string> {
+  using Decoded = fmt::string_view;
+
+  static size_t size(const std::string &value) {
+    return StringCodec::size(value.size());
+  }
+
+  static void encode(char *&out, const std::string &value) {
+    StringCodec::encode(out, value.data(), value.size());
+  }
+
+  static Decoded decode(const char *&in) { return StringCodec::decode(in); }
+};
+
+template <> struct ArgCodec<fmt::string_view> {
+  using Decoded = fmt::string_view;
+
+  static size_t size(const fmt::string_view &value) {
+    return StringCodec::size(value.size());
+  }
+
+  static void encode(char *&out, const fmt::string_view &value) {
+    StringCodec::encode(out, value.data(), value.size());
+  }
+
+  static Decoded decode(const char *&in) { return StringCodec::decode(in); }
+};
+} // namespace detail
+
+/**
+ * @brief 一组参数类型的编解码
+ * 编码在调用线程执行；format在后台线程按相同类型序列解码后格式化
+ * @tparam Args 退化（decay）后的参数类型
+ */
+template <typename... Args> struct DeferredCodec {
+  static size_t size(const Args &...args) {
+    size_t total = 0;
+    const int expand[] = {0, (total += detail::ArgCodec<Args>::size(args), 0)...};
+    (void)expand;
+    return total;
+  }
+
+  static void encode(char *out, const Args &...args) {
+    // 花括号初始化列表保证从左到右求值
+    const int expand[] = {0, (detail::ArgCodec<Args>::encode(out, args), 0)...};
+    (void)expand;
+    (void)out; // 无参数时未使用
+  }
+
+  static void format(fmt::memory_buffer &out, const char *fmt,
+                     const char *data) {
+    formatImpl(out, fmt, data,
+               typename detail::MakeIndexSeq<sizeof...(Args)>::type());
+  }
+
+private:
+  template <size_t... I>
+  static void formatImpl(fmt::memory_buffer &out, const char *fmt,
+                         const char *data, detail::IndexSeq<I...>) {
+    std::tuple<typename detail::ArgCodec<Args>::Decoded...> decoded{
+        detail::ArgCodec<Args>::decode(data)...};
+    (void)data;
+    fmt::vformat_to(std::back_inserter(out), fmt,
+                    fmt::make_format_args(std::get<I>(decoded)...));
+    (void)decoded;
+  }
+};
+} // namespace zlog
+
+/**
+ * @brief 在调用处生成静态调用点描述符
+ * fmt必须是字符串字面量或其他静态存储期的字符串
+ */
+#define ZLOG_CALL_SITE(level, fmt)                                            \
+  ([]() -> const zlog::CallSite & {                                           \
+    static const zlog::CallSite site = {level, __FILE__, __LINE__, fmt};      \
+    return site;                                                              \
+  }())
+
+#endif // ZLOG_DEFERRED_H_
@@ -1,6 +1,8 @@
 #ifndef ZLOG_FORMAT_H_
 #define ZLOG_FORMAT_H_
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <fmt/color.h>
@@ -62,6 +64,7 @@ public:
 
 protected:
   std::string timeFormat_; // 时间格式字符串
+  uint64_t cacheId_;       // 线程局部时间缓存的键
 };
 
 /**
@@ -136,9 +139,24 @@ protected:
   std::string str_; // 要输出的字符串
 };
 
+/**
+ * @brief 编译后的格式化指令
+ */
+enum class FormatOp : uint8_t {
+  LITERAL,   // 常量字节（普通字符、%T、%n合并而成）
+  MESSAGE,   // 主体消息
+  LEVEL,     // 日志等级（预先生成的名称表）
+  TIME,      // 时间（线程局部按秒缓存）
+  FILE,      // 源码文件名
+  LINE,      // 行号
+  THREAD_ID, // 线程ID（线程局部缓存字符串）
+  LOGGER     // 日志器名称（每次用strlen重新计算长度）
+};
+
 /**
  * @brief 日志格式化器
- * 解析格式化字符串并生成相应的格式化项
+ * 解析格式化字符串并编译为扁平的指令数组，
+ * 格式化时顺序执行指令，没有虚函数调用和临时字符串
  *
  * 格式化字符串说明：
  * %d 表示日期，可包含子格式{%H:%M:%S}
@@ -170,6 +188,23 @@ public:
   void format(fmt::memory_buffer &buffer, const LogMessage &msg) const;
 
 protected:
+  /**
+   * @brief 一条格式化指令
+   */
+  struct Instruction {
+    FormatOp op;     // 操作码
+    uint32_t offset; // LITERAL：常量在literals_中的偏移；TIME：times_下标
+    uint32_t len;    // LITERAL：常量长度
+  };
+
+  /**
+   * @brief 时间格式及其线程局部缓存的键
+   */
+  struct TimeSpec {
+    std::string format; // strftime格式
+    uint64_t cacheId;   // 缓存键，每个时间项唯一
+  };
+
   /**
    * @brief 解析格式化字符串
    * @return 解析成功返回true，否则返回false
@@ -177,17 +212,22 @@ protected:
   bool parsePattern();
 
   /**
-   * @brief 根据格式化字符创建对应的格式化项
-   * @param key 格式化字符
+   * @brief 根据格式化字符生成对应的指令
+   * @param key 格式化字符，为空表示普通字符串
    * @param val 格式化参数
-   * @return 格式化项智能指针
    */
-  static FormatItem::prt createItem(const std::string &key,
-                                    const std::string &val);
+  void compileItem(const std::string &key, const std::string &val);
+
+  /**
+   * @brief 追加常量字节，与前一条常量指令相邻时直接合并
+   */
+  void appendLiteral(const char *data, size_t len);
 
 protected:
-  std::string pattern_;                // 格式化字符串
-  std::vector<FormatItem::prt> items_; // 格式化项列表
+  std::string pattern_;             // 格式化字符串
+  std::vector<Instruction> ops_;    // 指令数组
+  std::string literals_;            // 常量字节池
+  std::vector<TimeSpec> times_;     // 时间格式
 };
 } // namespace zlog
 
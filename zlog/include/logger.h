@@ -11,12 +11,18 @@
 
 #include <fmt/format.h>
 
+#include "async_sink.h"
+#include "deferred.h"
 #include "format.h"
 #include "level.h"
 #include "looper.h"
+#include "mmap_sink.h"
+#include "rolling_sink.h"
 #include "sink.h"
 
 namespace zlog {
+class DeferredLogger;
+
 /**
  * @brief 日志器抽象基类
  * 提供日志记录的核心功能，支持模板化的日志接口
@@ -43,6 +49,16 @@ public:
    */
   std::string getName() const { return loggerName_; }
 
+  /**
+   * @brief 判断指定等级的日志是否会被输出
+   * 供调用方在求值格式化参数之前做等级判断
+   * @param level 日志等级
+   * @return 不低于等级限制返回true
+   */
+  bool shouldLog(const LogLevel::value level) const {
+    return level >= limitLevel_;
+  }
+
   /**
    * @brief 日志记录模板接口
    * @tparam Level 日志等级类型
@@ -59,6 +75,15 @@ public:
     logImplHelper(level, file, line, fmt, std::forward<Args>(args)...);
   }
 
+  /**
+   * @brief 按调用点记录日志
+   * 延迟格式化日志器只编码参数，由后台线程格式化；其他日志器立即格式化
+   * @param site 静态存储期的调用点描述符，见ZLOG_CALL_SITE
+   * @param args 格式化参数
+   */
+  template <typename... Args>
+  void logAt(const CallSite &site, Args &&...args);
+
   /**
    * @brief 记录 DEBUG 级别日志
    */
@@ -152,8 +177,14 @@ protected:
    */
   virtual void log(const char *data, size_t len) = 0;
 
+  /**
+   * @brief 让所有落地器写出暂存数据，由异步日志器的后台线程空闲时调用
+   */
+  void flushSinks() const;
+
 protected:
   std::mutex mutex_;                // 互斥锁
+  bool deferred_ = false;           // 是否为延迟格式化日志器
   const char *loggerName_;          // 日志器名称
   LogLevel::value limitLevel_;      // 日志等级限制
   Formatter::ptr formatter_;        // 日志格式化器
@@ -204,6 +235,27 @@ public:
               const Formatter::ptr &formatter, std::vector<LogSink::ptr> &sinks,
               AsyncType looperType, std::chrono::milliseconds milliseco);
 
+  /**
+   * @brief 构造函数
+   * @param loggerName 日志器名称
+   * @param limitLevel 日志等级限制
+   * @param formatter 日志格式化器
+   * @param sinks 日志落地器列表
+   * @param looperType 异步类型
+   * @param milliseco 最大等待时间
+   * @param policy 线程缓冲区满时的处理策略
+   */
+  AsyncLogger(const char *loggerName, const LogLevel::value limitLevel,
+              const Formatter::ptr &formatter, std::vector<LogSink::ptr> &sinks,
+              AsyncType looperType, std::chrono::milliseconds milliseco,
+              OverflowPolicy policy);
+
+  /**
+   * @brief 获取被丢弃的日志条数
+   * @return 丢弃条数
+   */
+  size_t droppedCount() const { return looper_->droppedCount(); }
+
 protected:
   /**
    * @brief 异步日志输出实现
@@ -224,12 +276,119 @@ protected:
   AsyncLooper::ptr looper_; // 异步循环器
 };
 
+/**
+ * @brief 延迟格式化（二进制）异步日志器
+ * 通过logAt写入时，调用线程只把调用点指针、时间、线程ID和参数原始字节
+ * 写入线程独占的环形缓冲区；消息格式化和Formatter流水线都在后台线程完成。
+ * 经debug/info等接口写入的日志仍在调用线程格式化，作为文本记录按序落地。
+ */
+class DeferredLogger final : public Logger {
+public:
+  /**
+   * @brief 构造函数
+   * @param loggerName 日志器名称
+   * @param limitLevel 日志等级限制
+   * @param formatter 日志格式化器
+   * @param sinks 日志落地器列表
+   * @param looperType 异步类型
+   * @param milliseco 最大等待时间
+   */
+  DeferredLogger(const char *loggerName, LogLevel::value limitLevel,
+                 const Formatter::ptr &formatter,
+                 std::vector<LogSink::ptr> &sinks, AsyncType looperType,
+                 std::chrono::milliseconds milliseco);
+
+  /**
+   * @brief 构造函数
+   * @param loggerName 日志器名称
+   * @param limitLevel 日志等级限制
+   * @param formatter 日志格式化器
+   * @param sinks 日志落地器列表
+   * @param looperType 异步类型
+   * @param milliseco 最大等待时间
+   * @param policy 线程缓冲区满时的处理策略
+   */
+  DeferredLogger(const char *loggerName, LogLevel::value limitLevel,
+                 const Formatter::ptr &formatter,
+                 std::vector<LogSink::ptr> &sinks, AsyncType looperType,
+                 std::chrono::milliseconds milliseco, OverflowPolicy policy);
+
+  /**
+   * @brief 编码一条二进制日志记录
+   * @param site 静态存储期的调用点描述符
+   * @param args 格式化参数，字符串内容会被拷贝
+   */
+  template <typename... Args>
+  void logDeferred(const CallSite &site, Args &&...args) {
+    if (site.level < limitLevel_)
+      return;
+
+    using Codec = DeferredCodec<typename std::decay<Args>::type...>;
+    const size_t size = sizeof(DeferredHeader) + Codec::size(args...);
+    DeferredHeader header;
+    header.size = static_cast<uint32_t>(size);
+    header.site = &site;
+    header.format = &Codec::format;
+    header.curtime = Date::getCurrentTime();
+    header.tid = std::this_thread::get_id();
+
+    char *record = recordBuffer(size);
+    std::memcpy(record, &header, sizeof(header));
+    Codec::encode(record + sizeof(header), args...);
+    looper_->push(record, size);
+  }
+
+  /**
+   * @brief 获取被丢弃的日志条数
+   * @return 丢弃条数
+   */
+  size_t droppedCount() const { return looper_->droppedCount(); }
+
+protected:
+  /**
+   * @brief 已格式化文本的输出，作为文本记录写入缓冲区
+   * @param data 日志数据
+   * @param len 数据长度
+   */
+  void log(const char *data, const size_t len) override;
+
+  /**
+   * @brief 后台线程解码记录、格式化并落地到各个sink
+   * @param buffer 缓冲区
+   */
+  void reLog(const Buffer &buffer);
+
+  /**
+   * @brief 获取线程局部的记录编码缓冲区
+   * @param size 需要的大小
+   * @return 缓冲区指针
+   */
+  static char *recordBuffer(size_t size);
+
+protected:
+  fmt::memory_buffer payload_; // 消息主体缓冲区（后台线程使用）
+  fmt::memory_buffer output_;  // 格式化输出缓冲区（后台线程使用）
+  AsyncLooper::ptr looper_;    // 异步循环器，最先析构
+};
+
+template <typename... Args>
+void Logger::logAt(const CallSite &site, Args &&...args) {
+  if (deferred_) {
+    static_cast<DeferredLogger *>(this)->logDeferred(
+        site, std::forward<Args>(args)...);
+    return;
+  }
+  logImplHelper(site.level, site.file, site.line, site.fmt,
+                std::forward<Args>(args)...);
+}
+
 /**
  * @brief 日志器类型枚举
  */
 enum class LoggerType {
-  LOGGER_SYNC, // 同步日志器
-  LOGGER_ASYNC // 异步日志器
+  LOGGER_SYNC,    // 同步日志器
+  LOGGER_ASYNC,   // 异步日志器
+  LOGGER_DEFERRED // 延迟格式化异步日志器
 };
 
 /**
@@ -257,6 +416,13 @@ public:
    */
   void buildEnalleUnSafe();
 
+  /**
+   * @brief 设置线程缓冲区满时的处理策略
+   * 未设置时由异步类型决定：安全模式阻塞，非安全模式溢出
+   * @param policy 处理策略
+   */
+  void buildOverflowPolicy(OverflowPolicy policy);
+
   /**
    * @brief 设置日志器名称
    * @param loggerName 日志器名称
@@ -307,6 +473,8 @@ protected:
   Formatter::ptr formatter_;            // 日志格式化器
   std::vector<LogSink::ptr> sinks_;     // 日志落地器列表
   AsyncType looperType_;                // 异步类型
+  OverflowPolicy overflowPolicy_;       // 缓冲区满策略
+  bool hasOverflowPolicy_;              // 是否显式设置了缓冲区满策略
   std::chrono::milliseconds milliseco_; // 最大等待时间
 };
 
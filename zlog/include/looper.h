@@ -3,11 +3,15 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "buffer.h"
+#include "ring_buffer.h"
 #include "util.h"
 
 namespace zlog {
@@ -19,20 +23,39 @@ enum class AsyncType {
   ASYNC_UNSAFE // 可扩容缓冲区--非阻塞模式
 };
 
+/**
+ * @brief 生产线程的环形缓冲区写满时的处理策略
+ */
+enum class OverflowPolicy {
+  BLOCK, // 阻塞等待后台线程腾出空间（ASYNC_SAFE的默认策略）
+  DROP,  // 丢弃当前这条日志并计数
+  SPILL  // 写入该线程的可扩容溢出缓冲区（ASYNC_UNSAFE的默认策略），
+         // 所有线程的溢出数据合计超过MAX_OVERFLOW_SIZE时阻塞等待
+};
+
 static constexpr size_t FLUSH_BUFFER_SIZE =
-    DEFAULT_BUFFER_SIZE / 32; // 刷新缓冲区大小阈值 
+    DEFAULT_BUFFER_SIZE / 32; // 刷新缓冲区大小阈值
+static constexpr size_t RING_NOTIFY_SIZE =
+    FLUSH_BUFFER_SIZE / 4; // 单个环形缓冲区积压超过该值时唤醒后台线程
+static constexpr size_t MAX_OVERFLOW_SIZE =
+    MAX_BUFFER_SIZE; // 一个循环器所有溢出缓冲区合计的数据上限
 
 /**
  * @brief 异步日志循环器
- * 实现生产者-消费者模式的异步日志处理
+ * 实现生产者-消费者模式的异步日志处理。
+ * 每个生产线程首次push时注册一个独占的SPSC环形缓冲区，写入路径无锁；
+ * 后台线程轮流（round-robin）取空各环形缓冲区，攒够阈值或超时后回调。
+ * 同一线程写入的日志保持顺序，不同线程之间不保证顺序。
  */
 class AsyncLooper {
 public:
   using Functor = std::function<void(Buffer &)>; // 回调函数类型
+  using IdleFunctor = std::function<void()>;     // 空闲回调函数类型
   using ptr = std::shared_ptr<AsyncLooper>;      // 智能指针类型
 
   /**
    * @brief 构造函数
+   * 缓冲区满策略由异步类型决定：ASYNC_SAFE为BLOCK，ASYNC_UNSAFE为SPILL
    * @param func 日志处理回调函数
    * @param looperType 异步类型（安全/非安全）
    * @param milliseco 最大等待时间（毫秒）
@@ -41,7 +64,18 @@ public:
               std::chrono::milliseconds milliseco);
 
   /**
-   * @brief 向生产缓冲区推送数据
+   * @brief 构造函数
+   * @param func 日志处理回调函数
+   * @param looperType 异步类型（安全/非安全）
+   * @param milliseco 最大等待时间（毫秒）
+   * @param policy 环形缓冲区满时的处理策略
+   */
+  AsyncLooper(Functor func, AsyncType looperType,
+              std::chrono::milliseconds milliseco, OverflowPolicy policy);
+
+  /**
+   * @brief 向当前线程的生产缓冲区推送数据
+   * 超过环形缓冲区容量的单条数据总是写入溢出缓冲区
    * @param data 数据指针
    * @param len 数据长度
    */
@@ -58,24 +92,123 @@ public:
    */
   void stop();
 
+  /**
+   * @brief 设置空闲回调
+   * 后台线程处理过数据后、一轮收集为空准备休眠时（以及停止前）调用一次，
+   * 供带暂存缓冲区的落地器把数据写出
+   * @param func 空闲回调函数
+   */
+  void setIdleCallback(IdleFunctor func);
+
+  /**
+   * @brief 获取缓冲区满策略
+   * @return 当前策略
+   */
+  OverflowPolicy overflowPolicy() const { return policy_; }
+
+  /**
+   * @brief 被丢弃的日志条数（DROP策略，或停止后仍无法写入）
+   * @return 丢弃条数
+   */
+  size_t droppedCount() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
 private:
+  struct ProducerQueue;
+  struct ThreadQueues;
+
+  /**
+   * @brief 获取当前线程在本循环器上的生产队列，首次调用时注册
+   * @return 生产队列指针
+   */
+  ProducerQueue *localQueue();
+
+  /**
+   * @brief 环形缓冲区写不下时按策略处理
+   */
+  void pushSlow(ProducerQueue *queue, const char *data, size_t len);
+
+  /**
+   * @brief 写入线程的溢出缓冲区
+   * 超过最大缓冲区大小或溢出预算时阻塞等待，永远写不进的数据丢弃并计数
+   */
+  void pushOverflow(ProducerQueue *queue, const char *data, size_t len);
+
+  /**
+   * @brief 从溢出预算中预留len字节
+   * @return 预算足够返回true
+   */
+  bool reserveOverflow(size_t len);
+
+  /**
+   * @brief 等待后台线程腾出空间
+   */
+  void waitForSpace();
+
+  /**
+   * @brief 唤醒后台线程
+   */
+  void wakeConsumer();
+
+  /**
+   * @brief 轮流取空所有生产队列到消费缓冲区，并回收已退出线程的队列
+   * 消费缓冲区放不下下一块数据时提前结束并设置backlogged_
+   * @return 取出的字节数
+   */
+  size_t drainQueues();
+
+  /**
+   * @brief 按顺序取出一个生产队列的环形缓冲区和溢出缓冲区
+   * @return 取出的字节数
+   */
+  size_t drainQueue(ProducerQueue &queue);
+
+  /**
+   * @brief 是否有值得立即处理的积压数据
+   */
+  bool hasPendingWork();
+
+  /**
+   * @brief 调用回调处理消费缓冲区并初始化
+   */
+  void flush();
+
+  /**
+   * @brief 调用空闲回调
+   */
+  void idle();
+
   /**
    * @brief 工作线程入口函数
-   * 处理消费缓冲区中的数据，处理完毕后初始化缓冲区并交换缓冲区
+   * 收集各生产队列的数据，攒够阈值、超时或停止时调用回调
    */
   void threadEntry();
 
 private:
+  const uint64_t id_;                   // 循环器编号，用于线程局部查找
   AsyncType looperType_;                // 异步类型
+  OverflowPolicy policy_;               // 缓冲区满策略
   std::atomic<bool> stop_;              // 停止标志
-  Buffer proBuf_;                       // 生产缓冲区
+  std::atomic<bool> sleeping_;          // 工作线程是否准备休眠
+  std::atomic<int> blockedProducers_;   // 正在等待空间的生产者数
+  std::atomic<size_t> dropped_;         // 丢弃条数
+  std::atomic<size_t> overflowBytes_;   // 所有溢出缓冲区中的字节数
   Buffer conBuf_;                       // 消费缓冲区
-  Spinlock mutex_;                      // 互斥锁（自旋锁）
-  std::condition_variable_any condPro_; // 生产者条件变量
-  std::condition_variable_any condCon_; // 消费者条件变量
-  std::thread thread_;                  // 工作线程
+  std::mutex queuesMutex_;              // 保护queues_
+  std::vector<std::shared_ptr<ProducerQueue>> queues_; // 已注册的生产队列
+  size_t nextQueue_;                    // 下一轮起始的队列下标
+  std::shared_ptr<ProducerQueue> sharedQueue_; // 线程局部对象析构后共用的队列
+  std::mutex waitMutex_;                // 配合条件变量
+  std::condition_variable condPro_;     // 生产者条件变量
+  std::condition_variable condCon_;     // 消费者条件变量
   Functor callBack_;                    // 回调函数
+  std::mutex idleMutex_;                // 保护idleCallBack_
+  IdleFunctor idleCallBack_;            // 空闲回调函数
+  bool dirty_;                          // 上次空闲回调后是否处理过数据
+  bool backlogged_;                     // 上一轮收集是否因放不下而提前结束
   std::chrono::milliseconds milliseco_; // 最大等待时间
+  std::thread thread_;                  // 工作线程
 };
 } // namespace zlog
 
@@ -0,0 +1,137 @@
+#ifndef ZLOG_MMAP_SINK_H_
+#define ZLOG_MMAP_SINK_H_
+/**
+ * @brief 内存映射落地模块
+ * 日志直接拷贝进文件映射，写入路径上没有系统调用，
+ * 进程崩溃后已写入映射的数据仍由内核写回文件
+ */
+
+#include <cstdint>
+#include <string>
+
+#include "sink.h"
+#include "util.h"
+
+namespace zlog {
+static constexpr size_t MMAP_SEGMENT_SIZE =
+    16 * 1024 * 1024; // 内存映射文件每段大小：16MB
+static constexpr size_t FLIGHT_RECORDER_SIZE =
+    8 * 1024 * 1024; // 飞行记录器默认保留的日志量：8MB
+
+/**
+ * @brief 内存映射文件落地器
+ * 按段用fallocate预分配文件空间并映射，日志直接拷贝进映射区，
+ * 一段写满后解除映射并映射下一段。
+ * 关闭时把文件截断到实际写入的长度；进程崩溃时文件末尾可能残留
+ * 预分配的零字节，重新打开时会跳过这些零字节继续追加。
+ */
+class MmapFileSink final : public LogSink, public NonCopyable {
+public:
+  /**
+   * @brief 构造函数
+   * @param pathname 文件路径
+   * @param segmentSize 每段大小，向上对齐到页大小
+   */
+  explicit MmapFileSink(const std::string &pathname,
+                        size_t segmentSize = MMAP_SEGMENT_SIZE);
+
+  /**
+   * @brief 析构函数
+   * 解除映射并截断文件到实际长度
+   */
+  ~MmapFileSink() override;
+
+  void log(const char *data, size_t len) override;
+
+  /**
+   * @brief 请求内核异步写回已写入的数据（msync MS_ASYNC）
+   */
+  void flush() override;
+
+protected:
+  /**
+   * @brief 映射从offset所在页开始的一段
+   * @param offset 下一次写入的文件偏移
+   * @return 成功返回true
+   */
+  bool mapSegment(off_t offset);
+
+  /**
+   * @brief 解除当前段的映射
+   */
+  void unmapSegment();
+
+  /**
+   * @brief 查找已有文件中最后一个非零字节之后的位置
+   */
+  off_t findDataEnd(off_t fileSize) const;
+
+  std::string pathname_; // 文件路径
+  int fd_;               // 文件描述符
+  size_t segmentSize_;   // 每段大小
+  char *map_;            // 当前段映射起始地址
+  off_t mapOffset_;      // 当前段对应的文件偏移
+  size_t pos_;           // 当前段内的写入位置
+};
+
+/**
+ * @brief 飞行记录器落地器
+ * 固定大小的内存映射环形文件，总是保存最近capacity字节的日志，
+ * 不需要flush：进程崩溃后用dump()即可从文件恢复最近的日志。
+ * 文件由一页头部和capacity字节的环形数据区组成，
+ * 头部记录累计写入的字节数，每条日志拷贝完成后才更新，
+ * 崩溃时最多丢失正在写入的那一条。
+ * 重新打开容量相同的已有文件时接着原有内容继续写。
+ */
+class FlightRecorderSink final : public LogSink, public NonCopyable {
+public:
+  /**
+   * @brief 构造函数
+   * @param pathname 文件路径
+   * @param capacity 环形数据区大小，向上对齐到页大小
+   */
+  explicit FlightRecorderSink(const std::string &pathname,
+                              size_t capacity = FLIGHT_RECORDER_SIZE);
+
+  /**
+   * @brief 析构函数
+   * 解除映射，文件内容保留
+   */
+  ~FlightRecorderSink() override;
+
+  /**
+   * @brief 写入日志，超过容量的单条日志只保留末尾capacity字节
+   */
+  void log(const char *data, size_t len) override;
+
+  /**
+   * @brief 请求内核异步写回映射区（msync MS_ASYNC）
+   */
+  void flush() override;
+
+  /**
+   * @brief 获取环形数据区大小
+   */
+  size_t capacity() const { return capacity_; }
+
+  /**
+   * @brief 从飞行记录器文件按时间顺序读出保存的日志
+   * 数据区回绕过时丢弃最早那条不完整的日志
+   * @param pathname 文件路径
+   * @return 日志内容，文件无效时返回空串
+   */
+  static std::string dump(const std::string &pathname);
+
+private:
+  struct Header;
+
+  int fd_;          // 文件描述符
+  size_t capacity_; // 环形数据区大小
+  char *map_;       // 整个文件的映射
+  size_t mapSize_;  // 映射大小
+  Header *header_;  // 文件头
+  char *data_;      // 环形数据区
+};
+} // namespace zlog
+
+#endif // ZLOG_MMAP_SINK_H_
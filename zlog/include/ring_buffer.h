@@ -0,0 +1,82 @@
+#ifndef ZLOG_RING_BUFFER_H_
+#define ZLOG_RING_BUFFER_H_
+#include <atomic>
+#include <cstddef>
+
+#include "buffer.h"
+#include "util.h"
+
+namespace zlog {
+static constexpr size_t RING_BUFFER_SIZE =
+    DEFAULT_BUFFER_SIZE / 8; // 每个生产线程的环形缓冲区大小：256KB
+
+/**
+ * @brief 单生产者单消费者无锁字节环形缓冲区
+ * 每个写日志的线程独占一个，后台线程负责读取。
+ * 读写下标单调递增，分别只由消费者/生产者修改，位于不同缓存行；
+ * 生产者缓存一份读下标，只有空间看起来不足时才去读取消费者的缓存行。
+ * 一次push的数据要么整体可见要么不可见，不会被消费者读到一半。
+ */
+class SpscRingBuffer : public NonCopyable {
+public:
+  /**
+   * @brief 构造函数
+   * @param capacity 容量，向上取整为2的幂
+   */
+  explicit SpscRingBuffer(size_t capacity = RING_BUFFER_SIZE);
+
+  /**
+   * @brief 析构函数
+   * 释放缓冲区内存
+   */
+  ~SpscRingBuffer();
+
+  /**
+   * @brief 写入数据（仅生产者线程调用）
+   * @param data 数据指针
+   * @param len 数据长度
+   * @return 空间足够并已写入返回true，空间不足返回false且不写入
+   */
+  bool push(const char *data, size_t len);
+
+  /**
+   * @brief 生产者视角的已用空间（仅生产者线程调用）
+   * 基于缓存的读下标，可能偏大
+   * @param refresh 是否先重新读取消费者的读下标
+   * @return 已用字节数
+   */
+  size_t producerSize(bool refresh);
+
+  /**
+   * @brief 将全部可读数据追加到缓冲区（仅消费者线程调用）
+   * out放不下全部数据时不读取，数据留在环形缓冲区中
+   * @param out 目标缓冲区
+   * @return 读取的字节数
+   */
+  size_t popTo(Buffer &out);
+
+  /**
+   * @brief 返回可读数据的长度，任意线程可调用
+   * @return 可读数据大小
+   */
+  size_t readAbleSize() const;
+
+  /**
+   * @brief 获取缓冲区容量
+   * @return 缓冲区总大小
+   */
+  size_t capacity() const { return capacity_; }
+
+private:
+  char *data_;      // 缓冲区指针
+  size_t capacity_; // 缓冲区总容量（2的幂）
+  size_t mask_;     // 下标掩码
+
+  alignas(64) std::atomic<size_t> writerIdx_; // 写下标，生产者修改
+  size_t cachedReaderIdx_;                    // 生产者缓存的读下标
+
+  alignas(64) std::atomic<size_t> readerIdx_; // 读下标，消费者修改
+};
+} // namespace zlog
+
+#endif // ZLOG_RING_BUFFER_H_
@@ -0,0 +1,152 @@
+#ifndef ZLOG_ROLLING_SINK_H_
+#define ZLOG_ROLLING_SINK_H_
+/**
+ * @brief 按时间/大小滚动的文件落地模块
+ * 写日志的线程只负责切换到后台线程预先打开好的文件描述符，
+ * 关闭、重命名、压缩和按保留策略清理都在低优先级的后台线程完成
+ */
+
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "sink.h"
+#include "util.h"
+
+namespace zlog {
+/**
+ * @brief 滚动与保留策略
+ */
+struct RollingOptions {
+  size_t maxSize = 0;         // 单个文件最大字节数，0表示不按大小滚动
+  time_t interval = 0;        // 按时间滚动的周期（秒，对齐本地时间），0表示不按时间滚动
+  size_t maxFiles = 0;        // 最多保留的归档文件数，0表示不限制
+  size_t maxTotalBytes = 0;   // 归档文件总字节数上限，0表示不限制
+  bool compress = true;       // 归档文件是否gzip压缩（需要zlib）
+};
+
+/**
+ * @brief 按时间/大小滚动的文件落地器
+ * 当前文件为 basename.log；滚动后归档为
+ * basename.YYYYmmdd-HHMMSS-NNN.log[.gz]，时间为该文件开始写入的时间，
+ * NNN保证同一秒内多次滚动时名称唯一且按名称排序即为时间顺序。
+ *
+ * 滚动时写日志的线程只交换文件描述符：下一个文件已由后台线程以
+ * basename.log.next 预先创建打开；后台线程尚未准备好时才同步打开。
+ * 后台线程按顺序关闭旧文件、重命名、压缩并清理超出保留策略的归档。
+ * 与其他落地器一样log()不是线程安全的，由日志器串行调用。
+ */
+class RollingFileSink final : public LogSink, public NonCopyable {
+public:
+  /**
+   * @brief 构造函数
+   * 已存在的当前文件会继续追加；上次进程滚动后未及归档就退出时，
+   * 遗留的basename.log.next[.N]按滚动顺序交给后台线程补做归档，
+   * 并继续追加到最后一个
+   * @param basename 文件基础名称（不含扩展名）
+   * @param options 滚动与保留策略
+   */
+  RollingFileSink(std::string basename, const RollingOptions &options);
+
+  /**
+   * @brief 析构函数
+   * 等待后台线程处理完所有归档任务后退出
+   */
+  ~RollingFileSink() override;
+
+  void log(const char *data, size_t len) override;
+
+  /**
+   * @brief 当前文件路径
+   */
+  const std::string &activePath() const { return activePath_; }
+
+  /**
+   * @brief 等待后台线程处理完已提交的归档任务（主要用于测试）
+   */
+  void waitIdle();
+
+  /**
+   * @brief 是否支持压缩（编译时找到了zlib）
+   */
+  static bool compressionSupported();
+
+private:
+  /**
+   * @brief 归档任务：旧文件已位于activePath_，新文件位于newPath
+   */
+  struct RollTask {
+    int oldFd;           // 旧文件描述符，由后台线程关闭
+    time_t openTime;     // 旧文件开始写入的时间
+    std::string newPath; // 新文件当前的路径
+  };
+
+  /**
+   * @brief 切换到下一个文件
+   */
+  void rollOver(time_t now);
+
+  /**
+   * @brief 计算now之后的下一个时间滚动点
+   */
+  time_t nextRollTime(time_t now) const;
+
+  /**
+   * @brief 后台线程入口
+   */
+  void threadEntry();
+
+  /**
+   * @brief 把上次进程遗留的非空下一个文件加入归档任务，删除空文件
+   * 在后台线程启动前调用
+   * @return 继续写入的文件路径
+   */
+  std::string recoverPending();
+
+  /**
+   * @brief 执行一个归档任务
+   */
+  void archive(const RollTask &task);
+
+  /**
+   * @brief 预先创建并打开下一个文件
+   * @return 成功返回true
+   */
+  bool prepareNext();
+
+  /**
+   * @brief 压缩归档文件为.gz，成功后删除原文件
+   * @return 最终的归档文件路径
+   */
+  std::string compressFile(const std::string &path);
+
+  /**
+   * @brief 按保留策略删除最旧的归档文件
+   */
+  void applyRetention();
+
+  std::string basename_;   // 文件基础名称
+  RollingOptions options_; // 滚动与保留策略
+  std::string activePath_; // 当前文件路径
+  std::string nextPath_;   // 预先打开的下一个文件路径
+  int fd_;                 // 当前文件描述符
+  size_t curSize_;         // 当前文件大小
+  time_t openTime_;        // 当前文件开始写入的时间
+  time_t rollTime_;        // 下一个时间滚动点，0表示不按时间滚动
+  size_t fallbackCount_;   // 同步打开的临时文件计数
+
+  std::mutex mutex_;                // 保护以下成员
+  std::condition_variable cond_;    // 通知后台线程
+  std::condition_variable idleCond_; // 通知waitIdle
+  std::deque<RollTask> tasks_;      // 待处理的归档任务
+  int nextFd_;                      // 预先打开的下一个文件，-1表示未准备好
+  bool busy_;                       // 后台线程正在处理任务
+  bool stop_;                       // 停止标志
+  std::thread thread_;              // 后台线程
+};
+} // namespace zlog
+
+#endif // ZLOG_ROLLING_SINK_H_
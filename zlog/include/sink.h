@@ -1,6 +1,9 @@
 #ifndef ZLOG_SINK_H_
 #define ZLOG_SINK_H_
 
+#include <sys/types.h>
+
+#include <ctime>
 #include <fstream>
 #include <string>
 #include <utility>
@@ -9,6 +12,8 @@
 #include <fmt/os.h>
 #include <fmt/ostream.h>
 
+#include "util.h"
+
 /**
  * @brief 日志落地模块
  * 实现日志输出到不同目标（控制台、文件、滚动文件）
@@ -31,6 +36,12 @@ public:
    * @param len 数据长度
    */
   virtual void log(const char *data, size_t len) = 0;
+
+  /**
+   * @brief 将缓冲的数据写出
+   * 异步日志器在后台线程空闲时调用，默认不做任何事
+   */
+  virtual void flush() {}
 };
 
 /**
@@ -40,6 +51,8 @@ public:
 class StdOutSink final : public LogSink {
 public:
   void log(const char *data, size_t len) override;
+
+  void flush() override;
 };
 
 /**
@@ -57,6 +70,8 @@ public:
 
   void log(const char *data, size_t len) override;
 
+  void flush() override;
+
 protected:
   std::string pathname_; // 文件路径
   std::ofstream ofs_;    // 输出文件流
@@ -79,6 +94,8 @@ public:
 
   void log(const char *data, size_t len) override;
 
+  void flush() override;
+
 protected:
   /**
    * @brief 创建新文件
@@ -100,6 +117,135 @@ protected:
   bool autoFlush_;       // 是否自动flush
 };
 
+static constexpr size_t FD_SINK_BUFFER_SIZE =
+    1024 * 1024; // 文件描述符落地器暂存缓冲区大小：1MB
+static constexpr size_t DIRECT_IO_ALIGN = 4096; // O_DIRECT的对齐粒度
+
+/**
+ * @brief 基于文件描述符的落地器基类
+ * 日志先追加到按页对齐的暂存缓冲区，缓冲区写满、后台线程空闲（flush）、
+ * 之后的秒内又有日志或关闭文件时才用write/writev写出，
+ * 一次系统调用覆盖一批日志。
+ * 没有定时器：同步日志器停止写日志后，最后一秒的数据会留在缓冲区，
+ * 直到下一条日志、flush()或析构，进程崩溃时这部分会丢失。
+ *
+ * 可选O_DIRECT：只按对齐粒度整块写出，不足一块的尾部经普通描述符写入
+ * 并留在缓冲区，下次与后续数据一起整块覆盖写；不支持O_DIRECT的文件系统
+ * 自动退回普通写。可选按字节数fdatasync做组提交。
+ * 与其他落地器一样不是线程安全的，由日志器串行调用。
+ */
+class FdSink : public LogSink, public NonCopyable {
+public:
+  /**
+   * @brief 构造函数
+   * @param bufferSize 暂存缓冲区大小，向上对齐到DIRECT_IO_ALIGN
+   * @param directIo 是否使用O_DIRECT绕过页缓存
+   * @param syncBytes 累计写出多少字节后fdatasync一次，0表示不主动同步
+   */
+  FdSink(size_t bufferSize, bool directIo, size_t syncBytes);
+
+  /**
+   * @brief 析构函数
+   * 写出剩余数据并关闭文件
+   */
+  ~FdSink() override;
+
+  void log(const char *data, size_t len) override;
+
+  void flush() override;
+
+  /**
+   * @brief 是否实际启用了O_DIRECT
+   */
+  bool directIo() const { return directFd_ >= 0; }
+
+protected:
+  /**
+   * @brief 以追加方式打开文件，失败时输出错误并丢弃后续日志
+   * @param pathname 文件路径
+   */
+  void openFile(const std::string &pathname);
+
+  /**
+   * @brief 写出全部数据（含fdatasync）并关闭文件
+   */
+  void closeFile();
+
+  /**
+   * @brief 追加数据到暂存缓冲区，必要时写出
+   */
+  void append(const char *data, size_t len);
+
+  /**
+   * @brief 写出暂存缓冲区
+   * @param includeTail O_DIRECT模式下是否也写出不足一块的尾部
+   */
+  void writeOut(bool includeTail);
+
+  /**
+   * @brief 累计写出字节数，达到阈值时fdatasync
+   */
+  void maybeSync(size_t written, bool force);
+
+  int fd_;                // 普通写描述符
+  int directFd_;          // O_DIRECT写描述符，未启用为-1
+  char *buffer_;          // 暂存缓冲区（按DIRECT_IO_ALIGN对齐）
+  size_t capacity_;       // 缓冲区容量
+  size_t size_;           // 缓冲区已用字节数
+  size_t tailWritten_;    // O_DIRECT模式下已经写出的尾部字节数
+  off_t fileOffset_;      // O_DIRECT模式下缓冲区起始对应的文件偏移
+  bool wantDirectIo_;     // 是否请求O_DIRECT
+  size_t syncBytes_;      // fdatasync阈值
+  size_t unsyncedBytes_;  // 上次同步后写出的字节数
+  time_t lastFlushTime_;  // 上次写出的时间（秒）
+};
+
+/**
+ * @brief 文件描述符文件落地器
+ * FileSink的批量写版本：同步日志器下在之后的秒内收到下一条日志时写出，
+ * 异步日志器下在后台线程空闲时写出
+ */
+class FdFileSink final : public FdSink {
+public:
+  /**
+   * @brief 构造函数
+   * @param pathname 文件路径
+   * @param bufferSize 暂存缓冲区大小
+   * @param directIo 是否使用O_DIRECT
+   * @param syncBytes 累计写出多少字节后fdatasync一次，0表示不主动同步
+   */
+  explicit FdFileSink(const std::string &pathname,
+                      size_t bufferSize = FD_SINK_BUFFER_SIZE,
+                      bool directIo = false, size_t syncBytes = 0);
+};
+
+/**
+ * @brief 按大小滚动的文件描述符落地器
+ * RollBySizeSink的批量写版本
+ */
+class RollBySizeFdSink final : public FdSink {
+public:
+  /**
+   * @brief 构造函数
+   * @param basename 文件基础名称
+   * @param maxSize 最大文件大小（字节）
+   * @param bufferSize 暂存缓冲区大小
+   * @param directIo 是否使用O_DIRECT
+   * @param syncBytes 累计写出多少字节后fdatasync一次，0表示不主动同步
+   */
+  RollBySizeFdSink(std::string basename, size_t maxSize,
+                   size_t bufferSize = FD_SINK_BUFFER_SIZE,
+                   bool directIo = false, size_t syncBytes = 0);
+
+  void log(const char *data, size_t len) override;
+
+protected:
+  std::string basename_; // 文件基础名称
+  size_t maxSize_;       // 最大文件大小
+  size_t curSize_;       // 当前文件大小
+  size_t nameCount_;     // 文件名计数器
+};
+
 /**
  * @brief 日志落地器工厂类
  * 使用工厂模式创建不同类型的日志落地器
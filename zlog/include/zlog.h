@@ -33,6 +33,18 @@ inline Logger::ptr rootLogger() {
 #define ERROR(fmt, ...) zlog::rootLogger()->ZLOG_ERROR(fmt, ##__VA_ARGS__)
 #define FATAL(fmt, ...) zlog::rootLogger()->ZLOG_FATAL(fmt, ##__VA_ARGS__)
 
+// 4. 按静态调用点记录：延迟格式化日志器在后台线程格式化，fmt须为字面量
+#define ZLOG_DEFERRED_DEBUG(fmt, ...)                                         \
+  logAt(ZLOG_CALL_SITE(zlog::LogLevel::value::DEBUG, fmt), ##__VA_ARGS__)
+#define ZLOG_DEFERRED_INFO(fmt, ...)                                          \
+  logAt(ZLOG_CALL_SITE(zlog::LogLevel::value::INFO, fmt), ##__VA_ARGS__)
+#define ZLOG_DEFERRED_WARN(fmt, ...)                                          \
+  logAt(ZLOG_CALL_SITE(zlog::LogLevel::value::WARNING, fmt), ##__VA_ARGS__)
+#define ZLOG_DEFERRED_ERROR(fmt, ...)                                         \
+  logAt(ZLOG_CALL_SITE(zlog::LogLevel::value::ERROR, fmt), ##__VA_ARGS__)
+#define ZLOG_DEFERRED_FATAL(fmt, ...)                                         \
+  logAt(ZLOG_CALL_SITE(zlog::LogLevel::value::FATAL, fmt), ##__VA_ARGS__)
+
 } // namespace zlog
 
 #endif // ZLOG_ZLOG_H_
@@ -0,0 +1,155 @@
+#include "async_sink.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+namespace zlog {
+
+AsyncSink::AsyncSink(LogSink::ptr sink, OverflowPolicy policy,
+                     size_t maxQueueBytes, std::chrono::milliseconds maxDelay)
+    : sink_(std::move(sink)), policy_(policy),
+      maxQueueBytes_(std::min(maxQueueBytes, MAX_BUFFER_SIZE)),
+      maxDelay_(maxDelay), stop_(false), bytes_(0), batches_(0), dropped_(0),
+      droppedBytes_(0), writeNanos_(0), maxWriteNanos_(0),
+      maxLatencyNanos_(0) {
+  thread_ = std::thread(&AsyncSink::threadEntry, this);
+}
+
+AsyncSink::~AsyncSink() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  condCon_.notify_all();
+  condPro_.notify_all();
+  thread_.join();
+}
+
+void AsyncSink::log(const char *data, size_t len) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!hasRoom(len)) {
+      // 超过最大缓冲区大小的数据等多久都写不进去，直接丢弃
+      if (policy_ != OverflowPolicy::DROP && !stop_ &&
+          len <= MAX_BUFFER_SIZE) {
+        condPro_.wait(lock, [this, len]() {
+          return stop_ || proBuf_.empty() || hasRoom(len);
+        });
+      }
+      if (!hasRoom(len)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        droppedBytes_.fetch_add(len, std::memory_order_relaxed);
+        return;
+      }
+    }
+    if (proBuf_.empty()) {
+      oldest_ = std::chrono::steady_clock::now();
+    }
+    proBuf_.push(data, len);
+  }
+  condCon_.notify_one();
+}
+
+bool AsyncSink::hasRoom(size_t len) const {
+  // 扩容会超过最大缓冲区大小时push()不会写入，必须先检查
+  if (!proBuf_.canAccommodate(len)) {
+    return false;
+  }
+  // 队列为空时总能写入，超过上限的单条数据不会永远阻塞
+  return policy_ == OverflowPolicy::SPILL || proBuf_.empty() ||
+         proBuf_.readAbleSize() + len <= maxQueueBytes_;
+}
+
+SinkMetrics AsyncSink::metrics() const {
+  SinkMetrics metrics;
+  metrics.bytes = bytes_.load(std::memory_order_relaxed);
+  metrics.batches = batches_.load(std::memory_order_relaxed);
+  metrics.dropped = dropped_.load(std::memory_order_relaxed);
+  metrics.droppedBytes = droppedBytes_.load(std::memory_order_relaxed);
+  metrics.writeNanos = writeNanos_.load(std::memory_order_relaxed);
+  metrics.maxWriteNanos = maxWriteNanos_.load(std::memory_order_relaxed);
+  metrics.maxLatencyNanos = maxLatencyNanos_.load(std::memory_order_relaxed);
+  return metrics;
+}
+
+void AsyncSink::updateMax(std::atomic<uint64_t> &target, uint64_t value) {
+  uint64_t current = target.load(std::memory_order_relaxed);
+  while (value > current &&
+         !target.compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+void AsyncSink::threadEntry() {
+  while (true) {
+    std::chrono::steady_clock::time_point oldest;
+    bool idle = false;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condCon_.wait(lock, [this]() { return stop_ || !proBuf_.empty(); });
+      if (maxDelay_.count() > 0) {
+        // 攒批：够一批或最早的数据等待超时才写
+        condCon_.wait_until(lock, oldest_ + maxDelay_, [this]() {
+          return stop_ || proBuf_.readAbleSize() >= FLUSH_BUFFER_SIZE;
+        });
+      }
+      if (proBuf_.empty()) {
+        break; // 只有stop_时才会为空
+      }
+      conBuf_.swap(proBuf_);
+      oldest = oldest_;
+    }
+    condPro_.notify_all();
+
+    writeBatch(oldest);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      idle = proBuf_.empty();
+    }
+    if (idle) {
+      try {
+        sink_->flush();
+      } catch (const std::exception &e) {
+        std::cerr << "AsyncSink flush exception: " << e.what() << std::endl;
+      } catch (...) {
+        std::cerr << "AsyncSink flush unknown exception" << std::endl;
+      }
+    }
+  }
+  try {
+    sink_->flush();
+  } catch (const std::exception &e) {
+    std::cerr << "AsyncSink flush exception: " << e.what() << std::endl;
+  } catch (...) {
+    std::cerr << "AsyncSink flush unknown exception" << std::endl;
+  }
+}
+
+void AsyncSink::writeBatch(std::chrono::steady_clock::time_point oldest) {
+  const size_t len = conBuf_.readAbleSize();
+  const auto start = std::chrono::steady_clock::now();
+  try {
+    sink_->log(conBuf_.begin(), len);
+  } catch (const std::exception &e) {
+    std::cerr << "AsyncSink log exception: " << e.what() << std::endl;
+  } catch (...) {
+    std::cerr << "AsyncSink log unknown exception" << std::endl;
+  }
+  const auto end = std::chrono::steady_clock::now();
+  conBuf_.reset();
+
+  const uint64_t writeNanos = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+          .count());
+  const uint64_t latencyNanos = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - oldest)
+          .count());
+  bytes_.fetch_add(len, std::memory_order_relaxed);
+  batches_.fetch_add(1, std::memory_order_relaxed);
+  writeNanos_.fetch_add(writeNanos, std::memory_order_relaxed);
+  updateMax(maxWriteNanos_, writeNanos);
+  updateMax(maxLatencyNanos_, latencyNanos);
+}
+} // namespace zlog
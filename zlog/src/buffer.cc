@@ -6,6 +6,7 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <new>
 #include <stdexcept>
 
 namespace zlog {
@@ -48,6 +49,16 @@ Buffer::~Buffer() {
   }
 }
 
+void *Buffer::operator new(size_t size) {
+  void *ptr = nullptr;
+  if (posix_memalign(&ptr, alignof(Buffer), size) != 0) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void Buffer::operator delete(void *ptr) { std::free(ptr); }
+
 void Buffer::push(const char *data, size_t len) {
   ensureEnoughSize(len);
   // 使用编译器内建函数进行更高效的内存拷贝
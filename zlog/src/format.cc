@@ -1,12 +1,118 @@
 #include "format.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
 namespace zlog {
 
-thread_local threadId id_cached{};
-thread_local std::string tidStr;
+// 时间缓存键生成器，保证不同时间项（包括先后复用同一地址的）互不干扰
+static std::atomic<uint64_t> nextTimeCacheId(1);
+
+/**
+ * @brief 追加字节：先扩容再直接拷贝，比memory_buffer::append的逐段循环更快
+ */
+static inline void appendBytes(fmt::memory_buffer &buffer, const char *data,
+                               size_t len) {
+  const size_t size = buffer.size();
+  buffer.resize(size + len);
+  std::memcpy(buffer.data() + size, data, len);
+}
+
+// 各日志等级的名称，按LogLevel::value下标预先生成
+static const fmt::string_view kLevelNames[] = {
+    "UNKNOWN", "DEBUG", "INFO", "WARNING", "ERROR", "FATAL", "OFF"};
+
+static void appendLevel(fmt::memory_buffer &buffer, LogLevel::value level) {
+  const size_t index = static_cast<size_t>(level);
+  const fmt::string_view name =
+      index < sizeof(kLevelNames) / sizeof(kLevelNames[0]) ? kLevelNames[index]
+                                                           : kLevelNames[0];
+  appendBytes(buffer, name.data(), name.size());
+}
+
+/**
+ * @brief 线程局部的时间字符串缓存，同一秒内直接复用
+ */
+static void appendTime(fmt::memory_buffer &buffer, const std::string &format,
+                       uint64_t cacheId, time_t curtime) {
+  struct TimeCache {
+    uint64_t cacheId = 0;
+    time_t second = 0;
+    size_t len = 0;
+    char str[64];
+  };
+  thread_local TimeCache cache;
+
+  if (cache.cacheId != cacheId || cache.second != curtime) {
+    struct tm lt {};
+    localtime_r(&curtime, &lt);
+    cache.len = strftime(cache.str, sizeof(cache.str), format.c_str(), &lt);
+    cache.cacheId = cacheId;
+    cache.second = curtime;
+  }
+
+  if (cache.len > 0) {
+    appendBytes(buffer, cache.str, cache.len);
+  } else {
+    // 错误处理
+    const char *err = "InvalidTime";
+    buffer.append(err, err + 11);
+  }
+}
+
+/**
+ * @brief 把线程ID格式化到out中，只在缓存未命中时调用
+ * 单独成函数，避免ostringstream的构造开销进入命中路径
+ * @return 写入的字节数
+ */
+__attribute__((noinline)) static size_t formatThreadId(const threadId &tid,
+                                                       char *out, size_t cap) {
+  std::ostringstream ss;
+  ss << tid;
+  const std::string str = ss.str();
+  const size_t len = std::min(str.size(), cap);
+  std::memcpy(out, str.data(), len);
+  return len;
+}
+
+/**
+ * @brief 线程局部的线程ID字符串缓存
+ * 直接映射的小表，异步后台线程为多个生产线程格式化时也能命中
+ */
+static void appendThreadId(fmt::memory_buffer &buffer, const threadId &tid) {
+  static constexpr size_t kSlots = 16;
+  struct TidCache {
+    threadId id[kSlots];
+    uint8_t len[kSlots] = {};
+    char str[kSlots][32];
+  };
+  thread_local TidCache cache;
+
+  // threadId在Linux上即pthread_t，取低位混合后作为槽位
+  uint64_t bits = 0;
+  std::memcpy(&bits, &tid, std::min(sizeof(bits), sizeof(tid)));
+  const size_t slot = static_cast<size_t>((bits ^ (bits >> 12)) >> 4) &
+                      (kSlots - 1);
+  if (cache.len[slot] == 0 || cache.id[slot] != tid) {
+    cache.len[slot] = static_cast<uint8_t>(
+        formatThreadId(tid, cache.str[slot], sizeof(cache.str[slot])));
+    cache.id[slot] = tid;
+  }
+  appendBytes(buffer, cache.str[slot], cache.len[slot]);
+}
+
+/**
+ * @brief 日志器名称很短，每次重新计算长度；
+ * 按指针缓存长度不安全，释放后的地址可能被更长的名称复用
+ */
+static void appendLoggerName(fmt::memory_buffer &buffer, const char *name) {
+  if (name != nullptr) {
+    appendBytes(buffer, name, strlen(name));
+  }
+}
 
 void MessageFormatItem::format(fmt::memory_buffer &buffer,
                                const LogMessage &msg) {
@@ -17,34 +123,16 @@ void MessageFormatItem::format(fmt::memory_buffer &buffer,
 
 void LevelFormatItem::format(fmt::memory_buffer &buffer,
                              const LogMessage &msg) {
-  std::string levelstr = LogLevel::toString(msg.level_);
-  buffer.append(levelstr.data(), levelstr.data() + levelstr.size());
+  appendLevel(buffer, msg.level_);
 }
 
 TimeFormatItem::TimeFormatItem(std::string timeFormat)
-    : timeFormat_(std::move(timeFormat)) {}
+    : timeFormat_(std::move(timeFormat)),
+      cacheId_(nextTimeCacheId.fetch_add(1, std::memory_order_relaxed)) {}
 
 void TimeFormatItem::format(fmt::memory_buffer &buffer, const LogMessage &msg) {
   // 秒级缓存优化
-  thread_local time_t last_second = 0;
-  thread_local char cached_time_str[64];
-  thread_local size_t cached_len = 0;
-
-  if (last_second != msg.curtime_) {
-    struct tm lt {};
-    localtime_r(&msg.curtime_, &lt);
-    cached_len = strftime(cached_time_str, sizeof(cached_time_str),
-                          timeFormat_.c_str(), &lt);
-    last_second = msg.curtime_;
-  }
-
-  if (cached_len > 0) {
-    buffer.append(cached_time_str, cached_time_str + cached_len);
-  } else {
-    // 错误处理
-    const char *err = "InvalidTime";
-    buffer.append(err, err + 11);
-  }
+  appendTime(buffer, timeFormat_, cacheId_, msg.curtime_);
 }
 
 void FileFormatItem::format(fmt::memory_buffer &buffer, const LogMessage &msg) {
@@ -54,27 +142,18 @@ void FileFormatItem::format(fmt::memory_buffer &buffer, const LogMessage &msg) {
 }
 
 void LineFormatItem::format(fmt::memory_buffer &buffer, const LogMessage &msg) {
-  fmt::format_to(std::back_inserter(buffer), "{}", msg.line_);
+  const fmt::format_int line(msg.line_);
+  buffer.append(line.data(), line.data() + line.size());
 }
 
 void ThreadIdFormatItem::format(fmt::memory_buffer &buffer,
                                 const LogMessage &msg) {
-  // 当缓存的ID与当前消息ID不同时才更新
-  if (id_cached != msg.tid_) {
-    id_cached = msg.tid_;
-    std::stringstream ss;
-    ss << id_cached;
-    tidStr = ss.str();
-  }
-
-  buffer.append(tidStr.data(), tidStr.data() + tidStr.size());
+  appendThreadId(buffer, msg.tid_);
 }
 
 void LoggerFormatItem::format(fmt::memory_buffer &buffer,
                               const LogMessage &msg) {
-  if (msg.loggerName_) {
-    buffer.append(msg.loggerName_, msg.loggerName_ + strlen(msg.loggerName_));
-  }
+  appendLoggerName(buffer, msg.loggerName_);
 }
 
 void TabFormatItem::format(fmt::memory_buffer &buffer, const LogMessage &msg) {
@@ -104,8 +183,42 @@ Formatter::Formatter(std::string pattern) : pattern_(std::move(pattern)) {
 
 void Formatter::format(fmt::memory_buffer &buffer,
                        const LogMessage &msg) const {
-  for (auto &item : items_) {
-    item->format(buffer, msg);
+  const char *literals = literals_.data();
+  for (const Instruction &ins : ops_) {
+    switch (ins.op) {
+    case FormatOp::LITERAL:
+      appendBytes(buffer, literals + ins.offset, ins.len);
+      break;
+    case FormatOp::MESSAGE:
+      if (msg.payload_) {
+        appendBytes(buffer, msg.payload_, strlen(msg.payload_));
+      }
+      break;
+    case FormatOp::LEVEL:
+      appendLevel(buffer, msg.level_);
+      break;
+    case FormatOp::TIME: {
+      const TimeSpec &spec = times_[ins.offset];
+      appendTime(buffer, spec.format, spec.cacheId, msg.curtime_);
+      break;
+    }
+    case FormatOp::FILE:
+      if (msg.file_) {
+        appendBytes(buffer, msg.file_, strlen(msg.file_));
+      }
+      break;
+    case FormatOp::LINE: {
+      const fmt::format_int line(msg.line_);
+      appendBytes(buffer, line.data(), line.size());
+      break;
+    }
+    case FormatOp::THREAD_ID:
+      appendThreadId(buffer, msg.tid_);
+      break;
+    case FormatOp::LOGGER:
+      appendLoggerName(buffer, msg.loggerName_);
+      break;
+    }
   }
 }
 
@@ -164,57 +277,66 @@ bool Formatter::parsePattern() {
     val.clear();
   }
 
-  // 7. 添加对应的格式化子对象
-  // 优化：合并相邻的 OtherFormatItem (字符串常量)
-  for (size_t i = 0; i < fmt_order.size(); ++i) {
-    if (fmt_order[i].first.empty()) {
-      // 当前是普通字符串
-      std::string combined_val = fmt_order[i].second;
-      // 向后查看是否还有普通字符串
-      while (i + 1 < fmt_order.size() && fmt_order[i + 1].first.empty()) {
-        combined_val += fmt_order[i + 1].second;
-        i++;
-      }
-      items_.push_back(std::make_shared<OtherFormatItem>(combined_val));
-    } else {
-      // 是格式化占位符
-      items_.push_back(createItem(fmt_order[i].first, fmt_order[i].second));
-    }
+  // 7. 编译为指令数组
+  // 优化：普通字符串、制表符和换行符合并为一条常量指令
+  for (const auto &item : fmt_order) {
+    compileItem(item.first, item.second);
   }
 
   return true;
 }
 
-FormatItem::prt Formatter::createItem(const std::string &key,
-                                      const std::string &val) {
+void Formatter::compileItem(const std::string &key, const std::string &val) {
+  if (key.empty()) {
+    appendLiteral(val.data(), val.size());
+    return;
+  }
+
+  Instruction ins{FormatOp::LITERAL, 0, 0};
   if (key == "d") {
-    if (!val.empty()) {
-      return std::make_shared<TimeFormatItem>(val);
-    } else {
-      return std::make_shared<TimeFormatItem>();
-    }
+    ins.op = FormatOp::TIME;
+    ins.offset = static_cast<uint32_t>(times_.size());
+    times_.push_back(TimeSpec{
+        val.empty() ? timeFormatDefault : val,
+        nextTimeCacheId.fetch_add(1, std::memory_order_relaxed)});
   } else if (key == "t")
-    return std::make_shared<ThreadIdFormatItem>();
+    ins.op = FormatOp::THREAD_ID;
   else if (key == "c")
-    return std::make_shared<LoggerFormatItem>();
+    ins.op = FormatOp::LOGGER;
   else if (key == "f")
-    return std::make_shared<FileFormatItem>();
+    ins.op = FormatOp::FILE;
   else if (key == "l")
-    return std::make_shared<LineFormatItem>();
+    ins.op = FormatOp::LINE;
   else if (key == "p")
-    return std::make_shared<LevelFormatItem>();
-  else if (key == "T")
-    return std::make_shared<TabFormatItem>();
-  else if (key == "m")
-    return std::make_shared<MessageFormatItem>();
-  else if (key == "n")
-    return std::make_shared<NLineFormatItem>();
-
-  if (!key.empty()) {
+    ins.op = FormatOp::LEVEL;
+  else if (key == "T") {
+    appendLiteral("\t", 1);
+    return;
+  } else if (key == "m")
+    ins.op = FormatOp::MESSAGE;
+  else if (key == "n") {
+    appendLiteral("\n", 1);
+    return;
+  } else {
     std::cerr << "没有对应的格式化字符: %" << key << std::endl;
     abort();
   }
-  return std::make_shared<OtherFormatItem>(val);
+  ops_.push_back(ins);
+}
+
+void Formatter::appendLiteral(const char *data, size_t len) {
+  if (len == 0) {
+    return;
+  }
+  if (!ops_.empty() && ops_.back().op == FormatOp::LITERAL &&
+      ops_.back().offset + ops_.back().len == literals_.size()) {
+    ops_.back().len += static_cast<uint32_t>(len);
+  } else {
+    ops_.push_back(Instruction{FormatOp::LITERAL,
+                               static_cast<uint32_t>(literals_.size()),
+                               static_cast<uint32_t>(len)});
+  }
+  literals_.append(data, len);
 }
 
 } // namespace zlog
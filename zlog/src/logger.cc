@@ -37,6 +37,12 @@ SyncLogger::SyncLogger(const char *loggerName, const LogLevel::value limitLevel,
                        std::vector<LogSink::ptr> &sinks)
     : Logger(loggerName, limitLevel, formatter, sinks) {}
 
+void Logger::flushSinks() const {
+  for (const auto &sink : sinks_) {
+    sink->flush();
+  }
+}
+
 void SyncLogger::log(const char *data, const size_t len) {
   std::unique_lock<std::mutex> lock(mutex_);
   if (sinks_.empty())
@@ -54,7 +60,22 @@ AsyncLogger::AsyncLogger(const char *loggerName,
     : Logger(loggerName, limitLevel, formatter, sinks),
       looper_(std::make_shared<AsyncLooper>(
           AsyncLooper::Functor{[this](const Buffer &buf) { this->reLog(buf); }},
-          looperType, milliseco)) {}
+          looperType, milliseco)) {
+  looper_->setIdleCallback([this]() { this->flushSinks(); });
+}
+
+AsyncLogger::AsyncLogger(const char *loggerName,
+                         const LogLevel::value limitLevel,
+                         const Formatter::ptr &formatter,
+                         std::vector<LogSink::ptr> &sinks, AsyncType looperType,
+                         std::chrono::milliseconds milliseco,
+                         OverflowPolicy policy)
+    : Logger(loggerName, limitLevel, formatter, sinks),
+      looper_(std::make_shared<AsyncLooper>(
+          AsyncLooper::Functor{[this](const Buffer &buf) { this->reLog(buf); }},
+          looperType, milliseco, policy)) {
+  looper_->setIdleCallback([this]() { this->flushSinks(); });
+}
 
 void AsyncLogger::log(const char *data, const size_t len) {
   looper_->push(data, len);
@@ -68,9 +89,101 @@ void AsyncLogger::reLog(const Buffer &buffer) const {
   }
 }
 
+DeferredLogger::DeferredLogger(const char *loggerName,
+                               const LogLevel::value limitLevel,
+                               const Formatter::ptr &formatter,
+                               std::vector<LogSink::ptr> &sinks,
+                               AsyncType looperType,
+                               std::chrono::milliseconds milliseco)
+    : Logger(loggerName, limitLevel, formatter, sinks),
+      looper_(std::make_shared<AsyncLooper>(
+          AsyncLooper::Functor{[this](const Buffer &buf) { this->reLog(buf); }},
+          looperType, milliseco)) {
+  deferred_ = true;
+  looper_->setIdleCallback([this]() { this->flushSinks(); });
+}
+
+DeferredLogger::DeferredLogger(const char *loggerName,
+                               const LogLevel::value limitLevel,
+                               const Formatter::ptr &formatter,
+                               std::vector<LogSink::ptr> &sinks,
+                               AsyncType looperType,
+                               std::chrono::milliseconds milliseco,
+                               OverflowPolicy policy)
+    : Logger(loggerName, limitLevel, formatter, sinks),
+      looper_(std::make_shared<AsyncLooper>(
+          AsyncLooper::Functor{[this](const Buffer &buf) { this->reLog(buf); }},
+          looperType, milliseco, policy)) {
+  deferred_ = true;
+  looper_->setIdleCallback([this]() { this->flushSinks(); });
+}
+
+char *DeferredLogger::recordBuffer(const size_t size) {
+  // 所有参数类型组合共用一个线程局部缓冲区
+  thread_local fmt::memory_buffer buffer;
+  buffer.resize(size);
+  return buffer.data();
+}
+
+void DeferredLogger::log(const char *data, const size_t len) {
+  DeferredHeader header;
+  header.size = static_cast<uint32_t>(sizeof(header) + len);
+  header.site = nullptr;
+  header.format = nullptr;
+  header.curtime = 0;
+  header.tid = threadId();
+
+  char *record = recordBuffer(header.size);
+  std::memcpy(record, &header, sizeof(header));
+  std::memcpy(record + sizeof(header), data, len);
+  looper_->push(record, header.size);
+}
+
+void DeferredLogger::reLog(const Buffer &buffer) {
+  // 环形缓冲区按整条记录发布，缓冲区中总是完整记录的序列
+  LogMessage msg(LogLevel::value::DEBUG, "", 0, "", loggerName_);
+  const char *cur = buffer.begin();
+  const char *end = cur + buffer.readAbleSize();
+  output_.clear();
+  while (cur + sizeof(DeferredHeader) <= end) {
+    DeferredHeader header;
+    std::memcpy(&header, cur, sizeof(header));
+    const char *body = cur + sizeof(header);
+    cur += header.size;
+
+    if (header.site == nullptr) {
+      output_.append(body, cur);
+      continue;
+    }
+
+    payload_.clear();
+    try {
+      header.format(payload_, header.site->fmt, body);
+    } catch (const std::exception &e) {
+      payload_.clear();
+      fmt::format_to(std::back_inserter(payload_), "[format error: {}] {}",
+                     e.what(), header.site->fmt);
+    }
+    payload_.push_back('\0');
+
+    msg.curtime_ = header.curtime;
+    msg.level_ = header.site->level;
+    msg.file_ = header.site->file;
+    msg.line_ = header.site->line;
+    msg.tid_ = header.tid;
+    msg.payload_ = payload_.data();
+    formatter_->format(output_, msg);
+  }
+
+  for (auto &sink : sinks_) {
+    sink->log(output_.data(), output_.size());
+  }
+}
+
 LoggerBuilder::LoggerBuilder()
     : loggerType_(LoggerType::LOGGER_SYNC), limitLevel_(LogLevel::value::DEBUG),
       looperType_(AsyncType::ASYNC_SAFE),
+      overflowPolicy_(OverflowPolicy::BLOCK), hasOverflowPolicy_(false),
       milliseco_(std::chrono::milliseconds(3000)) {}
 
 void LoggerBuilder::buildLoggerType(const LoggerType loggerType) {
@@ -81,6 +194,11 @@ void LoggerBuilder::buildEnalleUnSafe() {
   looperType_ = AsyncType::ASYNC_UNSAFE;
 }
 
+void LoggerBuilder::buildOverflowPolicy(const OverflowPolicy policy) {
+  overflowPolicy_ = policy;
+  hasOverflowPolicy_ = true;
+}
+
 void LoggerBuilder::buildLoggerName(const char *loggerName) {
   loggerName_ = loggerName;
 }
@@ -107,7 +225,22 @@ Logger::ptr LocalLoggerBuilder::build() {
   if (sinks_.empty()) {
     buildLoggerSink<StdOutSink>();
   }
+  if (loggerType_ == LoggerType::LOGGER_DEFERRED) {
+    if (hasOverflowPolicy_) {
+      return std::make_shared<DeferredLogger>(loggerName_, limitLevel_,
+                                              formatter_, sinks_, looperType_,
+                                              milliseco_, overflowPolicy_);
+    }
+    return std::make_shared<DeferredLogger>(loggerName_, limitLevel_,
+                                            formatter_, sinks_, looperType_,
+                                            milliseco_);
+  }
   if (loggerType_ == LoggerType::LOGGER_ASYNC) {
+    if (hasOverflowPolicy_) {
+      return std::make_shared<AsyncLogger>(loggerName_, limitLevel_,
+                                           formatter_, sinks_, looperType_,
+                                           milliseco_, overflowPolicy_);
+    }
     return std::make_shared<AsyncLogger>(loggerName_, limitLevel_, formatter_,
                                          sinks_, looperType_, milliseco_);
   }
@@ -161,7 +294,18 @@ Logger::ptr GlobalLoggerBuilder::build() {
     buildLoggerSink<StdOutSink>();
   }
   Logger::ptr logger;
-  if (loggerType_ == LoggerType::LOGGER_ASYNC) {
+  if (loggerType_ == LoggerType::LOGGER_DEFERRED && hasOverflowPolicy_) {
+    logger = std::make_shared<DeferredLogger>(loggerName_, limitLevel_,
+                                              formatter_, sinks_, looperType_,
+                                              milliseco_, overflowPolicy_);
+  } else if (loggerType_ == LoggerType::LOGGER_DEFERRED) {
+    logger = std::make_shared<DeferredLogger>(
+        loggerName_, limitLevel_, formatter_, sinks_, looperType_, milliseco_);
+  } else if (loggerType_ == LoggerType::LOGGER_ASYNC && hasOverflowPolicy_) {
+    logger = std::make_shared<AsyncLogger>(loggerName_, limitLevel_, formatter_,
+                                           sinks_, looperType_, milliseco_,
+                                           overflowPolicy_);
+  } else if (loggerType_ == LoggerType::LOGGER_ASYNC) {
     logger = std::make_shared<AsyncLogger>(loggerName_, limitLevel_, formatter_,
                                            sinks_, looperType_, milliseco_);
   } else {
@@ -1,79 +1,404 @@
 #include "looper.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <new>
+#include <utility>
 
 namespace zlog {
 
+/**
+ * @brief 一个生产线程在某个循环器上的队列
+ * 环形缓冲区由该线程无锁写入；溢出缓冲区由overflowMutex保护。
+ * 溢出缓冲区非空时，该线程后续数据都写入溢出缓冲区，
+ * 后台线程在锁内先取空环形缓冲区再取溢出缓冲区，从而保持线程内顺序。
+ */
+struct AsyncLooper::ProducerQueue {
+  SpscRingBuffer ring;                  // 无锁环形缓冲区
+  Spinlock overflowMutex;               // 保护overflow
+  std::unique_ptr<Buffer> overflow;     // 溢出缓冲区，首次使用时创建
+  std::atomic<bool> overflowing{false}; // 溢出缓冲区是否有数据
+  std::atomic<bool> closed{false};      // 生产线程已退出
+  std::atomic<bool> detached{false};    // 循环器已停止
+
+  // 环形缓冲区的读写下标和自旋锁按缓存行对齐，C++11的new不保证该对齐
+  static void *operator new(size_t size) {
+    void *ptr = nullptr;
+    if (posix_memalign(&ptr, alignof(ProducerQueue), size) != 0) {
+      throw std::bad_alloc();
+    }
+    return ptr;
+  }
+  static void operator delete(void *ptr) { std::free(ptr); }
+};
+
+/**
+ * @brief 线程局部的生产队列表
+ * 持有队列引用，线程退出时标记关闭，由后台线程取空后回收
+ */
+struct AsyncLooper::ThreadQueues {
+  uint64_t lastId = 0;            // 最近一次使用的循环器编号
+  ProducerQueue *last = nullptr;  // 最近一次使用的队列
+  bool destroyed = false;         // 线程局部对象已析构
+  std::vector<std::pair<uint64_t, std::shared_ptr<ProducerQueue>>> entries;
+
+  ~ThreadQueues() {
+    for (auto &entry : entries) {
+      entry.second->closed.store(true, std::memory_order_release);
+    }
+    entries.clear();
+    lastId = 0;
+    last = nullptr;
+    destroyed = true;
+  }
+};
+
+static std::atomic<uint64_t> nextLooperId(1);
+
+static OverflowPolicy defaultPolicy(const AsyncType looperType) {
+  return looperType == AsyncType::ASYNC_SAFE ? OverflowPolicy::BLOCK
+                                             : OverflowPolicy::SPILL;
+}
+
 AsyncLooper::AsyncLooper(Functor func, const AsyncType looperType,
                          const std::chrono::milliseconds milliseco)
-    : looperType_(looperType), stop_(false),
-      thread_(std::thread(&AsyncLooper::threadEntry, this)),
-      callBack_(std::move(func)), milliseco_(milliseco) {}
+    : AsyncLooper(std::move(func), looperType, milliseco,
+                  defaultPolicy(looperType)) {}
+
+AsyncLooper::AsyncLooper(Functor func, const AsyncType looperType,
+                         const std::chrono::milliseconds milliseco,
+                         const OverflowPolicy policy)
+    : id_(nextLooperId.fetch_add(1, std::memory_order_relaxed)),
+      looperType_(looperType), policy_(policy), stop_(false),
+      sleeping_(false), blockedProducers_(0), dropped_(0), overflowBytes_(0),
+      nextQueue_(0), sharedQueue_(new ProducerQueue()),
+      callBack_(std::move(func)), dirty_(false), backlogged_(false),
+      milliseco_(milliseco) {
+  queues_.push_back(sharedQueue_);
+  thread_ = std::thread(&AsyncLooper::threadEntry, this);
+}
+
+AsyncLooper::ProducerQueue *AsyncLooper::localQueue() {
+  thread_local ThreadQueues queues;
+  if (queues.lastId == id_) {
+    return queues.last;
+  }
+  if (queues.destroyed) {
+    return nullptr;
+  }
+
+  ProducerQueue *queue = nullptr;
+  for (const auto &entry : queues.entries) {
+    if (entry.first == id_) {
+      queue = entry.second.get();
+      break;
+    }
+  }
+  if (queue == nullptr) {
+    // 顺带清理已停止的循环器留下的队列
+    queues.entries.erase(
+        std::remove_if(queues.entries.begin(), queues.entries.end(),
+                       [](const std::pair<uint64_t,
+                                          std::shared_ptr<ProducerQueue>> &e) {
+                         return e.second->detached.load(
+                             std::memory_order_acquire);
+                       }),
+        queues.entries.end());
+    std::shared_ptr<ProducerQueue> created(new ProducerQueue());
+    {
+      std::lock_guard<std::mutex> lock(queuesMutex_);
+      queues_.push_back(created);
+    }
+    queue = created.get();
+    queues.entries.emplace_back(id_, std::move(created));
+  }
+  queues.lastId = id_;
+  queues.last = queue;
+  return queue;
+}
 
 void AsyncLooper::push(const char *data, const size_t len) {
-  std::unique_lock<Spinlock> lock(mutex_);
-  if (looperType_ == AsyncType::ASYNC_SAFE) {
-    // 安全模式下等待缓冲区有空闲空间
-    condPro_.wait(lock, [&]() { return proBuf_.writeAbleSize() >= len; });
-  } else {
-    // UNSAFE模式下，如果扩容会超过最大缓冲区大小，则阻塞等待
-    condPro_.wait(lock, [&]() { return proBuf_.canAccommodate(len); });
+  ProducerQueue *queue = localQueue();
+  if (queue == nullptr) {
+    pushOverflow(sharedQueue_.get(), data, len);
+    return;
   }
 
-  proBuf_.push(data, len); // 向缓冲区推送数据
+  if (!queue->overflowing.load(std::memory_order_relaxed) &&
+      queue->ring.push(data, len)) {
+    // 积压较多时确认后台线程没有在睡眠；与threadEntry中的fence配对
+    if (queue->ring.producerSize(false) >= RING_NOTIFY_SIZE &&
+        queue->ring.producerSize(true) >= RING_NOTIFY_SIZE) {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (sleeping_.load(std::memory_order_relaxed)) {
+        wakeConsumer();
+      }
+    }
+    return;
+  }
+  pushSlow(queue, data, len);
+}
+
+void AsyncLooper::pushSlow(ProducerQueue *queue, const char *data,
+                           const size_t len) {
+  // 超大的单条数据或已有溢出数据时，必须走溢出缓冲区以保持顺序
+  if (len > queue->ring.capacity() ||
+      queue->overflowing.load(std::memory_order_relaxed)) {
+    pushOverflow(queue, data, len);
+    return;
+  }
+
+  switch (policy_) {
+  case OverflowPolicy::BLOCK:
+    blockedProducers_.fetch_add(1, std::memory_order_relaxed);
+    while (!queue->ring.push(data, len)) {
+      if (stop_.load(std::memory_order_acquire)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        break;
+      }
+      waitForSpace();
+    }
+    blockedProducers_.fetch_sub(1, std::memory_order_relaxed);
+    break;
+  case OverflowPolicy::DROP:
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    break;
+  case OverflowPolicy::SPILL:
+    pushOverflow(queue, data, len);
+    break;
+  }
+}
 
-  if (proBuf_.readAbleSize() >= FLUSH_BUFFER_SIZE) { // 缓冲区可读空间大于阈值
-    condCon_.notify_one();
+void AsyncLooper::pushOverflow(ProducerQueue *queue, const char *data,
+                               const size_t len) {
+  {
+    std::unique_lock<Spinlock> lock(queue->overflowMutex);
+    if (!queue->overflow) {
+      queue->overflow.reset(new Buffer());
+    }
+    // 扩容会超过最大缓冲区大小或超出溢出预算时阻塞等待
+    while (true) {
+      const bool fits = queue->overflow->canAccommodate(len);
+      if (fits && reserveOverflow(len)) {
+        break;
+      }
+      // 超过预算或空缓冲区也放不下的数据等多久都写不进去
+      if (stop_.load(std::memory_order_acquire) || len > MAX_OVERFLOW_SIZE ||
+          (!fits && queue->overflow->empty())) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      lock.unlock();
+      blockedProducers_.fetch_add(1, std::memory_order_relaxed);
+      waitForSpace();
+      blockedProducers_.fetch_sub(1, std::memory_order_relaxed);
+      lock.lock();
+    }
+    queue->overflow->push(data, len);
+    queue->overflowing.store(true, std::memory_order_release);
+  }
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_.load(std::memory_order_relaxed)) {
+    wakeConsumer();
   }
 }
 
+bool AsyncLooper::reserveOverflow(const size_t len) {
+  size_t used = overflowBytes_.load(std::memory_order_relaxed);
+  do {
+    if (len > MAX_OVERFLOW_SIZE - used) {
+      return false;
+    }
+  } while (!overflowBytes_.compare_exchange_weak(used, used + len,
+                                                 std::memory_order_relaxed));
+  return true;
+}
+
+void AsyncLooper::waitForSpace() {
+  wakeConsumer();
+  std::unique_lock<std::mutex> lock(waitMutex_);
+  // 后台线程取走数据后会通知；超时兜底，避免错过通知
+  condPro_.wait_for(lock, std::chrono::milliseconds(1));
+}
+
+void AsyncLooper::wakeConsumer() {
+  std::lock_guard<std::mutex> lock(waitMutex_);
+  condCon_.notify_one();
+}
+
 AsyncLooper::~AsyncLooper() { stop(); }
 
 void AsyncLooper::stop() {
   stop_ = true;
-  condCon_.notify_all();
+  wakeConsumer();
   if (thread_.joinable()) {
     thread_.join(); // 等待工作线程退出
   }
+  std::lock_guard<std::mutex> lock(queuesMutex_);
+  for (const auto &queue : queues_) {
+    queue->detached.store(true, std::memory_order_release);
+  }
+}
+
+size_t AsyncLooper::drainQueues() {
+  std::lock_guard<std::mutex> lock(queuesMutex_);
+  const size_t count = queues_.size();
+  size_t total = 0;
+  bool hasClosed = false;
+  backlogged_ = false;
+  for (size_t i = 0; i < count && !backlogged_; ++i) {
+    ProducerQueue &queue = *queues_[(nextQueue_ + i) % count];
+    // 先读关闭标志：读到关闭后再取空，就不会漏掉线程退出前的数据
+    hasClosed |= queue.closed.load(std::memory_order_acquire);
+    total += drainQueue(queue);
+  }
+  nextQueue_ = count > 0 ? (nextQueue_ + 1) % count : 0;
+
+  if (hasClosed) {
+    // 回收已退出线程的队列；共用队列不会被关闭
+    queues_.erase(std::remove_if(queues_.begin(), queues_.end(),
+                                 [](const std::shared_ptr<ProducerQueue> &q) {
+                                   return q->closed.load(
+                                              std::memory_order_acquire) &&
+                                          q->ring.readAbleSize() == 0 &&
+                                          !q->overflowing.load(
+                                              std::memory_order_acquire);
+                                 }),
+                  queues_.end());
+  }
+  return total;
+}
+
+size_t AsyncLooper::drainQueue(ProducerQueue &queue) {
+  // 环形缓冲区的数据不超过其容量；按容量检查，取数时生产者再写入也放得下
+  if (!conBuf_.canAccommodate(queue.ring.capacity())) {
+    backlogged_ = true;
+    return 0;
+  }
+  size_t total = queue.ring.popTo(conBuf_);
+  if (!queue.overflowing.load(std::memory_order_acquire)) {
+    return total;
+  }
+
+  std::unique_ptr<Buffer> released; // 在锁外释放
+  std::lock_guard<Spinlock> overflowLock(queue.overflowMutex);
+  // 溢出缓冲区非空期间生产者不会写环形缓冲区，环形缓冲区里的数据都更早
+  if (!conBuf_.canAccommodate(queue.ring.capacity())) {
+    backlogged_ = true;
+    return total;
+  }
+  total += queue.ring.popTo(conBuf_);
+  Buffer &overflow = *queue.overflow;
+  const size_t len = overflow.readAbleSize();
+  if (conBuf_.empty()) {
+    // 直接交换：省去拷贝，也不受消费缓冲区扩容上限的限制
+    conBuf_.swap(overflow);
+  } else if (conBuf_.canAccommodate(len)) {
+    conBuf_.push(overflow.begin(), len);
+  } else {
+    // 留在原处，回调处理完消费缓冲区后再取
+    backlogged_ = true;
+    return total;
+  }
+  overflow.reset();
+  overflowBytes_.fetch_sub(len, std::memory_order_relaxed);
+  // 扩容过的溢出缓冲区不再保留，避免每个线程各占一份大块内存
+  if (overflow.capacity() > THRESHOLD_BUFFER_SIZE) {
+    released = std::move(queue.overflow);
+  }
+  queue.overflowing.store(false, std::memory_order_release);
+  return total + len;
+}
+
+bool AsyncLooper::hasPendingWork() {
+  std::lock_guard<std::mutex> lock(queuesMutex_);
+  for (const auto &queue : queues_) {
+    if (queue->ring.readAbleSize() >= RING_NOTIFY_SIZE ||
+        queue->overflowing.load(std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AsyncLooper::flush() {
+  try {
+    callBack_(conBuf_);
+  } catch (const std::exception &e) {
+    std::cerr << "AsyncLooper callback exception: " << e.what() << std::endl;
+  } catch (...) {
+    std::cerr << "AsyncLooper callback unknown exception" << std::endl;
+  }
+  conBuf_.reset();
+  dirty_ = true;
+}
+
+void AsyncLooper::setIdleCallback(IdleFunctor func) {
+  std::lock_guard<std::mutex> lock(idleMutex_);
+  idleCallBack_ = std::move(func);
+}
+
+void AsyncLooper::idle() {
+  dirty_ = false;
+  std::lock_guard<std::mutex> lock(idleMutex_);
+  if (!idleCallBack_) {
+    return;
+  }
+  try {
+    idleCallBack_();
+  } catch (const std::exception &e) {
+    std::cerr << "AsyncLooper idle callback exception: " << e.what()
+              << std::endl;
+  } catch (...) {
+    std::cerr << "AsyncLooper idle callback unknown exception" << std::endl;
+  }
 }
 
 void AsyncLooper::threadEntry() {
+  auto deadline = std::chrono::steady_clock::now() + milliseco_;
   while (true) {
-    {
-      // 1. 等待条件满足
-      std::unique_lock<Spinlock> lock(mutex_);
-
-      // 检查是否需要退出或有数据
-      if (proBuf_.empty() && stop_) {
-        break;
-      }
+    // 1. 先读停止标志再收集，保证stop()之前的push都会被处理
+    const bool stopping = stop_.load(std::memory_order_acquire);
+    const size_t drained = drainQueues();
 
-      // 等待，超时返回
-      condCon_.wait_for(lock, milliseco_, [this]() {
-        return (proBuf_.readAbleSize() >= FLUSH_BUFFER_SIZE) || stop_;
-      });
+    // 2. 唤醒等待空间的生产者
+    if (drained > 0 && blockedProducers_.load(std::memory_order_relaxed) > 0) {
+      condPro_.notify_all();
+    }
 
-      // 2. 交换缓冲区
-      if (proBuf_.empty()) {
-        if (stop_)
-          break;
-        continue; // 虚假唤醒或超时但无数据
+    // 3. 攒够阈值、消费缓冲区放不下、超时或停止时处理数据
+    const auto now = std::chrono::steady_clock::now();
+    if (!conBuf_.empty() &&
+        (stopping || backlogged_ ||
+         conBuf_.readAbleSize() >= FLUSH_BUFFER_SIZE || now >= deadline)) {
+      flush();
+      deadline = now + milliseco_;
+      continue;
+    }
+    if (stopping) {
+      if (dirty_) {
+        idle();
       }
-      conBuf_.swap(proBuf_);
-
-      // 3. 唤醒生产者
-      condPro_.notify_one();
+      break;
+    }
+    if (conBuf_.empty()) {
+      deadline = now + milliseco_;
+    }
+    // 一轮没有收集到数据，视为空闲
+    if (dirty_ && drained == 0) {
+      idle();
+      continue;
     }
 
-    // 4.处理数据并初始化
-    try {
-      callBack_(conBuf_);
-    } catch (const std::exception &e) {
-      std::cerr << "AsyncLooper callback exception: " << e.what() << std::endl;
-    } catch (...) {
-      std::cerr << "AsyncLooper callback unknown exception" << std::endl;
+    // 4. 等待，超时返回；与push中的fence配对，避免错过唤醒
+    std::unique_lock<std::mutex> lock(waitMutex_);
+    sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!stop_.load(std::memory_order_relaxed) && !hasPendingWork()) {
+      condCon_.wait_until(lock, deadline);
     }
-    conBuf_.reset();
+    sleeping_.store(false, std::memory_order_relaxed);
   }
 }
 
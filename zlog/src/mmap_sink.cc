@@ -0,0 +1,270 @@
+#include "mmap_sink.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+namespace zlog {
+
+static size_t pageSize() {
+  static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+static size_t roundUpToPage(size_t size) {
+  const size_t page = pageSize();
+  return (std::max(size, page) + page - 1) & ~(page - 1);
+}
+
+/**
+ * @brief 预分配文件空间，文件系统不支持fallocate时退回ftruncate
+ */
+static bool reserveFile(int fd, off_t offset, size_t len) {
+  if (::fallocate(fd, 0, offset, static_cast<off_t>(len)) == 0) {
+    return true;
+  }
+  if (errno != EOPNOTSUPP && errno != ENOSYS) {
+    return false;
+  }
+  struct stat st {};
+  if (::fstat(fd, &st) != 0) {
+    return false;
+  }
+  const off_t end = offset + static_cast<off_t>(len);
+  return st.st_size >= end || ::ftruncate(fd, end) == 0;
+}
+
+MmapFileSink::MmapFileSink(const std::string &pathname, size_t segmentSize)
+    : pathname_(pathname), fd_(-1), segmentSize_(roundUpToPage(segmentSize)),
+      map_(nullptr), mapOffset_(0), pos_(0) {
+  File::createDirectory(File::path(pathname_));
+  fd_ = ::open(pathname_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    std::cerr << "MmapFileSink open failed: " << pathname_ << ": "
+              << std::strerror(errno) << std::endl;
+    return;
+  }
+  struct stat st {};
+  const off_t end = ::fstat(fd_, &st) == 0 ? findDataEnd(st.st_size) : 0;
+  if (!mapSegment(end)) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+MmapFileSink::~MmapFileSink() {
+  if (fd_ < 0) {
+    return;
+  }
+  const off_t end = mapOffset_ + static_cast<off_t>(pos_);
+  unmapSegment();
+  // 去掉预分配但未写入的部分
+  if (::ftruncate(fd_, end) != 0) {
+    std::cerr << "MmapFileSink truncate failed: " << pathname_ << ": "
+              << std::strerror(errno) << std::endl;
+  }
+  ::close(fd_);
+}
+
+void MmapFileSink::log(const char *data, size_t len) {
+  while (len > 0 && map_ != nullptr) {
+    const size_t n = std::min(len, segmentSize_ - pos_);
+    std::memcpy(map_ + pos_, data, n);
+    pos_ += n;
+    data += n;
+    len -= n;
+    if (pos_ == segmentSize_) {
+      const off_t next = mapOffset_ + static_cast<off_t>(segmentSize_);
+      unmapSegment();
+      mapSegment(next);
+    }
+  }
+}
+
+void MmapFileSink::flush() {
+  if (map_ != nullptr && pos_ > 0) {
+    ::msync(map_, pos_, MS_ASYNC);
+  }
+}
+
+bool MmapFileSink::mapSegment(off_t offset) {
+  // 映射起点必须按页对齐，offset所在页之前的部分已经是文件内容
+  mapOffset_ = offset & ~static_cast<off_t>(pageSize() - 1);
+  pos_ = static_cast<size_t>(offset - mapOffset_);
+  if (!reserveFile(fd_, mapOffset_, segmentSize_)) {
+    std::cerr << "MmapFileSink fallocate failed: " << pathname_ << ": "
+              << std::strerror(errno) << std::endl;
+    return false;
+  }
+  void *addr = ::mmap(nullptr, segmentSize_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd_, mapOffset_);
+  if (addr == MAP_FAILED) {
+    std::cerr << "MmapFileSink mmap failed: " << pathname_ << ": "
+              << std::strerror(errno) << std::endl;
+    return false;
+  }
+  map_ = static_cast<char *>(addr);
+  return true;
+}
+
+void MmapFileSink::unmapSegment() {
+  if (map_ != nullptr) {
+    ::munmap(map_, segmentSize_);
+    map_ = nullptr;
+  }
+}
+
+off_t MmapFileSink::findDataEnd(off_t fileSize) const {
+  // 崩溃留下的预分配零字节最多一段，从文件末尾向前查找
+  char chunk[4096];
+  off_t end = fileSize;
+  const off_t limit =
+      std::max(static_cast<off_t>(0), fileSize - static_cast<off_t>(segmentSize_));
+  while (end > limit) {
+    const size_t n =
+        static_cast<size_t>(std::min(end - limit, static_cast<off_t>(sizeof(chunk))));
+    if (::pread(fd_, chunk, n, end - static_cast<off_t>(n)) !=
+        static_cast<ssize_t>(n)) {
+      return fileSize;
+    }
+    for (size_t i = n; i > 0; --i) {
+      if (chunk[i - 1] != '\0') {
+        return end - static_cast<off_t>(n - i);
+      }
+    }
+    end -= static_cast<off_t>(n);
+  }
+  return end;
+}
+
+/**
+ * @brief 飞行记录器文件头，独占第一页
+ */
+struct FlightRecorderSink::Header {
+  char magic[8];     // 文件标识
+  uint64_t capacity; // 环形数据区大小
+  uint64_t written;  // 累计写入字节数
+};
+
+static const char kFlightRecorderMagic[8] = {'Z', 'L', 'O', 'G',
+                                             'F', 'R', '1', '\0'};
+
+FlightRecorderSink::FlightRecorderSink(const std::string &pathname,
+                                       size_t capacity)
+    : fd_(-1), capacity_(roundUpToPage(capacity)), map_(nullptr),
+      mapSize_(pageSize() + capacity_), header_(nullptr), data_(nullptr) {
+  File::createDirectory(File::path(pathname));
+  fd_ = ::open(pathname.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    std::cerr << "FlightRecorderSink open failed: " << pathname << ": "
+              << std::strerror(errno) << std::endl;
+    return;
+  }
+  struct stat st {};
+  const bool reuse = ::fstat(fd_, &st) == 0 &&
+                     st.st_size == static_cast<off_t>(mapSize_);
+  if (!reuse && (::ftruncate(fd_, 0) != 0 || !reserveFile(fd_, 0, mapSize_))) {
+    std::cerr << "FlightRecorderSink fallocate failed: " << pathname << ": "
+              << std::strerror(errno) << std::endl;
+    ::close(fd_);
+    fd_ = -1;
+    return;
+  }
+  void *addr = ::mmap(nullptr, mapSize_, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd_, 0);
+  if (addr == MAP_FAILED) {
+    std::cerr << "FlightRecorderSink mmap failed: " << pathname << ": "
+              << std::strerror(errno) << std::endl;
+    ::close(fd_);
+    fd_ = -1;
+    return;
+  }
+  map_ = static_cast<char *>(addr);
+  header_ = reinterpret_cast<Header *>(map_);
+  data_ = map_ + pageSize();
+  if (std::memcmp(header_->magic, kFlightRecorderMagic,
+                  sizeof(kFlightRecorderMagic)) != 0 ||
+      header_->capacity != capacity_) {
+    header_->capacity = capacity_;
+    header_->written = 0;
+    std::memcpy(header_->magic, kFlightRecorderMagic,
+                sizeof(kFlightRecorderMagic));
+  }
+}
+
+FlightRecorderSink::~FlightRecorderSink() {
+  if (map_ != nullptr) {
+    ::munmap(map_, mapSize_);
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+void FlightRecorderSink::log(const char *data, size_t len) {
+  if (data_ == nullptr || len == 0) {
+    return;
+  }
+  uint64_t written = header_->written;
+  if (len > capacity_) {
+    written += len - capacity_;
+    data += len - capacity_;
+    len = capacity_;
+  }
+  const size_t pos = static_cast<size_t>(written % capacity_);
+  const size_t first = std::min(len, capacity_ - pos);
+  std::memcpy(data_ + pos, data, first);
+  std::memcpy(data_, data + first, len - first);
+  // 数据拷贝完成后才推进写入计数，崩溃时头部不会指向未写完的数据
+  __atomic_store_n(&header_->written, written + len, __ATOMIC_RELEASE);
+}
+
+void FlightRecorderSink::flush() {
+  if (map_ != nullptr) {
+    ::msync(map_, mapSize_, MS_ASYNC);
+  }
+}
+
+std::string FlightRecorderSink::dump(const std::string &pathname) {
+  std::string content;
+  const int fd = ::open(pathname.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return content;
+  }
+  Header header {};
+  struct stat st {};
+  if (::pread(fd, &header, sizeof(header), 0) ==
+          static_cast<ssize_t>(sizeof(header)) &&
+      std::memcmp(header.magic, kFlightRecorderMagic,
+                  sizeof(kFlightRecorderMagic)) == 0 &&
+      header.capacity > 0 && ::fstat(fd, &st) == 0 &&
+      static_cast<uint64_t>(st.st_size) == pageSize() + header.capacity) {
+    const size_t capacity = static_cast<size_t>(header.capacity);
+    const size_t len =
+        static_cast<size_t>(std::min<uint64_t>(header.written, capacity));
+    const size_t start =
+        static_cast<size_t>((header.written - len) % capacity);
+    content.resize(len);
+    const size_t first = std::min(len, capacity - start);
+    const off_t base = static_cast<off_t>(pageSize());
+    if (::pread(fd, &content[0], first, base + static_cast<off_t>(start)) !=
+            static_cast<ssize_t>(first) ||
+        ::pread(fd, &content[first], len - first, base) !=
+            static_cast<ssize_t>(len - first)) {
+      content.clear();
+    } else if (header.written > capacity) {
+      // 回绕后最早的一条日志可能只剩后半部分
+      const size_t newline = content.find('\n');
+      content.erase(0, newline == std::string::npos ? 0 : newline + 1);
+    }
+  }
+  ::close(fd);
+  return content;
+}
+} // namespace zlog
@@ -0,0 +1,79 @@
+#include "ring_buffer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace zlog {
+
+static size_t roundUpPowerOfTwo(size_t n) {
+  size_t result = 1;
+  while (result < n) {
+    result <<= 1;
+  }
+  return result;
+}
+
+SpscRingBuffer::SpscRingBuffer(const size_t capacity)
+    : data_(nullptr), capacity_(roundUpPowerOfTwo(capacity)),
+      mask_(capacity_ - 1), writerIdx_(0), cachedReaderIdx_(0),
+      readerIdx_(0) {
+  data_ = static_cast<char *>(std::malloc(capacity_));
+  if (!data_) {
+    throw std::bad_alloc();
+  }
+}
+
+SpscRingBuffer::~SpscRingBuffer() { std::free(data_); }
+
+bool SpscRingBuffer::push(const char *data, const size_t len) {
+  const size_t writer = writerIdx_.load(std::memory_order_relaxed);
+  if (capacity_ - (writer - cachedReaderIdx_) < len) {
+    // 缓存的读下标可能已过期，重新读取一次
+    cachedReaderIdx_ = readerIdx_.load(std::memory_order_acquire);
+    if (capacity_ - (writer - cachedReaderIdx_) < len) {
+      return false;
+    }
+  }
+
+  const size_t offset = writer & mask_;
+  const size_t first = std::min(len, capacity_ - offset);
+  __builtin_memcpy(data_ + offset, data, first);
+  __builtin_memcpy(data_, data + first, len - first); // 回绕部分
+  writerIdx_.store(writer + len, std::memory_order_release);
+  return true;
+}
+
+size_t SpscRingBuffer::producerSize(const bool refresh) {
+  if (refresh) {
+    cachedReaderIdx_ = readerIdx_.load(std::memory_order_acquire);
+  }
+  return writerIdx_.load(std::memory_order_relaxed) - cachedReaderIdx_;
+}
+
+size_t SpscRingBuffer::popTo(Buffer &out) {
+  const size_t reader = readerIdx_.load(std::memory_order_relaxed);
+  const size_t writer = writerIdx_.load(std::memory_order_acquire);
+  const size_t len = writer - reader;
+  // 目标缓冲区无法扩容到足够大时push()不会写入，数据留在原处
+  if (len == 0 || !out.canAccommodate(len)) {
+    return 0;
+  }
+
+  const size_t offset = reader & mask_;
+  const size_t first = std::min(len, capacity_ - offset);
+  out.push(data_ + offset, first);
+  if (len > first) {
+    out.push(data_, len - first);
+  }
+  readerIdx_.store(writer, std::memory_order_release);
+  return len;
+}
+
+size_t SpscRingBuffer::readAbleSize() const {
+  // 先读读下标：写下标单调递增，之后读到的值不会小于它
+  const size_t reader = readerIdx_.load(std::memory_order_acquire);
+  return writerIdx_.load(std::memory_order_acquire) - reader;
+}
+
+} // namespace zlog
@@ -0,0 +1,437 @@
+#include "rolling_sink.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#ifdef ZLOG_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace zlog {
+
+static constexpr int ROLLING_THREAD_NICE = 19; // 后台线程的nice值
+
+static int openLogFile(const std::string &path, bool truncate) {
+  return ::open(path.c_str(),
+                O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC |
+                    (truncate ? O_TRUNC : 0),
+                0644);
+}
+
+/**
+ * @brief 写出全部数据，处理EINTR和部分写
+ */
+static bool writeFully(int fd, const char *data, size_t len) {
+  while (len > 0) {
+    const ssize_t n = ::write(fd, data, len);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += n;
+    len -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+static bool pathExists(const std::string &path) {
+  struct stat st {};
+  return ::stat(path.c_str(), &st) == 0;
+}
+
+/**
+ * @brief 判断是否为本落地器的下一个文件名：stem.log.next或stem.log.next.N
+ * @param seq 输出N，stem.log.next输出-1
+ */
+static bool isNextName(const std::string &name, const std::string &stem,
+                       long &seq) {
+  const std::string prefix = stem + ".log.next";
+  if (name.compare(0, prefix.size(), prefix) != 0) {
+    return false;
+  }
+  if (name.size() == prefix.size()) {
+    seq = -1;
+    return true;
+  }
+  if (name.size() == prefix.size() + 1 || name[prefix.size()] != '.') {
+    return false;
+  }
+  seq = 0;
+  for (size_t i = prefix.size() + 1; i < name.size(); ++i) {
+    if (name[i] < '0' || name[i] > '9') {
+      return false;
+    }
+    seq = seq * 10 + (name[i] - '0');
+  }
+  return true;
+}
+
+/**
+ * @brief 判断是否为本落地器的归档文件名：stem.YYYYmmdd-HHMMSS-NNN.log[.gz]
+ */
+static bool isArchiveName(const std::string &name, const std::string &stem) {
+  if (name.size() < stem.size() + 1 ||
+      name.compare(0, stem.size(), stem) != 0 || name[stem.size()] != '.') {
+    return false;
+  }
+  const std::string rest = name.substr(stem.size() + 1);
+  static const char kPattern[] = "dddddddd-dddddd-ddd.log";
+  const size_t len = sizeof(kPattern) - 1;
+  if (rest.size() < len) {
+    return false;
+  }
+  for (size_t i = 0; i < len; ++i) {
+    const bool ok = kPattern[i] == 'd' ? (rest[i] >= '0' && rest[i] <= '9')
+                                       : rest[i] == kPattern[i];
+    if (!ok) {
+      return false;
+    }
+  }
+  return rest.size() == len || rest.compare(len, std::string::npos, ".gz") == 0;
+}
+
+RollingFileSink::RollingFileSink(std::string basename,
+                                 const RollingOptions &options)
+    : basename_(std::move(basename)), options_(options),
+      activePath_(basename_ + ".log"), nextPath_(basename_ + ".log.next"),
+      fd_(-1), curSize_(0), openTime_(Date::getCurrentTime()), rollTime_(0),
+      fallbackCount_(0), nextFd_(-1), busy_(false), stop_(false) {
+  File::createDirectory(File::path(activePath_));
+  // 有遗留的下一个文件时，其中的数据最新，继续写入最后一个
+  const std::string writePath = recoverPending();
+  fd_ = openLogFile(writePath, false);
+  if (fd_ < 0) {
+    std::cerr << "RollingFileSink open failed: " << writePath << ": "
+              << std::strerror(errno) << std::endl;
+  } else {
+    struct stat st {};
+    if (::fstat(fd_, &st) == 0) {
+      curSize_ = static_cast<size_t>(st.st_size);
+    }
+  }
+  if (options_.interval > 0) {
+    rollTime_ = nextRollTime(openTime_);
+  }
+  thread_ = std::thread(&RollingFileSink::threadEntry, this);
+}
+
+RollingFileSink::~RollingFileSink() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+  thread_.join();
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+  if (nextFd_ >= 0) {
+    ::close(nextFd_);
+    ::unlink(nextPath_.c_str());
+  }
+}
+
+void RollingFileSink::log(const char *data, size_t len) {
+  if (rollTime_ > 0) {
+    const time_t now = Date::getCurrentTime();
+    if (now >= rollTime_) {
+      rollOver(now);
+    }
+  }
+  if (options_.maxSize > 0 && curSize_ > 0 &&
+      curSize_ + len > options_.maxSize) {
+    rollOver(Date::getCurrentTime());
+  }
+  if (fd_ < 0) {
+    return;
+  }
+  if (!writeFully(fd_, data, len)) {
+    std::cerr << "RollingFileSink write failed: " << std::strerror(errno)
+              << std::endl;
+  }
+  curSize_ += len;
+}
+
+void RollingFileSink::waitIdle() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idleCond_.wait(lock, [this]() { return tasks_.empty() && !busy_; });
+}
+
+bool RollingFileSink::compressionSupported() {
+#ifdef ZLOG_HAVE_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
+void RollingFileSink::rollOver(time_t now) {
+  RollTask task;
+  task.oldFd = fd_;
+  task.openTime = openTime_;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fd_ = nextFd_;
+    nextFd_ = -1;
+  }
+  if (fd_ >= 0) {
+    task.newPath = nextPath_;
+  } else {
+    // 后台线程还没准备好下一个文件，只能同步打开一个临时文件
+    task.newPath = fmt::format("{}.{}", nextPath_, fallbackCount_++);
+    fd_ = openLogFile(task.newPath, true);
+    if (fd_ < 0) {
+      std::cerr << "RollingFileSink open failed: " << task.newPath << ": "
+                << std::strerror(errno) << std::endl;
+    }
+  }
+  curSize_ = 0;
+  openTime_ = now;
+  if (rollTime_ > 0) {
+    rollTime_ = nextRollTime(now);
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  cond_.notify_one();
+}
+
+time_t RollingFileSink::nextRollTime(time_t now) const {
+  // 按本地时间对齐，例如interval为3600时在每个整点滚动
+  struct tm lt {};
+  localtime_r(&now, &lt);
+  const time_t local = now + lt.tm_gmtoff;
+  return (local / options_.interval + 1) * options_.interval - lt.tm_gmtoff;
+}
+
+void RollingFileSink::threadEntry() {
+  // 降低后台线程优先级，避免与业务线程争抢CPU
+  ::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)),
+                ROLLING_THREAD_NICE);
+  bool prepareFailed = false; // 失败后等到下次滚动再重试
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    if (!tasks_.empty()) {
+      RollTask task = std::move(tasks_.front());
+      tasks_.pop_front();
+      busy_ = true;
+      lock.unlock();
+      archive(task);
+      lock.lock();
+      busy_ = false;
+      prepareFailed = false;
+      continue;
+    }
+    if (stop_) {
+      break;
+    }
+    // 全部任务处理完后再准备下一个文件，保证.next路径同一时间只被一个文件使用
+    if (nextFd_ < 0 && !prepareFailed) {
+      busy_ = true;
+      lock.unlock();
+      prepareFailed = !prepareNext();
+      lock.lock();
+      busy_ = false;
+      continue;
+    }
+    idleCond_.notify_all();
+    cond_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+  }
+  idleCond_.notify_all();
+}
+
+std::string RollingFileSink::recoverPending() {
+  const size_t slash = basename_.find_last_of('/');
+  const std::string dir =
+      slash == std::string::npos ? "." : basename_.substr(0, slash + 1);
+  const std::string stem =
+      slash == std::string::npos ? basename_ : basename_.substr(slash + 1);
+
+  std::vector<std::pair<long, std::string>> pending;
+  DIR *d = ::opendir(dir.c_str());
+  if (d == nullptr) {
+    return activePath_;
+  }
+  while (struct dirent *entry = ::readdir(d)) {
+    const std::string name = entry->d_name;
+    long seq = 0;
+    if (isNextName(name, stem, seq)) {
+      pending.emplace_back(seq, slash == std::string::npos ? name : dir + name);
+    }
+  }
+  ::closedir(d);
+
+  // 滚动时先用预先打开的.next，归档完成前的后续滚动依次用.next.N
+  std::sort(pending.begin(), pending.end());
+  std::string writePath = activePath_;
+  for (const auto &entry : pending) {
+    if (entry.first >= 0) {
+      fallbackCount_ = static_cast<size_t>(entry.first) + 1;
+    }
+    struct stat st {};
+    if (::stat(entry.second.c_str(), &st) != 0 || st.st_size == 0) {
+      // 空文件是预先打开但未使用的，或滚动后没有写入，没有数据可恢复
+      ::unlink(entry.second.c_str());
+      continue;
+    }
+    // 开始写入时间已无从得知，用上一个文件的修改时间代替，保持归档顺序
+    struct stat prev {};
+    RollTask task;
+    task.oldFd = -1;
+    task.openTime = ::stat(writePath.c_str(), &prev) == 0 ? prev.st_mtime
+                                                          : st.st_mtime;
+    task.newPath = entry.second;
+    tasks_.push_back(std::move(task));
+    writePath = entry.second;
+  }
+  return writePath;
+}
+
+void RollingFileSink::archive(const RollTask &task) {
+  if (task.oldFd >= 0) {
+    ::close(task.oldFd);
+  }
+
+  struct tm lt {};
+  localtime_r(&task.openTime, &lt);
+  char timeStr[32];
+  strftime(timeStr, sizeof(timeStr), "%Y%m%d-%H%M%S", &lt);
+  std::string archivePath;
+  for (size_t seq = 0;; ++seq) {
+    archivePath = fmt::format("{}.{}-{:03}.log", basename_, timeStr, seq);
+    if (!pathExists(archivePath) && !pathExists(archivePath + ".gz")) {
+      break;
+    }
+  }
+
+  // 两次重命名都不影响已打开的描述符，写日志的线程不受影响；
+  // 上次进程在两次重命名之间退出时当前文件已不存在
+  const bool hasActive = pathExists(activePath_);
+  if (hasActive && ::rename(activePath_.c_str(), archivePath.c_str()) != 0) {
+    std::cerr << "RollingFileSink rename failed: " << activePath_ << ": "
+              << std::strerror(errno) << std::endl;
+  }
+  if (::rename(task.newPath.c_str(), activePath_.c_str()) != 0) {
+    std::cerr << "RollingFileSink rename failed: " << task.newPath << ": "
+              << std::strerror(errno) << std::endl;
+  }
+
+  if (hasActive && options_.compress && compressionSupported()) {
+    compressFile(archivePath);
+  }
+  applyRetention();
+}
+
+bool RollingFileSink::prepareNext() {
+  const int fd = openLogFile(nextPath_, true);
+  if (fd < 0) {
+    std::cerr << "RollingFileSink open failed: " << nextPath_ << ": "
+              << std::strerror(errno) << std::endl;
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  nextFd_ = fd;
+  return true;
+}
+
+std::string RollingFileSink::compressFile(const std::string &path) {
+#ifdef ZLOG_HAVE_ZLIB
+  const std::string gzPath = path + ".gz";
+  const std::string tmpPath = gzPath + ".tmp";
+  const int in = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (in < 0) {
+    return path;
+  }
+  gzFile out = gzopen(tmpPath.c_str(), "wb6");
+  bool ok = out != nullptr;
+  std::vector<char> chunk(64 * 1024);
+  while (ok) {
+    const ssize_t n = ::read(in, chunk.data(), chunk.size());
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      ok = n == 0;
+      break;
+    }
+    ok = gzwrite(out, chunk.data(), static_cast<unsigned>(n)) == n;
+  }
+  ::close(in);
+  if (out != nullptr && gzclose(out) != Z_OK) {
+    ok = false;
+  }
+  if (!ok || ::rename(tmpPath.c_str(), gzPath.c_str()) != 0) {
+    std::cerr << "RollingFileSink compress failed: " << path << std::endl;
+    ::unlink(tmpPath.c_str());
+    return path;
+  }
+  ::unlink(path.c_str());
+  return gzPath;
+#else
+  return path;
+#endif
+}
+
+void RollingFileSink::applyRetention() {
+  if (options_.maxFiles == 0 && options_.maxTotalBytes == 0) {
+    return;
+  }
+  const size_t slash = basename_.find_last_of('/');
+  const std::string dir =
+      slash == std::string::npos ? "." : basename_.substr(0, slash + 1);
+  const std::string stem =
+      slash == std::string::npos ? basename_ : basename_.substr(slash + 1);
+
+  std::vector<std::pair<std::string, size_t>> archives;
+  DIR *d = ::opendir(dir.c_str());
+  if (d == nullptr) {
+    return;
+  }
+  while (struct dirent *entry = ::readdir(d)) {
+    const std::string name = entry->d_name;
+    if (!isArchiveName(name, stem)) {
+      continue;
+    }
+    const std::string path =
+        slash == std::string::npos ? name : dir + name;
+    struct stat st {};
+    if (::stat(path.c_str(), &st) == 0) {
+      archives.emplace_back(path, static_cast<size_t>(st.st_size));
+    }
+  }
+  ::closedir(d);
+
+  // 名称中的时间和序号定宽，按名称排序即按时间排序
+  std::sort(archives.begin(), archives.end());
+  size_t total = 0;
+  for (const auto &archive : archives) {
+    total += archive.second;
+  }
+  size_t count = archives.size();
+  for (const auto &archive : archives) {
+    const bool tooMany = options_.maxFiles > 0 && count > options_.maxFiles;
+    const bool tooLarge =
+        options_.maxTotalBytes > 0 && total > options_.maxTotalBytes;
+    if (!tooMany && !tooLarge) {
+      break;
+    }
+    ::unlink(archive.first.c_str());
+    total -= archive.second;
+    --count;
+  }
+}
+} // namespace zlog
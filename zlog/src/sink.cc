@@ -1,12 +1,39 @@
 #include "sink.h"
 
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+
 #include "util.h"
 namespace zlog {
 
+/**
+ * @brief 生成滚动文件名：基础名_时间-序号.log
+ */
+static std::string rollFileName(const std::string &basename, size_t count) {
+  time_t t = Date::getCurrentTime();
+  struct tm lt {};
+  localtime_r(&t, &lt);
+  // 先将时间格式化为字符串
+  char timeStr[64];
+  strftime(timeStr, sizeof(timeStr), "%Y%m%d%H%M%S", &lt);
+
+  return fmt::format("{}_{}-{}.log", basename, timeStr, count);
+}
+
 void StdOutSink::log(const char *data, size_t len) {
-  fmt::print(stdout, "{:.{}}", data, len);
+  fwrite(data, 1, len, stdout);
 }
 
+void StdOutSink::flush() { fflush(stdout); }
+
 FileSink::FileSink(std::string pathname, bool autoFlush)
     : pathname_(std::move(pathname)), autoFlush_(autoFlush) {
   File::createDirectory(File::path(pathname_));
@@ -16,13 +43,15 @@ FileSink::FileSink(std::string pathname, bool autoFlush)
 }
 
 void FileSink::log(const char *data, size_t len) {
-  fmt::print(ofs_, "{:.{}}", data, len);
+  ofs_.write(data, static_cast<std::streamsize>(len));
   // 只在启用autoFlush时才每次flush，否则依赖系统缓冲
   if (autoFlush_) {
     ofs_.flush();
   }
 }
 
+void FileSink::flush() { ofs_.flush(); }
+
 RollBySizeSink::RollBySizeSink(std::string basename, const size_t maxSize,
                                bool autoFlush)
     : basename_(std::move(basename)), maxSize_(maxSize), curSize_(0),
@@ -39,25 +68,17 @@ void RollBySizeSink::log(const char *data, size_t len) {
   if (curSize_ + len > maxSize_) {
     rollOver();
   }
-  fmt::print(ofs_, "{:.{}}", data, len);
+  ofs_.write(data, static_cast<std::streamsize>(len));
   if (autoFlush_) {
     ofs_.flush();
   }
   curSize_ += len;
 }
 
-std::string RollBySizeSink::createNewFile() {
-  time_t t = Date::getCurrentTime();
-  struct tm lt {};
-  localtime_r(&t, &lt);
-  // 先将时间格式化为字符串
-  char timeStr[64];
-  strftime(timeStr, sizeof(timeStr), "%Y%m%d%H%M%S", &lt);
-
-  std::string pathname =
-      fmt::format("{}_{}-{}.log", basename_, timeStr, nameCount_++);
+void RollBySizeSink::flush() { ofs_.flush(); }
 
-  return pathname;
+std::string RollBySizeSink::createNewFile() {
+  return rollFileName(basename_, nameCount_++);
 }
 
 void RollBySizeSink::rollOver() {
@@ -67,4 +88,266 @@ void RollBySizeSink::rollOver() {
   curSize_ = 0;
 }
 
+/**
+ * @brief 写出全部数据，处理EINTR和部分写
+ * @param offset 小于0时使用write，否则使用pwrite
+ */
+static bool writeAll(int fd, const char *data, size_t len, off_t offset) {
+  while (len > 0) {
+    const ssize_t n = offset < 0 ? ::write(fd, data, len)
+                                 : ::pwrite(fd, data, len, offset);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += n;
+    len -= static_cast<size_t>(n);
+    if (offset >= 0) {
+      offset += n;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief 用一次writev写出两段数据，处理EINTR和部分写
+ */
+static bool writevAll(int fd, struct iovec *iov, int count) {
+  while (count > 0) {
+    const ssize_t n = ::writev(fd, iov, count);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    size_t left = static_cast<size_t>(n);
+    while (count > 0 && left >= iov->iov_len) {
+      left -= iov->iov_len;
+      ++iov;
+      --count;
+    }
+    if (count > 0) {
+      iov->iov_base = static_cast<char *>(iov->iov_base) + left;
+      iov->iov_len -= left;
+    }
+  }
+  return true;
+}
+
+FdSink::FdSink(size_t bufferSize, bool directIo, size_t syncBytes)
+    : fd_(-1), directFd_(-1), buffer_(nullptr),
+      capacity_((std::max(bufferSize, DIRECT_IO_ALIGN) + DIRECT_IO_ALIGN - 1) &
+                ~(DIRECT_IO_ALIGN - 1)),
+      size_(0), tailWritten_(0), fileOffset_(0), wantDirectIo_(directIo),
+      syncBytes_(syncBytes), unsyncedBytes_(0),
+      lastFlushTime_(Date::getCurrentTime()) {
+  void *buffer = nullptr;
+  if (posix_memalign(&buffer, DIRECT_IO_ALIGN, capacity_) != 0) {
+    throw std::bad_alloc();
+  }
+  buffer_ = static_cast<char *>(buffer);
+}
+
+FdSink::~FdSink() {
+  closeFile();
+  free(buffer_);
+}
+
+void FdSink::openFile(const std::string &pathname) {
+  File::createDirectory(File::path(pathname));
+  size_ = 0;
+  tailWritten_ = 0;
+  fileOffset_ = 0;
+  if (wantDirectIo_) {
+    // O_DIRECT只写对齐的整块，尾部通过普通描述符按偏移写入
+    fd_ = ::open(pathname.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ >= 0) {
+      directFd_ =
+          ::open(pathname.c_str(), O_WRONLY | O_DIRECT | O_CLOEXEC);
+      if (directFd_ < 0) {
+        // 文件系统不支持O_DIRECT（如tmpfs），退回普通追加写
+        ::close(fd_);
+        fd_ = -1;
+      }
+    }
+    if (directFd_ >= 0) {
+      // 已有文件末尾不足一块的数据读回缓冲区，之后整块覆盖写
+      const off_t end = ::lseek(fd_, 0, SEEK_END);
+      fileOffset_ = end & ~static_cast<off_t>(DIRECT_IO_ALIGN - 1);
+      const size_t tail = static_cast<size_t>(end - fileOffset_);
+      if (tail > 0 &&
+          ::pread(fd_, buffer_, tail, fileOffset_) != static_cast<ssize_t>(tail)) {
+        std::cerr << "FdSink read tail failed: " << pathname << std::endl;
+        fileOffset_ = end;
+      } else {
+        size_ = tail;
+        tailWritten_ = tail;
+      }
+      return;
+    }
+  }
+  fd_ = ::open(pathname.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+               0644);
+  if (fd_ < 0) {
+    std::cerr << "FdSink open failed: " << pathname << ": "
+              << std::strerror(errno) << std::endl;
+  }
+}
+
+void FdSink::closeFile() {
+  if (fd_ < 0) {
+    return;
+  }
+  writeOut(true);
+  maybeSync(0, true);
+  if (directFd_ >= 0) {
+    ::close(directFd_);
+    directFd_ = -1;
+  }
+  ::close(fd_);
+  fd_ = -1;
+}
+
+void FdSink::log(const char *data, size_t len) {
+  append(data, len);
+  // 同步日志器没有空闲回调，跨秒后的第一条日志顺带写出之前的数据；
+  // 此后不再有日志时数据留在缓冲区，直到flush()或析构
+  const time_t now = Date::getCurrentTime();
+  if (now != lastFlushTime_) {
+    writeOut(true);
+    lastFlushTime_ = now;
+  }
+}
+
+void FdSink::flush() {
+  writeOut(true);
+  lastFlushTime_ = Date::getCurrentTime();
+}
+
+void FdSink::append(const char *data, size_t len) {
+  if (fd_ < 0) {
+    return;
+  }
+  if (directFd_ < 0) {
+    if (len <= capacity_ - size_) {
+      std::memcpy(buffer_ + size_, data, len);
+      size_ += len;
+      if (size_ == capacity_) {
+        writeOut(true);
+      }
+      return;
+    }
+    // 放不下：暂存数据和本条日志一次writev写出，不再拷贝
+    struct iovec iov[2];
+    iov[0].iov_base = buffer_;
+    iov[0].iov_len = size_;
+    iov[1].iov_base = const_cast<char *>(data);
+    iov[1].iov_len = len;
+    if (!writevAll(fd_, iov, 2)) {
+      std::cerr << "FdSink writev failed: " << std::strerror(errno)
+                << std::endl;
+    }
+    maybeSync(size_ + len, false);
+    size_ = 0;
+    return;
+  }
+  // O_DIRECT要求从对齐的缓冲区写出，只能分段拷贝
+  while (len > 0) {
+    const size_t n = std::min(len, capacity_ - size_);
+    std::memcpy(buffer_ + size_, data, n);
+    size_ += n;
+    data += n;
+    len -= n;
+    if (size_ == capacity_) {
+      writeOut(false);
+    }
+  }
+}
+
+void FdSink::writeOut(bool includeTail) {
+  if (fd_ < 0 || size_ == 0) {
+    return;
+  }
+  if (directFd_ < 0) {
+    if (!writeAll(fd_, buffer_, size_, -1)) {
+      std::cerr << "FdSink write failed: " << std::strerror(errno)
+                << std::endl;
+    }
+    maybeSync(size_, false);
+    size_ = 0;
+    return;
+  }
+
+  const size_t aligned = size_ & ~(DIRECT_IO_ALIGN - 1);
+  if (aligned > 0) {
+    if (!writeAll(directFd_, buffer_, aligned, fileOffset_)) {
+      // O_DIRECT写失败（如块大小不匹配），整体退回普通写
+      std::cerr << "FdSink direct write failed, fallback to buffered: "
+                << std::strerror(errno) << std::endl;
+      ::close(directFd_);
+      directFd_ = -1;
+      if (!writeAll(fd_, buffer_, size_, fileOffset_)) {
+        std::cerr << "FdSink write failed: " << std::strerror(errno)
+                  << std::endl;
+      }
+      ::lseek(fd_, 0, SEEK_END);
+      maybeSync(size_, false);
+      size_ = 0;
+      return;
+    }
+    fileOffset_ += static_cast<off_t>(aligned);
+    size_ -= aligned;
+    std::memmove(buffer_, buffer_ + aligned, size_);
+    tailWritten_ = tailWritten_ > aligned ? tailWritten_ - aligned : 0;
+    maybeSync(aligned, false);
+  }
+  if (includeTail && size_ > tailWritten_) {
+    if (!writeAll(fd_, buffer_ + tailWritten_, size_ - tailWritten_,
+                  fileOffset_ + static_cast<off_t>(tailWritten_))) {
+      std::cerr << "FdSink write failed: " << std::strerror(errno)
+                << std::endl;
+    }
+    maybeSync(size_ - tailWritten_, false);
+    tailWritten_ = size_;
+  }
+}
+
+void FdSink::maybeSync(size_t written, bool force) {
+  if (syncBytes_ == 0) {
+    return;
+  }
+  unsyncedBytes_ += written;
+  if (unsyncedBytes_ >= syncBytes_ || (force && unsyncedBytes_ > 0)) {
+    ::fdatasync(fd_);
+    unsyncedBytes_ = 0;
+  }
+}
+
+FdFileSink::FdFileSink(const std::string &pathname, size_t bufferSize,
+                       bool directIo, size_t syncBytes)
+    : FdSink(bufferSize, directIo, syncBytes) {
+  openFile(pathname);
+}
+
+RollBySizeFdSink::RollBySizeFdSink(std::string basename, size_t maxSize,
+                                   size_t bufferSize, bool directIo,
+                                   size_t syncBytes)
+    : FdSink(bufferSize, directIo, syncBytes), basename_(std::move(basename)),
+      maxSize_(maxSize), curSize_(0), nameCount_(0) {
+  openFile(rollFileName(basename_, nameCount_++));
+}
+
+void RollBySizeFdSink::log(const char *data, size_t len) {
+  if (curSize_ > 0 && curSize_ + len > maxSize_) {
+    closeFile();
+    openFile(rollFileName(basename_, nameCount_++));
+    curSize_ = 0;
+  }
+  FdSink::log(data, len);
+  curSize_ += len;
+}
+
 } // namespace zlog
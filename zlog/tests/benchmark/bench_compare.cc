@@ -205,6 +205,62 @@ void test_zlog_async_unsafe(int thread_count, size_t message_size) {
   std::this_thread::sleep_for(std::chrono::seconds(1));
 }
 
+// Zlog 同步模式 + 文件描述符落地器测试
+void test_zlog_sync_fd(int thread_count, size_t message_size) {
+  prepare_log_dir();
+
+  auto formatter = std::make_shared<zlog::Formatter>(kBenchPattern);
+  std::vector<zlog::LogSink::ptr> sinks;
+  sinks.push_back(
+      std::make_shared<zlog::FdFileSink>("bench_logs/zlog_sync_fd.log"));
+
+  // 所有线程共用一个 logger
+  auto logger = std::make_shared<zlog::SyncLogger>(
+      "bench_sync_fd", zlog::LogLevel::value::INFO, formatter, sinks);
+
+  std::string msg = make_string(message_size);
+
+  auto result = run_timed_benchmark(
+      "Zlog-Sync-Fd", thread_count, message_size, [&](int thread_id) {
+        (void)thread_id;
+        logger->logImpl(zlog::LogLevel::value::INFO, "", 0, msg.c_str());
+      });
+
+  g_results.push_back(result);
+  logger.reset();
+  cleanup_log_dir();
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+}
+
+// Zlog 异步模式 (ASYNC_SAFE) + 文件描述符落地器测试
+void test_zlog_async_fd(int thread_count, size_t message_size) {
+  prepare_log_dir();
+
+  auto formatter = std::make_shared<zlog::Formatter>(kBenchPattern);
+  std::vector<zlog::LogSink::ptr> sinks;
+  sinks.push_back(
+      std::make_shared<zlog::FdFileSink>("bench_logs/zlog_async_fd.log"));
+
+  // 所有线程共用一个 logger
+  auto logger = std::make_shared<zlog::AsyncLogger>(
+      "bench_async_fd", zlog::LogLevel::value::INFO, formatter, sinks,
+      zlog::AsyncType::ASYNC_SAFE, std::chrono::milliseconds(100));
+
+  std::string msg = make_string(message_size);
+
+  auto result = run_timed_benchmark(
+      "Zlog-Async-Fd", thread_count, message_size, [&](int thread_id) {
+        (void)thread_id;
+        logger->logImpl(zlog::LogLevel::value::INFO, "", 0, msg.c_str());
+      });
+
+  g_results.push_back(result);
+  logger.reset();
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  cleanup_log_dir();
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+}
+
 // Spdlog 同步模式测试
 void test_spdlog_sync(int thread_count, size_t message_size) {
   prepare_log_dir();
@@ -343,6 +399,14 @@ int main() {
       std::cout << " Zlog-Async-Unsafe...";
       test_zlog_async_unsafe(threads, msg_size);
 
+      // Zlog 同步 + 文件描述符落地器
+      std::cout << " Zlog-Sync-Fd...";
+      test_zlog_sync_fd(threads, msg_size);
+
+      // Zlog 异步 + 文件描述符落地器
+      std::cout << " Zlog-Async-Fd...";
+      test_zlog_async_fd(threads, msg_size);
+
       // Spdlog 同步
       std::cout << " Spdlog-Sync...";
       test_spdlog_sync(threads, msg_size);
@@ -0,0 +1,122 @@
+/**
+ * @brief zlog格式化吞吐测试
+ * 单线程反复调用Formatter::format，统计每条日志的格式化耗时与吞吐
+ *
+ * 用法: ./zlog_format_bench [options]
+ *   -c <count>     每个模式格式化的条数 (默认: 2000000)
+ *   -s <size>      日志消息大小(字节) (默认: 64)
+ *   -n <tids>      轮流使用的线程ID个数，模拟异步后台线程
+ *                  为多个生产线程格式化的情形 (默认: 8)
+ */
+#include "format.h"
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace zlog;
+
+struct Config {
+  long long count;
+  int msgSize;
+  int tids;
+
+  Config() : count(2000000), msgSize(64), tids(8) {}
+};
+
+// 收集若干个真实的线程ID
+static std::vector<threadId> collectThreadIds(int n) {
+  std::vector<threadId> ids;
+  ids.push_back(std::this_thread::get_id());
+  for (int i = 1; i < n; i++) {
+    std::thread t([]() {});
+    ids.push_back(t.get_id());
+    t.join();
+  }
+  return ids;
+}
+
+static void runPattern(const Config &cfg, const std::string &pattern,
+                       const std::vector<threadId> &ids) {
+  Formatter formatter(pattern);
+  const std::string payload(static_cast<size_t>(cfg.msgSize), 'x');
+  const LogLevel::value levels[] = {
+      LogLevel::value::DEBUG, LogLevel::value::INFO, LogLevel::value::WARNING,
+      LogLevel::value::ERROR};
+  LogMessage msg(LogLevel::value::INFO, __FILE__, __LINE__, payload.c_str(),
+                 "bench_logger");
+
+  fmt::memory_buffer buffer;
+  size_t bytes = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (long long i = 0; i < cfg.count; i++) {
+    msg.level_ = levels[i & 3];
+    msg.tid_ = ids[static_cast<size_t>(i) % ids.size()];
+    msg.line_ = static_cast<size_t>(i & 1023);
+    buffer.clear();
+    formatter.format(buffer, msg);
+    bytes += buffer.size();
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  const double seconds = std::chrono::duration<double>(end - start).count();
+  std::cout << std::left << std::setw(44) << pattern << std::right
+            << std::setw(10) << std::fixed << std::setprecision(1)
+            << seconds * 1e9 / static_cast<double>(cfg.count) << " ns"
+            << std::setw(12) << std::setprecision(2)
+            << static_cast<double>(cfg.count) / seconds / 1e6 << " M/s"
+            << std::setw(12) << std::setprecision(1)
+            << static_cast<double>(bytes) / seconds / (1024.0 * 1024.0)
+            << " MB/s\n";
+}
+
+static Config parseArgs(int argc, char *argv[]) {
+  Config cfg;
+  int opt;
+  while ((opt = getopt(argc, argv, "c:s:n:h")) != -1) {
+    switch (opt) {
+    case 'c':
+      cfg.count = std::atoll(optarg);
+      break;
+    case 's':
+      cfg.msgSize = std::atoi(optarg);
+      break;
+    case 'n':
+      cfg.tids = std::max(1, std::atoi(optarg));
+      break;
+    default:
+      std::cout << "Usage: " << argv[0] << " [-c count] [-s size] [-n tids]\n";
+      std::exit(opt == 'h' ? 0 : 1);
+    }
+  }
+  return cfg;
+}
+
+int main(int argc, char *argv[]) {
+  const Config cfg = parseArgs(argc, argv);
+  const std::vector<threadId> ids = collectThreadIds(cfg.tids);
+
+  std::cout << "count=" << cfg.count << " size=" << cfg.msgSize
+            << " tids=" << cfg.tids << "\n";
+  std::cout << std::left << std::setw(44) << "pattern" << std::right
+            << std::setw(13) << "per record" << std::setw(16) << "records"
+            << std::setw(17) << "output" << "\n";
+
+  const char *patterns[] = {
+      "%m%n",
+      "[%p][%c] %m%n",
+      "[%d{%H:%M:%S}][%t][%c][%f:%l][%p]%T%m%n",
+      "%d{%Y-%m-%d %H:%M:%S} %p %t %c %f:%l %m%n",
+  };
+  for (const char *pattern : patterns) {
+    runPattern(cfg, pattern, ids);
+  }
+  return 0;
+}
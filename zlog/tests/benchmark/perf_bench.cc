@@ -3,16 +3,21 @@
  * 用于perf工具采集同步/异步日志器的性能数据
  *
  * 用法: ./zlog_perf_bench [options]
- *   -m <mode>      模式: sync/async/both (默认: both)
+ *   -m <mode>      模式: sync/async/both/mp/binary (默认: both)
+ *                  mp: 异步日志器多生产者吞吐与单次调用延迟分布，
+ *                  线程数从1倍增到-t，遍历各缓冲区满策略
+ *                  binary: 同样的带参数日志，对比调用线程格式化与
+ *                  延迟格式化（DeferredLogger）的调用方开销
  *   -c <count>     日志条数 (默认: 1000000)
  *   -t <threads>   线程数 (默认: 4)
  *   -d <duration>  运行时长(秒)，0表示按条数运行 (默认: 0)
  *   -s <size>      日志消息大小(字节) (默认: 128)
  *   -o <output>    输出目录 (默认: perf_bench_logs)
  */
-#include "logger.h"
 #include "sink.h"
+#include "zlog.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstdlib>
@@ -21,6 +26,7 @@
 #include <iomanip>
 #include <iostream>
 #include <sys/stat.h>
+#include <cstdio>
 #include <thread>
 #include <vector>
 
@@ -233,6 +239,167 @@ void runAsyncBenchmark(const Config &cfg, AsyncType asyncType) {
   printStats("Async Logger (" + typeName + ")", stats, cfg.msgSize);
 }
 
+// 多生产者测试的日志调用方式
+enum class CallStyle {
+  PLAIN,   // 消息本身作为格式串，无参数
+  ARGS,    // 带参数，调用线程格式化
+  DEFERRED // 带参数，DeferredLogger后台格式化
+};
+
+// binary模式的格式串：两种调用方式使用相同的格式和参数
+#define MP_ARGS_FORMAT "seq={} cost={:.3f}ms peer={} payload={}"
+
+// 多生产者测试的一种配置
+struct MpVariant {
+  const char *name;
+  AsyncType asyncType;
+  OverflowPolicy policy;
+  CallStyle style;
+};
+
+static const MpVariant kMpVariants[] = {
+    {"block", AsyncType::ASYNC_SAFE, OverflowPolicy::BLOCK, CallStyle::PLAIN},
+    {"drop", AsyncType::ASYNC_SAFE, OverflowPolicy::DROP, CallStyle::PLAIN},
+    {"spill", AsyncType::ASYNC_UNSAFE, OverflowPolicy::SPILL, CallStyle::PLAIN},
+};
+
+static const MpVariant kBinaryVariants[] = {
+    {"eager", AsyncType::ASYNC_SAFE, OverflowPolicy::BLOCK, CallStyle::ARGS},
+    {"deferred", AsyncType::ASYNC_SAFE, OverflowPolicy::BLOCK,
+     CallStyle::DEFERRED},
+};
+
+// 多生产者测试结果
+struct MpResult {
+  double msgPerSec = 0;
+  double p50Ns = 0;
+  double p99Ns = 0;
+  double maxNs = 0;
+  size_t dropped = 0;
+};
+
+// 多生产者吞吐与延迟：每个线程记录每次logImpl调用的耗时
+MpResult runMultiProducerOnce(const Config &cfg, const MpVariant &variant,
+                              int threadCount) {
+  const std::string logFile =
+      cfg.outputDir + "/mp_" + variant.name + "_bench.log";
+  const long long countPerThread = cfg.count / threadCount;
+  std::vector<std::vector<uint32_t>> latencies(threadCount);
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point end;
+  size_t dropped = 0;
+
+  {
+    Formatter::ptr formatter =
+        std::make_shared<Formatter>("[%d{%H:%M:%S}][%t][%p] %m%n");
+    std::vector<LogSink::ptr> sinks;
+    sinks.push_back(std::make_shared<FileSink>(logFile));
+    std::shared_ptr<AsyncLogger> asyncLogger;
+    std::shared_ptr<DeferredLogger> deferredLogger;
+    Logger *logger = nullptr;
+    if (variant.style == CallStyle::DEFERRED) {
+      deferredLogger = std::make_shared<DeferredLogger>(
+          "mp_bench", LogLevel::value::INFO, formatter, sinks,
+          variant.asyncType, std::chrono::milliseconds(100), variant.policy);
+      logger = deferredLogger.get();
+    } else {
+      asyncLogger = std::make_shared<AsyncLogger>(
+          "mp_bench", LogLevel::value::INFO, formatter, sinks,
+          variant.asyncType, std::chrono::milliseconds(100), variant.policy);
+      logger = asyncLogger.get();
+    }
+    const char *peer = "10.0.0.1:8080";
+
+    const std::string msg = makeMessage(cfg.msgSize);
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+      threads.push_back(std::thread([&, t]() {
+        std::vector<uint32_t> &samples = latencies[t];
+        samples.reserve(countPerThread);
+        ready++;
+        while (!go.load()) {
+        }
+        for (long long i = 0; i < countPerThread; i++) {
+          const auto begin = std::chrono::steady_clock::now();
+          switch (variant.style) {
+          case CallStyle::PLAIN:
+            logger->logImpl(LogLevel::value::INFO, __FILE__, __LINE__,
+                            msg.c_str());
+            break;
+          case CallStyle::ARGS:
+            logger->logImpl(LogLevel::value::INFO, __FILE__, __LINE__,
+                            MP_ARGS_FORMAT, i, i * 0.001, peer, msg);
+            break;
+          case CallStyle::DEFERRED:
+            logger->ZLOG_DEFERRED_INFO(MP_ARGS_FORMAT, i, i * 0.001, peer,
+                                       msg);
+            break;
+          }
+          const auto cost = std::chrono::steady_clock::now() - begin;
+          samples.push_back(static_cast<uint32_t>(std::min<long long>(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(cost)
+                  .count(),
+              UINT32_MAX)));
+        }
+      }));
+    }
+    while (ready.load() < threadCount) {
+    }
+    start = std::chrono::steady_clock::now();
+    go = true;
+    for (size_t i = 0; i < threads.size(); ++i) {
+      threads[i].join();
+    }
+    end = std::chrono::steady_clock::now();
+    dropped = deferredLogger ? deferredLogger->droppedCount()
+                             : asyncLogger->droppedCount();
+  }
+
+  std::vector<uint32_t> all;
+  for (const auto &samples : latencies) {
+    all.insert(all.end(), samples.begin(), samples.end());
+  }
+  MpResult result;
+  if (all.empty()) {
+    return result;
+  }
+  std::sort(all.begin(), all.end());
+  const double seconds =
+      std::chrono::duration<double>(end - start).count();
+  result.msgPerSec = all.size() / seconds;
+  result.p50Ns = all[all.size() / 2];
+  result.p99Ns = all[std::min(all.size() - 1, all.size() * 99 / 100)];
+  result.maxNs = all.back();
+  result.dropped = dropped;
+  return result;
+}
+
+// 多生产者基准测试：线程数从1倍增到cfg.threads
+template <size_t N>
+void runMultiProducerBenchmark(const Config &cfg, const char *title,
+                               const MpVariant (&variants)[N]) {
+  std::cout << "\n[3] Running " << title << "...\n";
+  ensureDir(cfg.outputDir);
+
+  char line[160];
+  snprintf(line, sizeof(line), "%-8s %8s %14s %10s %10s %12s %10s\n",
+           "variant", "threads", "msg/s", "p50_ns", "p99_ns", "max_us",
+           "dropped");
+  std::cout << line;
+  for (const MpVariant &variant : variants) {
+    for (int threads = 1; threads <= cfg.threads; threads *= 2) {
+      const MpResult r = runMultiProducerOnce(cfg, variant, threads);
+      snprintf(line, sizeof(line),
+               "%-8s %8d %14.0f %10.0f %10.0f %12.1f %10zu\n", variant.name,
+               threads, r.msgPerSec, r.p50Ns, r.p99Ns, r.maxNs / 1000.0,
+               r.dropped);
+      std::cout << line;
+    }
+  }
+}
+
 // 解析命令行参数
 Config parseArgs(int argc, char *argv[]) {
   Config cfg;
@@ -262,7 +429,8 @@ Config parseArgs(int argc, char *argv[]) {
     default:
       std::cout
           << "Usage: " << argv[0] << " [options]\n"
-          << "  -m <mode>      Mode: sync/async/both (default: both)\n"
+          << "  -m <mode>      Mode: sync/async/both/mp/binary "
+             "(default: both)\n"
           << "  -c <count>     Log count (default: 1000000)\n"
           << "  -t <threads>   Thread count (default: 4)\n"
           << "  -d <duration>  Duration in seconds, 0 for count-based "
@@ -298,6 +466,16 @@ int main(int argc, char *argv[]) {
     runAsyncBenchmark(cfg, AsyncType::ASYNC_UNSAFE);
   }
 
+  if (cfg.mode == "mp") {
+    runMultiProducerBenchmark(cfg, "Async Multi-Producer Benchmark",
+                              kMpVariants);
+  }
+
+  if (cfg.mode == "binary") {
+    runMultiProducerBenchmark(cfg, "Deferred Binary Logging Benchmark",
+                              kBinaryVariants);
+  }
+
   std::cout << "\n========================================\n";
   std::cout << "Benchmark Complete!\n";
   std::cout << "Log files saved to: " << cfg.outputDir << "\n";
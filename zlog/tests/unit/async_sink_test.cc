@@ -0,0 +1,237 @@
+#include "zlog.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace zlog;
+
+// 可配置写入耗时的捕获落地器
+class SlowSink : public LogSink {
+public:
+  explicit SlowSink(std::chrono::milliseconds delay = std::chrono::milliseconds(0))
+      : delay_(delay), flushes_(0) {}
+
+  void log(const char *data, size_t len) override {
+    std::this_thread::sleep_for(delay_);
+    std::lock_guard<std::mutex> lock(mutex_);
+    text_.append(data, len);
+  }
+
+  void flush() override { flushes_++; }
+
+  std::string text() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return text_;
+  }
+
+  int flushes() const { return flushes_.load(); }
+
+private:
+  std::chrono::milliseconds delay_;
+  std::mutex mutex_;
+  std::string text_;
+  std::atomic<int> flushes_;
+};
+
+// 打开闸门前一直阻塞的计数落地器，只统计字节数不保存数据
+class GatedSink : public LogSink {
+public:
+  GatedSink() : open_(false), bytes_(0) {}
+
+  void log(const char *, size_t len) override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this]() { return open_; });
+    bytes_ += len;
+  }
+
+  void flush() override {}
+
+  void open() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      open_ = true;
+    }
+    cond_.notify_all();
+  }
+
+  size_t bytes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool open_;
+  size_t bytes_;
+};
+
+// ===================== 基本功能测试 =====================
+
+TEST(AsyncSinkTest, ForwardsInOrderAndFlushesWhenIdle) {
+  auto inner = std::make_shared<SlowSink>();
+  std::string expected;
+  {
+    AsyncSink sink(inner);
+    for (int i = 0; i < 1000; i++) {
+      std::string line = "line " + std::to_string(i) + "\n";
+      sink.log(line.c_str(), line.size());
+      expected += line;
+    }
+  }
+  EXPECT_EQ(inner->text(), expected);
+  EXPECT_GE(inner->flushes(), 1);
+}
+
+TEST(AsyncSinkTest, MetricsCountBytesAndBatches) {
+  auto inner = std::make_shared<SlowSink>(std::chrono::milliseconds(1));
+  AsyncSink sink(inner);
+  for (int i = 0; i < 100; i++) {
+    sink.log("0123456789", 10);
+  }
+  while (sink.metrics().bytes < 1000) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  const SinkMetrics metrics = sink.metrics();
+  EXPECT_EQ(metrics.bytes, 1000u);
+  EXPECT_GE(metrics.batches, 1u);
+  EXPECT_LE(metrics.batches, 100u);
+  EXPECT_EQ(metrics.dropped, 0u);
+  EXPECT_GE(metrics.maxWriteNanos, 1000000u);
+  EXPECT_GE(metrics.writeNanos, metrics.maxWriteNanos);
+  EXPECT_GE(metrics.maxLatencyNanos, metrics.maxWriteNanos);
+}
+
+TEST(AsyncSinkTest, BatchingWaitsForDelay) {
+  auto inner = std::make_shared<SlowSink>();
+  AsyncSink sink(inner, OverflowPolicy::BLOCK, DEFAULT_BUFFER_SIZE,
+                 std::chrono::milliseconds(50));
+  for (int i = 0; i < 10; i++) {
+    sink.log("x\n", 2);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(sink.metrics().batches, 0u);
+  while (sink.metrics().bytes < 20) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(sink.metrics().batches, 1u);
+}
+
+// ===================== 队列满策略测试 =====================
+
+TEST(AsyncSinkTest, DropPolicyCountsDrops) {
+  auto inner = std::make_shared<SlowSink>(std::chrono::milliseconds(20));
+  size_t accepted = 0;
+  {
+    AsyncSink sink(inner, OverflowPolicy::DROP, 100);
+    std::string record(40, 'd');
+    for (int i = 0; i < 50; i++) {
+      sink.log(record.c_str(), record.size());
+    }
+    const SinkMetrics metrics = sink.metrics();
+    EXPECT_GT(metrics.dropped, 0u);
+    EXPECT_EQ(metrics.droppedBytes, metrics.dropped * 40);
+    accepted = 50 - metrics.dropped;
+  }
+  EXPECT_EQ(inner->text().size(), accepted * 40);
+}
+
+TEST(AsyncSinkTest, BlockPolicyLosesNothing) {
+  auto inner = std::make_shared<SlowSink>(std::chrono::milliseconds(1));
+  std::string expected;
+  {
+    AsyncSink sink(inner, OverflowPolicy::BLOCK, 256);
+    for (int i = 0; i < 500; i++) {
+      std::string line = "blocked " + std::to_string(i) + "\n";
+      sink.log(line.c_str(), line.size());
+      expected += line;
+    }
+    EXPECT_EQ(sink.metrics().dropped, 0u);
+  }
+  EXPECT_EQ(inner->text(), expected);
+}
+
+TEST(AsyncSinkTest, OversizedRecordIsDroppedUnderEveryPolicy) {
+  // 数据不会被读取，未触碰的页不占物理内存
+  const size_t len = MAX_BUFFER_SIZE + 1;
+  std::unique_ptr<char[]> record(new char[len]);
+  for (OverflowPolicy policy : {OverflowPolicy::BLOCK, OverflowPolicy::DROP,
+                                OverflowPolicy::SPILL}) {
+    auto inner = std::make_shared<SlowSink>();
+    {
+      AsyncSink sink(inner, policy);
+      sink.log(record.get(), len);
+      sink.log("after\n", 6);
+      const SinkMetrics metrics = sink.metrics();
+      EXPECT_EQ(metrics.dropped, 1u);
+      EXPECT_EQ(metrics.droppedBytes, len);
+    }
+    EXPECT_EQ(inner->text(), "after\n");
+  }
+}
+
+TEST(AsyncSinkTest, SaturatedSpillWaitsInsteadOfOverflowing) {
+  auto inner = std::make_shared<GatedSink>();
+  // 每个缓冲区扩容到MAX_BUFFER_SIZE前最多容纳3条，
+  // 下游阻塞时两个缓冲区都满，第8条必然等待
+  const size_t len = MAX_BUFFER_SIZE / 4;
+  const int count = 8;
+  std::unique_ptr<char[]> record(new char[MAX_BUFFER_SIZE + 1]);
+  AsyncSink sink(inner, OverflowPolicy::SPILL);
+  std::atomic<int> pushed(0);
+  std::thread producer([&]() {
+    for (int i = 0; i < count; i++) {
+      sink.log(record.get(), len);
+      pushed++;
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_LT(pushed.load(), count);
+  // 队列饱和时超大的数据直接丢弃，不等待
+  sink.log(record.get(), MAX_BUFFER_SIZE + 1);
+  EXPECT_EQ(sink.metrics().dropped, 1u);
+
+  inner->open();
+  producer.join();
+  while (inner->bytes() < len * count) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(inner->bytes(), len * count);
+  EXPECT_EQ(sink.metrics().dropped, 1u);
+}
+
+// ===================== 日志器扇出测试 =====================
+
+TEST(AsyncSinkTest, SlowSinkDoesNotDelayOthers) {
+  auto slow = std::make_shared<SlowSink>(std::chrono::milliseconds(200));
+  auto fast = std::make_shared<SlowSink>();
+  std::vector<LogSink::ptr> sinks;
+  sinks.push_back(std::make_shared<AsyncSink>(slow));
+  sinks.push_back(fast);
+
+  AsyncLogger logger("fanout", LogLevel::value::DEBUG,
+                     std::make_shared<Formatter>("%m%n"), sinks,
+                     AsyncType::ASYNC_SAFE, std::chrono::milliseconds(1));
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 5; i++) {
+    logger.ZLOG_INFO("msg {}", i);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  while (fast->text().find("msg 4") == std::string::npos) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  // 快落地器不需要等慢落地器的多次200ms写入
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(300));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
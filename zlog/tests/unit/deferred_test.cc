@@ -0,0 +1,163 @@
+#include "zlog.h"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace zlog;
+
+class CaptureSink : public LogSink {
+public:
+  void log(const char *data, size_t len) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    text_.append(data, len);
+  }
+
+  std::string text() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return text_;
+  }
+
+private:
+  std::mutex mutex_;
+  std::string text_;
+};
+
+class DeferredTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    sink = std::make_shared<CaptureSink>();
+    sinks.push_back(sink);
+  }
+
+  std::shared_ptr<DeferredLogger> makeLogger(const std::string &pattern,
+                                             LogLevel::value level) {
+    return std::make_shared<DeferredLogger>(
+        "deferred", level, std::make_shared<Formatter>(pattern), sinks,
+        AsyncType::ASYNC_SAFE, std::chrono::milliseconds(10));
+  }
+
+  template <typename... Args>
+  static std::string roundTrip(const char *fmt, const Args &...args) {
+    using Codec = DeferredCodec<Args...>;
+    std::vector<char> data(Codec::size(args...));
+    Codec::encode(data.data(), args...);
+    fmt::memory_buffer out;
+    Codec::format(out, fmt, data.data());
+    return std::string(out.data(), out.size());
+  }
+
+  std::shared_ptr<CaptureSink> sink;
+  std::vector<LogSink::ptr> sinks;
+};
+
+// ===================== 编解码测试 =====================
+
+TEST_F(DeferredTest, CodecArithmetic) {
+  EXPECT_EQ(roundTrip("{} {} {} {}", 42, -7L, 2.5, 'x'), "42 -7 2.5 x");
+  EXPECT_EQ(roundTrip("{}/{}", true, static_cast<uint64_t>(1) << 40),
+            "true/1099511627776");
+  EXPECT_EQ(roundTrip("no args"), "no args");
+}
+
+TEST_F(DeferredTest, CodecStringsAreCopied) {
+  std::string owned = "owned";
+  const char *literal = "literal";
+  using Codec =
+      DeferredCodec<const char *, std::string, fmt::string_view, const char *>;
+  std::vector<char> data(Codec::size(literal, owned, fmt::string_view("view"),
+                                     nullptr));
+  Codec::encode(data.data(), literal, owned, fmt::string_view("view"),
+                nullptr);
+  owned.assign("changed");
+
+  fmt::memory_buffer out;
+  Codec::format(out, "{} {} {} {}", data.data());
+  EXPECT_EQ(std::string(out.data(), out.size()), "literal owned view (null)");
+}
+
+// ===================== 日志器测试 =====================
+
+TEST_F(DeferredTest, FormatsOnBackend) {
+  {
+    auto logger = makeLogger("[%p][%c] %m%n", LogLevel::value::DEBUG);
+    std::string name = "fiber-1";
+    logger->ZLOG_DEFERRED_INFO("id={} name={} ratio={:.2f}", 7, name, 0.125);
+    name.assign("reused");
+    logger->ZLOG_DEFERRED_DEBUG("plain");
+  }
+  EXPECT_EQ(sink->text(), "[INFO][deferred] id=7 name=fiber-1 ratio=0.12\n"
+                          "[DEBUG][deferred] plain\n");
+}
+
+TEST_F(DeferredTest, LevelFilterAndTextRecords) {
+  {
+    auto logger = makeLogger("%m%n", LogLevel::value::INFO);
+    logger->ZLOG_DEFERRED_DEBUG("dropped {}", 1);
+    logger->ZLOG_DEFERRED_INFO("first {}", 1);
+    // 立即格式化的接口作为文本记录，与二进制记录保持顺序
+    logger->ZLOG_INFO("second {}", 2);
+    logger->ZLOG_DEFERRED_ERROR("third {}", 3);
+  }
+  EXPECT_EQ(sink->text(), "first 1\nsecond 2\nthird 3\n");
+}
+
+TEST_F(DeferredTest, FormatErrorIsReported) {
+  {
+    auto logger = makeLogger("%m%n", LogLevel::value::DEBUG);
+    logger->ZLOG_DEFERRED_INFO("missing {} {}", 1);
+  }
+  EXPECT_NE(sink->text().find("[format error:"), std::string::npos);
+  EXPECT_NE(sink->text().find("missing {} {}"), std::string::npos);
+}
+
+TEST_F(DeferredTest, NonDeferredLoggerFormatsImmediately) {
+  SyncLogger logger("sync", LogLevel::value::DEBUG,
+                    std::make_shared<Formatter>("%f:%l %m%n"), sinks);
+  const int line = __LINE__ + 1;
+  logger.ZLOG_DEFERRED_WARN("value={}", 5);
+  EXPECT_EQ(sink->text(),
+            std::string(__FILE__) + ":" + std::to_string(line) + " value=5\n");
+}
+
+TEST_F(DeferredTest, MultiThreadKeepsPerThreadOrder) {
+  const int kThreads = 4;
+  const int kPerThread = 5000;
+  {
+    auto logger = makeLogger("%m%n", LogLevel::value::DEBUG);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+      threads.push_back(std::thread([&logger, t]() {
+        for (int i = 0; i < kPerThread; i++) {
+          logger->ZLOG_DEFERRED_INFO("{} {}", t, i);
+        }
+      }));
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
+  std::vector<int> next(kThreads, 0);
+  const std::string text = sink->text();
+  size_t pos = 0;
+  int lines = 0;
+  while (pos < text.size()) {
+    const size_t end = text.find('\n', pos);
+    ASSERT_NE(end, std::string::npos);
+    const int t = std::stoi(text.substr(pos, end - pos));
+    const int i = std::stoi(text.substr(text.find(' ', pos) + 1));
+    ASSERT_EQ(i, next[t]);
+    next[t]++;
+    lines++;
+    pos = end + 1;
+  }
+  EXPECT_EQ(lines, kThreads * kPerThread);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -3,7 +3,11 @@
 #include <chrono>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 using namespace zlog;
 
@@ -212,6 +216,158 @@ TEST_F(LooperTest, CallbackException) {
   EXPECT_GE(count.load(), 1);
 }
 
+TEST_F(LooperTest, DefaultOverflowPolicy) {
+  AsyncLooper safe([](Buffer &) {}, AsyncType::ASYNC_SAFE,
+                   std::chrono::milliseconds(50));
+  AsyncLooper unsafe([](Buffer &) {}, AsyncType::ASYNC_UNSAFE,
+                     std::chrono::milliseconds(50));
+  EXPECT_EQ(safe.overflowPolicy(), OverflowPolicy::BLOCK);
+  EXPECT_EQ(unsafe.overflowPolicy(), OverflowPolicy::SPILL);
+}
+
+TEST_F(LooperTest, DropPolicyCountsDropped) {
+  std::mutex gate;
+  gate.lock(); // 阻塞回调，让环形缓冲区写满
+  std::atomic<size_t> receivedBytes(0);
+
+  AsyncLooper looper(
+      [&](Buffer &buf) {
+        std::lock_guard<std::mutex> lock(gate);
+        receivedBytes += buf.readAbleSize();
+      },
+      AsyncType::ASYNC_SAFE, std::chrono::milliseconds(10),
+      OverflowPolicy::DROP);
+
+  const std::string msg(1024, 'D');
+  const size_t kCount = 2 * RING_BUFFER_SIZE / msg.size();
+  for (size_t i = 0; i < kCount; i++) {
+    looper.push(msg.c_str(), msg.size()); // 不阻塞
+  }
+  gate.unlock();
+  looper.stop();
+
+  EXPECT_GT(looper.droppedCount(), 0u);
+  EXPECT_EQ(receivedBytes.load() + looper.droppedCount() * msg.size(),
+            kCount * msg.size());
+}
+
+TEST_F(LooperTest, SpillPolicyKeepsThreadOrder) {
+  std::mutex gate;
+  gate.lock();
+  std::string received;
+
+  AsyncLooper looper(
+      [&](Buffer &buf) {
+        std::lock_guard<std::mutex> lock(gate);
+        received.append(buf.begin(), buf.readAbleSize());
+      },
+      AsyncType::ASYNC_UNSAFE, std::chrono::milliseconds(10),
+      OverflowPolicy::SPILL);
+
+  // 超过环形缓冲区容量，后半部分进入溢出缓冲区
+  std::string expected;
+  for (int i = 0; i < 40000; i++) {
+    const std::string msg = "line" + std::to_string(i) + "\n";
+    expected += msg;
+    looper.push(msg.c_str(), msg.size());
+  }
+  gate.unlock();
+  looper.stop();
+
+  EXPECT_EQ(looper.droppedCount(), 0u);
+  EXPECT_EQ(received, expected);
+}
+
+TEST_F(LooperTest, BlockPolicyMultiProducerNoLoss) {
+  std::mutex mtx;
+  std::vector<std::string> lastSeen(4);
+  std::string pending;
+  std::atomic<bool> ordered(true);
+  std::atomic<size_t> lines(0);
+
+  AsyncLooper looper(
+      [&](Buffer &buf) {
+        std::lock_guard<std::mutex> lock(mtx);
+        pending.append(buf.begin(), buf.readAbleSize());
+        size_t pos;
+        while ((pos = pending.find('\n')) != std::string::npos) {
+          const std::string line = pending.substr(0, pos);
+          pending.erase(0, pos + 1);
+          const int t = line[0] - '0';
+          const int seq = std::stoi(line.substr(2));
+          if (!lastSeen[t].empty() && std::stoi(lastSeen[t]) + 1 != seq) {
+            ordered = false;
+          }
+          lastSeen[t] = std::to_string(seq);
+          lines++;
+        }
+      },
+      AsyncType::ASYNC_SAFE, std::chrono::milliseconds(10),
+      OverflowPolicy::BLOCK);
+
+  const int kPerThread = 20000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.push_back(std::thread([&looper, t]() {
+      const std::string padding(100, 'p');
+      for (int i = 0; i < kPerThread; i++) {
+        const std::string msg = std::to_string(t) + " " + std::to_string(i) +
+                                " " + padding + "\n";
+        looper.push(msg.c_str(), msg.size());
+      }
+    }));
+  }
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i].join(); // 线程退出后其队列仍需被取空
+  }
+  looper.stop();
+
+  EXPECT_EQ(lines.load(), static_cast<size_t>(4 * kPerThread));
+  EXPECT_TRUE(ordered.load());
+  EXPECT_EQ(looper.droppedCount(), 0u);
+}
+
+TEST_F(LooperTest, SpillBeyondConsumerBufferLosesNothing) {
+  std::mutex gate;
+  gate.lock();
+  std::atomic<size_t> receivedBytes(0);
+
+  AsyncLooper looper(
+      [&](Buffer &buf) {
+        std::lock_guard<std::mutex> lock(gate);
+        receivedBytes += buf.readAbleSize();
+      },
+      AsyncType::ASYNC_UNSAFE, std::chrono::milliseconds(10),
+      OverflowPolicy::SPILL);
+  looper.push("start", 5); // 回调阻塞在这一批上
+
+  // 两个线程的溢出数据合计超过一个消费缓冲区能扩容到的大小，
+  // 也超过循环器的溢出预算
+  const size_t kRecord = MAX_BUFFER_SIZE / 4 + 1;
+  const int kPerThread = 2;
+  std::unique_ptr<char[]> record(new char[kRecord]);
+  std::atomic<int> pushed(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 2; t++) {
+    threads.push_back(std::thread([&looper, &record, &pushed, kRecord]() {
+      for (int i = 0; i < kPerThread; i++) {
+        looper.push(record.get(), kRecord);
+        pushed++;
+      }
+    }));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_LT(pushed.load(), 2 * kPerThread); // 回调阻塞期间超出预算的写入等待
+  gate.unlock();
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i].join();
+  }
+  looper.stop();
+
+  EXPECT_EQ(looper.droppedCount(), 0u);
+  EXPECT_EQ(receivedBytes.load(), 5 + 2 * kPerThread * kRecord);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,135 @@
+#include "mmap_sink.h"
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace zlog;
+
+class MmapSinkTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    testDir = "test_mmap_logs";
+    mkdir(testDir.c_str(), 0755);
+  }
+
+  void TearDown() override {
+    unlink((testDir + "/mmap.log").c_str());
+    unlink((testDir + "/recorder.bin").c_str());
+    rmdir(testDir.c_str());
+  }
+
+  static std::string readFile(const std::string &path) {
+    std::ifstream ifs(path.c_str(), std::ios::binary);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    return ss.str();
+  }
+
+  std::string testDir;
+};
+
+// ===================== MmapFileSink 测试 =====================
+
+TEST_F(MmapSinkTest, WritesAcrossSegments) {
+  const std::string path = testDir + "/mmap.log";
+  std::string expected;
+  {
+    // 一页一段，日志会跨段写入
+    MmapFileSink sink(path, 1);
+    for (int i = 0; i < 1000; i++) {
+      std::string line = "mmap line " + std::to_string(i) + "\n";
+      sink.log(line.c_str(), line.size());
+      expected += line;
+    }
+  }
+  // 关闭后文件截断到实际长度
+  EXPECT_EQ(readFile(path), expected);
+}
+
+TEST_F(MmapSinkTest, ReopenAfterCrashSkipsPreallocatedZeros) {
+  const std::string path = testDir + "/mmap.log";
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    MmapFileSink *sink = new MmapFileSink(path, 64 * 1024);
+    sink->log("before crash\n", 13);
+    _exit(0); // 不析构，模拟崩溃
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+
+  struct stat st {};
+  ASSERT_EQ(stat(path.c_str(), &st), 0);
+  EXPECT_EQ(st.st_size, 64 * 1024); // 预分配的整段
+
+  {
+    MmapFileSink sink(path, 64 * 1024);
+    sink.log("after restart\n", 14);
+  }
+  EXPECT_EQ(readFile(path), "before crash\nafter restart\n");
+}
+
+// ===================== FlightRecorderSink 测试 =====================
+
+TEST_F(MmapSinkTest, FlightRecorderKeepsLatest) {
+  const std::string path = testDir + "/recorder.bin";
+  std::string expected;
+  {
+    FlightRecorderSink sink(path, 4096);
+    EXPECT_EQ(sink.capacity(), 4096u);
+    for (int i = 0; i < 1000; i++) {
+      std::string line = "record " + std::to_string(i) + "\n";
+      sink.log(line.c_str(), line.size());
+      expected += line;
+    }
+  }
+
+  const std::string content = FlightRecorderSink::dump(path);
+  ASSERT_FALSE(content.empty());
+  EXPECT_LE(content.size(), 4096u);
+  // 内容是完整日志的末尾，且从一条完整日志开始
+  EXPECT_EQ(expected.substr(expected.size() - content.size()), content);
+  EXPECT_EQ(content.compare(0, 7, "record "), 0);
+  EXPECT_EQ(content.substr(content.size() - 11), "record 999\n");
+}
+
+TEST_F(MmapSinkTest, FlightRecorderSurvivesCrash) {
+  const std::string path = testDir + "/recorder.bin";
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    FlightRecorderSink *sink = new FlightRecorderSink(path, 8192);
+    sink->log("last words\n", 11);
+    _exit(0); // 不flush也不析构
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  EXPECT_EQ(FlightRecorderSink::dump(path), "last words\n");
+
+  // 重新打开时接着原有内容写
+  {
+    FlightRecorderSink sink(path, 8192);
+    sink.log("restarted\n", 10);
+  }
+  EXPECT_EQ(FlightRecorderSink::dump(path), "last words\nrestarted\n");
+}
+
+TEST_F(MmapSinkTest, FlightRecorderOversizedRecord) {
+  const std::string path = testDir + "/recorder.bin";
+  std::string big(10000, 'x');
+  big += "\ntail\n";
+  {
+    FlightRecorderSink sink(path, 4096);
+    sink.log(big.c_str(), big.size());
+  }
+  EXPECT_EQ(FlightRecorderSink::dump(path), "tail\n");
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,96 @@
+#include "ring_buffer.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+using namespace zlog;
+
+class RingBufferTest : public ::testing::Test {
+protected:
+  Buffer out;
+};
+
+// ===================== 基本读写测试 =====================
+
+TEST_F(RingBufferTest, CapacityRoundedToPowerOfTwo) {
+  SpscRingBuffer ring(1000);
+  EXPECT_EQ(ring.capacity(), 1024u);
+  EXPECT_EQ(ring.readAbleSize(), 0u);
+  EXPECT_EQ(RING_BUFFER_SIZE, 256u * 1024u);
+}
+
+TEST_F(RingBufferTest, PushAndPop) {
+  SpscRingBuffer ring(64);
+  EXPECT_TRUE(ring.push("hello", 5));
+  EXPECT_TRUE(ring.push(" world", 6));
+  EXPECT_EQ(ring.readAbleSize(), 11u);
+
+  EXPECT_EQ(ring.popTo(out), 11u);
+  EXPECT_EQ(std::string(out.begin(), out.readAbleSize()), "hello world");
+  EXPECT_EQ(ring.readAbleSize(), 0u);
+  EXPECT_EQ(ring.popTo(out), 0u);
+}
+
+TEST_F(RingBufferTest, RejectWhenFull) {
+  SpscRingBuffer ring(16);
+  EXPECT_TRUE(ring.push("0123456789", 10));
+  EXPECT_FALSE(ring.push("abcdefg", 7)); // 只剩6字节
+  EXPECT_EQ(ring.readAbleSize(), 10u);
+  EXPECT_TRUE(ring.push("abcdef", 6));
+  EXPECT_EQ(ring.producerSize(true), 16u);
+}
+
+// ===================== 回绕测试 =====================
+
+TEST_F(RingBufferTest, WrapAround) {
+  SpscRingBuffer ring(16);
+  ASSERT_TRUE(ring.push("0123456789", 10));
+  ring.popTo(out);
+  out.reset();
+
+  // 写下标位于10，这条数据跨越缓冲区末尾
+  ASSERT_TRUE(ring.push("abcdefghijkl", 12));
+  EXPECT_EQ(ring.producerSize(true), 12u);
+  EXPECT_EQ(ring.popTo(out), 12u);
+  EXPECT_EQ(std::string(out.begin(), out.readAbleSize()), "abcdefghijkl");
+}
+
+// ===================== 并发测试 =====================
+
+TEST_F(RingBufferTest, ConcurrentProducerConsumer) {
+  SpscRingBuffer ring(256);
+  const int kCount = 100000;
+
+  std::thread producer([&ring]() {
+    for (int i = 0; i < kCount; ++i) {
+      const std::string msg = std::to_string(i) + "\n";
+      while (!ring.push(msg.c_str(), msg.size())) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::string received;
+  int lines = 0;
+  while (lines < kCount) {
+    out.reset();
+    if (ring.popTo(out) == 0) {
+      std::this_thread::yield();
+      continue;
+    }
+    received.append(out.begin(), out.readAbleSize());
+    size_t pos;
+    while ((pos = received.find('\n')) != std::string::npos) {
+      ASSERT_EQ(received.substr(0, pos), std::to_string(lines));
+      received.erase(0, pos + 1);
+      ++lines;
+    }
+  }
+  producer.join();
+  EXPECT_TRUE(received.empty());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,245 @@
+#include "rolling_sink.h"
+#include <algorithm>
+#include <dirent.h>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#ifdef ZLOG_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace zlog;
+
+class RollingSinkTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    testDir = "test_rolling_logs";
+    cleanup();
+    mkdir(testDir.c_str(), 0755);
+    basename = testDir + "/app";
+  }
+
+  void TearDown() override { cleanup(); }
+
+  void cleanup() {
+    for (const auto &name : listDir()) {
+      unlink((testDir + "/" + name).c_str());
+    }
+    rmdir(testDir.c_str());
+  }
+
+  std::vector<std::string> listDir() {
+    std::vector<std::string> files;
+    DIR *dir = opendir(testDir.c_str());
+    if (dir) {
+      struct dirent *entry;
+      while ((entry = readdir(dir)) != NULL) {
+        std::string name = entry->d_name;
+        if (name != "." && name != "..") {
+          files.push_back(name);
+        }
+      }
+      closedir(dir);
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+  }
+
+  std::vector<std::string> archives() {
+    std::vector<std::string> result;
+    for (const auto &name : listDir()) {
+      if (name != "app.log" && name.find(".log.next") == std::string::npos) {
+        result.push_back(name);
+      }
+    }
+    return result;
+  }
+
+  static std::string readFile(const std::string &path) {
+    std::ifstream ifs(path.c_str(), std::ios::binary);
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    return ss.str();
+  }
+
+  // 读取归档文件内容，.gz文件先解压
+  std::string readArchive(const std::string &name) {
+    const std::string path = testDir + "/" + name;
+    if (name.size() < 3 || name.compare(name.size() - 3, 3, ".gz") != 0) {
+      return readFile(path);
+    }
+#ifdef ZLOG_HAVE_ZLIB
+    std::string content;
+    gzFile in = gzopen(path.c_str(), "rb");
+    char buf[4096];
+    int n;
+    while (in != nullptr && (n = gzread(in, buf, sizeof(buf))) > 0) {
+      content.append(buf, static_cast<size_t>(n));
+    }
+    if (in != nullptr) {
+      gzclose(in);
+    }
+    return content;
+#else
+    return std::string();
+#endif
+  }
+
+  std::string testDir;
+  std::string basename;
+};
+
+// ===================== 按大小滚动测试 =====================
+
+TEST_F(RollingSinkTest, RollBySizeKeepsAllData) {
+  RollingOptions options;
+  options.maxSize = 100;
+  options.compress = false;
+
+  std::string expected;
+  {
+    RollingFileSink sink(basename, options);
+    EXPECT_EQ(sink.activePath(), basename + ".log");
+    for (int i = 0; i < 20; i++) {
+      std::string line = "size roll message number " + std::to_string(i) + "\n";
+      sink.log(line.c_str(), line.size());
+      expected += line;
+    }
+    sink.waitIdle();
+  }
+
+  // 归档按名称排序即为时间顺序，拼接后加上当前文件应等于全部数据
+  std::vector<std::string> names = archives();
+  EXPECT_GT(names.size(), 1u);
+  std::string all;
+  for (const auto &name : names) {
+    EXPECT_LE(readArchive(name).size(), 100u);
+    all += readArchive(name);
+  }
+  all += readFile(basename + ".log");
+  EXPECT_EQ(all, expected);
+  // 退出时删除预先打开的空文件
+  EXPECT_EQ(listDir().size(), names.size() + 1);
+}
+
+TEST_F(RollingSinkTest, ReopenAppendsToActiveFile) {
+  RollingOptions options;
+  options.maxSize = 1024;
+  {
+    RollingFileSink sink(basename, options);
+    sink.log("first\n", 6);
+  }
+  {
+    RollingFileSink sink(basename, options);
+    sink.log("second\n", 7);
+  }
+  EXPECT_EQ(readFile(basename + ".log"), "first\nsecond\n");
+  EXPECT_TRUE(archives().empty());
+}
+
+TEST_F(RollingSinkTest, RecoversPendingNextFiles) {
+  // 模拟上次进程滚动两次后、归档前退出：.next和.next.0中是更新的数据
+  std::ofstream(basename + ".log") << "active\n";
+  std::ofstream(basename + ".log.next") << "next\n";
+  std::ofstream(basename + ".log.next.0") << "fallback\n";
+  std::ofstream(basename + ".log.next.1"); // 空文件不参与恢复
+
+  RollingOptions options;
+  options.maxSize = 1024;
+  options.compress = false;
+  {
+    RollingFileSink sink(basename, options);
+    sink.log("after\n", 6);
+    sink.waitIdle();
+  }
+
+  std::vector<std::string> names = archives();
+  ASSERT_EQ(names.size(), 2u);
+  EXPECT_EQ(readArchive(names[0]), "active\n");
+  EXPECT_EQ(readArchive(names[1]), "next\n");
+  EXPECT_EQ(readFile(basename + ".log"), "fallback\nafter\n");
+  EXPECT_EQ(listDir().size(), 3u);
+}
+
+// ===================== 按时间滚动测试 =====================
+
+TEST_F(RollingSinkTest, RollByTime) {
+  RollingOptions options;
+  options.interval = 1;
+  options.compress = false;
+  {
+    RollingFileSink sink(basename, options);
+    sink.log("before\n", 7);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    sink.log("after\n", 6);
+    sink.waitIdle();
+  }
+  std::vector<std::string> names = archives();
+  ASSERT_EQ(names.size(), 1u);
+  EXPECT_EQ(readArchive(names[0]), "before\n");
+  EXPECT_EQ(readFile(basename + ".log"), "after\n");
+}
+
+// ===================== 压缩与保留测试 =====================
+
+TEST_F(RollingSinkTest, CompressAndRetainByCount) {
+  RollingOptions options;
+  options.maxSize = 64;
+  options.maxFiles = 3;
+  {
+    RollingFileSink sink(basename, options);
+    for (int i = 0; i < 30; i++) {
+      std::string line = "retention line " + std::to_string(i) + "\n";
+      sink.log(line.c_str(), line.size());
+    }
+    sink.waitIdle();
+  }
+
+  std::vector<std::string> names = archives();
+  EXPECT_EQ(names.size(), 3u);
+  for (const auto &name : names) {
+    if (RollingFileSink::compressionSupported()) {
+      EXPECT_EQ(name.substr(name.size() - 7), ".log.gz");
+    }
+    EXPECT_EQ(readArchive(name).compare(0, 15, "retention line "), 0);
+  }
+  // 保留的是最新的归档
+  const std::string last = readArchive(names.back());
+  const std::string active = readFile(basename + ".log");
+  EXPECT_NE(active.find("retention line 29"), std::string::npos);
+  EXPECT_EQ(last.find("retention line 0\n"), std::string::npos);
+}
+
+TEST_F(RollingSinkTest, RetainByTotalBytes) {
+  RollingOptions options;
+  options.maxSize = 100;
+  options.maxTotalBytes = 250;
+  options.compress = false;
+  {
+    RollingFileSink sink(basename, options);
+    std::string line(50, 'b');
+    line.back() = '\n';
+    for (int i = 0; i < 40; i++) {
+      sink.log(line.c_str(), line.size());
+    }
+    sink.waitIdle();
+  }
+
+  size_t total = 0;
+  for (const auto &name : archives()) {
+    total += readArchive(name).size();
+  }
+  EXPECT_GT(total, 0u);
+  EXPECT_LE(total, 250u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -254,6 +254,88 @@ TEST_F(SinkTest, RollBySizeSinkLargeFile) {
   EXPECT_EQ(fileCount, 1);
 }
 
+// ===================== FdSink Tests =====================
+
+TEST_F(SinkTest, FdFileSinkBufferedUntilFlush) {
+  std::string filepath = testDir + "/fd_file.log";
+  {
+    FdFileSink sink(filepath);
+    sink.log("first\n", 6);
+    sink.log("second\n", 7);
+    sink.flush();
+    EXPECT_EQ(readFile(filepath), "first\nsecond\n");
+    sink.log("third\n", 6);
+  }
+  // 析构时写出剩余数据
+  EXPECT_EQ(readFile(filepath), "first\nsecond\nthird\n");
+}
+
+TEST_F(SinkTest, FdFileSinkLargeRecordWritev) {
+  std::string filepath = testDir + "/fd_large.log";
+  std::string expected;
+  {
+    // 缓冲区最小为一个对齐块，超过剩余空间的记录与暂存数据一次writev写出
+    FdFileSink sink(filepath, 1);
+    for (int i = 0; i < 20; i++) {
+      std::string line(1000 + i, static_cast<char>('a' + i));
+      line.push_back('\n');
+      sink.log(line.c_str(), line.size());
+      expected += line;
+    }
+  }
+  EXPECT_EQ(readFile(filepath), expected);
+}
+
+TEST_F(SinkTest, FdFileSinkDirectIoAppend) {
+  std::string filepath = testDir + "/fd_direct.log";
+  {
+    std::ofstream ofs(filepath.c_str(), std::ios::binary);
+    ofs << "existing\n";
+  }
+
+  std::string expected = "existing\n";
+  {
+    FdFileSink sink(filepath, DIRECT_IO_ALIGN * 2, true, 64 * 1024);
+    for (int i = 0; i < 2000; i++) {
+      std::string line = "direct line " + std::to_string(i) + "\n";
+      sink.log(line.c_str(), line.size());
+      expected += line;
+      if (i % 300 == 0) {
+        // 中途写出不对齐的尾部，之后整块覆盖写
+        sink.flush();
+        EXPECT_EQ(readFile(filepath), expected);
+      }
+    }
+  }
+  EXPECT_EQ(readFile(filepath), expected);
+}
+
+TEST_F(SinkTest, RollBySizeFdSinkRollOver) {
+  std::string basename = testDir + "/fd_roll";
+  size_t maxSize = 100;
+
+  {
+    RollBySizeFdSink sink(basename, maxSize);
+    for (int i = 0; i < 10; i++) {
+      std::string line =
+          "this is a longer log message line " + std::to_string(i) + "\n";
+      sink.log(line.c_str(), line.size());
+    }
+  }
+
+  std::vector<std::string> files = listDir(testDir);
+  int fileCount = 0;
+  size_t totalSize = 0;
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (files[i].find("fd_roll") != std::string::npos) {
+      fileCount++;
+      totalSize += readFile(testDir + "/" + files[i]).size();
+    }
+  }
+  EXPECT_GT(fileCount, 1) << "Expected multiple rolled files";
+  EXPECT_EQ(totalSize, 10 * 36u);
+}
+
 // ===================== SinkFactory Tests =====================
 
 TEST_F(SinkTest, SinkFactoryCreateStdOut) {